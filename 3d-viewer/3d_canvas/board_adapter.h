@@ -546,6 +546,16 @@ class BOARD_ADAPTER
     void createLayers( REPORTER *aStatusTextReporter );
     void destroyLayers();
 
+    /**
+     * Add the board drawings (graphic lines, texts and dimensions) of a layer.
+     *
+     * @param aTraceUnknown is true to trace the drawing types which are not handled
+     */
+    void addDrawingsToContainer( PCB_LAYER_ID aLayerId, CGENERICCONTAINER2D* aDstContainer,
+                                 bool aTraceUnknown );
+    void addDrawingsToPolygon( PCB_LAYER_ID aLayerId, SHAPE_POLY_SET& aCornerBuffer,
+                               bool aTraceUnknown );
+
     // Helper functions to create the board
      void createNewTrack( const TRACK* aTrack, CGENERICCONTAINER2D *aDstContainer,
                           int aClearanceValue );
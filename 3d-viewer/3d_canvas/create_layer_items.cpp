@@ -49,15 +49,45 @@
 #include <class_zone.h>
 #include <class_text_mod.h>
 #include <convert_basic_shapes_to_polygon.h>
+#include <parallel_for.h>
 #include <trigo.h>
 #include <utility>
 #include <vector>
+#include <deque>
+#include <functional>
 #include <thread>
 #include <algorithm>
 #include <atomic>
 
 #include <profile.h>
 
+
+namespace
+{
+
+/**
+ * Run the tasks in parallel and wait for all of them.  Tasks must not write to the same
+ * objects.
+ */
+void runTasks( const std::vector<std::function<void()>>& aTasks )
+{
+    ParallelFor( aTasks.size(),
+                 [&]( size_t aIdx )
+                 {
+                     aTasks[aIdx]();
+                 } );
+}
+
+
+/// The objects and contours added to a layer by one task
+struct LAYER_PART
+{
+    CCONTAINER2D   m_objects;
+    SHAPE_POLY_SET m_poly;
+};
+
+} // namespace
+
 void BOARD_ADAPTER::destroyLayers()
 {
     if( !m_layers_poly.empty() )
@@ -211,868 +241,693 @@ void BOARD_ADAPTER::createLayers( REPORTER *aStatusTextReporter )
     start_Time = GetRunningMicroSecs();
 #endif
 
-    if( aStatusTextReporter )
-        aStatusTextReporter->Report( _( "Create tracks and vias" ) );
-
-    // Create tracks as objects and add it to container
+    // Holes statistics of the pads
     // /////////////////////////////////////////////////////////////////////////
-    for( PCB_LAYER_ID curr_layer_id : layer_id )
+    for( MODULE* module : m_board->Modules() )
     {
-        wxASSERT( m_layers_container2D.find( curr_layer_id ) != m_layers_container2D.end() );
-
-        CBVHCONTAINER2D *layerContainer = m_layers_container2D[curr_layer_id];
-
-        // ADD TRACKS
-        unsigned int nTracks = trackList.size();
-
-        for( unsigned int trackIdx = 0; trackIdx < nTracks; ++trackIdx )
+        for( D_PAD* pad : module->Pads() )
         {
-            const TRACK *track = trackList[trackIdx];
-
-            // NOTE: Vias can be on multiple layers
-            if( !track->IsOnLayer( curr_layer_id ) )
+            if( !pad->GetDrillSize().x )    // Not drilled pad like SMD pad
                 continue;
 
-            // Add object item to layer container
-            createNewTrack( track, layerContainer, 0.0f );
+            m_stats_nr_holes++;
+            m_stats_hole_med_diameter += ( ( pad->GetDrillSize().x +
+                                             pad->GetDrillSize().y ) / 2.0f ) * m_biuTo3Dunits;
         }
     }
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T03: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
+    if( m_stats_nr_holes )
+        m_stats_hole_med_diameter /= (float)m_stats_nr_holes;
 
-    // Create VIAS and THTs objects and add it to holes containers
+    // Prepare the holes containers of the layers having blind or buried vias
     // /////////////////////////////////////////////////////////////////////////
-    for( PCB_LAYER_ID curr_layer_id : layer_id )
+    for( const TRACK* track : trackList )
     {
-        // ADD TRACKS
-        unsigned int nTracks = trackList.size();
-
-        for( unsigned int trackIdx = 0; trackIdx < nTracks; ++trackIdx )
+        if( track->Type() != PCB_VIA_T
+                || static_cast<const VIA*>( track )->GetViaType() == VIATYPE::THROUGH )
         {
-            const TRACK *track = trackList[trackIdx];
-
-            if( !track->IsOnLayer( curr_layer_id ) )
-                continue;
+            continue;
+        }
 
-            // ADD VIAS and THT
-            if( track->Type() == PCB_VIA_T )
+        for( PCB_LAYER_ID curr_layer_id : layer_id )
+        {
+            if( track->IsOnLayer( curr_layer_id )
+                    && m_layers_holes2D.find( curr_layer_id ) == m_layers_holes2D.end() )
             {
-                const VIA*    via               = static_cast<const VIA*>( track );
-                const VIATYPE viatype           = via->GetViaType();
-                const float   holediameter      = via->GetDrillValue() * BiuTo3Dunits();
-                const float   thickness         = GetCopperThickness3DU();
-                const float   hole_inner_radius = ( holediameter / 2.0f );
-
-                const SFVEC2F via_center(
-                        via->GetStart().x * m_biuTo3Dunits, -via->GetStart().y * m_biuTo3Dunits );
-
-                if( viatype != VIATYPE::THROUGH )
-                {
-
-                    // Add hole objects
-                    // /////////////////////////////////////////////////////////
-
-                    CBVHCONTAINER2D *layerHoleContainer = NULL;
-
-                    // Check if the layer is already created
-                    if( m_layers_holes2D.find( curr_layer_id ) == m_layers_holes2D.end() )
-                    {
-                        // not found, create a new container
-                        layerHoleContainer = new CBVHCONTAINER2D;
-                        m_layers_holes2D[curr_layer_id] = layerHoleContainer;
-                    }
-                    else
-                    {
-                        // found
-                        layerHoleContainer = m_layers_holes2D[curr_layer_id];
-                    }
-
-                    // Add a hole for this layer
-                    layerHoleContainer->Add( new CFILLEDCIRCLE2D( via_center,
-                                                                  hole_inner_radius + thickness,
-                                                                  *track ) );
-                }
-                else if( curr_layer_id == layer_id[0] ) // it only adds once the THT holes
-                {
-                    // Add through hole object
-                    // /////////////////////////////////////////////////////////
-                    m_through_holes_outer.Add( new CFILLEDCIRCLE2D( via_center,
-                                                                    hole_inner_radius + thickness,
-                                                                    *track ) );
-
-                    m_through_holes_vias_outer.Add(
-                                new CFILLEDCIRCLE2D( via_center,
-                                                     hole_inner_radius + thickness,
-                                                     *track ) );
-
-                    m_through_holes_inner.Add( new CFILLEDCIRCLE2D( via_center,
-                                                                    hole_inner_radius,
-                                                                    *track ) );
-
-                    //m_through_holes_vias_inner.Add( new CFILLEDCIRCLE2D( via_center,
-                    //                                                     hole_inner_radius,
-                    //                                                     *track ) );
-                }
+                m_layers_holes2D[curr_layer_id] = new CBVHCONTAINER2D;
+                m_layers_outer_holes_poly[curr_layer_id] = new SHAPE_POLY_SET;
+                m_layers_inner_holes_poly[curr_layer_id] = new SHAPE_POLY_SET;
             }
         }
     }
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T04: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
-
-    // Create VIAS and THTs objects and add it to holes containers
+    // Prepare tech layers containers
+    // User layers are not drawn here, only technical layers
     // /////////////////////////////////////////////////////////////////////////
-    for( PCB_LAYER_ID curr_layer_id : layer_id )
-    {
-        // ADD TRACKS
-        const unsigned int nTracks = trackList.size();
-
-        for( unsigned int trackIdx = 0; trackIdx < nTracks; ++trackIdx )
-        {
-            const TRACK *track = trackList[trackIdx];
-
-            if( !track->IsOnLayer( curr_layer_id ) )
-                continue;
-
-            // ADD VIAS and THT
-            if( track->Type() == PCB_VIA_T )
-            {
-                const VIA *via = static_cast< const VIA*>( track );
-                const VIATYPE viatype = via->GetViaType();
-
-                if( viatype != VIATYPE::THROUGH )
-                {
-
-                    // Add VIA hole contourns
-                    // /////////////////////////////////////////////////////////
-
-                    // Add outer holes of VIAs
-                    SHAPE_POLY_SET *layerOuterHolesPoly = NULL;
-                    SHAPE_POLY_SET *layerInnerHolesPoly = NULL;
-
-                    // Check if the layer is already created
-                    if( m_layers_outer_holes_poly.find( curr_layer_id ) ==
-                        m_layers_outer_holes_poly.end() )
-                    {
-                        // not found, create a new container
-                        layerOuterHolesPoly = new SHAPE_POLY_SET;
-                        m_layers_outer_holes_poly[curr_layer_id] = layerOuterHolesPoly;
-
-                        wxASSERT( m_layers_inner_holes_poly.find( curr_layer_id ) ==
-                                  m_layers_inner_holes_poly.end() );
-
-                        layerInnerHolesPoly = new SHAPE_POLY_SET;
-                        m_layers_inner_holes_poly[curr_layer_id] = layerInnerHolesPoly;
-                    }
-                    else
-                    {
-                        // found
-                        layerOuterHolesPoly = m_layers_outer_holes_poly[curr_layer_id];
-
-                        wxASSERT( m_layers_inner_holes_poly.find( curr_layer_id ) !=
-                                  m_layers_inner_holes_poly.end() );
-
-                        layerInnerHolesPoly = m_layers_inner_holes_poly[curr_layer_id];
-                    }
-
-                    const int holediameter = via->GetDrillValue();
-                    const int hole_outer_radius = (holediameter / 2) + GetCopperThicknessBIU();
-
-                    TransformCircleToPolygon( *layerOuterHolesPoly, via->GetStart(),
-                            hole_outer_radius, ARC_HIGH_DEF );
+    static const PCB_LAYER_ID teckLayerList[] = {
+            B_Adhes,
+            F_Adhes,
+            B_Paste,
+            F_Paste,
+            B_SilkS,
+            F_SilkS,
+            B_Mask,
+            F_Mask,
 
-                    TransformCircleToPolygon( *layerInnerHolesPoly, via->GetStart(),
-                            holediameter / 2, ARC_HIGH_DEF );
-                }
-                else if( curr_layer_id == layer_id[0] ) // it only adds once the THT holes
-                {
-                    const int holediameter = via->GetDrillValue();
-                    const int hole_outer_radius = (holediameter / 2)+ GetCopperThicknessBIU();
+            // Aux Layers
+            Dwgs_User,
+            Cmts_User,
+            Eco1_User,
+            Eco2_User,
+            Edge_Cuts,
+            Margin
+        };
 
-                    // Add through hole contourns
-                    // /////////////////////////////////////////////////////////
-                    TransformCircleToPolygon( m_through_outer_holes_poly, via->GetStart(),
-                            hole_outer_radius, ARC_HIGH_DEF );
+    std::vector< PCB_LAYER_ID > tech_layer_id;
 
-                    TransformCircleToPolygon( m_through_inner_holes_poly, via->GetStart(),
-                            holediameter / 2, ARC_HIGH_DEF );
+    for( LSEQ seq = LSET::AllNonCuMask().Seq( teckLayerList, arrayDim( teckLayerList ) );
+         seq;
+         ++seq )
+    {
+        const PCB_LAYER_ID curr_layer_id = *seq;
 
-                    // Add samething for vias only
+        if( !Is3DLayerEnabled( curr_layer_id ) )
+            continue;
 
-                    TransformCircleToPolygon( m_through_outer_holes_vias_poly, via->GetStart(),
-                            hole_outer_radius, ARC_HIGH_DEF );
+        tech_layer_id.push_back( curr_layer_id );
 
-                    //TransformCircleToPolygon( m_through_inner_holes_vias_poly,
-                    //                          via->GetStart(),
-                    //                          holediameter / 2,
-                    //                          GetNrSegmentsCircle( holediameter ) );
-                }
-            }
-        }
+        m_layers_container2D[curr_layer_id] = new CBVHCONTAINER2D;
+        m_layers_poly[curr_layer_id] = new SHAPE_POLY_SET;
     }
 
 #ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T05: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
+    printf( "T03: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time ) / 1e3 );
     start_Time = GetRunningMicroSecs();
 #endif
 
-    // Creates outline contours of the tracks and add it to the poly of the layer
-    // /////////////////////////////////////////////////////////////////////////
-    if( GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS )
-            && ( m_render_engine == RENDER_ENGINE::OPENGL_LEGACY ) )
-    {
-        for( PCB_LAYER_ID curr_layer_id : layer_id )
-        {
-            wxASSERT( m_layers_poly.find( curr_layer_id ) != m_layers_poly.end() );
+    if( aStatusTextReporter )
+        aStatusTextReporter->Report( _( "Create tracks and vias" ) );
 
-            SHAPE_POLY_SET *layerPoly = m_layers_poly[curr_layer_id];
+    // All the layers and item classes are built by independent tasks.  A task only
+    // writes to the containers it owns; when several tasks contribute to a layer, each
+    // one fills its own LAYER_PART and the parts are merged in task creation order.
+    // /////////////////////////////////////////////////////////////////////////
+    const bool copperPolys = GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS )
+                             && ( m_render_engine == RENDER_ENGINE::OPENGL_LEGACY );
 
-            // ADD TRACKS
-            unsigned int nTracks = trackList.size();
+    std::vector<std::function<void()>>  tasks;
+    std::deque<LAYER_PART>              parts;
+    std::vector<std::vector<LAYER_PART*>> copperParts( layer_id.size() );
 
-            for( unsigned int trackIdx = 0; trackIdx < nTracks; ++trackIdx )
-            {
-                const TRACK *track = trackList[trackIdx];
+    auto newPart = [&]( size_t aLayerIdx ) -> LAYER_PART*
+                   {
+                       parts.emplace_back();
+                       copperParts[aLayerIdx].push_back( &parts.back() );
+                       return &parts.back();
+                   };
 
-                if( !track->IsOnLayer( curr_layer_id ) )
-                    continue;
+    for( size_t layerIdx = 0; layerIdx < layer_id.size(); ++layerIdx )
+    {
+        const PCB_LAYER_ID curr_layer_id = layer_id[layerIdx];
 
-                // Add the track contour
-                track->TransformShapeWithClearanceToPolygon( *layerPoly, 0 );
-            }
+        // ADD TRACKS
+        LAYER_PART* tracks = newPart( layerIdx );
+
+        tasks.push_back( [this, &trackList, curr_layer_id, tracks]()
+                         {
+                             for( const TRACK* track : trackList )
+                             {
+                                 // NOTE: Vias can be on multiple layers
+                                 if( track->IsOnLayer( curr_layer_id ) )
+                                     createNewTrack( track, &tracks->m_objects, 0.0f );
+                             }
+                         } );
+
+        if( copperPolys )
+        {
+            tasks.push_back( [&trackList, curr_layer_id, tracks]()
+                             {
+                                 for( const TRACK* track : trackList )
+                                 {
+                                     if( track->IsOnLayer( curr_layer_id ) )
+                                         track->TransformShapeWithClearanceToPolygon(
+                                                 tracks->m_poly, 0 );
+                                 }
+                             } );
         }
-    }
-
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T06: %.3f ms\n", (float)( GetRunningMicroSecs()  - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
 
-    // Add holes of modules
-    // /////////////////////////////////////////////////////////////////////////
-    for( MODULE* module : m_board->Modules() )
-    {
-        for( D_PAD* pad : module->Pads() )
+        // ADD PADS
+        LAYER_PART* pads = newPart( layerIdx );
+
+        tasks.push_back( [this, curr_layer_id, pads]()
+                         {
+                             for( MODULE* module : m_board->Modules() )
+                             {
+                                 // Note: NPTH pads are not drawn on copper layers when the
+                                 // pad has same shape as its hole
+                                 AddPadsShapesWithClearanceToContainer( module,
+                                                                        &pads->m_objects,
+                                                                        curr_layer_id, 0, true );
+
+                                 // Micro-wave modules may have items on copper layers
+                                 AddGraphicsShapesWithClearanceToContainer( module,
+                                                                            &pads->m_objects,
+                                                                            curr_layer_id, 0 );
+                             }
+                         } );
+
+        if( copperPolys )
         {
-            const wxSize padHole = pad->GetDrillSize();
-
-            if( !padHole.x )    // Not drilled pad like SMD pad
-                continue;
+            tasks.push_back( [this, curr_layer_id, pads]()
+                             {
+                                 for( MODULE* module : m_board->Modules() )
+                                 {
+                                     transformPadsShapesWithClearanceToPolygon( module->Pads(),
+                                                                                curr_layer_id,
+                                                                                pads->m_poly,
+                                                                                0, true );
+
+                                     module->TransformGraphicTextWithClearanceToPolygonSet(
+                                             curr_layer_id, pads->m_poly, 0 );
+
+                                     transformGraphicModuleEdgeToPolygonSet( module,
+                                                                             curr_layer_id,
+                                                                             pads->m_poly );
+                                 }
+                             } );
+        }
 
-            // The hole in the body is inflated by copper thickness,
-            // if not plated, no copper
-            const int inflate = (pad->GetAttribute () != PAD_ATTRIB_HOLE_NOT_PLATED) ?
-                                GetCopperThicknessBIU() : 0;
+        // ADD GRAPHIC ITEMS ON COPPER LAYERS (texts)
+        LAYER_PART* drawings = newPart( layerIdx );
 
-            m_stats_nr_holes++;
-            m_stats_hole_med_diameter += ( ( pad->GetDrillSize().x +
-                                             pad->GetDrillSize().y ) / 2.0f ) * m_biuTo3Dunits;
+        tasks.push_back( [this, curr_layer_id, drawings]()
+                         {
+                             addDrawingsToContainer( curr_layer_id, &drawings->m_objects, true );
+                         } );
 
-            m_through_holes_outer.Add( createNewPadDrill( pad, inflate ) );
-            m_through_holes_inner.Add( createNewPadDrill( pad,       0 ) );
+        if( copperPolys )
+        {
+            tasks.push_back( [this, curr_layer_id, drawings]()
+                             {
+                                 addDrawingsToPolygon( curr_layer_id, drawings->m_poly, true );
+                             } );
         }
-    }
-    if( m_stats_nr_holes )
-        m_stats_hole_med_diameter /= (float)m_stats_nr_holes;
-
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T07: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
 
-    // Add contours of the pad holes (pads can be Circle or Segment holes)
-    // /////////////////////////////////////////////////////////////////////////
-    for( MODULE* module : m_board->Modules() )
-    {
-        for( D_PAD* pad : module->Pads() )
+        // ADD COPPER ZONES
+        if( GetFlag( FL_ZONE ) )
         {
-            const wxSize padHole = pad->GetDrillSize();
+            for( ZONE_CONTAINER* zone : m_board->Zones() )
+            {
+                if( zone->GetLayer() != curr_layer_id )
+                    continue;
 
-            if( !padHole.x ) // Not drilled pad like SMD pad
-                continue;
+                LAYER_PART* zonePart = newPart( layerIdx );
 
-            // The hole in the body is inflated by copper thickness.
-            const int inflate = GetCopperThicknessBIU();
+                tasks.push_back( [this, zone, curr_layer_id, zonePart]()
+                                 {
+                                     AddSolidAreasShapesToContainer( zone,
+                                                                     &zonePart->m_objects,
+                                                                     curr_layer_id );
+                                 } );
 
-            if( pad->GetAttribute () != PAD_ATTRIB_HOLE_NOT_PLATED )
-            {
-                pad->BuildPadDrillShapePolygon( m_through_outer_holes_poly, inflate );
-                pad->BuildPadDrillShapePolygon( m_through_inner_holes_poly, 0 );
-            }
-            else
-            {
-                // If not plated, no copper.
-                pad->BuildPadDrillShapePolygon( m_through_outer_holes_poly_NPTH, inflate );
+                if( copperPolys )
+                {
+                    tasks.push_back( [zone, zonePart]()
+                                     {
+                                         zone->TransformSolidAreasShapesToPolygonSet(
+                                                 zonePart->m_poly );
+                                     } );
+                }
             }
         }
-    }
-
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T08: %.3f ms\n", (float)( GetRunningMicroSecs()  - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
 
-    // Add modules PADs objects to containers
-    // /////////////////////////////////////////////////////////////////////////
-    for( PCB_LAYER_ID curr_layer_id : layer_id )
-    {
-        wxASSERT( m_layers_container2D.find( curr_layer_id ) != m_layers_container2D.end() );
-
-        CBVHCONTAINER2D *layerContainer = m_layers_container2D[curr_layer_id];
+        // ADD BLIND AND BURIED VIAS HOLES
+        if( m_layers_holes2D.find( curr_layer_id ) == m_layers_holes2D.end() )
+            continue;
 
-        // ADD PADS
-        for( MODULE* module : m_board->Modules() )
-        {
-            // Note: NPTH pads are not drawn on copper layers when the pad
-            // has same shape as its hole
-            AddPadsShapesWithClearanceToContainer( module,
-                                                   layerContainer,
-                                                   curr_layer_id,
-                                                   0,
-                                                   true );
-
-            // Micro-wave modules may have items on copper layers
-            AddGraphicsShapesWithClearanceToContainer( module,
-                                                       layerContainer,
-                                                       curr_layer_id,
-                                                       0 );
-        }
+        CBVHCONTAINER2D* layerHoleContainer = m_layers_holes2D[curr_layer_id];
+        SHAPE_POLY_SET*  layerOuterHolesPoly = m_layers_outer_holes_poly[curr_layer_id];
+        SHAPE_POLY_SET*  layerInnerHolesPoly = m_layers_inner_holes_poly[curr_layer_id];
+
+        tasks.push_back( [this, &trackList, curr_layer_id, layerHoleContainer]()
+                         {
+                             const float thickness = GetCopperThickness3DU();
+
+                             for( const TRACK* track : trackList )
+                             {
+                                 if( track->Type() != PCB_VIA_T
+                                         || !track->IsOnLayer( curr_layer_id ) )
+                                     continue;
+
+                                 const VIA* via = static_cast<const VIA*>( track );
+
+                                 if( via->GetViaType() == VIATYPE::THROUGH )
+                                     continue;
+
+                                 const float holediameter = via->GetDrillValue() * BiuTo3Dunits();
+                                 const SFVEC2F via_center( via->GetStart().x * m_biuTo3Dunits,
+                                                          -via->GetStart().y * m_biuTo3Dunits );
+
+                                 // Add a hole for this layer
+                                 layerHoleContainer->Add(
+                                         new CFILLEDCIRCLE2D( via_center,
+                                                              holediameter / 2.0f + thickness,
+                                                              *track ) );
+                             }
+                         } );
+
+        tasks.push_back( [this, &trackList, curr_layer_id, layerOuterHolesPoly,
+                          layerInnerHolesPoly]()
+                         {
+                             for( const TRACK* track : trackList )
+                             {
+                                 if( track->Type() != PCB_VIA_T
+                                         || !track->IsOnLayer( curr_layer_id ) )
+                                     continue;
+
+                                 const VIA* via = static_cast<const VIA*>( track );
+
+                                 if( via->GetViaType() == VIATYPE::THROUGH )
+                                     continue;
+
+                                 const int holediameter = via->GetDrillValue();
+                                 const int hole_outer_radius = ( holediameter / 2 )
+                                                               + GetCopperThicknessBIU();
+
+                                 TransformCircleToPolygon( *layerOuterHolesPoly, via->GetStart(),
+                                                           hole_outer_radius, ARC_HIGH_DEF );
+
+                                 TransformCircleToPolygon( *layerInnerHolesPoly, via->GetStart(),
+                                                           holediameter / 2, ARC_HIGH_DEF );
+                             }
+                         } );
     }
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T09: %.3f ms\n", (float)( GetRunningMicroSecs()  - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
-
-    // Add modules PADs poly contourns
+    // Add through holes of vias, it only adds once the THT holes
     // /////////////////////////////////////////////////////////////////////////
-    if( GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS )
-            && ( m_render_engine == RENDER_ENGINE::OPENGL_LEGACY ) )
-    {
-        for( PCB_LAYER_ID curr_layer_id : layer_id )
-        {
-            wxASSERT( m_layers_poly.find( curr_layer_id ) != m_layers_poly.end() );
-
-            SHAPE_POLY_SET *layerPoly = m_layers_poly[curr_layer_id];
-
-            // ADD PADS
-            for( auto module : m_board->Modules() )
-            {
-                // Construct polys
-                // /////////////////////////////////////////////////////////////
-
-                // Note: NPTH pads are not drawn on copper layers when the pad
-                // has same shape as its hole
-                transformPadsShapesWithClearanceToPolygon( module->Pads(),
-                                                           curr_layer_id,
-                                                           *layerPoly,
-                                                           0,
-                                                           true );
-
-                // Micro-wave modules may have items on copper layers
-                module->TransformGraphicTextWithClearanceToPolygonSet( curr_layer_id,
-                                                                       *layerPoly,
-                                                                       0 );
+    LAYER_PART viaHolesOuter;
+    LAYER_PART viaHolesInner;
 
-                transformGraphicModuleEdgeToPolygonSet( module, curr_layer_id, *layerPoly );
-            }
-        }
+    if( !layer_id.empty() )
+    {
+        const PCB_LAYER_ID first_layer_id = layer_id[0];
+
+        tasks.push_back( [this, &trackList, first_layer_id, &viaHolesOuter, &viaHolesInner]()
+                         {
+                             const float thickness = GetCopperThickness3DU();
+
+                             for( const TRACK* track : trackList )
+                             {
+                                 if( track->Type() != PCB_VIA_T
+                                         || !track->IsOnLayer( first_layer_id ) )
+                                     continue;
+
+                                 const VIA* via = static_cast<const VIA*>( track );
+
+                                 if( via->GetViaType() != VIATYPE::THROUGH )
+                                     continue;
+
+                                 const float holediameter = via->GetDrillValue() * BiuTo3Dunits();
+                                 const float hole_inner_radius = holediameter / 2.0f;
+                                 const SFVEC2F via_center( via->GetStart().x * m_biuTo3Dunits,
+                                                          -via->GetStart().y * m_biuTo3Dunits );
+
+                                 viaHolesOuter.m_objects.Add(
+                                         new CFILLEDCIRCLE2D( via_center,
+                                                              hole_inner_radius + thickness,
+                                                              *track ) );
+
+                                 m_through_holes_vias_outer.Add(
+                                         new CFILLEDCIRCLE2D( via_center,
+                                                              hole_inner_radius + thickness,
+                                                              *track ) );
+
+                                 viaHolesInner.m_objects.Add(
+                                         new CFILLEDCIRCLE2D( via_center, hole_inner_radius,
+                                                              *track ) );
+                             }
+                         } );
+
+        tasks.push_back( [this, &trackList, first_layer_id, &viaHolesOuter, &viaHolesInner]()
+                         {
+                             for( const TRACK* track : trackList )
+                             {
+                                 if( track->Type() != PCB_VIA_T
+                                         || !track->IsOnLayer( first_layer_id ) )
+                                     continue;
+
+                                 const VIA* via = static_cast<const VIA*>( track );
+
+                                 if( via->GetViaType() != VIATYPE::THROUGH )
+                                     continue;
+
+                                 const int holediameter = via->GetDrillValue();
+                                 const int hole_outer_radius = ( holediameter / 2 )
+                                                               + GetCopperThicknessBIU();
+
+                                 TransformCircleToPolygon( viaHolesOuter.m_poly, via->GetStart(),
+                                                           hole_outer_radius, ARC_HIGH_DEF );
+
+                                 TransformCircleToPolygon( viaHolesInner.m_poly, via->GetStart(),
+                                                           holediameter / 2, ARC_HIGH_DEF );
+
+                                 // Add samething for vias only
+                                 TransformCircleToPolygon( m_through_outer_holes_vias_poly,
+                                                           via->GetStart(), hole_outer_radius,
+                                                           ARC_HIGH_DEF );
+                             }
+                         } );
     }
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T10: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
+    // Add holes of modules (pads can be Circle or Segment holes)
+    // /////////////////////////////////////////////////////////////////////////
+    LAYER_PART padHolesOuter;
+    LAYER_PART padHolesInner;
+
+    tasks.push_back( [this, &padHolesOuter, &padHolesInner]()
+                     {
+                         for( MODULE* module : m_board->Modules() )
+                         {
+                             for( D_PAD* pad : module->Pads() )
+                             {
+                                 if( !pad->GetDrillSize().x )    // Not drilled pad like SMD pad
+                                     continue;
+
+                                 // The hole in the body is inflated by copper thickness,
+                                 // if not plated, no copper
+                                 const int inflate =
+                                         ( pad->GetAttribute() != PAD_ATTRIB_HOLE_NOT_PLATED ) ?
+                                         GetCopperThicknessBIU() : 0;
+
+                                 padHolesOuter.m_objects.Add( createNewPadDrill( pad, inflate ) );
+                                 padHolesInner.m_objects.Add( createNewPadDrill( pad, 0 ) );
+                             }
+                         }
+                     } );
+
+    tasks.push_back( [this, &padHolesOuter, &padHolesInner]()
+                     {
+                         for( MODULE* module : m_board->Modules() )
+                         {
+                             for( D_PAD* pad : module->Pads() )
+                             {
+                                 if( !pad->GetDrillSize().x )    // Not drilled pad like SMD pad
+                                     continue;
+
+                                 // The hole in the body is inflated by copper thickness.
+                                 const int inflate = GetCopperThicknessBIU();
+
+                                 if( pad->GetAttribute() != PAD_ATTRIB_HOLE_NOT_PLATED )
+                                 {
+                                     pad->BuildPadDrillShapePolygon( padHolesOuter.m_poly,
+                                                                     inflate );
+                                     pad->BuildPadDrillShapePolygon( padHolesInner.m_poly, 0 );
+                                 }
+                                 else
+                                 {
+                                     // If not plated, no copper.
+                                     pad->BuildPadDrillShapePolygon(
+                                             m_through_outer_holes_poly_NPTH, inflate );
+                                 }
+                             }
+                         }
+                     } );
 
-    // Add graphic item on copper layers to object containers
+    // Build Tech layers
+    // Based on: https://github.com/KiCad/kicad-source-mirror/blob/master/3d-viewer/3d_draw.cpp#L1059
     // /////////////////////////////////////////////////////////////////////////
-    for( PCB_LAYER_ID curr_layer_id : layer_id )
+    for( PCB_LAYER_ID curr_layer_id : tech_layer_id )
     {
-        wxASSERT( m_layers_container2D.find( curr_layer_id ) != m_layers_container2D.end() );
+        CBVHCONTAINER2D* layerContainer = m_layers_container2D[curr_layer_id];
+        SHAPE_POLY_SET*  layerPoly = m_layers_poly[curr_layer_id];
 
-        CBVHCONTAINER2D *layerContainer = m_layers_container2D[curr_layer_id];
-
-        // ADD GRAPHIC ITEMS ON COPPER LAYERS (texts)
-        for( auto item : m_board->Drawings() )
+        // Add objects
+        tasks.push_back( [this, curr_layer_id, layerContainer]()
         {
-            if( !item->IsOnLayer( curr_layer_id ) )
-                continue;
+            // Add drawing objects
+            addDrawingsToContainer( curr_layer_id, layerContainer, false );
 
-            switch( item->Type() )
+            // Add modules tech layers - objects
+            for( MODULE* module : m_board->Modules() )
             {
-            case PCB_LINE_T:
-            {
-                AddShapeWithClearanceToContainer( (DRAWSEGMENT*)item,
-                                                  layerContainer,
-                                                  curr_layer_id,
-                                                  0 );
-            }
-            break;
+                if( (curr_layer_id == F_SilkS) || (curr_layer_id == B_SilkS) )
+                {
+                    int     linewidth = g_DrawDefaultLineThickness;
 
-            case PCB_TEXT_T:
-                AddShapeWithClearanceToContainer( (TEXTE_PCB*) item,
-                                                  layerContainer,
-                                                  curr_layer_id,
-                                                  0 );
-            break;
+                    for( D_PAD* pad : module->Pads() )
+                    {
+                        if( !pad->IsOnLayer( curr_layer_id ) )
+                            continue;
 
-            case PCB_DIMENSION_T:
-                AddShapeWithClearanceToContainer( (DIMENSION*) item,
-                                                  layerContainer,
-                                                  curr_layer_id,
-                                                  0 );
-            break;
+                        buildPadShapeThickOutlineAsSegments( pad, layerContainer, linewidth );
+                    }
+                }
+                else
+                {
+                    AddPadsShapesWithClearanceToContainer(
+                            module, layerContainer, curr_layer_id, 0, false );
+                }
 
-            default:
-                wxLogTrace( m_logTrace,
-                            wxT( "createLayers: item type: %d not implemented" ),
-                            item->Type() );
-            break;
+                AddGraphicsShapesWithClearanceToContainer( module, layerContainer,
+                                                           curr_layer_id, 0 );
             }
-        }
-    }
-
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T11: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
-
-    // Add graphic item on copper layers to poly contourns
-    // /////////////////////////////////////////////////////////////////////////
-    if( GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS )
-            && ( m_render_engine == RENDER_ENGINE::OPENGL_LEGACY ) )
-    {
-        for( PCB_LAYER_ID cur_layer_id : layer_id )
-        {
-            wxASSERT( m_layers_poly.find( cur_layer_id ) != m_layers_poly.end() );
-
-            SHAPE_POLY_SET *layerPoly = m_layers_poly[cur_layer_id];
 
-            // ADD GRAPHIC ITEMS ON COPPER LAYERS (texts)
-            for( BOARD_ITEM* item : m_board->Drawings() )
+            // Draw non copper zones
+            if( GetFlag( FL_ZONE ) )
             {
-                if( !item->IsOnLayer( cur_layer_id ) )
-                    continue;
-
-                switch( item->Type() )
+                for( ZONE_CONTAINER* zone : m_board->Zones() )
                 {
-                case PCB_LINE_T:
-                    ( (DRAWSEGMENT*) item )->TransformShapeWithClearanceToPolygon( *layerPoly, 0 );
-                    break;
-
-                case PCB_TEXT_T:
-                    ( (TEXTE_PCB*) item )->TransformShapeWithClearanceToPolygonSet( *layerPoly, 0 );
-                    break;
-
-                default:
-                    wxLogTrace( m_logTrace, wxT( "createLayers: item type: %d not implemented" ),
-                                item->Type() );
-                    break;
+                    if( zone->IsOnLayer( curr_layer_id ) )
+                        AddSolidAreasShapesToContainer( zone, layerContainer, curr_layer_id );
                 }
             }
-        }
-    }
-
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T12: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
-
-    if( GetFlag( FL_ZONE ) )
-    {
-        if( aStatusTextReporter )
-            aStatusTextReporter->Report( _( "Create zones" ) );
+        } );
 
-        // Add zones objects
-        // /////////////////////////////////////////////////////////////////////
-        std::atomic<size_t> nextZone( 0 );
-        std::atomic<size_t> threadsFinished( 0 );
-
-        size_t parallelThreadCount = std::max<size_t>( std::thread::hardware_concurrency(), 2 );
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+        // Add contours
+        tasks.push_back( [this, curr_layer_id, layerPoly]()
         {
-            std::thread t = std::thread( [&]()
+            // Add drawing contours
+            addDrawingsToPolygon( curr_layer_id, *layerPoly, false );
+
+            // Add modules tech layers - contours
+            for( MODULE* module : m_board->Modules() )
             {
-                for( size_t areaId = nextZone.fetch_add( 1 );
-                            areaId < static_cast<size_t>( m_board->GetAreaCount() );
-                            areaId = nextZone.fetch_add( 1 ) )
+                if( (curr_layer_id == F_SilkS) || (curr_layer_id == B_SilkS) )
                 {
-                    const ZONE_CONTAINER* zone = m_board->GetArea( areaId );
-
-                    if( zone == nullptr )
-                        break;
+                    const int linewidth = g_DrawDefaultLineThickness;
 
-                    auto layerContainer = m_layers_container2D.find( zone->GetLayer() );
+                    for( D_PAD* pad : module->Pads() )
+                    {
+                        if( !pad->IsOnLayer( curr_layer_id ) )
+                            continue;
 
-                    if( layerContainer != m_layers_container2D.end() )
-                        AddSolidAreasShapesToContainer( zone, layerContainer->second,
-                                                        zone->GetLayer() );
+                        buildPadShapeThickOutlineAsPolygon( pad, *layerPoly, linewidth );
+                    }
+                }
+                else
+                {
+                    transformPadsShapesWithClearanceToPolygon(
+                            module->Pads(), curr_layer_id, *layerPoly, 0, false );
                 }
 
-                threadsFinished++;
-            } );
+                // On tech layers, use a poor circle approximation, only for texts (stroke font)
+                module->TransformGraphicTextWithClearanceToPolygonSet( curr_layer_id,
+                                                                       *layerPoly, 0 );
 
-            t.detach();
-        }
+                // Add the remaining things with dynamic seg count for circles
+                transformGraphicModuleEdgeToPolygonSet( module, curr_layer_id, *layerPoly );
+            }
 
-        while( threadsFinished < parallelThreadCount )
-            std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+            // Draw non copper zones
+            if( GetFlag( FL_ZONE ) )
+            {
+                for( ZONE_CONTAINER* zone : m_board->Zones() )
+                {
+                    if( zone->IsOnLayer( curr_layer_id ) )
+                        zone->TransformSolidAreasShapesToPolygonSet( *layerPoly );
+                }
+            }
 
+            // This will make a union of all added contours
+            layerPoly->Simplify( SHAPE_POLY_SET::PM_FAST );
+        } );
     }
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "fill zones T13: %.3f ms\n", (float)( GetRunningMicroSecs()  - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
-
-    if( GetFlag( FL_ZONE ) && GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS )
-            && ( m_render_engine == RENDER_ENGINE::OPENGL_LEGACY ) )
-    {
-        // ADD COPPER ZONES
-        for( ZONE_CONTAINER* zone : m_board->Zones() )
-        {
-            if( zone == nullptr )
-                break;
-
-            auto layerContainer = m_layers_poly.find( zone->GetLayer() );
-
-            if( layerContainer != m_layers_poly.end() )
-                zone->TransformSolidAreasShapesToPolygonSet( *layerContainer->second );
-        }
-    }
+    runTasks( tasks );
 
 #ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T14: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
+    printf( "T04 (layer items): %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time ) / 1e3 );
     start_Time = GetRunningMicroSecs();
 #endif
 
-    // Simplify layer polygons
+    // Merge the parts
     // /////////////////////////////////////////////////////////////////////////
-
-    if( aStatusTextReporter )
-        aStatusTextReporter->Report( _( "Simplifying copper layers polygons" ) );
-
-    if( GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS )
-            && ( m_render_engine == RENDER_ENGINE::OPENGL_LEGACY ) )
+    for( size_t layerIdx = 0; layerIdx < layer_id.size(); ++layerIdx )
     {
-        std::atomic<size_t> nextItem( 0 );
-        std::atomic<size_t> threadsFinished( 0 );
+        const PCB_LAYER_ID curr_layer_id = layer_id[layerIdx];
 
-        size_t parallelThreadCount = std::min<size_t>(
-                std::max<size_t>( std::thread::hardware_concurrency(), 2 ),
-                layer_id.size() );
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-        {
-            std::thread t = std::thread( [&nextItem, &threadsFinished, &layer_id, this]()
-            {
-                for( size_t i = nextItem.fetch_add( 1 );
-                            i < layer_id.size();
-                            i = nextItem.fetch_add( 1 ) )
-                {
-                    auto layerPoly = m_layers_poly.find( layer_id[i] );
-
-                    if( layerPoly != m_layers_poly.end() )
-                        // This will make a union of all added contours
-                        layerPoly->second->Simplify( SHAPE_POLY_SET::PM_FAST );
-                }
-
-                threadsFinished++;
-            } );
-
-            t.detach();
-        }
-
-        while( threadsFinished < parallelThreadCount )
-            std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
-    }
-
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T15: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
+        wxASSERT( m_layers_container2D.find( curr_layer_id ) != m_layers_container2D.end() );
+        wxASSERT( !copperPolys || m_layers_poly.find( curr_layer_id ) != m_layers_poly.end() );
 
-    // Simplify holes polygon contours
-    // /////////////////////////////////////////////////////////////////////////
-    if( aStatusTextReporter )
-        aStatusTextReporter->Report( _( "Simplify holes contours" ) );
+        CBVHCONTAINER2D* layerContainer = m_layers_container2D[curr_layer_id];
 
-    for( PCB_LAYER_ID layer : layer_id )
-    {
-        if( m_layers_outer_holes_poly.find( layer ) != m_layers_outer_holes_poly.end() )
+        for( LAYER_PART* part : copperParts[layerIdx] )
         {
-            // found
-            SHAPE_POLY_SET *polyLayer = m_layers_outer_holes_poly[layer];
-            polyLayer->Simplify( SHAPE_POLY_SET::PM_FAST );
-
-            wxASSERT( m_layers_inner_holes_poly.find( layer ) != m_layers_inner_holes_poly.end() );
+            layerContainer->Transfer( part->m_objects );
 
-            polyLayer = m_layers_inner_holes_poly[layer];
-            polyLayer->Simplify( SHAPE_POLY_SET::PM_FAST );
+            if( copperPolys )
+                m_layers_poly[curr_layer_id]->Append( part->m_poly );
         }
     }
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T16: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time ) / 1e3 );
-#endif
-    // End Build Copper layers
+    parts.clear();
 
+    m_through_holes_outer.Transfer( viaHolesOuter.m_objects );
+    m_through_holes_outer.Transfer( padHolesOuter.m_objects );
+    m_through_holes_inner.Transfer( viaHolesInner.m_objects );
+    m_through_holes_inner.Transfer( padHolesInner.m_objects );
 
-    // This will make a union of all added contourns
-    m_through_inner_holes_poly.Simplify( SHAPE_POLY_SET::PM_FAST );
-    m_through_outer_holes_poly.Simplify( SHAPE_POLY_SET::PM_FAST );
-    m_through_outer_holes_poly_NPTH.Simplify( SHAPE_POLY_SET::PM_FAST );
-    m_through_outer_holes_vias_poly.Simplify( SHAPE_POLY_SET::PM_FAST );
-    //m_through_inner_holes_vias_poly.Simplify( SHAPE_POLY_SET::PM_FAST ); // Not in use
+    m_through_outer_holes_poly.Append( viaHolesOuter.m_poly );
+    m_through_outer_holes_poly.Append( padHolesOuter.m_poly );
+    m_through_inner_holes_poly.Append( viaHolesInner.m_poly );
+    m_through_inner_holes_poly.Append( padHolesInner.m_poly );
 
 #ifdef PRINT_STATISTICS_3D_VIEWER
-    unsigned stats_endCopperLayersTime = GetRunningMicroSecs();
+    printf( "T05 (merge): %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time ) / 1e3 );
+    start_Time = GetRunningMicroSecs();
 #endif
 
-    // Build Tech layers
-    // Based on: https://github.com/KiCad/kicad-source-mirror/blob/master/3d-viewer/3d_draw.cpp#L1059
+    // Simplify polygons and build BVH for holes and vias
     // /////////////////////////////////////////////////////////////////////////
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    unsigned stats_startTechLayersTime = GetRunningMicroSecs();
-#endif
-
     if( aStatusTextReporter )
-        aStatusTextReporter->Report( _( "Build Tech layers" ) );
-
-    // draw graphic items, on technical layers
-    static const PCB_LAYER_ID teckLayerList[] = {
-            B_Adhes,
-            F_Adhes,
-            B_Paste,
-            F_Paste,
-            B_SilkS,
-            F_SilkS,
-            B_Mask,
-            F_Mask,
-
-            // Aux Layers
-            Dwgs_User,
-            Cmts_User,
-            Eco1_User,
-            Eco2_User,
-            Edge_Cuts,
-            Margin
-        };
+        aStatusTextReporter->Report( _( "Simplifying copper layers polygons" ) );
 
-    // User layers are not drawn here, only technical layers
+    tasks.clear();
 
-    for( LSEQ seq = LSET::AllNonCuMask().Seq( teckLayerList, arrayDim( teckLayerList ) );
-         seq;
-         ++seq )
+    if( copperPolys )
     {
-        const PCB_LAYER_ID curr_layer_id = *seq;
-
-        if( !Is3DLayerEnabled( curr_layer_id ) )
-            continue;
-
-        CBVHCONTAINER2D *layerContainer = new CBVHCONTAINER2D;
-        m_layers_container2D[curr_layer_id] = layerContainer;
-
-        SHAPE_POLY_SET *layerPoly = new SHAPE_POLY_SET;
-        m_layers_poly[curr_layer_id] = layerPoly;
-
-        // Add drawing objects
-        // /////////////////////////////////////////////////////////////////////
-        for( BOARD_ITEM* item : m_board->Drawings() )
+        for( PCB_LAYER_ID curr_layer_id : layer_id )
         {
-            if( !item->IsOnLayer( curr_layer_id ) )
-                continue;
+            SHAPE_POLY_SET* layerPoly = m_layers_poly[curr_layer_id];
 
-            switch( item->Type() )
-            {
-            case PCB_LINE_T:
-                AddShapeWithClearanceToContainer( (DRAWSEGMENT*)item,
-                                                  layerContainer,
-                                                  curr_layer_id,
-                                                  0 );
-                break;
-
-            case PCB_TEXT_T:
-                AddShapeWithClearanceToContainer( (TEXTE_PCB*) item,
-                                                  layerContainer,
-                                                  curr_layer_id,
-                                                  0 );
-                break;
-
-            case PCB_DIMENSION_T:
-                AddShapeWithClearanceToContainer( (DIMENSION*) item,
-                                                  layerContainer,
-                                                  curr_layer_id,
-                                                  0 );
-                break;
-
-            default:
-                break;
-            }
+            // This will make a union of all added contours
+            tasks.push_back( [layerPoly]()
+                             {
+                                 layerPoly->BatchedUnion( SHAPE_POLY_SET::PM_FAST );
+                             } );
         }
+    }
 
+    std::vector<SHAPE_POLY_SET*> holesPolys = { &m_through_inner_holes_poly,
+                                                &m_through_outer_holes_poly,
+                                                &m_through_outer_holes_poly_NPTH,
+                                                &m_through_outer_holes_vias_poly };
 
-        // Add drawing contours
-        // /////////////////////////////////////////////////////////////////////
-        for( BOARD_ITEM* item : m_board->Drawings() )
-        {
-            if( !item->IsOnLayer( curr_layer_id ) )
-                continue;
+    for( std::pair<const PCB_LAYER_ID, SHAPE_POLY_SET*>& poly : m_layers_outer_holes_poly )
+        holesPolys.push_back( poly.second );
 
-            switch( item->Type() )
-            {
-            case PCB_LINE_T:
-                ( (DRAWSEGMENT*) item )->TransformShapeWithClearanceToPolygon( *layerPoly, 0 );
-                break;
+    for( std::pair<const PCB_LAYER_ID, SHAPE_POLY_SET*>& poly : m_layers_inner_holes_poly )
+        holesPolys.push_back( poly.second );
 
-            case PCB_TEXT_T:
-                ( (TEXTE_PCB*) item )->TransformShapeWithClearanceToPolygonSet( *layerPoly, 0 );
-                break;
+    for( SHAPE_POLY_SET* poly : holesPolys )
+        tasks.push_back( [poly]() { poly->BatchedUnion( SHAPE_POLY_SET::PM_FAST ); } );
 
-            default:
-                break;
-            }
-        }
+    //m_through_inner_holes_vias_poly.Simplify( SHAPE_POLY_SET::PM_FAST ); // Not in use
 
+    std::vector<CBVHCONTAINER2D*> bvhContainers = { &m_through_holes_inner,
+                                                    &m_through_holes_outer };
 
-        // Add modules tech layers - objects
-        // /////////////////////////////////////////////////////////////////////
-        for( MODULE* module : m_board->Modules() )
-        {
-            if( (curr_layer_id == F_SilkS) || (curr_layer_id == B_SilkS) )
-            {
-                int     linewidth = g_DrawDefaultLineThickness;
+    for( std::pair<const PCB_LAYER_ID, CBVHCONTAINER2D*>& hole : m_layers_holes2D )
+        bvhContainers.push_back( hole.second );
 
-                for( D_PAD* pad : module->Pads() )
-                {
-                    if( !pad->IsOnLayer( curr_layer_id ) )
-                        continue;
-
-                    buildPadShapeThickOutlineAsSegments( pad, layerContainer, linewidth );
-                }
-            }
-            else
-            {
-                AddPadsShapesWithClearanceToContainer(
-                        module, layerContainer, curr_layer_id, 0, false );
-            }
-
-            AddGraphicsShapesWithClearanceToContainer( module, layerContainer, curr_layer_id, 0 );
-        }
+    // We only need the Solder mask to initialize the BVH
+    // because..?
+    if( m_layers_container2D[B_Mask] )
+        bvhContainers.push_back( m_layers_container2D[B_Mask] );
 
+    if( m_layers_container2D[F_Mask] )
+        bvhContainers.push_back( m_layers_container2D[F_Mask] );
 
-        // Add modules tech layers - contours
-        // /////////////////////////////////////////////////////////////////////
-        for( MODULE* module : m_board->Modules() )
-        {
-            if( (curr_layer_id == F_SilkS) || (curr_layer_id == B_SilkS) )
-            {
-                const int linewidth = g_DrawDefaultLineThickness;
+    for( CBVHCONTAINER2D* container : bvhContainers )
+        tasks.push_back( [container]() { container->BuildBVH(); } );
 
-                for( D_PAD* pad : module->Pads() )
-                {
-                    if( !pad->IsOnLayer( curr_layer_id ) )
-                        continue;
+    runTasks( tasks );
 
-                    buildPadShapeThickOutlineAsPolygon( pad, *layerPoly, linewidth );
-                }
-            }
-            else
-            {
-                transformPadsShapesWithClearanceToPolygon(
-                        module->Pads(), curr_layer_id, *layerPoly, 0, false );
-            }
+#ifdef PRINT_STATISTICS_3D_VIEWER
+    unsigned stats_endTime = GetRunningMicroSecs();
 
-            // On tech layers, use a poor circle approximation, only for texts (stroke font)
-            module->TransformGraphicTextWithClearanceToPolygonSet( curr_layer_id, *layerPoly, 0 );
+    printf( "T06 (simplify and BVH): %.3f ms\n", (float)( stats_endTime - start_Time ) / 1e3 );
+    printf( "BOARD_ADAPTER::createLayers times\n" );
+    printf( "  All layers:             %.3f ms\n",
+            (float)( stats_endTime - stats_startCopperLayersTime ) / 1e3 );
+    printf( "Statistics:\n" );
+    printf( "  m_stats_nr_tracks                   %u\n", m_stats_nr_tracks );
+    printf( "  m_stats_nr_vias                     %u\n", m_stats_nr_vias );
+    printf( "  m_stats_nr_holes                    %u\n", m_stats_nr_holes );
+    printf( "  m_stats_via_med_hole_diameter (3DU) %f\n", m_stats_via_med_hole_diameter );
+    printf( "  m_stats_hole_med_diameter     (3DU) %f\n", m_stats_hole_med_diameter );
+    printf( "  m_calc_seg_min_factor3DU      (3DU) %f\n", m_calc_seg_min_factor3DU );
+    printf( "  m_calc_seg_max_factor3DU      (3DU) %f\n", m_calc_seg_max_factor3DU );
+#endif
+}
 
-            // Add the remaining things with dynamic seg count for circles
-            transformGraphicModuleEdgeToPolygonSet( module, curr_layer_id, *layerPoly );
-        }
 
+void BOARD_ADAPTER::addDrawingsToContainer( PCB_LAYER_ID aLayerId,
+                                            CGENERICCONTAINER2D* aDstContainer,
+                                            bool aTraceUnknown )
+{
+    for( BOARD_ITEM* item : m_board->Drawings() )
+    {
+        if( !item->IsOnLayer( aLayerId ) )
+            continue;
 
-        // Draw non copper zones
-        // /////////////////////////////////////////////////////////////////////
-        if( GetFlag( FL_ZONE ) )
+        switch( item->Type() )
         {
-            for( int ii = 0; ii < m_board->GetAreaCount(); ++ii )
-            {
-                ZONE_CONTAINER* zone = m_board->GetArea( ii );
-
-                if( !zone->IsOnLayer( curr_layer_id ) )
-                    continue;
-
-                AddSolidAreasShapesToContainer( zone, layerContainer, curr_layer_id );
-            }
+        case PCB_LINE_T:
+            AddShapeWithClearanceToContainer( (DRAWSEGMENT*) item, aDstContainer, aLayerId, 0 );
+            break;
 
-            for( int ii = 0; ii < m_board->GetAreaCount(); ++ii )
-            {
-                ZONE_CONTAINER* zone = m_board->GetArea( ii );
+        case PCB_TEXT_T:
+            AddShapeWithClearanceToContainer( (TEXTE_PCB*) item, aDstContainer, aLayerId, 0 );
+            break;
 
-                if( !zone->IsOnLayer( curr_layer_id ) )
-                    continue;
+        case PCB_DIMENSION_T:
+            AddShapeWithClearanceToContainer( (DIMENSION*) item, aDstContainer, aLayerId, 0 );
+            break;
 
-                zone->TransformSolidAreasShapesToPolygonSet( *layerPoly );
-            }
+        default:
+            if( aTraceUnknown )
+                wxLogTrace( m_logTrace, wxT( "createLayers: item type: %d not implemented" ),
+                            item->Type() );
+            break;
         }
-
-        // This will make a union of all added contours
-        layerPoly->Simplify( SHAPE_POLY_SET::PM_FAST );
     }
-    // End Build Tech layers
-
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    unsigned stats_endTechLayersTime = GetRunningMicroSecs();
-#endif
-
-
-    // Build BVH for holes and vias
-    // /////////////////////////////////////////////////////////////////////////
-
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    unsigned stats_startHolesBVHTime = GetRunningMicroSecs();
-#endif
-    if( aStatusTextReporter )
-        aStatusTextReporter->Report( _( "Build BVH for holes and vias" ) );
+}
 
-    m_through_holes_inner.BuildBVH();
-    m_through_holes_outer.BuildBVH();
 
-    if( !m_layers_holes2D.empty() )
+void BOARD_ADAPTER::addDrawingsToPolygon( PCB_LAYER_ID aLayerId, SHAPE_POLY_SET& aCornerBuffer,
+                                          bool aTraceUnknown )
+{
+    for( BOARD_ITEM* item : m_board->Drawings() )
     {
-        for( auto& hole : m_layers_holes2D)
-            hole.second->BuildBVH();
-    }
-
-    // We only need the Solder mask to initialize the BVH
-    // because..?
-    if( m_layers_container2D[B_Mask] )
-        m_layers_container2D[B_Mask]->BuildBVH();
+        if( !item->IsOnLayer( aLayerId ) )
+            continue;
 
-    if( m_layers_container2D[F_Mask] )
-        m_layers_container2D[F_Mask]->BuildBVH();
+        switch( item->Type() )
+        {
+        case PCB_LINE_T:
+            ( (DRAWSEGMENT*) item )->TransformShapeWithClearanceToPolygon( aCornerBuffer, 0 );
+            break;
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    unsigned stats_endHolesBVHTime = GetRunningMicroSecs();
+        case PCB_TEXT_T:
+            ( (TEXTE_PCB*) item )->TransformShapeWithClearanceToPolygonSet( aCornerBuffer, 0 );
+            break;
 
-    printf( "BOARD_ADAPTER::createLayers times\n" );
-    printf( "  Copper Layers:          %.3f ms\n",
-            (float)( stats_endCopperLayersTime  - stats_startCopperLayersTime  ) / 1e3 );
-    printf( "  Holes BVH creation:     %.3f ms\n",
-            (float)( stats_endHolesBVHTime      - stats_startHolesBVHTime      ) / 1e3 );
-    printf( "  Tech Layers:            %.3f ms\n",
-            (float)( stats_endTechLayersTime    - stats_startTechLayersTime    ) / 1e3 );
-    printf( "Statistics:\n" );
-    printf( "  m_stats_nr_tracks                   %u\n", m_stats_nr_tracks );
-    printf( "  m_stats_nr_vias                     %u\n", m_stats_nr_vias );
-    printf( "  m_stats_nr_holes                    %u\n", m_stats_nr_holes );
-    printf( "  m_stats_via_med_hole_diameter (3DU) %f\n", m_stats_via_med_hole_diameter );
-    printf( "  m_stats_hole_med_diameter     (3DU) %f\n", m_stats_hole_med_diameter );
-    printf( "  m_calc_seg_min_factor3DU      (3DU) %f\n", m_calc_seg_min_factor3DU );
-    printf( "  m_calc_seg_max_factor3DU      (3DU) %f\n", m_calc_seg_max_factor3DU );
-#endif
+        default:
+            if( aTraceUnknown )
+                wxLogTrace( m_logTrace, wxT( "createLayers: item type: %d not implemented" ),
+                            item->Type() );
+            break;
+        }
+    }
 }
@@ -59,6 +59,20 @@ public:
         }
     }
 
+    /**
+     * @brief Transfer - Move all the objects of another container to the end of this one
+     * @param aOther - the container to empty
+     */
+    void Transfer( CGENERICCONTAINER2D &aOther )
+    {
+        std::lock_guard<std::mutex> lock( m_lock );
+        std::lock_guard<std::mutex> otherLock( aOther.m_lock );
+
+        m_objects.splice( m_objects.end(), aOther.m_objects );
+        m_bbox.Union( aOther.m_bbox );
+        aOther.m_bbox.Reset();
+    }
+
     void Clear();
 
     const LIST_OBJECT2D &GetList() const { return m_objects; }
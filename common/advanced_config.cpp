@@ -52,6 +52,36 @@ namespace AC_STACK
     static constexpr int max_stack = 4096 * 4096;
 }
 
+/**
+ * Limits and default number of trace spans kept per thread.
+ */
+namespace AC_TRACE
+{
+    static constexpr int min_spans = 1024;
+    static constexpr int default_spans = 65536;
+    static constexpr int max_spans = 16 * 1024 * 1024;
+}
+
+/**
+ * Limits and default of the undo memory budget, in MB.  0 disables the budget.
+ */
+namespace AC_UNDO
+{
+    static constexpr int min_memory = 0;
+    static constexpr int default_memory = 2048;
+    static constexpr int max_memory = 1024 * 1024;
+}
+
+/**
+ * Limits and default of the footprint library polling interval, in ms.
+ */
+namespace AC_FP_LIB
+{
+    static constexpr int min_poll = 0;
+    static constexpr int default_poll = 1000;
+    static constexpr int max_poll = 3600 * 1000;
+}
+
 /**
  * List of known keys for advanced configuration options.
  *
@@ -80,6 +110,31 @@ static const wxChar RealtimeConnectivity[] = wxT( "RealtimeConnectivity" );
  */
 static const wxChar CoroutineStackSize[] = wxT( "CoroutineStackSize" );
 
+/**
+ * Record timing spans (see TRACE_SPAN) and append them to this file on exit, in the
+ * Chrome trace event format.  Open the file with chrome://tracing or ui.perfetto.dev.
+ */
+static const wxChar TraceSpanFile[] = wxT( "TraceSpanFile" );
+
+/**
+ * Number of timing spans kept per thread; older spans are overwritten.
+ */
+static const wxChar TraceSpanBufferSize[] = wxT( "TraceSpanBufferSize" );
+
+/**
+ * Approximate memory, in MB, that the undo list of the board editor may use before its
+ * oldest levels are discarded.  0 means no limit besides the number of undo levels.
+ */
+static const wxChar UndoMemoryLimit[] = wxT( "UndoMemoryLimit" );
+
+/**
+ * Minimum time, in ms, between two checks of the file timestamps of a footprint library.
+ * Changes made on this computer are usually seen immediately through file system
+ * notifications; the timestamps catch the others (e.g. from other hosts on a network share).
+ * 0 checks the timestamps each time a library is accessed.
+ */
+static const wxChar FootprintLibraryPollInterval[] = wxT( "FootprintLibraryPollInterval" );
+
 } // namespace KEYS
 
 
@@ -160,6 +215,9 @@ ADVANCED_CFG::ADVANCED_CFG()
     m_EnableUsePadProperty = false;
     m_realTimeConnectivity = true;
     m_coroutineStackSize = AC_STACK::default_stack;
+    m_traceSpanBufferSize = AC_TRACE::default_spans;
+    m_undoMemoryLimit = AC_UNDO::default_memory;
+    m_fpLibPollInterval = AC_FP_LIB::default_poll;
 
     loadFromConfigFile();
 }
@@ -203,6 +261,21 @@ void ADVANCED_CFG::loadSettings( wxConfigBase& aCfg )
                                                &m_coroutineStackSize, AC_STACK::default_stack,
                                                AC_STACK::min_stack, AC_STACK::max_stack ) );
 
+    configParams.push_back( new PARAM_CFG_WXSTRING( true, AC_KEYS::TraceSpanFile,
+                                                    &m_traceSpanFile ) );
+
+    configParams.push_back( new PARAM_CFG_INT( true, AC_KEYS::TraceSpanBufferSize,
+                                               &m_traceSpanBufferSize, AC_TRACE::default_spans,
+                                               AC_TRACE::min_spans, AC_TRACE::max_spans ) );
+
+    configParams.push_back( new PARAM_CFG_INT( true, AC_KEYS::UndoMemoryLimit,
+                                               &m_undoMemoryLimit, AC_UNDO::default_memory,
+                                               AC_UNDO::min_memory, AC_UNDO::max_memory ) );
+
+    configParams.push_back( new PARAM_CFG_INT( true, AC_KEYS::FootprintLibraryPollInterval,
+                                               &m_fpLibPollInterval, AC_FP_LIB::default_poll,
+                                               AC_FP_LIB::min_poll, AC_FP_LIB::max_poll ) );
+
     wxConfigLoadSetups( &aCfg, configParams );
 
     for( auto param : configParams )
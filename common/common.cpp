@@ -35,6 +35,11 @@
 #include <wx/utils.h>
 #include <wx/stdpaths.h>
 #include <wx/url.h>
+#include <wx/thread.h>
+#include <clocale>
+#if defined( __APPLE__ )
+#include <xlocale.h>
+#endif
 #include <boost/uuid/uuid_generators.hpp>
 #include <boost/uuid/uuid_io.hpp>
 #include <boost/functional/hash.hpp>
@@ -216,8 +221,54 @@ void KiAssertFilter( const wxString &file, int line,
 #endif
 
 std::atomic<unsigned int> LOCALE_IO::m_c_count( 0 );
-LOCALE_IO::LOCALE_IO() : m_wxLocale( nullptr )
+
+
+namespace
 {
+
+/// Nesting count of the LOCALE_IO instances of the calling worker thread
+thread_local unsigned int t_threadCount = 0;
+
+#if defined( _WIN32 )
+thread_local int         t_prevThreadConfig = 0;
+thread_local std::string t_prevThreadLocale;
+#else
+thread_local locale_t    t_cLocale = (locale_t) 0;
+thread_local locale_t    t_prevThreadLocale = (locale_t) 0;
+#endif
+
+} // namespace
+
+
+LOCALE_IO::LOCALE_IO() :
+        m_wxLocale( nullptr ),
+        m_perThread( !wxThread::IsMain() )
+{
+    if( m_perThread )
+    {
+        // Worker threads (e.g. background saves) only switch their own locale: changing
+        // the global one would race with the GUI thread and with other workers.
+        if( t_threadCount++ == 0 )
+        {
+#if defined( _WIN32 )
+            t_prevThreadConfig = _configthreadlocale( _ENABLE_PER_THREAD_LOCALE );
+            t_prevThreadLocale = setlocale( LC_NUMERIC, nullptr );
+            setlocale( LC_NUMERIC, "C" );
+#else
+            locale_t base = duplocale( LC_GLOBAL_LOCALE );
+
+            t_cLocale = newlocale( LC_NUMERIC_MASK, "C", base );
+
+            if( t_cLocale )
+                t_prevThreadLocale = uselocale( t_cLocale );
+            else if( base )
+                freelocale( base );
+#endif
+        }
+
+        return;
+    }
+
     // use thread safe, atomic operation
     if( m_c_count++ == 0 )
     {
@@ -239,6 +290,26 @@ LOCALE_IO::LOCALE_IO() : m_wxLocale( nullptr )
 
 LOCALE_IO::~LOCALE_IO()
 {
+    if( m_perThread )
+    {
+        if( --t_threadCount == 0 )
+        {
+#if defined( _WIN32 )
+            setlocale( LC_NUMERIC, t_prevThreadLocale.c_str() );
+            _configthreadlocale( t_prevThreadConfig );
+#else
+            if( t_cLocale )
+            {
+                uselocale( t_prevThreadLocale );
+                freelocale( t_cLocale );
+                t_cLocale = (locale_t) 0;
+            }
+#endif
+        }
+
+        return;
+    }
+
     // use thread safe, atomic operation
     if( --m_c_count == 0 )
     {
@@ -41,6 +41,7 @@
 
 #include <tool/tool_dispatcher.h>
 #include <tool/tool_manager.h>
+#include <trace_span.h>
 
 #ifdef PROFILE
 #include <profile.h>
@@ -174,6 +175,9 @@ void EDA_DRAW_PANEL_GAL::onPaint( wxPaintEvent& WXUNUSED( aEvent ) )
     if( m_drawing )
         return;
 
+    TRACE_SPAN span( "EDA_DRAW_PANEL_GAL::onPaint", "view" );
+    auto       paintStart = std::chrono::steady_clock::now();
+
 #ifdef PROFILE
     PROF_COUNTER totalRealTime;
 #endif /* PROFILE */
@@ -234,6 +238,24 @@ void EDA_DRAW_PANEL_GAL::onPaint( wxPaintEvent& WXUNUSED( aEvent ) )
 
     m_lastRefresh = wxGetLocalTimeMillis();
     m_drawing = false;
+
+    using MSECS = std::chrono::duration<double, std::milli>;
+    auto paintEnd = std::chrono::steady_clock::now();
+
+    m_redrawStats.m_frames++;
+    m_redrawStats.m_lastPaint = MSECS( paintEnd - paintStart ).count();
+    m_redrawStats.m_maxPaint = std::max( m_redrawStats.m_maxPaint, m_redrawStats.m_lastPaint );
+
+    // Paints requested by the system rather than by Refresh() have no latency, and
+    // requests made while painting are served by the next frame
+    if( m_refreshRequested != std::chrono::steady_clock::time_point()
+            && m_refreshRequested <= paintStart )
+    {
+        m_redrawStats.m_lastLatency = MSECS( paintEnd - m_refreshRequested ).count();
+        m_redrawStats.m_maxLatency = std::max( m_redrawStats.m_maxLatency,
+                                               m_redrawStats.m_lastLatency );
+        m_refreshRequested = std::chrono::steady_clock::time_point();
+    }
 }
 
 
@@ -259,6 +281,7 @@ void EDA_DRAW_PANEL_GAL::Refresh( bool aEraseBackground, const wxRect* aRect )
         return;
 
     m_pendingRefresh = true;
+    m_refreshRequested = std::chrono::steady_clock::now();
 
 #ifdef __WXMAC__
     // Timers on OS X may have a high latency (seen up to 500ms and more) which
@@ -269,14 +292,21 @@ void EDA_DRAW_PANEL_GAL::Refresh( bool aEraseBackground, const wxRect* aRect )
     wxLongLong t = wxGetLocalTimeMillis();
     wxLongLong delta = t - m_lastRefresh;
 
-    if( delta >= MinRefreshPeriod )
+    // Frame budget: after a slow frame, leave the event loop at least as much time as the
+    // frame took to draw, so tools are not starved by back-to-back repaints
+    long period = MinRefreshPeriod;
+
+    if( m_redrawStats.m_lastPaint > period )
+        period = static_cast<long>( m_redrawStats.m_lastPaint );
+
+    if( delta >= period )
     {
         ForceRefresh();
     }
     else
     {
         // One shot timer
-        m_refreshTimer.Start( ( MinRefreshPeriod - delta ).ToLong(), true );
+        m_refreshTimer.Start( ( period - delta ).ToLong(), true );
     }
 #endif
 }
@@ -36,7 +36,11 @@
 #include <math/util.h>      // for KiROUND
 #include <bitmap_base.h>
 
+#include <algorithm>
+#include <atomic>
+#include <future>
 #include <limits>
+#include <thread>
 
 #include <pixman.h>
 
@@ -64,6 +68,10 @@ CAIRO_GAL_BASE::CAIRO_GAL_BASE( GAL_DISPLAY_OPTIONS& aDisplayOptions ) :
     context             = nullptr;
     surface             = nullptr;
 
+    // Tiled rendering is enabled only by the GALs drawing to image surfaces
+    tiledRendering      = false;
+    tileContext         = nullptr;
+
     // Grid color settings are different in Cairo and OpenGL
     SetGridColor( COLOR4D( 0.1, 0.1, 0.1, 0.8 ) );
     SetAxesColor( COLOR4D( BLUE ) );
@@ -76,6 +84,9 @@ CAIRO_GAL_BASE::CAIRO_GAL_BASE( GAL_DISPLAY_OPTIONS& aDisplayOptions ) :
 
 CAIRO_GAL_BASE::~CAIRO_GAL_BASE()
 {
+    for( TILE_OP& op : tileOps )
+        cairo_path_destroy( op.path );
+
     ClearCache();
 
     if( surface )
@@ -99,6 +110,7 @@ void CAIRO_GAL_BASE::endDrawing()
 {
     // Force remaining objects to be drawn
     Flush();
+    flushTiles();
 }
 
 void CAIRO_GAL_BASE::updateWorldScreenMatrix()
@@ -243,7 +255,7 @@ void CAIRO_GAL_BASE::DrawSegment( const VECTOR2D& aStartPoint, const VECTOR2D& a
         cairo_move_to( currentContext, p0.x, p0.y );
         cairo_line_to( currentContext, p1.x, p1.y );
         cairo_set_source_rgba( currentContext, fillColor.r, fillColor.g, fillColor.b, fillColor.a );
-        cairo_stroke( currentContext );
+        renderPath( false, false );
     }
     else
     {
@@ -455,6 +467,9 @@ void CAIRO_GAL_BASE::DrawCurve( const VECTOR2D& aStartPoint, const VECTOR2D& aCo
 
 void CAIRO_GAL_BASE::DrawBitmap( const BITMAP_BASE& aBitmap )
 {
+    // Bitmaps are painted directly, so everything recorded before has to be rendered first
+    flushTiles();
+
     cairo_save( currentContext );
 
     // We have to calculate the pixel size in users units to draw the image.
@@ -537,7 +552,7 @@ void CAIRO_GAL_BASE::ClearScreen()
 {
     cairo_set_source_rgb( currentContext, m_clearColor.r, m_clearColor.g, m_clearColor.b );
     cairo_rectangle( currentContext, 0.0, 0.0, screenSize.x, screenSize.y );
-    cairo_fill( currentContext );
+    renderPath( true, false );
 }
 
 
@@ -817,13 +832,13 @@ void CAIRO_GAL_BASE::DrawGroup( int aGroupNumber )
         case CMD_STROKE_PATH:
             cairo_set_source_rgba( currentContext, strokeColor.r, strokeColor.g, strokeColor.b, strokeColor.a );
             cairo_append_path( currentContext, it->cairoPath );
-            cairo_stroke( currentContext );
+            renderPath( false, false );
             break;
 
         case CMD_FILL_PATH:
             cairo_set_source_rgba( currentContext, fillColor.r, fillColor.g, fillColor.b, strokeColor.a );
             cairo_append_path( currentContext, it->cairoPath );
-            cairo_fill( currentContext );
+            renderPath( true, false );
             break;
 
             /*
@@ -977,7 +992,7 @@ void CAIRO_GAL_BASE::drawAxes( const VECTOR2D& aStartPoint, const VECTOR2D& aEnd
     cairo_line_to( currentContext, p1.x, org.y );
     cairo_move_to( currentContext, org.x, p0.y );
     cairo_line_to( currentContext, org.x, p1.y );
-    cairo_stroke( currentContext );
+    renderPath( false, false );
 }
 
 
@@ -990,7 +1005,7 @@ void CAIRO_GAL_BASE::drawGridLine( const VECTOR2D& aStartPoint, const VECTOR2D&
     cairo_set_source_rgba( currentContext, gridColor.r, gridColor.g, gridColor.b, gridColor.a );
     cairo_move_to( currentContext, p0.x, p0.y );
     cairo_line_to( currentContext, p1.x, p1.y );
-    cairo_stroke( currentContext );
+    renderPath( false, false );
 }
 
 
@@ -1010,7 +1025,7 @@ void CAIRO_GAL_BASE::drawGridCross( const VECTOR2D& aPoint )
     cairo_line_to( currentContext, p1.x, p1.y );
     cairo_move_to( currentContext, p2.x, p2.y );
     cairo_line_to( currentContext, p3.x, p3.y );
-    cairo_stroke( currentContext );
+    renderPath( false, false );
 }
 
 
@@ -1024,7 +1039,7 @@ void CAIRO_GAL_BASE::drawGridPoint( const VECTOR2D& aPoint, double aSize )
     cairo_arc( currentContext, p.x, p.y, s, 0.0, 2.0 * M_PI );
     cairo_close_path( currentContext );
 
-    cairo_fill( currentContext );
+    renderPath( true, false );
 }
 
 void CAIRO_GAL_BASE::flushPath()
@@ -1034,17 +1049,14 @@ void CAIRO_GAL_BASE::flushPath()
        cairo_set_source_rgba( currentContext,
                fillColor.r, fillColor.g, fillColor.b, fillColor.a );
 
-       if( isStrokeEnabled )
-           cairo_fill_preserve( currentContext );
-       else
-           cairo_fill( currentContext );
+       renderPath( true, isStrokeEnabled );
    }
 
    if( isStrokeEnabled )
    {
        cairo_set_source_rgba( currentContext,
                strokeColor.r, strokeColor.g, strokeColor.b, strokeColor.a );
-       cairo_stroke( currentContext );
+       renderPath( false, false );
    }
 }
 
@@ -1060,14 +1072,14 @@ void CAIRO_GAL_BASE::storePath()
             if( isFillEnabled )
             {
                 cairo_set_source_rgba( currentContext, fillColor.r, fillColor.g, fillColor.b, fillColor.a );
-                cairo_fill_preserve( currentContext );
+                renderPath( true, true );
             }
 
             if( isStrokeEnabled )
             {
                 cairo_set_source_rgba( currentContext, strokeColor.r, strokeColor.g,
                                       strokeColor.b, strokeColor.a );
-                cairo_stroke_preserve( currentContext );
+                renderPath( false, true );
             }
         }
         else
@@ -1097,6 +1109,211 @@ void CAIRO_GAL_BASE::storePath()
 }
 
 
+void CAIRO_GAL_BASE::renderPath( bool aFill, bool aPreserve )
+{
+    double r, g, b, a;
+
+    // Only solid colors are recorded, anything else is rendered right away
+    if( !tiledRendering
+            || cairo_pattern_get_rgba( cairo_get_source( currentContext ), &r, &g, &b, &a )
+                    != CAIRO_STATUS_SUCCESS )
+    {
+        flushTiles();
+
+        if( aFill && aPreserve )
+            cairo_fill_preserve( currentContext );
+        else if( aFill )
+            cairo_fill( currentContext );
+        else if( aPreserve )
+            cairo_stroke_preserve( currentContext );
+        else
+            cairo_stroke( currentContext );
+
+        return;
+    }
+
+    // Operations recorded for another buffer have to be rendered before switching
+    if( currentContext != tileContext )
+    {
+        flushTiles();
+        tileContext = currentContext;
+    }
+
+    TILE_OP op;
+    op.path = cairo_copy_path( currentContext );
+    op.fill = aFill;
+    op.color[0] = r;
+    op.color[1] = g;
+    op.color[2] = b;
+    op.color[3] = a;
+    op.lineWidth = cairo_get_line_width( currentContext );
+    op.lineCap = cairo_get_line_cap( currentContext );
+    op.lineJoin = cairo_get_line_join( currentContext );
+    op.op = cairo_get_operator( currentContext );
+    cairo_get_matrix( currentContext, &op.matrix );
+
+    // Device space extents, grown by the half line width for strokes (miter joins may
+    // reach further) and by one pixel for antialiasing
+    double x0, y0, x1, y1;
+    cairo_path_extents( currentContext, &x0, &y0, &x1, &y1 );
+
+    if( !aFill )
+    {
+        double margin = op.lineWidth / 2.0;
+
+        if( op.lineJoin == CAIRO_LINE_JOIN_MITER || op.lineCap == CAIRO_LINE_CAP_SQUARE )
+            margin *= std::max( M_SQRT2, cairo_get_miter_limit( currentContext ) );
+
+        x0 -= margin;
+        y0 -= margin;
+        x1 += margin;
+        y1 += margin;
+    }
+
+    double xs[4] = { x0, x1, x1, x0 };
+    double ys[4] = { y0, y0, y1, y1 };
+
+    op.x0 = op.y0 = std::numeric_limits<double>::max();
+    op.x1 = op.y1 = std::numeric_limits<double>::lowest();
+
+    for( int i = 0; i < 4; i++ )
+    {
+        cairo_user_to_device( currentContext, &xs[i], &ys[i] );
+        op.x0 = std::min( op.x0, xs[i] - 1.0 );
+        op.y0 = std::min( op.y0, ys[i] - 1.0 );
+        op.x1 = std::max( op.x1, xs[i] + 1.0 );
+        op.y1 = std::max( op.y1, ys[i] + 1.0 );
+    }
+
+    tileOps.push_back( op );
+
+    if( !aPreserve )
+        cairo_new_path( currentContext );
+}
+
+
+void CAIRO_GAL_BASE::flushTiles()
+{
+    if( tileOps.empty() )
+        return;
+
+    cairo_surface_t*  target = cairo_get_target( tileContext );
+    cairo_antialias_t antialias = cairo_get_antialias( tileContext );
+
+    // Renders the operations touching a region of the target, offset by ( aX, aY )
+    auto renderOps = [&]( cairo_t* aCtx, int aX, int aY, int aWidth, int aHeight )
+    {
+        cairo_set_antialias( aCtx, antialias );
+
+        for( const TILE_OP& op : tileOps )
+        {
+            if( op.x1 < aX || op.y1 < aY || op.x0 > aX + aWidth || op.y0 > aY + aHeight )
+                continue;
+
+            cairo_matrix_t matrix = op.matrix;
+            matrix.x0 -= aX;
+            matrix.y0 -= aY;
+
+            cairo_set_matrix( aCtx, &matrix );
+            cairo_set_operator( aCtx, op.op );
+            cairo_set_source_rgba( aCtx, op.color[0], op.color[1], op.color[2], op.color[3] );
+            cairo_new_path( aCtx );
+            cairo_append_path( aCtx, op.path );
+
+            if( op.fill )
+            {
+                cairo_fill( aCtx );
+            }
+            else
+            {
+                cairo_set_line_width( aCtx, op.lineWidth );
+                cairo_set_line_cap( aCtx, op.lineCap );
+                cairo_set_line_join( aCtx, op.lineJoin );
+                cairo_stroke( aCtx );
+            }
+        }
+    };
+
+    if( cairo_surface_get_type( target ) != CAIRO_SURFACE_TYPE_IMAGE
+            || cairo_image_surface_get_format( target ) != GAL_FORMAT )
+    {
+        cairo_t* ctx = cairo_create( target );
+        renderOps( ctx, 0, 0, std::numeric_limits<int>::max() / 2,
+                   std::numeric_limits<int>::max() / 2 );
+        cairo_destroy( ctx );
+    }
+    else
+    {
+        cairo_surface_flush( target );
+
+        unsigned char* data = cairo_image_surface_get_data( target );
+        int            stride = cairo_image_surface_get_stride( target );
+        int            width = cairo_image_surface_get_width( target );
+        int            height = cairo_image_surface_get_height( target );
+        int            cols = ( width + TILE_SIZE - 1 ) / TILE_SIZE;
+        int            rows = ( height + TILE_SIZE - 1 ) / TILE_SIZE;
+        size_t         tileCount = (size_t) cols * rows;
+
+        // Each tile is an image surface over its own part of the target buffer, so the
+        // workers never write to the same pixels and no compositing pass is needed
+        std::atomic<size_t> nextTile( 0 );
+        size_t parallelThreadCount = 1;
+
+        if( tileOps.size() >= PARALLEL_MIN_OPS )
+            parallelThreadCount = std::min<size_t>( std::thread::hardware_concurrency(),
+                                                    tileCount );
+
+        auto tile_lambda = [&]() -> size_t
+        {
+            size_t num = 0;
+
+            for( size_t i = nextTile++; i < tileCount; i = nextTile++ )
+            {
+                int x = ( i % cols ) * TILE_SIZE;
+                int y = ( i / cols ) * TILE_SIZE;
+                int w = std::min( x + TILE_SIZE, width ) - x;
+                int h = std::min( y + TILE_SIZE, height ) - y;
+
+                cairo_surface_t* tile = cairo_image_surface_create_for_data(
+                        data + (size_t) y * stride + x * 4, GAL_FORMAT, w, h, stride );
+                cairo_t* ctx = cairo_create( tile );
+
+                renderOps( ctx, x, y, w, h );
+
+                cairo_destroy( ctx );
+                cairo_surface_destroy( tile );
+                num++;
+            }
+
+            return num;
+        };
+
+        if( parallelThreadCount <= 1 )
+        {
+            tile_lambda();
+        }
+        else
+        {
+            std::vector<std::future<size_t>> returns( parallelThreadCount );
+
+            for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+                returns[ii] = std::async( std::launch::async, tile_lambda );
+
+            for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+                returns[ii].wait();
+        }
+
+        cairo_surface_mark_dirty( target );
+    }
+
+    for( TILE_OP& op : tileOps )
+        cairo_path_destroy( op.path );
+
+    tileOps.clear();
+    tileContext = nullptr;
+}
+
+
 void CAIRO_GAL_BASE::blitCursor( wxMemoryDC& clientDC )
 {
     if( !IsCursorEnabled() )
@@ -1212,6 +1429,8 @@ CAIRO_GAL::CAIRO_GAL( GAL_DISPLAY_OPTIONS& aDisplayOptions,
     validCompositor     = false;
     SetTarget( TARGET_NONCACHED );
 
+    tiledRendering      = true;
+
     parentWindow  = aParent;
     mouseListener = aMouseListener;
     paintListener = aPaintListener;
@@ -1381,6 +1600,9 @@ RENDER_TARGET CAIRO_GAL::GetTarget() const
 
 void CAIRO_GAL::ClearTarget( RENDER_TARGET aTarget )
 {
+    // The buffer is cleared directly, so pending operations have to be rendered first
+    flushTiles();
+
     // Save the current state
     unsigned int currentBuffer = compositor->GetBuffer();
 
@@ -1430,6 +1652,8 @@ void CAIRO_GAL::deinitSurface()
     if( !isInitialized )
         return;
 
+    flushTiles();
+
     cairo_destroy( context );
     context = nullptr;
     cairo_surface_destroy( surface );
@@ -1513,6 +1737,101 @@ bool CAIRO_GAL::updatedGalDisplayOptions( const GAL_DISPLAY_OPTIONS& aOptions )
 }
 
 
+CAIRO_IMAGE_GAL::CAIRO_IMAGE_GAL( GAL_DISPLAY_OPTIONS& aDisplayOptions, int aWidth,
+                                  int aHeight ) :
+    CAIRO_GAL_BASE( aDisplayOptions )
+{
+    tiledRendering = true;
+    screenSize = VECTOR2I( aWidth, aHeight );
+
+    initSurface();
+}
+
+
+void CAIRO_IMAGE_GAL::ResizeScreen( int aWidth, int aHeight )
+{
+    CAIRO_GAL_BASE::ResizeScreen( aWidth, aHeight );
+
+    initSurface();
+}
+
+
+bool CAIRO_IMAGE_GAL::SaveImage( const wxString& aFileName ) const
+{
+    cairo_surface_flush( surface );
+
+    const unsigned char* data = cairo_image_surface_get_data( surface );
+    int                  stride = cairo_image_surface_get_stride( surface );
+    wxImage              img( screenSize.x, screenSize.y, false );
+
+    img.InitAlpha();
+
+    // Cairo stores premultiplied ARGB pixels in native endianness
+    for( int y = 0; y < screenSize.y; y++ )
+    {
+        const uint32_t* row = reinterpret_cast<const uint32_t*>( data + (size_t) y * stride );
+
+        for( int x = 0; x < screenSize.x; x++ )
+        {
+            uint32_t pixel = row[x];
+            unsigned a = ( pixel >> 24 ) & 0xff;
+            unsigned r = ( pixel >> 16 ) & 0xff;
+            unsigned g = ( pixel >> 8 ) & 0xff;
+            unsigned b = pixel & 0xff;
+
+            if( a > 0 && a < 255 )
+            {
+                r = r * 255 / a;
+                g = g * 255 / a;
+                b = b * 255 / a;
+            }
+
+            img.SetRGB( x, y, r, g, b );
+            img.SetAlpha( x, y, a );
+        }
+    }
+
+    return img.SaveFile( aFileName, wxBITMAP_TYPE_PNG );
+}
+
+
+void CAIRO_IMAGE_GAL::initSurface()
+{
+    flushTiles();
+
+    if( context )
+        cairo_destroy( context );
+
+    if( surface )
+        cairo_surface_destroy( surface );
+
+    surface = cairo_image_surface_create( GAL_FORMAT, std::max( screenSize.x, 1 ),
+                                          std::max( screenSize.y, 1 ) );
+    context = cairo_create( surface );
+    currentContext = context;
+
+    switch( options.cairo_antialiasing_mode )
+    {
+    case CAIRO_ANTIALIASING_MODE::FAST:
+        cairo_set_antialias( context, CAIRO_ANTIALIAS_FAST );
+        break;
+    case CAIRO_ANTIALIASING_MODE::GOOD:
+        cairo_set_antialias( context, CAIRO_ANTIALIAS_GOOD );
+        break;
+    case CAIRO_ANTIALIASING_MODE::BEST:
+        cairo_set_antialias( context, CAIRO_ANTIALIAS_BEST );
+        break;
+    default:
+        cairo_set_antialias( context, CAIRO_ANTIALIAS_NONE );
+    }
+
+#ifdef DEBUG
+    cairo_status_t status = cairo_status( context );
+    wxASSERT_MSG( status == CAIRO_STATUS_SUCCESS, wxT( "Cairo context creation error" ) );
+#endif /* DEBUG */
+}
+
+
 void CAIRO_GAL_BASE::DrawGrid()
 {
     SetTarget( TARGET_NONCACHED );
@@ -32,6 +32,8 @@
 #include <wx/string.h>
 #include <gr_text.h>
 
+#include <mutex>
+
 
 using namespace KIGFX;
 
@@ -44,6 +46,7 @@ const double STROKE_FONT::ITALIC_TILT = 1.0 / 8;
 
 GLYPH_LIST*         g_newStrokeFontGlyphs = nullptr;     ///< Glyph list
 std::vector<BOX2D>* g_newStrokeFontGlyphBoundingBoxes;   ///< Bounding boxes of the glyphs
+std::once_flag      g_newStrokeFontLoaded;               ///< Guards the loading of the above
 
 
 STROKE_FONT::STROKE_FONT( GAL* aGal ) :
@@ -54,13 +57,23 @@ STROKE_FONT::STROKE_FONT( GAL* aGal ) :
 
 bool STROKE_FONT::LoadNewStrokeFont( const char* const aNewStrokeFont[], int aNewStrokeFontSize )
 {
-    if( g_newStrokeFontGlyphs )
-    {
-        m_glyphs = g_newStrokeFontGlyphs;
-        m_glyphBoundingBoxes = g_newStrokeFontGlyphBoundingBoxes;
-        return true;
-    }
+    // Each GAL loads the font, including the GALs of worker threads (plotting, 3D viewer),
+    // so the shared glyphs are built by the first caller while the others wait for them.
+    std::call_once( g_newStrokeFontLoaded,
+                    [&]()
+                    {
+                        buildNewStrokeFontGlyphs( aNewStrokeFont, aNewStrokeFontSize );
+                    } );
+
+    m_glyphs = g_newStrokeFontGlyphs;
+    m_glyphBoundingBoxes = g_newStrokeFontGlyphBoundingBoxes;
+    return true;
+}
+
 
+void STROKE_FONT::buildNewStrokeFontGlyphs( const char* const aNewStrokeFont[],
+                                            int aNewStrokeFontSize ) const
+{
     g_newStrokeFontGlyphs = new GLYPH_LIST;
     g_newStrokeFontGlyphs->reserve( aNewStrokeFontSize );
 
@@ -151,10 +164,6 @@ bool STROKE_FONT::LoadNewStrokeFont( const char* const aNewStrokeFont[], int aNe
         g_newStrokeFontGlyphBoundingBoxes->emplace_back( computeBoundingBox( glyph, glyphWidth ) );
         g_newStrokeFontGlyphs->push_back( glyph );
     }
-
-    m_glyphs = g_newStrokeFontGlyphs;
-    m_glyphBoundingBoxes = g_newStrokeFontGlyphBoundingBoxes;
-    return true;
 }
 
 
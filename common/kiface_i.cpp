@@ -29,6 +29,7 @@
 #include <kiface_i.h>
 #include <pgm_base.h>
 #include <systemdirsappend.h>
+#include <trace_span.h>
 
 #include <common.h>
 
@@ -92,12 +93,16 @@ bool KIFACE_I::start_common( int aCtlBits )
     m_bm.Init();
     setSearchPaths( &m_bm.m_search, m_id );
 
+    // Each kiface has its own copy of the span buffers
+    TRACE_SPAN::InitFromConfig();
+
     return true;
 }
 
 
 void KIFACE_I::end_common()
 {
+    TRACE_SPAN::FlushToConfigFile();
     m_bm.End();
 }
 
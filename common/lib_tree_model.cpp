@@ -23,6 +23,9 @@
 
 #include <eda_pattern_match.h>
 #include <lib_tree_item.h>
+#include <algorithm>
+#include <iterator>
+#include <numeric>
 #include <utility>
 #include <pgm_base.h>
 #include <kicad_string.h>
@@ -49,6 +52,45 @@ static int matchPosScore(int aPosition, int aMaximum)
 }
 
 
+// Return true if a search term has no regex, wildcard or relational syntax.  Such terms
+// only match the strings containing them.
+static bool isLiteralTerm( const wxString& aTerm )
+{
+    static const wxString special = wxT( ".*+?^${}()|[]\\<=>" );
+
+    for( wxUniChar c : aTerm )
+    {
+        if( special.Find( c ) != wxNOT_FOUND )
+            return false;
+    }
+
+    return true;
+}
+
+
+// Add the keys of all the 3 character substrings of aText to aKeys.
+static void addTrigrams( const wxString& aText, std::vector<uint64_t>& aKeys )
+{
+    std::wstring text = aText.ToStdWstring();
+
+    for( size_t i = 2; i < text.size(); ++i )
+    {
+        aKeys.push_back( ( uint64_t( text[i - 2] & 0x1FFFFF ) << 42 )
+                         | ( uint64_t( text[i - 1] & 0x1FFFFF ) << 21 )
+                         | uint64_t( text[i] & 0x1FFFFF ) );
+    }
+}
+
+
+// Return true if a LIB_ID node can match a literal search term (see UpdateScore()).
+static bool containsTerm( const LIB_TREE_NODE* aNode, const wxString& aTerm )
+{
+    return aNode->m_MatchName.Find( aTerm ) != wxNOT_FOUND
+           || aNode->m_Parent->m_MatchName.Find( aTerm ) != wxNOT_FOUND
+           || aNode->m_SearchText.Find( aTerm ) != wxNOT_FOUND;
+}
+
+
 void LIB_TREE_NODE::ResetScore()
 {
     for( auto& child: m_Children )
@@ -319,6 +361,7 @@ void LIB_TREE_NODE_LIB::UpdateScore( EDA_COMBINED_MATCHER& aMatcher )
 LIB_TREE_NODE_ROOT::LIB_TREE_NODE_ROOT()
 {
     m_Type = ROOT;
+    m_searchTreeHash = 0;
 }
 
 
@@ -336,3 +379,242 @@ void LIB_TREE_NODE_ROOT::UpdateScore( EDA_COMBINED_MATCHER& aMatcher )
         child->UpdateScore( aMatcher );
 }
 
+
+void LIB_TREE_NODE_ROOT::validateSearchIndex()
+{
+    // Nodes are sorted by score, so compare the node sets rather than their order.  New and
+    // updated items are not normalized yet.
+    uintptr_t hash = 0;
+    size_t    itemCount = 0;
+    bool      normalized = true;
+
+    for( const std::unique_ptr<LIB_TREE_NODE>& lib : m_Children )
+    {
+        hash += reinterpret_cast<uintptr_t>( lib.get() ) * 31;
+
+        for( const std::unique_ptr<LIB_TREE_NODE>& item : lib->m_Children )
+        {
+            hash += reinterpret_cast<uintptr_t>( item.get() );
+            normalized &= item->m_Normalized;
+        }
+
+        itemCount += lib->m_Children.size();
+    }
+
+    if( normalized && hash == m_searchTreeHash && m_Children.size() == m_searchLibs.size()
+            && itemCount == m_searchItems.size() )
+    {
+        return;
+    }
+
+    m_searchLibs.clear();
+    m_searchItems.clear();
+    m_trigrams.clear();
+    m_lastTerms.clear();
+    m_searchTreeHash = hash;
+
+    std::vector<uint64_t> keys;
+
+    for( const std::unique_ptr<LIB_TREE_NODE>& lib : m_Children )
+    {
+        unsigned first = m_searchItems.size();
+
+        for( const std::unique_ptr<LIB_TREE_NODE>& item : lib->m_Children )
+        {
+            unsigned idx = m_searchItems.size();
+
+            if( !item->m_Normalized )
+            {
+                item->m_MatchName = item->m_MatchName.Lower();
+                item->m_SearchText = item->m_SearchText.Lower();
+                item->m_Normalized = true;
+            }
+
+            keys.clear();
+            addTrigrams( item->m_MatchName, keys );
+            addTrigrams( item->m_SearchText, keys );
+
+            std::sort( keys.begin(), keys.end() );
+            keys.erase( std::unique( keys.begin(), keys.end() ), keys.end() );
+
+            // Items are added in index order, so the lists stay sorted
+            for( uint64_t key : keys )
+                m_trigrams[key].push_back( idx );
+
+            m_searchItems.push_back( item.get() );
+        }
+
+        m_searchLibs.push_back( { lib.get(), first, (unsigned) m_searchItems.size() } );
+    }
+}
+
+
+std::vector<unsigned> LIB_TREE_NODE_ROOT::searchCandidates( const wxString& aTerm ) const
+{
+    std::vector<uint64_t> keys;
+    std::vector<unsigned> candidates;
+    bool                  first = true;
+
+    addTrigrams( aTerm, keys );
+
+    for( uint64_t key : keys )
+    {
+        auto it = m_trigrams.find( key );
+
+        if( it == m_trigrams.end() )
+        {
+            candidates.clear();
+            break;
+        }
+
+        if( first )
+        {
+            candidates = it->second;
+            first = false;
+        }
+        else
+        {
+            std::vector<unsigned> both;
+
+            std::set_intersection( candidates.begin(), candidates.end(),
+                                   it->second.begin(), it->second.end(),
+                                   std::back_inserter( both ) );
+            candidates.swap( both );
+        }
+
+        if( candidates.empty() )
+            break;
+    }
+
+    // Items also match the name of their library
+    bool libMatch = false;
+
+    for( const SEARCH_LIB& lib : m_searchLibs )
+    {
+        if( lib.m_firstItem < lib.m_endItem && lib.m_lib->m_MatchName.Find( aTerm ) != wxNOT_FOUND )
+        {
+            for( unsigned idx = lib.m_firstItem; idx < lib.m_endItem; ++idx )
+                candidates.push_back( idx );
+
+            libMatch = true;
+        }
+    }
+
+    if( libMatch )
+    {
+        std::sort( candidates.begin(), candidates.end() );
+        candidates.erase( std::unique( candidates.begin(), candidates.end() ), candidates.end() );
+    }
+
+    return candidates;
+}
+
+
+void LIB_TREE_NODE_ROOT::UpdateSearchScores( const std::vector<wxString>& aTerms )
+{
+    validateSearchIndex();
+
+    if( aTerms.empty() )
+    {
+        m_lastTerms.clear();
+        return;
+    }
+
+    bool literal = std::all_of( aTerms.begin(), aTerms.end(), isLiteralTerm );
+
+    // When each previous term is part of a new term, the items matching the new terms
+    // also matched the previous ones.
+    bool refined = literal && !m_lastTerms.empty()
+                   && std::all_of( m_lastTerms.begin(), m_lastTerms.end(),
+                                   [&]( const wxString& aLastTerm )
+                                   {
+                                       return std::any_of( aTerms.begin(), aTerms.end(),
+                                               [&]( const wxString& aTerm )
+                                               {
+                                                   return aTerm.Find( aLastTerm ) != wxNOT_FOUND;
+                                               } );
+                                   } );
+
+    std::vector<unsigned> candidates;
+
+    if( refined )
+    {
+        candidates = m_lastMatches;
+    }
+    else
+    {
+        candidates.resize( m_searchItems.size() );
+        std::iota( candidates.begin(), candidates.end(), 0 );
+    }
+
+    for( const wxString& term : aTerms )
+    {
+        if( !isLiteralTerm( term ) )
+            continue;
+
+        if( term.length() >= 3 )
+        {
+            std::vector<unsigned> possible = searchCandidates( term );
+            std::vector<unsigned> both;
+
+            std::set_intersection( candidates.begin(), candidates.end(),
+                                   possible.begin(), possible.end(),
+                                   std::back_inserter( both ) );
+            candidates.swap( both );
+        }
+
+        // Trigrams only tell which items may contain the term; shorter terms have none
+        candidates.erase( std::remove_if( candidates.begin(), candidates.end(),
+                                          [&]( unsigned aIdx )
+                                          {
+                                              return !containsTerm( m_searchItems[aIdx], term );
+                                          } ),
+                          candidates.end() );
+    }
+
+    // The other items score 0, as they would have in UpdateScore()
+    for( LIB_TREE_NODE* item : m_searchItems )
+        item->m_Score = 0;
+
+    for( unsigned idx : candidates )
+        m_searchItems[idx]->m_Score = kLowestDefaultScore;
+
+    for( const wxString& term : aTerms )
+    {
+        EDA_COMBINED_MATCHER matcher( term );
+
+        for( unsigned idx : candidates )
+            m_searchItems[idx]->UpdateScore( matcher );
+
+        for( const SEARCH_LIB& lib : m_searchLibs )
+        {
+            if( lib.m_firstItem == lib.m_endItem )
+                lib.m_lib->UpdateScore( matcher );
+        }
+    }
+
+    for( const SEARCH_LIB& lib : m_searchLibs )
+    {
+        if( lib.m_firstItem == lib.m_endItem )
+            continue;
+
+        lib.m_lib->m_Score = 0;
+
+        for( unsigned idx = lib.m_firstItem; idx < lib.m_endItem; ++idx )
+            lib.m_lib->m_Score = std::max( lib.m_lib->m_Score, m_searchItems[idx]->m_Score );
+    }
+
+    m_lastTerms.clear();
+    m_lastMatches.clear();
+
+    if( literal )
+    {
+        m_lastTerms = aTerms;
+
+        for( unsigned idx : candidates )
+        {
+            if( m_searchItems[idx]->m_Score > 0 )
+                m_lastMatches.push_back( idx );
+        }
+    }
+}
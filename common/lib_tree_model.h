@@ -22,8 +22,10 @@
 #ifndef LIB_TREE_MODEL_H
 #define LIB_TREE_MODEL_H
 
+#include <cstdint>
 #include <vector>
 #include <memory>
+#include <unordered_map>
 #include <wx/string.h>
 #include <lib_tree_item.h>
 
@@ -51,6 +53,8 @@ class EDA_COMBINED_MATCHER;
  * Quick summary of methods used to drive this class:
  *
  * - `UpdateScore()` - accumulate scores recursively given a new search token
+ * - `LIB_TREE_NODE_ROOT::UpdateSearchScores()` - same for all the search tokens at
+ *      once, using a search index to skip the items which cannot match
  * - `ResetScore()` - reset scores recursively for a new search string
  * - `AssignIntrinsicRanks()` - calculate and cache the initial sort order
  * - `SortNodes()` - recursively sort the tree by score
@@ -282,6 +286,45 @@ public:
     LIB_TREE_NODE_LIB& AddLib( wxString const& aName, wxString const& aDesc );
 
     virtual void UpdateScore( EDA_COMBINED_MATCHER& aMatcher ) override;
+
+    /**
+     * Accumulate the scores of all the search terms, like calling UpdateScore() once per
+     * term after ResetScore().
+     *
+     * Terms without regex, wildcard or relational syntax can only match items containing
+     * them, so a trigram index of the items narrows the items to score.  When each term
+     * of the previous search is contained in one of \a aTerms (e.g. the user typed more
+     * characters), only the items which matched the previous search are scored again.
+     *
+     * The index is rebuilt when items are added, updated or removed.
+     *
+     * @param aTerms    the search terms, normalized to lowercase
+     */
+    void UpdateSearchScores( const std::vector<wxString>& aTerms );
+
+private:
+    /// Rebuild the search index if the tree changed since it was built.
+    void validateSearchIndex();
+
+    /// @return the sorted indices of the m_searchItems which may contain \a aTerm.
+    std::vector<unsigned> searchCandidates( const wxString& aTerm ) const;
+
+    struct SEARCH_LIB
+    {
+        LIB_TREE_NODE* m_lib;
+        unsigned       m_firstItem;     // Index in m_searchItems of the first child
+        unsigned       m_endItem;       // And past the last child
+    };
+
+    std::vector<SEARCH_LIB>     m_searchLibs;
+    std::vector<LIB_TREE_NODE*> m_searchItems;     // The LIB_ID nodes
+    uintptr_t                   m_searchTreeHash;  // Of the nodes when indexed
+
+    // Sorted m_searchItems indices of the items containing each trigram
+    std::unordered_map<uint64_t, std::vector<unsigned>> m_trigrams;
+
+    std::vector<wxString>       m_lastTerms;       // Of the last UpdateSearchScores()
+    std::vector<unsigned>       m_lastMatches;     // Valid if m_lastTerms is not empty
 };
 
 
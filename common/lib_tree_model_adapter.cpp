@@ -194,15 +194,13 @@ void LIB_TREE_MODEL_ADAPTER::UpdateSearchString( wxString const& aSearch )
             child->m_Score *= 2;
     }
 
-    wxStringTokenizer tokenizer( aSearch );
+    wxStringTokenizer     tokenizer( aSearch );
+    std::vector<wxString> terms;
 
     while( tokenizer.HasMoreTokens() )
-    {
-        const wxString term = tokenizer.GetNextToken().Lower();
-        EDA_COMBINED_MATCHER matcher( term );
+        terms.push_back( tokenizer.GetNextToken().Lower() );
 
-        m_tree.UpdateScore( matcher );
-    }
+    m_tree.UpdateSearchScores( terms );
 
     m_tree.SortNodes();
 
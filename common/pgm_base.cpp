@@ -58,6 +58,7 @@
 #include <settings/settings_manager.h>
 #include <systemdirsappend.h>
 #include <trace_helpers.h>
+#include <trace_span.h>
 
 
 static const wxChar traceEnvVars[]     = wxT( "KIENVVARS" );
@@ -127,6 +128,8 @@ PGM_BASE::~PGM_BASE()
 void PGM_BASE::Destroy()
 {
     // unlike a normal destructor, this is designed to be called more than once safely:
+    TRACE_SPAN::FlushToConfigFile();
+
     delete m_pgm_checker;
     m_pgm_checker = 0;
 
@@ -236,6 +239,8 @@ bool PGM_BASE::InitPgm()
     if( !m_settings_manager->IsOK() )
         return false;
 
+    TRACE_SPAN::InitFromConfig();
+
     // Init KiCad environment
     // the environment variable KICAD (if exists) gives the kicad path:
     // something like set KICAD=d:\kicad
@@ -199,7 +199,7 @@ void PSLIKE_PLOTTER::FlashPadRoundRect( const wxPoint& aPadPos, const wxSize& aS
 
     std::vector< wxPoint > cornerList;
     // TransformRoundRectToPolygon creates only one convex polygon
-    SHAPE_LINE_CHAIN& poly = outline.Outline( 0 );
+    const SHAPE_LINE_CHAIN& poly = outline.COutline( 0 );
     cornerList.reserve( poly.PointCount() );
 
     for( int ii = 0; ii < poly.PointCount(); ++ii )
@@ -232,7 +232,7 @@ void PSLIKE_PLOTTER::FlashPadCustom( const wxPoint& aPadPos, const wxSize& aSize
 
     for( int cnt = 0; cnt < aPolygons->OutlineCount(); ++cnt )
     {
-        SHAPE_LINE_CHAIN& poly = aPolygons->Outline( cnt );
+        const SHAPE_LINE_CHAIN& poly = aPolygons->COutline( cnt );
         cornerList.clear();
 
         for( int ii = 0; ii < poly.PointCount(); ++ii )
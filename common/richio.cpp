@@ -23,7 +23,9 @@
  */
 
 
+#include <algorithm>
 #include <cstdarg>
+#include <cstring>
 #include <config.h> // HAVE_FGETC_NOLOCK
 
 #include <richio.h>
@@ -320,6 +322,31 @@ char* INPUTSTREAM_LINE_READER::ReadLine()
 }
 
 
+//-----<LINE_CHUNK_READER>--------------------------------------------------
+
+char* LINE_CHUNK_READER::ReadChunk( char* aBuff, unsigned aBuffSize )
+{
+    // Leave room for at least one byte of text, or the reader would never move on
+    if( aBuffSize < 2 )
+        return NULL;
+
+    if( m_offset == 0 && m_reader.ReadLine() == NULL )
+        return NULL;
+
+    unsigned len = std::min( m_reader.Length() - m_offset, aBuffSize - 1 );
+
+    memcpy( aBuff, m_reader.Line() + m_offset, len );
+    aBuff[len] = 0;
+
+    m_offset += len;
+
+    if( m_offset >= m_reader.Length() )
+        m_offset = 0;
+
+    return aBuff;
+}
+
+
 //-----<OUTPUTFORMATTER>----------------------------------------------------
 
 // factor out a common GetQuoteChar
@@ -523,6 +550,20 @@ FILE_OUTPUTFORMATTER::~FILE_OUTPUTFORMATTER()
 }
 
 
+void FILE_OUTPUTFORMATTER::Finish()
+{
+    if( !m_fp )
+        return;
+
+    FILE* fp = m_fp;
+
+    m_fp = nullptr;
+
+    if( fclose( fp ) != 0 )
+        THROW_IO_ERROR( strerror( errno ) );
+}
+
+
 void FILE_OUTPUTFORMATTER::write( const char* aOutBuf, int aCount )
 {
     if( fwrite( aOutBuf, (unsigned) aCount, 1, m_fp ) != 1 )
@@ -37,6 +37,7 @@
 #include <eda_draw_frame.h>
 
 #include <core/optional.h>
+#include <trace_span.h>
 
 
 ///> Stores information about a mouse button state
@@ -119,7 +120,9 @@ struct TOOL_DISPATCHER::BUTTON_STATE
 
 TOOL_DISPATCHER::TOOL_DISPATCHER( TOOL_MANAGER* aToolMgr, ACTIONS *aActions ) :
     m_toolMgr( aToolMgr ),
-    m_actions( aActions )
+    m_actions( aActions ),
+    m_coalesceMotion( true ),
+    m_flushScheduled( false )
 {
     m_buttons.push_back( new BUTTON_STATE( BUT_LEFT, wxEVT_LEFT_DOWN,
                          wxEVT_LEFT_UP, wxEVT_LEFT_DCLICK ) );
@@ -143,6 +146,74 @@ void TOOL_DISPATCHER::ResetState()
 {
     for( BUTTON_STATE* st : m_buttons )
         st->Reset();
+
+    m_pendingMotion = NULLOPT;
+}
+
+
+void TOOL_DISPATCHER::SetMotionCoalescing( bool aEnable )
+{
+    if( !aEnable )
+        flushMotion();
+
+    m_coalesceMotion = aEnable;
+}
+
+
+bool TOOL_DISPATCHER::processEvent( const TOOL_EVENT& aEvent )
+{
+    if( !aEvent.IsMotion() && !aEvent.IsDrag() )
+    {
+        // Keep the event order: tools must see the latest position before a click or key
+        flushMotion();
+        return m_toolMgr->ProcessEvent( aEvent );
+    }
+
+    m_motionStats.m_received++;
+
+    if( !m_pendingMotion )
+        m_pendingSince = std::chrono::steady_clock::now();
+
+    m_pendingMotion = aEvent;
+
+    if( !m_coalesceMotion )
+    {
+        flushMotion();
+    }
+    else if( !m_flushScheduled )
+    {
+        // Queued events are processed once the native event queue is empty, so all the
+        // motion events of a burst are merged into the last one
+        m_flushScheduled = true;
+        CallAfter( [this]()
+                   {
+                       m_flushScheduled = false;
+                       flushMotion();
+                   } );
+    }
+
+    return true;
+}
+
+
+void TOOL_DISPATCHER::flushMotion()
+{
+    if( !m_pendingMotion )
+        return;
+
+    TRACE_SPAN span( "TOOL_DISPATCHER::flushMotion", "tools" );
+
+    TOOL_EVENT evt = *m_pendingMotion;
+    m_pendingMotion = NULLOPT;
+
+    m_motionStats.m_dispatched++;
+    m_toolMgr->ProcessEvent( evt );
+
+    std::chrono::duration<double, std::milli> latency =
+            std::chrono::steady_clock::now() - m_pendingSince;
+
+    m_motionStats.m_lastLatency = latency.count();
+    m_motionStats.m_maxLatency = std::max( m_motionStats.m_maxLatency, latency.count() );
 }
 
 
@@ -239,7 +310,7 @@ bool TOOL_DISPATCHER::handleMouseButton( wxEvent& aEvent, int aIndex, bool aMoti
     if( evt )
     {
         evt->SetMousePosition( isClick ? st->downPosition : m_lastMousePos );
-        m_toolMgr->ProcessEvent( *evt );
+        processEvent( *evt );
 
         return true;
     }
@@ -531,7 +602,7 @@ void TOOL_DISPATCHER::DispatchWxEvent( wxEvent& aEvent )
     {
         wxLogTrace( kicadTraceToolStack, "TOOL_DISPATCHER::DispatchWxEvent %s", evt->Format() );
 
-        handled = m_toolMgr->ProcessEvent( *evt );
+        handled = processEvent( *evt );
 
         // ESC is the special key for canceling tools, and is therefore seen as handled
         if( key == WXK_ESCAPE )
@@ -570,7 +641,7 @@ void TOOL_DISPATCHER::DispatchWxCommand( wxCommandEvent& aEvent )
     {
         wxLogTrace( kicadTraceToolStack, "TOOL_DISPATCHER::DispatchWxCommand %s", evt->Format() );
 
-        m_toolMgr->ProcessEvent( *evt );
+        processEvent( *evt );
     }
     else
         aEvent.Skip();
@@ -0,0 +1,287 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <trace_span.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <wx/log.h>
+#include <wx/utils.h>
+
+#include <advanced_config.h>
+
+
+std::atomic<bool> TRACE_SPAN::s_enabled( false );
+
+
+namespace
+{
+
+struct SPAN_EVENT
+{
+    const char* name;
+    const char* category;
+    uint64_t    start;
+    uint64_t    end;
+    int         threadId;
+};
+
+
+/**
+ * The spans of one thread.  Only the owning thread writes events, but readers may flush
+ * them at any time, so events are written and read under the buffer lock.  The lock is
+ * not contended while nobody flushes.
+ *
+ * Buffers are never freed: when a thread exits its buffer is handed to the next new
+ * thread, so short-lived worker threads do not grow the registry.  Each event keeps the
+ * id of the thread that recorded it, so spans of the previous owner that were not flushed
+ * yet keep their thread.
+ */
+struct SPAN_BUFFER
+{
+    SPAN_BUFFER( size_t aCapacity ) :
+            m_events( aCapacity ),
+            m_written( 0 ),
+            m_flushed( 0 ),
+            m_inUse( true )
+    {
+    }
+
+    std::mutex              m_lock;
+    std::vector<SPAN_EVENT> m_events;
+    uint64_t                m_written;    ///< Guarded by m_lock
+    uint64_t                m_flushed;    ///< Guarded by m_lock
+    std::atomic<bool>       m_inUse;
+};
+
+
+struct SPAN_REGISTRY
+{
+    std::mutex                                lock;
+    std::vector<std::unique_ptr<SPAN_BUFFER>> buffers;
+    size_t                                    capacity = 65536;
+    int                                       lastThreadId = 0;
+};
+
+
+SPAN_REGISTRY& registry()
+{
+    static SPAN_REGISTRY s_registry;
+    return s_registry;
+}
+
+
+/**
+ * Find a free buffer of the current capacity, or create one.
+ *
+ * @param aThreadId receives a new id for the calling thread.
+ */
+SPAN_BUFFER* acquireBuffer( int& aThreadId )
+{
+    SPAN_REGISTRY&              reg = registry();
+    std::lock_guard<std::mutex> guard( reg.lock );
+
+    aThreadId = ++reg.lastThreadId;
+
+    for( std::unique_ptr<SPAN_BUFFER>& buffer : reg.buffers )
+    {
+        bool expected = false;
+
+        if( buffer->m_events.size() == reg.capacity
+                && buffer->m_inUse.compare_exchange_strong( expected, true ) )
+        {
+            return buffer.get();
+        }
+    }
+
+    reg.buffers.push_back( std::make_unique<SPAN_BUFFER>( reg.capacity ) );
+    return reg.buffers.back().get();
+}
+
+
+/// Releases the buffer of a thread when the thread exits.
+struct THREAD_BUFFER
+{
+    SPAN_BUFFER* m_buffer = nullptr;
+    int          m_threadId = 0;
+
+    ~THREAD_BUFFER()
+    {
+        if( m_buffer )
+            m_buffer->m_inUse = false;
+    }
+};
+
+
+thread_local THREAD_BUFFER t_buffer;
+
+
+/**
+ * Visit the events of every buffer that were not flushed yet, oldest first, and mark
+ * them as flushed.  Events overwritten by the ring before being flushed are lost.
+ * Threads recording spans meanwhile wait for their buffer to be visited.
+ */
+template <typename VISITOR>
+void flushEvents( VISITOR aVisitor )
+{
+    SPAN_REGISTRY&              reg = registry();
+    std::lock_guard<std::mutex> guard( reg.lock );
+
+    for( std::unique_ptr<SPAN_BUFFER>& buffer : reg.buffers )
+    {
+        std::lock_guard<std::mutex> bufferGuard( buffer->m_lock );
+
+        uint64_t written = buffer->m_written;
+        uint64_t size = buffer->m_events.size();
+        uint64_t first = std::max( buffer->m_flushed, written > size ? written - size : 0 );
+
+        for( uint64_t ii = first; ii < written; ii++ )
+            aVisitor( buffer->m_events[ii % size] );
+
+        buffer->m_flushed = written;
+    }
+}
+
+
+void writeEvent( std::ostream& aStream, long aPid, const SPAN_EVENT& aEvent )
+{
+    uint64_t duration = aEvent.end - aEvent.start;
+
+    // Chrome trace timestamps are in microseconds; keep a tenth of a microsecond
+    aStream << "{\"name\":\"" << aEvent.name << "\",\"cat\":\"" << aEvent.category << "\""
+            << ",\"ph\":\"X\",\"ts\":" << aEvent.start / 1000 << "." << aEvent.start % 1000 / 100
+            << ",\"dur\":" << duration / 1000 << "." << duration % 1000 / 100
+            << ",\"pid\":" << aPid << ",\"tid\":" << aEvent.threadId << "}";
+}
+
+} // namespace
+
+
+uint64_t TRACE_SPAN::now()
+{
+    // Not relative to a start time of our own: each module keeps its own statics, and
+    // their spans must line up in a shared trace file
+    auto sinceEpoch = std::chrono::steady_clock::now().time_since_epoch();
+
+    return std::chrono::duration_cast<std::chrono::nanoseconds>( sinceEpoch ).count();
+}
+
+
+void TRACE_SPAN::record( const char* aName, const char* aCategory, uint64_t aStart,
+                         uint64_t aEnd )
+{
+    SPAN_BUFFER* buffer = t_buffer.m_buffer;
+
+    if( !buffer )
+        buffer = t_buffer.m_buffer = acquireBuffer( t_buffer.m_threadId );
+
+    std::lock_guard<std::mutex> guard( buffer->m_lock );
+    uint64_t                    idx = buffer->m_written++;
+
+    buffer->m_events[idx % buffer->m_events.size()] =
+            { aName, aCategory, aStart, aEnd, t_buffer.m_threadId };
+}
+
+
+void TRACE_SPAN::Enable( bool aEnable, size_t aEventsPerThread )
+{
+    if( aEnable )
+    {
+        SPAN_REGISTRY&              reg = registry();
+        std::lock_guard<std::mutex> guard( reg.lock );
+
+        // Buffers of the old size are not reused; threads that already own one keep it
+        reg.capacity = std::max<size_t>( aEventsPerThread, 1 );
+    }
+
+    s_enabled = aEnable;
+}
+
+
+void TRACE_SPAN::InitFromConfig()
+{
+    const ADVANCED_CFG& cfg = ADVANCED_CFG::GetCfg();
+
+    if( !cfg.m_traceSpanFile.IsEmpty() )
+        Enable( true, cfg.m_traceSpanBufferSize );
+}
+
+
+void TRACE_SPAN::FlushToConfigFile()
+{
+    const ADVANCED_CFG& cfg = ADVANCED_CFG::GetCfg();
+
+    if( cfg.m_traceSpanFile.IsEmpty() )
+        return;
+
+    if( !AppendChromeTrace( cfg.m_traceSpanFile.ToStdString() ) )
+        wxLogTrace( "KICAD_TRACE_SPAN", "Cannot write trace file %s", cfg.m_traceSpanFile );
+}
+
+
+void TRACE_SPAN::WriteChromeTrace( std::ostream& aStream )
+{
+    long pid = wxGetProcessId();
+    bool first = true;
+
+    aStream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+    flushEvents( [&]( const SPAN_EVENT& aEvent )
+                 {
+                     if( !first )
+                         aStream << ",\n";
+
+                     writeEvent( aStream, pid, aEvent );
+                     first = false;
+                 } );
+
+    aStream << "\n]}\n";
+}
+
+
+bool TRACE_SPAN::AppendChromeTrace( const std::string& aFileName )
+{
+    std::ofstream stream( aFileName, std::ios::out | std::ios::app | std::ios::ate );
+
+    if( !stream )
+        return false;
+
+    long pid = wxGetProcessId();
+
+    // The array format lets several writers append to one file, so open it only once
+    if( stream.tellp() == 0 )
+        stream << "[\n";
+
+    flushEvents( [&]( const SPAN_EVENT& aEvent )
+                 {
+                     writeEvent( stream, pid, aEvent );
+                     stream << ",\n";
+                 } );
+
+    return !stream.fail();
+}
@@ -35,7 +35,9 @@
 
 #include <gal/definitions.h>
 #include <gal/graphics_abstraction_layer.h>
+#include <gal/cairo/cairo_gal.h>
 #include <painter.h>
+#include <trace_span.h>
 
 #ifdef __WXDEBUG__
 #include <profile.h>
@@ -472,6 +474,27 @@ int VIEW::Query( const BOX2I& aRect, std::vector<LAYER_ITEM_PAIR>& aResult ) con
 }
 
 
+int VIEW::QueryAll( const BOX2I& aRect, std::vector<LAYER_ITEM_PAIR>& aResult ) const
+{
+    for( auto i = m_orderedLayers.rbegin(); i != m_orderedLayers.rend(); ++i )
+    {
+        if( ( *i )->displayOnly )
+            continue;
+
+        int  layer = ( *i )->id;
+        auto visitor = [&]( VIEW_ITEM* aItem )
+                       {
+                           aResult.push_back( LAYER_ITEM_PAIR( aItem, layer ) );
+                           return true;
+                       };
+
+        ( *i )->items->Query( aRect, visitor );
+    }
+
+    return aResult.size();
+}
+
+
 VECTOR2D VIEW::ToWorld( const VECTOR2D& aCoord, bool aAbsolute ) const
 {
     const MATRIX3x3D& matrix = m_gal->GetScreenWorldMatrix();
@@ -1144,6 +1167,8 @@ void VIEW::ClearTargets()
 
 void VIEW::Redraw()
 {
+    TRACE_SPAN span( "VIEW::Redraw", "view" );
+
 #ifdef __WXDEBUG__
     PROF_COUNTER totalRealTime;
 #endif /* __WXDEBUG__ */
@@ -1483,6 +1508,64 @@ std::unique_ptr<VIEW> VIEW::DataReference() const
 }
 
 
+/// Points a painter at another GAL, and back at the GAL of its view when leaving the scope
+struct painterGalOverride
+{
+    painterGalOverride( PAINTER* aPainter, GAL* aGal, GAL* aViewGal ) :
+        painter( aPainter ), viewGal( aViewGal )
+    {
+        painter->SetGAL( aGal );
+    }
+
+    ~painterGalOverride()
+    {
+        painter->SetGAL( viewGal );
+    }
+
+    PAINTER* painter;
+    GAL*     viewGal;
+};
+
+
+bool VIEW::SaveSnapshot( const BOX2D& aArea, const VECTOR2I& aSize, const wxString& aFileName )
+{
+    wxCHECK( m_painter, false );
+
+    GAL_DISPLAY_OPTIONS options;
+    options.cairo_antialiasing_mode = CAIRO_ANTIALIASING_MODE::GOOD;
+
+    CAIRO_IMAGE_GAL       gal( options, aSize.x, aSize.y );
+    std::unique_ptr<VIEW> view( DataReference() );
+
+    // Cached groups belong to the GAL of this view: everything is drawn immediately instead
+    for( auto& entry : view->m_layers )
+    {
+        if( entry.second.target == TARGET_OVERLAY )
+            entry.second.visible = false;
+        else
+            entry.second.target = TARGET_NONCACHED;
+    }
+
+    view->SetScaleLimits( 10e9, 0.0001 );
+    view->SetGAL( &gal );
+    view->SetPainter( m_painter );
+    view->SetMirror( m_mirrorX, m_mirrorY );
+    view->SetViewport( aArea );
+
+    painterGalOverride painterGal( m_painter, &gal, m_gal );
+
+    gal.SetClearColor( m_painter->GetSettings()->GetBackgroundColor() );
+
+    {
+        GAL_DRAWING_CONTEXT ctx( &gal );
+        gal.ClearScreen();
+        view->Redraw();
+    }
+
+    return gal.SaveImage( aFileName );
+}
+
+
 void VIEW::SetVisible( VIEW_ITEM* aItem, bool aIsVisible )
 {
     auto viewData = aItem->viewPrivData();
@@ -24,6 +24,7 @@
  */
 
 #include <fctsys.h>
+#include <atomic>
 #include <macros.h>
 #include <kicad_string.h>
 #include <sch_draw_panel.h>
@@ -76,6 +77,12 @@ bool operator<( const LIB_PART& aItem1, const LIB_PART& aItem2 )
 }
 
 
+/// Source of the revision stamps handed out by LIB_PART::touch().  Stamps are global so
+/// that a freshly allocated symbol can never be mistaken for a previous one at the same
+/// address.
+static std::atomic<unsigned long long> s_nextRevision( 1 );
+
+
 /// http://www.boost.org/doc/libs/1_55_0/libs/smart_ptr/sp_techniques.html#weak_without_shared
 struct null_deleter
 {
@@ -87,7 +94,10 @@ struct null_deleter
 
 LIB_PART::LIB_PART( const wxString& aName, LIB_PART* aParent, PART_LIB* aLibrary ) :
     EDA_ITEM( LIB_PART_T ),
-    m_me( this, null_deleter() )
+    m_me( this, null_deleter() ),
+    m_revision( s_nextRevision++ ),
+    m_flattenedRevision( 0 ),
+    m_flattenedParentRevision( 0 )
 {
     m_dateLastEdition     = 0;
     m_unitCount           = 1;
@@ -116,7 +126,10 @@ LIB_PART::LIB_PART( const wxString& aName, LIB_PART* aParent, PART_LIB* aLibrary
 
 LIB_PART::LIB_PART( const LIB_PART& aPart, PART_LIB* aLibrary ) :
     EDA_ITEM( aPart ),
-    m_me( this, null_deleter() )
+    m_me( this, null_deleter() ),
+    m_revision( s_nextRevision++ ),
+    m_flattenedRevision( 0 ),
+    m_flattenedParentRevision( 0 )
 {
     LIB_ITEM* newItem;
 
@@ -206,10 +219,18 @@ const LIB_PART& LIB_PART::operator=( const LIB_PART& aPart )
     if( parent )
         SetParent( parent.get() );
 
+    touch();
+
     return *this;
 }
 
 
+void LIB_PART::touch()
+{
+    m_revision = s_nextRevision++;
+}
+
+
 int LIB_PART::Compare( const LIB_PART& aRhs ) const
 {
     if( m_me == aRhs.m_me )
@@ -313,6 +334,7 @@ void LIB_PART::SetName( const wxString& aName )
     m_libId.SetLibItemName( validatedName, false );
 
     GetValueField().SetText( validatedName );
+    touch();
 }
 
 
@@ -350,6 +372,8 @@ void LIB_PART::SetParent( LIB_PART* aParent )
     {
         m_parent.reset();
     }
+
+    touch();
 }
 
 
@@ -385,6 +409,26 @@ std::unique_ptr< LIB_PART > LIB_PART::Flatten() const
 }
 
 
+LIB_PART* LIB_PART::GetFlattenedPart()
+{
+    if( !IsAlias() )
+        return this;
+
+    PART_SPTR parent = m_parent.lock();
+
+    if( !m_flattenedCache
+            || m_flattenedRevision != m_revision
+            || m_flattenedParentRevision != parent->GetRevision() )
+    {
+        m_flattenedCache = Flatten();
+        m_flattenedRevision = m_revision;
+        m_flattenedParentRevision = parent->GetRevision();
+    }
+
+    return m_flattenedCache.get();
+}
+
+
 const wxString LIB_PART::GetLibraryName() const
 {
     if( m_library )
@@ -596,6 +640,7 @@ void LIB_PART::RemoveDrawItem( LIB_ITEM* aItem )
         {
             items.erase( i );
             SetModified();
+            touch();
             break;
         }
     }
@@ -608,6 +653,7 @@ void LIB_PART::AddDrawItem( LIB_ITEM* aItem )
         return;
 
     m_drawings.push_back( aItem );
+    touch();
 }
 
 
@@ -831,6 +877,8 @@ void LIB_PART::SetFields( const std::vector <LIB_FIELD>& aFields )
         field->SetParent( this );
         m_drawings.push_back( field );
     }
+
+    touch();
 }
 
 
@@ -919,12 +967,15 @@ void LIB_PART::SetOffset( const wxPoint& aOffset )
 {
     for( LIB_ITEM& item : m_drawings )
         item.Offset( aOffset );
+
+    touch();
 }
 
 
 void LIB_PART::RemoveDuplicateDrawItems()
 {
     m_drawings.unique();
+    touch();
 }
 
 
@@ -1062,6 +1113,7 @@ void LIB_PART::SetUnitCount( int aCount, bool aDuplicateDrawItems )
     }
 
     m_unitCount = aCount;
+    touch();
 }
 
 
@@ -1119,6 +1171,8 @@ void LIB_PART::SetConversion( bool aSetConvert, bool aDuplicatePins )
                 ++i;
         }
     }
+
+    touch();
 }
 
 
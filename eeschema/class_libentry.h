@@ -120,6 +120,13 @@ class LIB_PART : public EDA_ITEM, public LIB_TREE_ITEM
     wxString            m_keyWords;         ///< keyword list (used for search for parts by keyword)
     wxString            m_docFileName;      ///< Associate doc file name
 
+    unsigned long long  m_revision;         ///< Unique stamp changed on every modification.
+
+    ///< Flattened copy of a derived symbol, see GetFlattenedPart().
+    std::unique_ptr< LIB_PART > m_flattenedCache;
+    unsigned long long  m_flattenedRevision;        ///< m_revision when cache was built.
+    unsigned long long  m_flattenedParentRevision;  ///< Parent m_revision when cache was built.
+
     static int  m_subpartIdSeparator;       ///< the separator char between
                                             ///< the subpart id and the reference like U1A
                                             ///< ( m_subpartIdSeparator = 0 ) or U1.A or U1-A
@@ -128,6 +135,9 @@ class LIB_PART : public EDA_ITEM, public LIB_TREE_ITEM
                                             ///< or '1' can be used, other values have no sense.
     void deleteAllFields();
 
+    /// Assign a new unique revision stamp, invalidating any cached flattened copy.
+    void touch();
+
 public:
 
     LIB_PART( const wxString& aName, LIB_PART* aParent = nullptr, PART_LIB* aLibrary = nullptr );
@@ -160,6 +170,7 @@ public:
     void SetDescription( const wxString& aDescription )
     {
         m_description = aDescription;
+        touch();
     }
 
     wxString GetDescription() override { return m_description; }
@@ -167,6 +178,7 @@ public:
     void SetKeyWords( const wxString& aKeyWords )
     {
         m_keyWords = aKeyWords;
+        touch();
     }
 
     wxString GetKeyWords() const { return m_keyWords; }
@@ -174,6 +186,7 @@ public:
     void SetDocFileName( const wxString& aDocFileName )
     {
         m_docFileName = aDocFileName;
+        touch();
     }
 
     wxString GetDocFileName() const { return m_docFileName; }
@@ -197,6 +210,7 @@ public:
     void SetFootprintFilters( const wxArrayString& aFootprintFilters )
     {
         m_FootprintList = aFootprintFilters;
+        touch();
     }
 
     void ViewGetLayers( int aLayers[], int& aCount ) const override;
@@ -233,14 +247,14 @@ public:
     bool IsPower() const  { return m_options == ENTRY_POWER; }
     bool IsNormal() const { return m_options == ENTRY_NORMAL; }
 
-    void SetPower()     { m_options = ENTRY_POWER; }
-    void SetNormal()    { m_options = ENTRY_NORMAL; }
+    void SetPower()     { m_options = ENTRY_POWER; touch(); }
+    void SetNormal()    { m_options = ENTRY_NORMAL; touch(); }
 
     /**
      * Set interchangeable the property for part units.
      * @param aLockUnits when true then units are set as not interchangeable.
      */
-    void LockUnits( bool aLockUnits ) { m_unitsLocked = aLockUnits; }
+    void LockUnits( bool aLockUnits ) { m_unitsLocked = aLockUnits; touch(); }
 
     /**
      * Check whether part units are interchangeable.
@@ -547,7 +561,7 @@ public:
      *
      * @param aOffset - The offset in mils.
      */
-    void SetPinNameOffset( int aOffset ) { m_pinNameOffset = aOffset; }
+    void SetPinNameOffset( int aOffset ) { m_pinNameOffset = aOffset; touch(); }
     int GetPinNameOffset() { return m_pinNameOffset; }
 
     /**
@@ -555,7 +569,7 @@ public:
      *
      * @param aShow - True to make the part pin names visible.
      */
-    void SetShowPinNames( bool aShow ) { m_showPinNames = aShow; }
+    void SetShowPinNames( bool aShow ) { m_showPinNames = aShow; touch(); }
     bool ShowPinNames() { return m_showPinNames; }
 
     /**
@@ -563,7 +577,7 @@ public:
      *
      * @param aShow - True to make the part pin numbers visible.
      */
-    void SetShowPinNumbers( bool aShow ) { m_showPinNumbers = aShow; }
+    void SetShowPinNumbers( bool aShow ) { m_showPinNumbers = aShow; touch(); }
     bool ShowPinNumbers() { return m_showPinNumbers; }
 
     /**
@@ -592,6 +606,34 @@ public:
      */
     std::unique_ptr< LIB_PART > Flatten() const;
 
+    /**
+     * Return the flattened version of this symbol without allocating a new copy on each call.
+     *
+     * Root symbols return themselves.  Derived symbols return a cached result of Flatten()
+     * which is rebuilt only when the revision of this symbol or of its parent has changed.
+     * The returned pointer is owned by this symbol and is only valid until the next change
+     * to this symbol or its parent.  This is not thread safe.
+     *
+     * @return the flattened symbol.
+     */
+    LIB_PART* GetFlattenedPart();
+
+    /**
+     * Return the revision stamp of this symbol.
+     *
+     * Stamps are unique across all symbols and change every time the symbol is modified
+     * through the LIB_PART API or ClearCaches() is called.
+     */
+    unsigned long long GetRevision() const { return m_revision; }
+
+    /**
+     * Invalidate any data cached from this symbol.
+     *
+     * Must be called after draw items or fields have been modified directly through
+     * GetDrawItems() or GetField() rather than through the LIB_PART API.
+     */
+    void ClearCaches() { touch(); }
+
     /**
      * Return a list of LIB_ITEM objects separated by unit and convert number.
      *
@@ -474,6 +474,10 @@ void LIB_EDIT_FRAME::OnExportBody( wxCommandEvent& aEvent )
 
 void LIB_EDIT_FRAME::OnModify()
 {
+    // Edits are made directly on the draw items so make sure the flattened copy is rebuilt.
+    if( m_my_part )
+        m_my_part->ClearCaches();
+
     GetScreen()->SetModify();
     storeCurrentPart();
 
@@ -818,7 +822,7 @@ const BOX2I LIB_EDIT_FRAME::GetDocumentExtents() const
     }
     else
     {
-        EDA_RECT boundingBox = m_my_part->Flatten()->GetUnitBoundingBox( m_unit, m_convert );
+        EDA_RECT boundingBox = m_my_part->GetFlattenedPart()->GetUnitBoundingBox( m_unit, m_convert );
         return BOX2I( boundingBox.GetOrigin(), VECTOR2I( boundingBox.GetWidth(),
                                                          boundingBox.GetHeight() ) );
     }
@@ -188,7 +188,7 @@ bool LIB_EDIT_FRAME::LoadComponentFromCurrentLib( const wxString& aAliasName, in
 
     GetScreen()->ClearUndoRedoList();
     m_toolManager->RunAction( ACTIONS::zoomFitScreen, true );
-    SetShowDeMorgan( GetCurPart()->Flatten()->HasConversion() );
+    SetShowDeMorgan( GetCurPart()->GetFlattenedPart()->HasConversion() );
 
     if( aUnit > 0 )
         RebuildSymbolUnitsList();
@@ -532,7 +532,7 @@ void LIB_EDIT_FRAME::UpdateAfterSymbolProperties( wxString* aOldName )
     m_treePane->GetLibTree()->SelectLibId( LIB_ID( lib, m_my_part->GetName() ) );
 
     RebuildSymbolUnitsList();
-    SetShowDeMorgan( GetCurPart()->Flatten()->HasConversion() );
+    SetShowDeMorgan( GetCurPart()->GetFlattenedPart()->HasConversion() );
     updateTitle();
     DisplayCmpDoc();
 
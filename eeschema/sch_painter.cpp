@@ -386,14 +386,7 @@ void SCH_PAINTER::draw( LIB_PART *aPart, int aLayer, bool aDrawFields, int aUnit
     if( !aConvert )
         aConvert = m_schSettings.m_ShowConvert;
 
-    std::unique_ptr< LIB_PART > tmpPart;
-    LIB_PART* drawnPart = aPart;
-
-    if( aPart->IsAlias() )
-    {
-        tmpPart = aPart->Flatten();
-        drawnPart = tmpPart.get();
-    }
+    LIB_PART* drawnPart = aPart->GetFlattenedPart();
 
     for( auto& item : drawnPart->GetDrawItems() )
     {
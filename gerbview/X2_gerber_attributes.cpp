@@ -43,7 +43,9 @@
 
 #include <wx/log.h>
 #include <X2_gerber_attributes.h>
+#include <gerber_file_image.h>
 #include <macros.h>
+#include <richio.h>
 
 /*
  * X2_ATTRIBUTE
@@ -90,7 +92,7 @@ void X2_ATTRIBUTE::DbgListPrms()
         wxLogMessage( m_Prms.Item( ii ) );
 }
 
-bool X2_ATTRIBUTE::ParseAttribCmd( FILE* aFile, char *aBuffer, int aBuffSize, char* &aText,
+bool X2_ATTRIBUTE::ParseAttribCmd( LINE_CHUNK_READER* aFile, char *aBuffer, int aBuffSize, char* &aText,
                                    int& aLineNum )
 {
     // parse a TF, TA, TO ... command and fill m_Prms by the parameters found.
@@ -136,7 +138,7 @@ bool X2_ATTRIBUTE::ParseAttribCmd( FILE* aFile, char *aBuffer, int aBuffSize, ch
         // end of current line, read another one.
         if( aBuffer && aFile )
         {
-            if( fgets( aBuffer, aBuffSize, aFile ) == NULL )
+            if( aFile->ReadChunk( aBuffer, aBuffSize ) == NULL )
             {
                 // end of file
                 ok = false;
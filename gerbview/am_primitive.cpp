@@ -107,8 +107,8 @@ void AM_PRIMITIVE::DrawBasicShape( const GERBER_DRAW_ITEM* aParent,
                             aShapeBuffer.Append( polybuffer[0].x, polybuffer[0].y );}
 
     // Draw the primitive shape for flashed items.
-    static std::vector<wxPoint> polybuffer;     // create a static buffer to avoid a lot of memory reallocation
-    polybuffer.clear();
+    // Not static: shapes can be built by several gerber files being loaded at once.
+    std::vector<wxPoint> polybuffer;
 
     wxPoint curPos = aShapePos;
     D_CODE* tool   = aParent->GetDcodeDescr();
@@ -779,13 +779,13 @@ int AM_PRIMITIVE::GetShapeDim( const GERBER_DRAW_ITEM* aParent )
 }
 
 
-SHAPE_POLY_SET* APERTURE_MACRO::GetApertureMacroShape( const GERBER_DRAW_ITEM* aParent,
-                                                       wxPoint aShapePos )
+void APERTURE_MACRO::BuildApertureMacroShape( const GERBER_DRAW_ITEM* aParent,
+                                              wxPoint aShapePos, SHAPE_POLY_SET& aShape )
 {
     SHAPE_POLY_SET holeBuffer;
     bool hasHole = false;
 
-    m_shape.RemoveAllContours();
+    aShape.RemoveAllContours();
 
     for( AM_PRIMITIVES::iterator prim_macro = primitives.begin();
          prim_macro != primitives.end(); ++prim_macro )
@@ -794,14 +794,14 @@ SHAPE_POLY_SET* APERTURE_MACRO::GetApertureMacroShape( const GERBER_DRAW_ITEM* a
             continue;
 
         if( prim_macro->IsAMPrimitiveExposureOn( aParent ) )
-            prim_macro->DrawBasicShape( aParent, m_shape, aShapePos );
+            prim_macro->DrawBasicShape( aParent, aShape, aShapePos );
         else
         {
             prim_macro->DrawBasicShape( aParent, holeBuffer, aShapePos );
 
             if( holeBuffer.OutlineCount() )     // we have a new hole in shape: remove the hole
             {
-                m_shape.BooleanSubtract( holeBuffer, SHAPE_POLY_SET::PM_FAST );
+                aShape.BooleanSubtract( holeBuffer, SHAPE_POLY_SET::PM_FAST );
                 holeBuffer.RemoveAllContours();
                 hasHole = true;
             }
@@ -811,15 +811,7 @@ SHAPE_POLY_SET* APERTURE_MACRO::GetApertureMacroShape( const GERBER_DRAW_ITEM* a
     // If a hole is defined inside a polygon, we must fracture the polygon
     // to be able to drawn it (i.e link holes by overlapping edges)
     if( hasHole )
-        m_shape.Fracture( SHAPE_POLY_SET::PM_FAST );
-
-    m_boundingBox = EDA_RECT( wxPoint( 0, 0 ), wxSize( 1, 1 ) );
-    auto bb = m_shape.BBox();
-    wxPoint center( bb.Centre().x, bb.Centre().y );
-    m_boundingBox.Move( aParent->GetABPosition( center ) );
-    m_boundingBox.Inflate( bb.GetWidth() / 2, bb.GetHeight() / 2 );
-
-    return &m_shape;
+        aShape.Fracture( SHAPE_POLY_SET::PM_FAST );
 }
 
 
@@ -833,14 +825,17 @@ void APERTURE_MACRO::DrawApertureMacroShape( GERBER_DRAW_ITEM* aParent,
                                              COLOR4D aColor,
                                              wxPoint aShapePos, bool aFilledShape )
 {
-    SHAPE_POLY_SET* shapeBuffer = GetApertureMacroShape( aParent, aShapePos );
+    // The cached shape is relative to the flash position: move a copy to aShapePos
+    SHAPE_POLY_SET shapeBuffer = aParent->GetDcodeDescr()->GetMacroShape( aParent );
 
-    if( shapeBuffer->OutlineCount() == 0 )
+    if( shapeBuffer.OutlineCount() == 0 )
         return;
 
-    for( int ii = 0; ii < shapeBuffer->OutlineCount(); ii++ )
+    shapeBuffer.Move( VECTOR2I( aParent->GetABPosition( aShapePos ) ) );
+
+    for( int ii = 0; ii < shapeBuffer.OutlineCount(); ii++ )
     {
-        SHAPE_LINE_CHAIN& poly = shapeBuffer->Outline( ii );
+        SHAPE_LINE_CHAIN& poly = shapeBuffer.Outline( ii );
 
         GRClosedPoly( aClipBox, aDC, poly.PointCount(), (wxPoint*) &poly.CPoint( 0 ), aFilledShape,
                 aColor, aColor );
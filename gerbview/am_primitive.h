@@ -173,9 +173,6 @@ struct APERTURE_MACRO
      */
     AM_PARAMS m_localparamStack;
 
-    SHAPE_POLY_SET m_shape;     ///< The shape of the item, calculated by GetApertureMacroShape
-    EDA_RECT m_boundingBox;     ///< The bounding box of the item, calculated by GetApertureMacroShape
-
     /**
      * function GetLocalParam
      * Usually, parameters are defined inside the aperture primitive
@@ -191,13 +188,17 @@ struct APERTURE_MACRO
 
 
     /**
-     * Function GetApertureMacroShape
+     * Function BuildApertureMacroShape
      * Calculate the primitive shape for flashed items.
      * When an item is flashed, this is the shape of the item
+     * Items use the shape cached by their D_CODE (see D_CODE::GetMacroShape), which
+     * calls this function only once per D_CODE and layer transform.
      * @param aParent = the parent GERBER_DRAW_ITEM which is actually drawn
-     * @return The shape of the item
+     * @param aShapePos = the actual shape position
+     * @param aShape = the buffer to fill with the shape of the item, in AB coordinates
      */
-    SHAPE_POLY_SET* GetApertureMacroShape( const GERBER_DRAW_ITEM* aParent, wxPoint aShapePos );
+    void BuildApertureMacroShape( const GERBER_DRAW_ITEM* aParent, wxPoint aShapePos,
+                                  SHAPE_POLY_SET& aShape );
 
    /**
      * Function DrawApertureMacroShape
@@ -226,12 +227,6 @@ struct APERTURE_MACRO
      * @return a dimension, or -1 if no dim to calculate
      */
     int  GetShapeDim( GERBER_DRAW_ITEM* aParent );
-
-    /// Returns the bounding box of the shape
-    EDA_RECT GetBoundingBox() const
-    {
-        return m_boundingBox;
-    }
 };
 
 
@@ -87,6 +87,39 @@ void D_CODE::Clear_D_CODE_Data()
     m_Rotation   = 0.0;
     m_EdgesCount = 0;
     m_Polygon.RemoveAllContours();
+    m_MacroShape.RemoveAllContours();
+    m_MacroShapeValid = false;
+}
+
+
+void D_CODE::updateMacroShape( const GERBER_DRAW_ITEM* aParent )
+{
+    wxASSERT( aParent->GetDcodeDescr() == this );
+
+    // GetABPosition() is a linear transform followed by a translation. The shape is cached
+    // relative to the flash position, so only the linear part (swap axis, scale, rotation and
+    // mirror) must match the cached one.
+    const int unit = Millimeter2iu( 10 );
+    wxPoint origin = aParent->GetABPosition( wxPoint( 0, 0 ) );
+    wxPoint axisX  = aParent->GetABPosition( wxPoint( unit, 0 ) ) - origin;
+    wxPoint axisY  = aParent->GetABPosition( wxPoint( 0, unit ) ) - origin;
+
+    if( m_MacroShapeValid && axisX == m_MacroShapeAxisX && axisY == m_MacroShapeAxisY )
+        return;
+
+    m_MacroShape.RemoveAllContours();
+
+    if( m_Macro )
+    {
+        // Build the shape flashed at (0,0), and remove the translation part of the transform
+        m_Macro->BuildApertureMacroShape( aParent, wxPoint( 0, 0 ), m_MacroShape );
+        m_MacroShape.Move( VECTOR2I( -origin.x, -origin.y ) );
+    }
+
+    m_MacroShapeBBox  = m_MacroShape.BBox();
+    m_MacroShapeAxisX = axisX;
+    m_MacroShapeAxisY = axisY;
+    m_MacroShapeValid = true;
 }
 
 
@@ -90,6 +90,24 @@ private:
      */
     std::vector<double>   m_am_params;
 
+    /**
+     * Aperture macro shape cache. The shape only depends on the parameters of this D_CODE
+     * and on the layer transform, so it is built once in AB coordinates relative to the flash
+     * position, and shared by all the items flashed with this D_CODE.
+     */
+    SHAPE_POLY_SET        m_MacroShape;
+    BOX2I                 m_MacroShapeBBox;
+    bool                  m_MacroShapeValid;
+    wxPoint               m_MacroShapeAxisX;    ///< image of the X axis unit by the cached
+    wxPoint               m_MacroShapeAxisY;    ///< layer transform (idem for Y axis)
+
+    /**
+     * Function updateMacroShape
+     * (re)builds the cached aperture macro shape if the layer transform of aParent
+     * is not the one used to build it.
+     */
+    void updateMacroShape( const GERBER_DRAW_ITEM* aParent );
+
 public:
     wxSize                m_Size;           ///< Horizontal and vertical dimensions.
     APERTURE_T            m_Shape;          ///< shape ( Line, rectangle, circle , oval .. )
@@ -122,6 +140,7 @@ public:
     void AppendParam( double aValue )
     {
         m_am_params.push_back( aValue );
+        m_MacroShapeValid = false;
     }
 
     /**
@@ -151,11 +170,35 @@ public:
     void SetMacro( APERTURE_MACRO* aMacro )
     {
         m_Macro = aMacro;
+        m_MacroShapeValid = false;
     }
 
 
     APERTURE_MACRO* GetMacro() const { return m_Macro; }
 
+    /**
+     * Function GetMacroShape
+     * returns the shape of the aperture macro of this D_CODE, flashed by aParent.
+     * The shape is in AB coordinates, relative to the flash position: it must be
+     * moved by aParent->GetABPosition( aParent->m_Start ) to be drawn.
+     * @param aParent = a GERBER_DRAW_ITEM flashed with this D_CODE
+     */
+    const SHAPE_POLY_SET& GetMacroShape( const GERBER_DRAW_ITEM* aParent )
+    {
+        updateMacroShape( aParent );
+        return m_MacroShape;
+    }
+
+    /**
+     * Function GetMacroShapeBBox
+     * @return the bounding box of GetMacroShape(), relative to the flash position
+     */
+    const BOX2I& GetMacroShapeBBox( const GERBER_DRAW_ITEM* aParent )
+    {
+        updateMacroShape( aParent );
+        return m_MacroShapeBBox;
+    }
+
     /**
      * Function ShowApertureType
      * returns a character string telling what type of aperture type \a aType is.
@@ -171,6 +171,16 @@ public: EXCELLON_IMAGE( int layer ) :
      */
     bool LoadFile( const wxString& aFullFileName );
 
+    /**
+     * Read and load drill (EXCELLON format) data from any source, for instance an archive
+     * member held in memory.
+     * @param aReader is the source of the drill data.
+     * @param aFileName is the file name to associate with the image.
+     * @return bool if OK, false if the drill data was not loaded or could not be read
+     *         to the end (the read error is the last message in m_messagesList)
+     */
+    bool LoadFile( LINE_READER& aReader, const wxString& aFileName );
+
 private:
     bool Execute_HEADER_And_M_Command( char*& text );
     bool Select_Tool( char*& text );
@@ -242,56 +242,6 @@ static EXCELLON_CMD excellon_G_CmdList[] =
 };
 
 
-bool GERBVIEW_FRAME::Read_EXCELLON_File( const wxString& aFullFileName )
-{
-    wxString msg;
-    int layerId = GetActiveLayer();      // current layer used in GerbView
-    GERBER_FILE_IMAGE_LIST* images = GetGerberLayout()->GetImagesList();
-    auto gerber_layer = images->GetGbrImage( layerId );
-
-    // OIf the active layer contains old gerber or nc drill data, remove it
-    if( gerber_layer )
-        Erase_Current_DrawLayer( false );
-
-    EXCELLON_IMAGE* drill_layer = new EXCELLON_IMAGE( layerId );
-
-    // Read the Excellon drill file:
-    bool success = drill_layer->LoadFile( aFullFileName );
-
-    if( !success )
-    {
-        delete drill_layer;
-        msg.Printf( _( "File %s not found" ), aFullFileName );
-        DisplayError( this, msg );
-        return false;
-    }
-
-    layerId = images->AddGbrImage( drill_layer, layerId );
-
-    if( layerId < 0 )
-    {
-        delete drill_layer;
-        DisplayError( this, _( "No room to load file" ) );
-        return false;
-    }
-
-    // Display errors list
-    if( drill_layer->GetMessages().size() > 0 )
-    {
-        HTML_MESSAGE_BOX dlg( this, _( "Error reading EXCELLON drill file" ) );
-        dlg.ListSet( drill_layer->GetMessages() );
-        dlg.ShowModal();
-    }
-
-    if( GetCanvas() )
-    {
-        for( GERBER_DRAW_ITEM* item : drill_layer->GetItems() )
-            GetCanvas()->GetView()->Add( (KIGFX::VIEW_ITEM*) item );
-    }
-
-    return success;
-}
-
 /*
  * Read a EXCELLON file.
  * Gerber classes are used because there is likeness between Gerber files
@@ -306,30 +256,49 @@ bool GERBVIEW_FRAME::Read_EXCELLON_File( const wxString& aFullFileName )
  */
 
 bool EXCELLON_IMAGE::LoadFile( const wxString & aFullFileName )
+{
+    FILE* file = wxFopen( aFullFileName, "rt" );
+
+    if( file == NULL )
+        return false;
+
+    // FILE_LINE_READER will close the file.
+    FILE_LINE_READER excellonReader( file, aFullFileName );
+
+    return LoadFile( excellonReader, aFullFileName );
+}
+
+
+bool EXCELLON_IMAGE::LoadFile( LINE_READER& aReader, const wxString& aFileName )
 {
     // Set the default parmeter values:
     ResetDefaultValues();
     ClearMessageList();
 
-    m_Current_File = wxFopen( aFullFileName, "rt" );
-
-    if( m_Current_File == NULL )
-        return false;
+    // Drill files are read line by line from aReader, not through the RS274X line buffer
+    m_Current_File = NULL;
 
     wxString msg;
-    m_FileName = aFullFileName;
+    m_FileName = aFileName;
 
     LOCALE_IO toggleIo;
 
-    // FILE_LINE_READER will close the file.
-    FILE_LINE_READER excellonReader( m_Current_File, m_FileName );
-
     while( true )
     {
-        if( excellonReader.ReadLine() == 0 )
-            break;
+        try
+        {
+            if( aReader.ReadLine() == 0 )
+                break;
+        }
+        catch( const IO_ERROR& ioe )
+        {
+            // A read error (e.g. a line too long for the reader): the image is incomplete
+            AddMessageToList( ioe.What() );
+            m_Current_File = NULL;
+            return false;
+        }
 
-        char* line = excellonReader.Line();
+        char* line = aReader.Line();
         char* text = StrPurge( line );
 
         if( *text == ';' || *text == 0 )       // comment: skip line or empty malformed line
@@ -388,6 +357,7 @@ bool EXCELLON_IMAGE::LoadFile( const wxString & aFullFileName )
     delete m_FileFunction;
     m_FileFunction = new X2_ATTRIBUTE_FILEFUNCTION( dummy );
 
+    m_Current_File = NULL;
     m_InUse = true;
 
     return true;
@@ -24,6 +24,7 @@
 
 #include <fctsys.h>
 #include <wx/wfstream.h>
+#include <wx/mstream.h>
 #include <wx/zipstrm.h>
 #include <common.h>
 #include <reporter.h>
@@ -36,6 +37,12 @@
 #include <gerbview_layer_widget.h>
 #include <wildcards_and_files_ext.h>
 #include <widgets/progress_reporter.h>
+#include <view/view.h>
+
+#include <atomic>
+#include <future>
+#include <memory>
+#include <thread>
 
 // HTML Messages used more than one time:
 #define MSG_NO_MORE_LAYER _( "<b>No more available layers in Gerbview to load files" )
@@ -259,15 +266,12 @@ bool GERBVIEW_FRAME::loadListOfGerberAndDrillFiles( const wxString& aPath,
 
     // Read gerber files: each file is loaded on a new GerbView layer
     bool success = true;
-    int layer = GetActiveLayer();
-    LSET visibility = GetVisibleLayers();
 
     // Manage errors when loading files
     wxString msg;
     WX_STRING_REPORTER reporter( &msg );
 
-    // Create progress dialog (only used if more than 1 file to load
-    std::unique_ptr<WX_PROGRESS_REPORTER> progress = nullptr;
+    std::vector<GERBER_SOURCE> sources;
 
     for( unsigned ii = 0; ii < aFilenameList.GetCount(); ii++ )
     {
@@ -290,73 +294,21 @@ bool GERBVIEW_FRAME::loadListOfGerberAndDrillFiles( const wxString& aPath,
 
         m_lastFileName = filename.GetFullPath();
 
-        if( !progress && ( aFilenameList.GetCount() > 1 ) )
-        {
-            progress = std::make_unique<WX_PROGRESS_REPORTER>( this,
-                            _( "Loading Gerber files..." ), 1, false );
-            progress->SetMaxProgress( aFilenameList.GetCount() - 1 );
-            progress->Report( wxString::Format( _("Loading %u/%zu %s" ), ii+1,
-                                            aFilenameList.GetCount(), m_lastFileName ) );
-        }
-        else if( progress )
-        {
-            progress->Report( wxString::Format( _("Loading %u/%zu %s" ), ii+1,
-                                            aFilenameList.GetCount(), m_lastFileName ) );
-            progress->KeepRefreshing();
-        }
-
-        SetActiveLayer( layer, false );
-
-        visibility[ layer ] = true;
-
-        if( aFileType && (*aFileType)[ii] == 1 )
-        {
-            LoadExcellonFiles( filename.GetFullPath() );
-            layer = GetActiveLayer();   // Loading NC drill file changes the active layer
-        }
-        else
-        {
-            if( Read_GERBER_File( filename.GetFullPath() ) )
-            {
-                UpdateFileHistory( m_lastFileName );
-
-                layer = getNextAvailableLayer( layer );
-
-                if( layer == NO_AVAILABLE_LAYERS && ii < aFilenameList.GetCount()-1 )
-                {
-                    success = false;
-                    reporter.Report( MSG_NO_MORE_LAYER, RPT_SEVERITY_ERROR );
-
-                    // Report the name of not loaded files:
-                    ii += 1;
-                    while( ii < aFilenameList.GetCount() )
-                    {
-                        filename = aFilenameList[ii++];
-                        wxString txt = wxString::Format( MSG_NOT_LOADED, filename.GetFullName() );
-                        reporter.Report( txt, RPT_SEVERITY_ERROR );
-                    }
-                    break;
-                }
-
-                SetActiveLayer( layer, false );
-            }
-        }
-
-        if( progress )
-            progress->AdvanceProgress();
+        sources.emplace_back( filename.GetFullPath(), aFileType && (*aFileType)[ii] == 1 );
     }
 
-    if( !success )
+    if( !loadSources( sources, reporter, true ) )
+        success = false;
+
+    if( !msg.IsEmpty() )
     {
         wxSafeYield();  // Allows slice of time to redraw the screen
                         // to refresh widgets, before displaying messages
-        HTML_MESSAGE_BOX mbox( this, _( "Errors" ) );
+        HTML_MESSAGE_BOX mbox( this, success ? _( "Messages" ) : _( "Errors" ) );
         mbox.ListSet( msg );
         mbox.ShowModal();
     }
 
-    SetVisibleLayers( visibility );
-
     Zoom_Automatique( false );
 
     // Synchronize layers tools with actual active layer:
@@ -367,7 +319,7 @@ bool GERBVIEW_FRAME::loadListOfGerberAndDrillFiles( const wxString& aPath,
     // we need to set it to a blank layer in case they load another file.
     // We can't start with the next available layer when loading files because
     // some users expect the behavior of overwriting the active layer on load.
-    SetActiveLayer( getNextAvailableLayer( layer ), true );
+    SetActiveLayer( getNextAvailableLayer( GetActiveLayer() ), true );
 
     m_LayersManager->UpdateLayerIcons();
     syncLayerBox( true );
@@ -378,6 +330,233 @@ bool GERBVIEW_FRAME::loadListOfGerberAndDrillFiles( const wxString& aPath,
 }
 
 
+/**
+ * Parse one Gerber or NC drill source into a new image.
+ *
+ * Called from the loader threads: only the returned image and \a aError are modified.
+ *
+ * @param aError receives the reason when the source cannot be read, if one is known.
+ * @return the image, or nullptr if the source cannot be read.
+ */
+static GERBER_FILE_IMAGE* parseSource( const GERBER_SOURCE& aSource, wxString& aError )
+{
+    std::unique_ptr<LINE_READER> reader;
+
+    try
+    {
+        if( aSource.m_InMemory )
+            reader.reset( new STRING_LINE_READER( aSource.m_Data, aSource.m_FileName ) );
+        else
+            reader.reset( new FILE_LINE_READER( aSource.m_FileName ) );
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        aError = ioe.What();
+        return nullptr;
+    }
+
+    // The graphic layer is assigned when the image is added to the images list.
+    if( aSource.m_IsDrill )
+    {
+        std::unique_ptr<EXCELLON_IMAGE> drill_layer( new EXCELLON_IMAGE( 0 ) );
+
+        if( !drill_layer->LoadFile( *reader, aSource.m_FileName ) )
+        {
+            if( !drill_layer->GetMessages().IsEmpty() )
+                aError = drill_layer->GetMessages().Last();
+
+            return nullptr;
+        }
+
+        return drill_layer.release();
+    }
+
+    std::unique_ptr<GERBER_FILE_IMAGE> gerber( new GERBER_FILE_IMAGE( 0 ) );
+
+    if( !gerber->LoadGerberFile( *reader, aSource.m_FileName ) )
+    {
+        if( !gerber->GetMessages().IsEmpty() )
+            aError = gerber->GetMessages().Last();
+
+        return nullptr;
+    }
+
+    return gerber.release();
+}
+
+
+bool GERBVIEW_FRAME::loadSources( std::vector<GERBER_SOURCE>& aSources, REPORTER& aReporter,
+                                  bool aUpdateHistory )
+{
+    if( aSources.empty() )
+        return true;
+
+    std::vector<std::unique_ptr<GERBER_FILE_IMAGE>> images( aSources.size() );
+    std::vector<wxString> errors( aSources.size() );
+    std::unique_ptr<WX_PROGRESS_REPORTER> progress;
+
+    if( aSources.size() > 1 )
+    {
+        progress = std::make_unique<WX_PROGRESS_REPORTER>( this, _( "Loading Gerber files..." ),
+                                                           1, false );
+        progress->SetMaxProgress( aSources.size() );
+        progress->Report( wxString::Format( _( "Loading %zu files" ), aSources.size() ) );
+        progress->KeepRefreshing();
+    }
+
+    {
+        // The parsers need the C locale.  Switch it once here, so the loader threads never
+        // switch it themselves while other threads are parsing.
+        LOCALE_IO toggleIo;
+
+        std::atomic<size_t> nextSource( 0 );
+        size_t              parallelThreadCount =
+                std::min<size_t>( std::thread::hardware_concurrency(), aSources.size() );
+        std::vector<std::future<size_t>> returns( parallelThreadCount );
+
+        auto parse_lambda = [&]() -> size_t
+        {
+            size_t num = 0;
+
+            for( size_t i = nextSource++; i < aSources.size(); i = nextSource++ )
+            {
+                images[i].reset( parseSource( aSources[i], errors[i] ) );
+
+                // The in-memory copy is no longer needed
+                std::string().swap( aSources[i].m_Data );
+
+                if( progress )
+                    progress->AdvanceProgress();
+
+                num++;
+            }
+
+            return num;
+        };
+
+        if( parallelThreadCount <= 1 )
+            parse_lambda();
+        else
+        {
+            for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+                returns[ii] = std::async( std::launch::async, parse_lambda );
+
+            for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            {
+                // Here we balance returns with a 100ms timeout to allow UI updating
+                std::future_status status;
+                do
+                {
+                    if( progress )
+                        progress->KeepRefreshing();
+
+                    status = returns[ii].wait_for( std::chrono::milliseconds( 100 ) );
+                } while( status != std::future_status::ready );
+            }
+        }
+    }
+
+    // Now add the images to the layers, in order.  This touches the GUI and the view so it
+    // stays on the main thread.
+    GERBER_FILE_IMAGE_LIST* imagesList = GetImagesList();
+    LSET visibility = GetVisibleLayers();
+    int  layer = GetActiveLayer();
+    bool success = true;
+    bool reported_no_more_layer = false;
+    wxString msg;
+
+    for( size_t ii = 0; ii < aSources.size(); ++ii )
+    {
+        const GERBER_SOURCE& source = aSources[ii];
+        wxFileName fn( source.m_FileName );
+
+        if( !images[ii] )
+        {
+            success = false;
+            msg.Printf( _( "<b>File \"%s\" read error</b>\n" ), source.m_FileName );
+            aReporter.Report( msg, RPT_SEVERITY_ERROR );
+
+            if( !errors[ii].IsEmpty() )
+                aReporter.Report( errors[ii], RPT_SEVERITY_ERROR );
+            continue;
+        }
+
+        if( layer == NO_AVAILABLE_LAYERS )
+        {
+            success = false;
+
+            if( !reported_no_more_layer )
+                aReporter.Report( MSG_NO_MORE_LAYER, RPT_SEVERITY_ERROR );
+
+            reported_no_more_layer = true;
+
+            // Report the name of not loaded files:
+            msg.Printf( MSG_NOT_LOADED, fn.GetFullName() );
+            aReporter.Report( msg, RPT_SEVERITY_ERROR );
+            continue;
+        }
+
+        SetActiveLayer( layer, false );
+
+        // If the layer contains old gerber or nc drill data, remove it
+        if( GetGbrImage( layer ) )
+            Erase_Current_DrawLayer( false );
+
+        GERBER_FILE_IMAGE* gerber = images[ii].release();
+        gerber->m_GraphicLayer = layer;
+        imagesList->AddGbrImage( gerber, layer );
+        visibility[ layer ] = true;
+
+        // Collect the parser messages, which were previously displayed file by file
+        if( gerber->GetMessages().size() > 0 )
+        {
+            msg.Printf( _( "<b>Messages for \"%s\":</b>" ), fn.GetFullName() );
+            aReporter.Report( msg, RPT_SEVERITY_WARNING );
+
+            for( const wxString& message : gerber->GetMessages() )
+                aReporter.Report( message, RPT_SEVERITY_WARNING );
+        }
+
+        /* if the gerber file has items using D codes but missing D codes definitions,
+         * it can be a deprecated RS274D file (i.e. without any aperture information),
+         * or has missing definitions, warn the user:
+         */
+        if( !source.m_IsDrill && gerber->GetItemsCount() && gerber->m_Has_MissingDCode )
+        {
+            if( !gerber->m_Has_DCode )
+                msg.Printf( _( "Warning: \"%s\" has no D-Code definition\n"
+                               "Therefore the size of some items is undefined" ),
+                            fn.GetFullName() );
+            else
+                msg.Printf( _( "Warning: \"%s\" has some missing D-Code definitions\n"
+                               "Therefore the size of some items is undefined" ),
+                            fn.GetFullName() );
+
+            aReporter.Report( msg, RPT_SEVERITY_WARNING );
+        }
+
+        if( GetCanvas() )
+        {
+            for( GERBER_DRAW_ITEM* item : gerber->GetItems() )
+                GetCanvas()->GetView()->Add( (KIGFX::VIEW_ITEM*) item );
+        }
+
+        if( aUpdateHistory )
+            UpdateFileHistory( source.m_FileName,
+                               source.m_IsDrill ? &m_drillFileHistory : nullptr );
+
+        layer = getNextAvailableLayer( layer );
+    }
+
+    if( layer != NO_AVAILABLE_LAYERS )
+        SetActiveLayer( layer, false );
+
+    SetVisibleLayers( visibility );
+
+    return success;
+}
+
+
 bool GERBVIEW_FRAME::LoadExcellonFiles( const wxString& aFullFileName )
 {
     wxString   filetypes;
@@ -418,13 +597,12 @@ bool GERBVIEW_FRAME::LoadExcellonFiles( const wxString& aFullFileName )
     }
 
     // Read Excellon drill files: each file is loaded on a new GerbView layer
-    bool success = true;
-    int layer = GetActiveLayer();
-
     // Manage errors when loading files
     wxString msg;
     WX_STRING_REPORTER reporter( &msg );
 
+    std::vector<GERBER_SOURCE> sources;
+
     for( unsigned ii = 0; ii < filenamesList.GetCount(); ii++ )
     {
         filename = filenamesList[ii];
@@ -434,38 +612,14 @@ bool GERBVIEW_FRAME::LoadExcellonFiles( const wxString& aFullFileName )
 
         m_lastFileName = filename.GetFullPath();
 
-        SetActiveLayer( layer, false );
-
-        if( Read_EXCELLON_File( filename.GetFullPath() ) )
-        {
-            // Update the list of recent drill files.
-            UpdateFileHistory( filename.GetFullPath(), &m_drillFileHistory );
-
-            layer = getNextAvailableLayer( layer );
-
-            if( layer == NO_AVAILABLE_LAYERS && ii < filenamesList.GetCount()-1 )
-            {
-                success = false;
-                reporter.Report( MSG_NO_MORE_LAYER, RPT_SEVERITY_ERROR );
-
-                // Report the name of not loaded files:
-                ii += 1;
-                while( ii < filenamesList.GetCount() )
-                {
-                    filename = filenamesList[ii++];
-                    wxString txt = wxString::Format( MSG_NOT_LOADED, filename.GetFullName() );
-                    reporter.Report( txt, RPT_SEVERITY_ERROR );
-                }
-                break;
-            }
-
-            SetActiveLayer( layer, false );
-        }
+        sources.emplace_back( filename.GetFullPath(), true );
     }
 
-    if( !success )
+    bool success = loadSources( sources, reporter, true );
+
+    if( !msg.IsEmpty() )
     {
-        HTML_MESSAGE_BOX mbox( this, _( "Errors" ) );
+        HTML_MESSAGE_BOX mbox( this, success ? _( "Messages" ) : _( "Errors" ) );
         mbox.ListSet( msg );
         mbox.ShowModal();
     }
@@ -486,10 +640,6 @@ bool GERBVIEW_FRAME::unarchiveFiles( const wxString& aFullFileName, REPORTER* aR
 {
     wxString msg;
 
-    // Extract the path of aFullFileName. We use it to store temporary files
-    wxFileName fn( aFullFileName );
-    wxString unzipDir = fn.GetPath();
-
     wxFFileInputStream zipFile( aFullFileName );
 
     if( !zipFile.IsOk() )
@@ -506,19 +656,11 @@ bool GERBVIEW_FRAME::unarchiveFiles( const wxString& aFullFileName, REPORTER* aR
     // Update the list of recent zip files.
     UpdateFileHistory( aFullFileName, &m_zipFileHistory );
 
-    // The unzipped file in only a temporary file. Give it a filename
-    // which cannot conflict with an usual filename.
-    // TODO: make Read_GERBER_File() and Read_EXCELLON_File() able to
-    // accept a stream, and avoid using a temp file.
-    wxFileName temp_fn( "$tempfile.tmp" );
-    temp_fn.MakeAbsolute( unzipDir );
-    wxString unzipped_tempfile = temp_fn.GetFullPath();
-
-
+    // The archive members are extracted in memory, then parsed together.
+    std::vector<GERBER_SOURCE> sources;
     bool success = true;
     wxZipInputStream zipArchive( zipFile );
     wxZipEntry* entry;
-    bool reported_no_more_layer = false;
 
     while( ( entry = zipArchive.GetNextEntry() ) )
     {
@@ -526,6 +668,8 @@ bool GERBVIEW_FRAME::unarchiveFiles( const wxString& aFullFileName, REPORTER* aR
         wxFileName uzfn = fname;
         wxString curr_ext = uzfn.GetExt().Lower();
 
+        delete entry;
+
         // The archive contains Gerber and/or Excellon drill files. Use the right loader.
         // However it can contain a few other files (reports, pdf files...),
         // which will be skipped.
@@ -538,93 +682,42 @@ bool GERBVIEW_FRAME::unarchiveFiles( const wxString& aFullFileName, REPORTER* aR
         {
             if( aReporter )
             {
-                msg.Printf( _( "Info: skip file \"%s\" (unknown type)\n" ), entry->GetName() );
+                msg.Printf( _( "Info: skip file \"%s\" (unknown type)\n" ), fname );
                 aReporter->Report( msg, RPT_SEVERITY_WARNING );
             }
 
             continue;
         }
 
-        int layer = GetActiveLayer();
+        wxMemoryOutputStream unzipped;
+        unzipped.Write( zipArchive );
 
-        if( layer == NO_AVAILABLE_LAYERS )
+        if( zipArchive.GetLastError() != wxSTREAM_EOF )
         {
             success = false;
 
             if( aReporter )
             {
-                if( !reported_no_more_layer )
-                    aReporter->Report( MSG_NO_MORE_LAYER,  RPT_SEVERITY_ERROR );
-
-                reported_no_more_layer = true;
-
-                // Report the name of not loaded files:
-                msg.Printf( MSG_NOT_LOADED, GetChars( entry->GetName() ) );
+                msg.Printf( _( "<b>unzipped file %s read error</b>\n" ), fname );
                 aReporter->Report( msg, RPT_SEVERITY_ERROR );
             }
 
-            delete entry;
             continue;
         }
 
-        // Create the unzipped temporary file:
-        {
-            wxFFileOutputStream temporary_ofile( unzipped_tempfile );
-
-            if( temporary_ofile.Ok() )
-                temporary_ofile.Write( zipArchive );
-            else
-            {
-                success = false;
-
-                if( aReporter )
-                {
-                    msg.Printf( _( "<b>Unable to create temporary file \"%s\"</b>\n"),
-                                unzipped_tempfile );
-                    aReporter->Report( msg, RPT_SEVERITY_ERROR );
-                }
-            }
-        }
-
-        bool read_ok = true;
-
-        if( curr_ext[0] == 'g' || curr_ext == "pho" )
-        {
-            // Read gerber files: each file is loaded on a new GerbView layer
-            read_ok = Read_GERBER_File( unzipped_tempfile );
-        }
-        else // if( curr_ext == "drl" )
-        {
-            read_ok = Read_EXCELLON_File( unzipped_tempfile );
-        }
-
-        delete entry;
-
-        // The unzipped file is only a temporary file, delete it.
-        wxRemoveFile( unzipped_tempfile );
+        sources.emplace_back( fname, curr_ext == "drl" );
 
-        if( !read_ok )
-        {
-            success = false;
+        GERBER_SOURCE& source = sources.back();
+        source.m_InMemory = true;
+        source.m_Data.resize( unzipped.GetSize() );
 
-            if( aReporter )
-            {
-                msg.Printf( _("<b>unzipped file %s read error</b>\n"), unzipped_tempfile );
-                aReporter->Report( msg, RPT_SEVERITY_ERROR );
-            }
-        }
-        else
-        {
-            GERBER_FILE_IMAGE* gerber_image = GetGbrImage( layer );
-
-            if( gerber_image )
-                gerber_image->m_FileName = fname;
-
-            layer = getNextAvailableLayer( layer );
-            SetActiveLayer( layer, false );
-        }
+        if( !source.m_Data.empty() )
+            unzipped.CopyTo( &source.m_Data[0], source.m_Data.size() );
     }
 
+    if( !loadSources( sources, aReporter ? *aReporter : NULL_REPORTER::GetInstance(), false ) )
+        success = false;
+
     return success;
 }
 
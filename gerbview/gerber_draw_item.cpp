@@ -368,10 +368,14 @@ const EDA_RECT GERBER_DRAW_ITEM::GetBoundingBox() const
     {
         if( code )
         {
-            // Update the shape drawings and the bounding box coordiantes:
-            code->GetMacro()->GetApertureMacroShape( this, m_Start );
-            // now the bounding box is valid:
-            bbox = code->GetMacro()->GetBoundingBox();
+            // The cached macro shape bounding box is in AB coordinates, relative to the
+            // flash position. Give its corners in XY coordinates: they are converted back
+            // to AB coordinates below.
+            const BOX2I& bb = code->GetMacroShapeBBox( this );
+            wxPoint pos = GetABPosition( m_Start );
+
+            bbox.SetOrigin( GetXYPosition( wxPoint( bb.GetOrigin() ) + pos ) );
+            bbox.SetEnd( GetXYPosition( wxPoint( bb.GetEnd() ) + pos ) );
         }
         break;
     }
@@ -879,9 +883,17 @@ bool GERBER_DRAW_ITEM::HitTest( const wxPoint& aRefPos, int aAccuracy ) const
         }
 
     case GBR_SPOT_MACRO:
-        // Aperture macro polygons are already in absolute coordinates
-        auto p = GetDcodeDescr()->GetMacro()->GetApertureMacroShape( this, m_Start );
-        return p->Contains( VECTOR2I( aRefPos ), -1, aAccuracy );
+    {
+        // Aperture macro shapes are in AB coordinates, relative to the flash position
+        D_CODE*  code = GetDcodeDescr();
+        VECTOR2I rel_pos = VECTOR2I( aRefPos - GetABPosition( m_Start ) );
+        BOX2I    bbox = code->GetMacroShapeBBox( this );
+
+        if( !bbox.Inflate( aAccuracy ).Contains( rel_pos ) )
+            return false;
+
+        return code->GetMacroShape( this ).Contains( rel_pos, -1, aAccuracy );
+    }
     }
 
     // TODO: a better analyze of the shape (perhaps create a D_CODE::HitTest for flashed items)
@@ -964,7 +976,7 @@ unsigned int GERBER_DRAW_ITEM::ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) cons
         switch( m_Shape )
         {
         case GBR_SPOT_MACRO:
-            size = GetDcodeDescr()->GetMacro()->GetBoundingBox().GetWidth();
+            size = GetDcodeDescr()->GetMacroShapeBBox( this ).GetWidth();
             break;
 
         case GBR_ARC:
@@ -41,6 +41,8 @@ typedef std::vector<GERBER_DRAW_ITEM*> GERBER_DRAW_ITEMS;
 
 class GERBVIEW_FRAME;
 class D_CODE;
+class LINE_READER;
+class LINE_CHUNK_READER;
 
 /* gerber files have different parameters to define units and how items must be plotted.
  *  some are for the entire file, and other can change along a file.
@@ -159,7 +161,7 @@ public:
     bool               m_LastCoordIsIJPos;                      // true if a IJ coord was read (for arcs & circles )
     int                m_ArcRadius;                             // A value ( = radius in circular routing in Excellon files )
     LAST_EXTRA_ARC_DATA_TYPE m_LastArcDataType;                 // Identifier for arc data type (IJ (center) or A## (radius))
-    FILE*              m_Current_File;                          // Current file to read
+    LINE_CHUNK_READER* m_Current_File;                          // Current data source to read
 
     int                m_Selected_Tool;                         // For highlight: current selected Dcode
     bool               m_Has_DCode;                             // true = DCodes in file
@@ -199,12 +201,13 @@ private:
      * @param aText = pointer to the last useful char in aBuff
      *          on return: points the beginning of the next line.
      * @param aBuffSize = the size in bytes of aBuff
-     * @param aFile = the opened GERBER file to read
+     * @param aFile = the GERBER data source to read
      * @return a pointer to the beginning of the next line or NULL if end of file
     */
-    char* GetNextLine( char *aBuff, unsigned int aBuffSize, char* aText, FILE* aFile );
+    char* GetNextLine( char *aBuff, unsigned int aBuffSize, char* aText, LINE_CHUNK_READER* aFile );
 
-    bool GetEndOfBlock( char* aBuff, unsigned int aBuffSize, char*& aText, FILE* aGerberFile );
+    bool GetEndOfBlock( char* aBuff, unsigned int aBuffSize, char*& aText,
+                        LINE_CHUNK_READER* aGerberFile );
 
     /**
       * reads a single RS274X command terminated with a %
@@ -238,7 +241,7 @@ private:
      * @return bool - true if a macro was read in successfully, else false.
      */
     bool ReadApertureMacro( char *aBuff, unsigned int aBuffSize,
-                            char* & text, FILE * gerber_file );
+                            char* & text, LINE_CHUNK_READER* gerber_file );
 
     // functions to execute G commands or D basic commands:
     bool    Execute_G_Command( char*& text, int G_command );
@@ -262,6 +265,20 @@ public:
      */
     bool LoadGerberFile( const wxString& aFullFileName );
 
+    /**
+     * Read and load gerber data from any source, for instance an archive member held
+     * in memory.
+     *
+     * Only this image is modified, so several images can be loaded concurrently provided
+     * the caller holds a LOCALE_IO for the duration of the loads.
+     *
+     * @param aReader is the source of the gerber data.
+     * @param aFileName is the file name to associate with the image.
+     * @return bool if OK, false if the gerber data was not loaded or could not be read
+     *         to the end (the read error is the last message in m_messagesList)
+     */
+    bool LoadGerberFile( LINE_READER& aReader, const wxString& aFileName );
+
     const wxArrayString& GetMessages() const { return m_messagesList; }
 
     /**
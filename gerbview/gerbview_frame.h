@@ -45,6 +45,26 @@ class GERBER_FILE_IMAGE_LIST;
 class REPORTER;
 
 
+/**
+ * A Gerber or NC drill file queued for loading.
+ *
+ * Files on disk are read directly by the parser; archive members are held in memory.
+ */
+struct GERBER_SOURCE
+{
+    wxString    m_FileName;     ///< Full path on disk, or member name inside an archive
+    bool        m_IsDrill;      ///< true for an Excellon drill file
+    bool        m_InMemory;     ///< true if m_Data holds the content of the file
+    std::string m_Data;         ///< File content, when m_InMemory is set
+
+    GERBER_SOURCE( const wxString& aFileName, bool aIsDrill ) :
+            m_FileName( aFileName ),
+            m_IsDrill( aIsDrill ),
+            m_InMemory( false )
+    {}
+};
+
+
 /**
  * GERBVIEW_FRAME
  * is the main window used in GerbView.
@@ -210,6 +230,20 @@ private:
                                         const wxArrayString& aFilenameList,
                                         const std::vector<int>* aFileType = nullptr );
 
+    /**
+     * Parse a list of Gerber and NC drill sources concurrently, then add each image to
+     * the next available layer, starting at the active layer.
+     *
+     * The active layer is left on the first layer after the loaded ones, if any.
+     *
+     * @param aSources is the list of sources to load, in layer order.
+     * @param aReporter collects the warning and error messages.
+     * @param aUpdateHistory is true to add the loaded files to the recent files lists.
+     * @return true if every source was loaded
+     */
+    bool loadSources( std::vector<GERBER_SOURCE>& aSources, REPORTER& aReporter,
+                      bool aUpdateHistory );
+
 public:
     GERBVIEW_FRAME( KIWAY* aKiway, wxWindow* aParent );
     ~GERBVIEW_FRAME();
@@ -509,7 +543,6 @@ public:
      * @return true if file was opened successfully.
      */
     bool LoadGerberFiles( const wxString& aFileName );
-    bool Read_GERBER_File( const wxString&   GERBER_FullFileName );
 
     /**
      * function LoadExcellonFiles
@@ -520,7 +553,6 @@ public:
      * @return true if file was opened successfully.
      */
     bool LoadExcellonFiles( const wxString& aFileName );
-    bool Read_EXCELLON_File( const wxString& aFullFileName );
 
     /**
      * function LoadZipArchiveFileLoadZipArchiveFile
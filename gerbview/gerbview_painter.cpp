@@ -565,20 +565,26 @@ void GERBVIEW_PAINTER::drawFlashedShape( GERBER_DRAW_ITEM* aItem, bool aFilled )
 void GERBVIEW_PAINTER::drawApertureMacro( GERBER_DRAW_ITEM* aParent, bool aFilled )
 {
     D_CODE* code = aParent->GetDcodeDescr();
-    APERTURE_MACRO* macro = code->GetMacro();
 
-    SHAPE_POLY_SET* macroShape = macro->GetApertureMacroShape( aParent, aParent->m_Start );
+    // The macro shape is shared by all the items flashed with this D_CODE, and is
+    // relative to the flash position: draw it translated to this position
+    const SHAPE_POLY_SET& macroShape = code->GetMacroShape( aParent );
 
     if( !m_gerbviewSettings.m_polygonFill )
         m_gal->SetLineWidth( m_gerbviewSettings.m_outlineWidth );
 
+    m_gal->Save();
+    m_gal->Translate( VECTOR2D( aParent->GetABPosition( aParent->m_Start ) ) );
+
     if( !aFilled )
     {
-        for( int i = 0; i < macroShape->OutlineCount(); i++ )
-            m_gal->DrawPolyline( macroShape->COutline( i ) );
+        for( int i = 0; i < macroShape.OutlineCount(); i++ )
+            m_gal->DrawPolyline( macroShape.COutline( i ) );
     }
     else
-        m_gal->DrawPolygon( *macroShape );
+        m_gal->DrawPolygon( macroShape );
+
+    m_gal->Restore();
 }
 
 
@@ -34,87 +34,30 @@
 
 #include <html_messagebox.h>
 #include <macros.h>
+#include <richio.h>
 
-/* Read a gerber file, RS274D, RS274X or RS274X2 format.
- */
-bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName )
-{
-    wxString msg;
-
-    int layer = GetActiveLayer();
-    GERBER_FILE_IMAGE_LIST* images = GetImagesList();
-    GERBER_FILE_IMAGE* gerber = GetGbrImage( layer );
+#include <memory>
 
-    if( gerber != NULL )
-    {
-        Erase_Current_DrawLayer( false );
-    }
+// size of a single line of text from a gerber file.
+// warning: some files can have *very long* lines, so the buffer must be large.
+#define GERBER_BUFZ 1000000
 
-    gerber = new GERBER_FILE_IMAGE( layer );
 
-    // Read the gerber file. The image will be added only if it can be read
-    // to avoid broken data.
-    bool success = gerber->LoadGerberFile( GERBER_FullFileName );
+bool GERBER_FILE_IMAGE::LoadGerberFile( const wxString& aFullFileName )
+{
+    FILE* file = wxFopen( aFullFileName, wxT( "rt" ) );
 
-    if( !success )
-    {
-        delete gerber;
-        msg.Printf( _( "File \"%s\" not found" ), GERBER_FullFileName );
-        DisplayError( this, msg, 10 );
+    if( file == NULL )
         return false;
-    }
-
-    images->AddGbrImage( gerber, layer );
 
-    // Display errors list
-    if( gerber->GetMessages().size() > 0 )
-    {
-        HTML_MESSAGE_BOX dlg( this, _("Errors") );
-        dlg.ListSet(gerber->GetMessages());
-        dlg.ShowModal();
-    }
+    // FILE_LINE_READER will close the file.
+    FILE_LINE_READER reader( file, aFullFileName );
 
-    /* if the gerber file has items using D codes but missing D codes definitions,
-     * it can be a deprecated RS274D file (i.e. without any aperture information),
-     * or has missing definitions,
-     * warn the user:
-     */
-    if( gerber->GetItemsCount() && gerber->m_Has_MissingDCode )
-    {
-        if( !gerber->m_Has_DCode )
-            msg = _("Warning: this file has no D-Code definition\n"
-                    "Therefore the size of some items is undefined");
-        else
-            msg = _("Warning: this file has some missing D-Code definitions\n"
-                    "Therefore the size of some items is undefined");
-
-        wxMessageBox( msg );
-    }
-
-    if( GetCanvas() )
-    {
-        if( gerber->m_ImageNegative )
-        {
-            // TODO: find a way to handle negative images
-            // (maybe convert geometry into positives?)
-        }
-
-        for( auto item : gerber->GetItems() )
-            GetCanvas()->GetView()->Add( (KIGFX::VIEW_ITEM*) item );
-    }
-
-    return true;
+    return LoadGerberFile( reader, aFullFileName );
 }
 
 
-
-// size of a single line of text from a gerber file.
-// warning: some files can have *very long* lines, so the buffer must be large.
-#define GERBER_BUFZ 1000000
-// A large buffer to store one line
-static char lineBuffer[GERBER_BUFZ+1];
-
-bool GERBER_FILE_IMAGE::LoadGerberFile( const wxString& aFullFileName )
+bool GERBER_FILE_IMAGE::LoadGerberFile( LINE_READER& aReader, const wxString& aFileName )
 {
     int      G_command = 0;        // command number for G commands like G04
     int      D_commande = 0;       // command number for D commands like D02
@@ -123,101 +66,113 @@ bool GERBER_FILE_IMAGE::LoadGerberFile( const wxString& aFullFileName )
     ClearMessageList( );
     ResetDefaultValues();
 
-    // Read the gerber file */
-    m_Current_File = wxFopen( aFullFileName, wxT( "rt" ) );
+    // The parser works on a fixed size buffer: longer lines are read in several chunks
+    LINE_CHUNK_READER chunkReader( aReader );
 
-    if( m_Current_File == 0 )
-        return false;
+    m_Current_File = &chunkReader;
+    m_FileName = aFileName;
 
-    m_FileName = aFullFileName;
+    // A large buffer to store one line.  Not static, so several images can be read at once.
+    std::unique_ptr<char[]> buffer( new char[GERBER_BUFZ + 1] );
+    char* lineBuffer = buffer.get();
 
     LOCALE_IO toggleIo;
 
     wxString msg;
 
-    while( true )
+    try
     {
-        if( fgets( lineBuffer, GERBER_BUFZ, m_Current_File ) == NULL )
-            break;
-
-        m_LineNum++;
-        text = StrPurge( lineBuffer );
-
-        while( text && *text )
+        while( true )
         {
-            switch( *text )
-            {
-            case ' ':
-            case '\r':
-            case '\n':
-                text++;
-                break;
-
-            case '*':       // End command
-                m_CommandState = END_BLOCK;
-                text++;
-                break;
-
-            case 'M':       // End file
-                m_CommandState = CMD_IDLE;
-                while( *text )
-                    text++;
-                break;
-
-            case 'G':    /* Line type Gxx : command */
-                G_command = GCodeNumber( text );
-                Execute_G_Command( text, G_command );
+            if( m_Current_File->ReadChunk( lineBuffer, GERBER_BUFZ ) == NULL )
                 break;
 
-            case 'D':       /* Line type Dxx : Tool selection (xx > 0) or
-                             * command if xx = 0..9 */
-                D_commande = DCodeNumber( text );
-                Execute_DCODE_Command( text, D_commande );
-                break;
+            m_LineNum++;
+            text = StrPurge( lineBuffer );
 
-            case 'X':
-            case 'Y':                   /* Move or draw command */
-                m_CurrentPos = ReadXYCoord( text );
-                if( *text == '*' )      // command like X12550Y19250*
+            while( text && *text )
+            {
+                switch( *text )
                 {
-                    Execute_DCODE_Command( text, m_Last_Pen_Command );
-                }
-                break;
-
-            case 'I':
-            case 'J':       /* Auxiliary Move command */
-                m_IJPos = ReadIJCoord( text );
+                case ' ':
+                case '\r':
+                case '\n':
+                    text++;
+                    break;
 
-                if( *text == '*' )      // command like X35142Y15945J504*
-                {
-                    Execute_DCODE_Command( text, m_Last_Pen_Command );
-                }
-                break;
+                case '*':       // End command
+                    m_CommandState = END_BLOCK;
+                    text++;
+                    break;
 
-            case '%':
-                if( m_CommandState != ENTER_RS274X_CMD )
-                {
-                    m_CommandState = ENTER_RS274X_CMD;
-                    ReadRS274XCommand( lineBuffer, GERBER_BUFZ, text );
-                }
-                else        //Error
-                {
-                    AddMessageToList( "Expected RS274X Command"  );
+                case 'M':       // End file
                     m_CommandState = CMD_IDLE;
+                    while( *text )
+                        text++;
+                    break;
+
+                case 'G':    /* Line type Gxx : command */
+                    G_command = GCodeNumber( text );
+                    Execute_G_Command( text, G_command );
+                    break;
+
+                case 'D':       /* Line type Dxx : Tool selection (xx > 0) or
+                                 * command if xx = 0..9 */
+                    D_commande = DCodeNumber( text );
+                    Execute_DCODE_Command( text, D_commande );
+                    break;
+
+                case 'X':
+                case 'Y':                   /* Move or draw command */
+                    m_CurrentPos = ReadXYCoord( text );
+                    if( *text == '*' )      // command like X12550Y19250*
+                    {
+                        Execute_DCODE_Command( text, m_Last_Pen_Command );
+                    }
+                    break;
+
+                case 'I':
+                case 'J':       /* Auxiliary Move command */
+                    m_IJPos = ReadIJCoord( text );
+
+                    if( *text == '*' )      // command like X35142Y15945J504*
+                    {
+                        Execute_DCODE_Command( text, m_Last_Pen_Command );
+                    }
+                    break;
+
+                case '%':
+                    if( m_CommandState != ENTER_RS274X_CMD )
+                    {
+                        m_CommandState = ENTER_RS274X_CMD;
+                        ReadRS274XCommand( lineBuffer, GERBER_BUFZ, text );
+                    }
+                    else        //Error
+                    {
+                        AddMessageToList( "Expected RS274X Command"  );
+                        m_CommandState = CMD_IDLE;
+                        text++;
+                    }
+                    break;
+
+                default:
+                    msg.Printf( "Unexpected char 0x%2.2X &lt;%c&lt;", *text, *text );
+                    AddMessageToList( msg );
                     text++;
+                    break;
                 }
-                break;
-
-            default:
-                msg.Printf( "Unexpected char 0x%2.2X &lt;%c&lt;", *text, *text );
-                AddMessageToList( msg );
-                text++;
-                break;
             }
         }
     }
+    catch( const IO_ERROR& ioe )
+    {
+        // A read error (e.g. a line too long for the reader): the image is incomplete
+        AddMessageToList( ioe.What() );
+        m_Current_File = NULL;
+        return false;
+    }
 
-    fclose( m_Current_File );
+    m_Current_File = NULL;
 
     m_InUse = true;
 
@@ -31,6 +31,7 @@
 #include <macros.h>
 #include <base_units.h>
 #include <math/util.h>      // for KiROUND
+#include <richio.h>
 
 #include <gerbview.h>
 #include <gerber_file_image.h>
@@ -181,7 +182,7 @@ bool GERBER_FILE_IMAGE::ReadRS274XCommand( char *aBuff, unsigned int aBuffSize,
         }
 
         // end of current line, read another one.
-        if( fgets( aBuff, aBuffSize, m_Current_File ) == NULL )
+        if( m_Current_File->ReadChunk( aBuff, aBuffSize ) == NULL )
         {
             // end of file
             ok = false;
@@ -865,7 +866,8 @@ bool GERBER_FILE_IMAGE::ExecuteRS274XCommand( int aCommand, char* aBuff,
 }
 
 
-bool GERBER_FILE_IMAGE::GetEndOfBlock( char* aBuff, unsigned int aBuffSize, char*& aText, FILE* gerber_file )
+bool GERBER_FILE_IMAGE::GetEndOfBlock( char* aBuff, unsigned int aBuffSize, char*& aText,
+                                       LINE_CHUNK_READER* gerber_file )
 {
     for( ; ; )
     {
@@ -880,7 +882,7 @@ bool GERBER_FILE_IMAGE::GetEndOfBlock( char* aBuff, unsigned int aBuffSize, char
             aText++;
         }
 
-        if( fgets( aBuff, aBuffSize, gerber_file ) == NULL )
+        if( gerber_file->ReadChunk( aBuff, aBuffSize ) == NULL )
             break;
 
         m_LineNum++;
@@ -891,7 +893,8 @@ bool GERBER_FILE_IMAGE::GetEndOfBlock( char* aBuff, unsigned int aBuffSize, char
 }
 
 
-char* GERBER_FILE_IMAGE::GetNextLine( char *aBuff, unsigned int aBuffSize, char* aText, FILE* aFile )
+char* GERBER_FILE_IMAGE::GetNextLine( char *aBuff, unsigned int aBuffSize, char* aText,
+                                      LINE_CHUNK_READER* aFile )
 {
     for( ; ; )
     {
@@ -904,7 +907,7 @@ char* GERBER_FILE_IMAGE::GetNextLine( char *aBuff, unsigned int aBuffSize, char*
                 break;
 
             case 0:    // End of text found in aBuff: Read a new string
-                if( fgets( aBuff, aBuffSize, aFile ) == NULL )
+                if( aFile->ReadChunk( aBuff, aBuffSize ) == NULL )
                     return NULL;
 
                 m_LineNum++;
@@ -921,7 +924,7 @@ char* GERBER_FILE_IMAGE::GetNextLine( char *aBuff, unsigned int aBuffSize, char*
 
 bool GERBER_FILE_IMAGE::ReadApertureMacro( char *aBuff, unsigned int aBuffSize,
                                 char*&    aText,
-                                FILE*     gerber_file )
+                                LINE_CHUNK_READER* gerber_file )
 {
     wxString       msg;
     APERTURE_MACRO am;
@@ -24,6 +24,8 @@
 #ifndef ADVANCED_CFG__H
 #define ADVANCED_CFG__H
 
+#include <wx/string.h>
+
 class wxConfigBase;
 
 /**
@@ -83,6 +85,28 @@ public:
      */
     int m_coroutineStackSize;
 
+    /**
+     * File to which TRACE_SPAN timings are appended on exit.  Recording is off when empty.
+     */
+    wxString m_traceSpanFile;
+
+    /**
+     * Number of spans kept per thread before the oldest are overwritten
+     */
+    int m_traceSpanBufferSize;
+
+    /**
+     * Approximate memory budget of the board editor undo list, in MB.  The oldest undo
+     * levels are discarded when it is exceeded.  0 disables the budget.
+     */
+    int m_undoMemoryLimit;
+
+    /**
+     * Minimum time in ms between two scans of the file timestamps of a footprint library.
+     * 0 scans the library each time it is accessed.
+     */
+    int m_fpLibPollInterval;
+
 
 private:
     ADVANCED_CFG();
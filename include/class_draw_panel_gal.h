@@ -31,6 +31,7 @@
 #include <math/box2.h>
 #include <math/vector2d.h>
 #include <msgpanel.h>
+#include <chrono>
 #include <memory>
 #include <common.h>
 
@@ -113,6 +114,23 @@ public:
      */
     void ForceRefresh();
 
+    ///> Redraw timings, for measuring interactive performance.
+    struct REDRAW_STATS
+    {
+        unsigned m_frames = 0;
+
+        ///> Time spent in onPaint() (ms).
+        double   m_lastPaint = 0.0;
+        double   m_maxPaint = 0.0;
+
+        ///> Time between the first Refresh() request and the end of the matching paint (ms).
+        double   m_lastLatency = 0.0;
+        double   m_maxLatency = 0.0;
+    };
+
+    const REDRAW_STATS& GetRedrawStats() const { return m_redrawStats; }
+    void ResetRedrawStats() { m_redrawStats = REDRAW_STATS(); }
+
     /**
      * Function SetEventDispatcher()
      * Sets a dispatcher that processes events and forwards them to tools.
@@ -217,6 +235,11 @@ protected:
     bool                     m_pendingRefresh;   /// Is there a redraw event requested?
     wxTimer                  m_refreshTimer;     /// Timer to prevent too-frequent refreshing
 
+    /// Time of the first Refresh() call since the last paint
+    std::chrono::steady_clock::time_point m_refreshRequested;
+
+    REDRAW_STATS             m_redrawStats;
+
     /// True if GAL is currently redrawing the view
     bool                     m_drawing;
 
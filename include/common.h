@@ -210,6 +210,10 @@ enum class EDA_UNITS
  * The constructor sets a "C" language locale option, to read/print files with floating
  * point  numbers.  The destructor insures that the default locale is restored if an
  * exception is thrown or not.
+ *
+ * On the GUI thread the process locale is switched.  On any other thread only the locale
+ * of that thread is switched, so a worker can read or write files while the GUI thread
+ * keeps using the user locale.
  */
 class LOCALE_IO
 {
@@ -225,6 +229,9 @@ private:
     // (the locale can be set by user, and is not always the system locale)
     std::string m_user_locale;
     wxLocale*   m_wxLocale;
+
+    // true if only the locale of the calling (non GUI) thread is switched
+    bool        m_perThread;
 };
 
 /**
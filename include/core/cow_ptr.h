@@ -0,0 +1,88 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef COW_PTR_H
+#define COW_PTR_H
+
+#include <memory>
+
+/**
+ * A copy-on-write value.  Copies of a COW_PTR share the same object until one of them
+ * asks for write access, which then gets its own copy.
+ *
+ * Used for large geometry held by board items (zone fills, custom pad shapes), so the
+ * item clones stored in the undo list cost almost nothing until the live item changes.
+ *
+ * Copying a COW_PTR while another thread writes to the same COW_PTR is not safe, as
+ * for the value type itself.
+ */
+template <typename T>
+class COW_PTR
+{
+public:
+    COW_PTR() :
+            m_data( std::make_shared<T>() )
+    {
+    }
+
+    explicit COW_PTR( const T& aValue ) :
+            m_data( std::make_shared<T>( aValue ) )
+    {
+    }
+
+    const T& operator*() const { return *m_data; }
+    const T* operator->() const { return m_data.get(); }
+
+    /**
+     * @return a mutable reference to the value, copying it first if it is shared.
+     */
+    T& Write()
+    {
+        if( m_data.use_count() > 1 )
+            m_data = std::make_shared<T>( *m_data );
+
+        return *m_data;
+    }
+
+    /**
+     * Replace the value.  Other copies keep the previous one.
+     */
+    void Set( const T& aValue )
+    {
+        m_data = std::make_shared<T>( aValue );
+    }
+
+    /**
+     * @return true if the value is shared with another COW_PTR.
+     */
+    bool IsShared() const { return m_data.use_count() > 1; }
+
+    /**
+     * @return an identifier of the shared value, e.g. to count shared memory only once.
+     */
+    const void* Id() const { return m_data.get(); }
+
+private:
+    std::shared_ptr<T> m_data;
+};
+
+#endif // COW_PTR_H
@@ -38,6 +38,7 @@
 #include <wx/dcbuffer.h>
 
 #include <memory>
+#include <vector>
 
 /**
  * @brief Class CAIRO_GAL is the cairo implementation of the graphics abstraction layer.
@@ -312,6 +313,45 @@ protected:
     void flushPath();
     void storePath();                           ///< Store the actual path
 
+    /**
+     * Fills or strokes the current path.  When tiled rendering is enabled, the operation is
+     * recorded and rendered later by flushTiles().
+     *
+     * @param aFill is true to fill the path, false to stroke it.
+     * @param aPreserve is true to keep the path in the context afterwards.
+     */
+    void renderPath( bool aFill, bool aPreserve );
+
+    /**
+     * Renders the recorded operations to their target.  The target is split into tiles,
+     * rendered in parallel.
+     */
+    void flushTiles();
+
+    /// A fill or stroke operation recorded for tiled rendering
+    struct TILE_OP
+    {
+        cairo_path_t*     path;
+        bool              fill;
+        double            color[4];
+        double            lineWidth;
+        cairo_line_cap_t  lineCap;
+        cairo_line_join_t lineJoin;
+        cairo_operator_t  op;
+        cairo_matrix_t    matrix;
+        double            x0, y0, x1, y1;       ///< Extents in device space
+    };
+
+    bool                tiledRendering;         ///< Record operations and render them in tiles
+    cairo_t*            tileContext;            ///< Context the operations were recorded for
+    std::vector<TILE_OP> tileOps;               ///< Operations waiting for flushTiles()
+
+    /// Size of the tiles, in pixels
+    static constexpr int TILE_SIZE = 256;
+
+    /// Minimum number of recorded operations to render the tiles in parallel
+    static constexpr size_t PARALLEL_MIN_OPS = 256;
+
     /**
      * @brief Blits cursor into the current screen.
      */
@@ -469,6 +509,33 @@ protected:
     bool updatedGalDisplayOptions( const GAL_DISPLAY_OPTIONS& aOptions ) override;
 };
 
+
+/**
+ * CAIRO_IMAGE_GAL renders to an offscreen image of a given size, without any window.
+ * It is used to take snapshots of views, e.g. for automated reviews.
+ */
+class CAIRO_IMAGE_GAL : public CAIRO_GAL_BASE
+{
+public:
+    CAIRO_IMAGE_GAL( GAL_DISPLAY_OPTIONS& aDisplayOptions, int aWidth, int aHeight );
+
+    /// @brief Resizes the image, its contents are lost.
+    virtual void ResizeScreen( int aWidth, int aHeight ) override;
+
+    /**
+     * Function SaveImage
+     * writes the rendered image to a PNG file.
+     *
+     * @param aFileName is the name of the file to write.
+     * @return true if the file was written.
+     */
+    bool SaveImage( const wxString& aFileName ) const;
+
+protected:
+    /// Create the image surface and its context
+    void initSurface();
+};
+
 } // namespace KIGFX
 
 #endif  // CAIROGAL_H_
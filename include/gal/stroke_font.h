@@ -143,6 +143,13 @@ private:
      */
     BOX2D computeBoundingBox( const GLYPH* aGlyph, double aGlyphWidth ) const;
 
+    /**
+     * Build the glyphs shared by all the stroke fonts from the font data.  Called only
+     * once, see LoadNewStrokeFont().
+     */
+    void buildNewStrokeFontGlyphs( const char* const aNewStrokeFont[],
+                                   int aNewStrokeFontSize ) const;
+
     /**
      * @brief Draws a single line of text. Multiline texts should be split before using the
      * function.
@@ -306,6 +306,47 @@ public:
 };
 
 
+/**
+ * LINE_CHUNK_READER
+ * reads the lines of a LINE_READER into a fixed size buffer, the way fgets() reads
+ * a FILE: a line longer than the buffer is returned in several chunks, and only the
+ * last chunk of a line ends with its line terminator.
+ */
+class LINE_CHUNK_READER
+{
+    LINE_READER&    m_reader;
+    unsigned        m_offset;   ///< bytes of the current line already returned, 0 for none.
+
+public:
+
+    /**
+     * Constructor ( LINE_READER& )
+     * does not take ownership over @a aReader, so will not destroy it.
+     */
+    LINE_CHUNK_READER( LINE_READER& aReader ) :
+        m_reader( aReader ),
+        m_offset( 0 )
+    {
+    }
+
+    /**
+     * Function ReadChunk
+     * copies the next chunk of at most @a aBuffSize - 1 bytes of text into @a aBuff
+     * and nul terminates it.  A new line is read from the underlying reader only once
+     * the current one has been entirely returned.
+     * @return char* - @a aBuff, or NULL at the end of the data or if @a aBuffSize is
+     *  less than 2.
+     * @throw IO_ERROR if the underlying reader does.
+     */
+    char* ReadChunk( char* aBuff, unsigned aBuffSize );
+
+    LINE_READER& Reader() const
+    {
+        return m_reader;
+    }
+};
+
+
 #define OUTPUTFMTBUFZ    500        ///< default buffer size for any OUTPUT_FORMATTER
 
 /**
@@ -508,6 +549,13 @@ public:
 
     ~FILE_OUTPUTFORMATTER();
 
+    /**
+     * Flush and close the file now, instead of in the destructor, so that a failed
+     * final write is reported.  Nothing may be written afterwards.
+     * @throw IO_ERROR if the file cannot be flushed or closed.
+     */
+    void Finish();
+
 protected:
     //-----<OUTPUTFORMATTER>------------------------------------------------
     void write( const char* aOutBuf, int aCount ) override;
@@ -25,6 +25,7 @@
 #ifndef __TOOL_DISPATCHER_H
 #define __TOOL_DISPATCHER_H
 
+#include <chrono>
 #include <vector>
 #include <wx/event.h>
 #include <tool/tool_event.h>
@@ -89,6 +90,31 @@ public:
      */
     virtual void DispatchWxCommand( wxCommandEvent& aEvent );
 
+    ///> Counters describing how far tools lag behind the mouse.
+    struct MOTION_STATS
+    {
+        ///> Motion and drag events generated from wx events.
+        unsigned m_received = 0;
+
+        ///> Events actually handed to the tools; the rest were superseded by newer ones.
+        unsigned m_dispatched = 0;
+
+        ///> Time between the oldest coalesced event and the end of its processing (ms).
+        double   m_lastLatency = 0.0;
+        double   m_maxLatency = 0.0;
+    };
+
+    const MOTION_STATS& GetMotionStats() const { return m_motionStats; }
+    void ResetMotionStats() { m_motionStats = MOTION_STATS(); }
+
+    /**
+     * Function SetMotionCoalescing()
+     * Enables or disables coalescing of motion and drag events.  When enabled (default),
+     * such events are held until pending wx events are processed, and only the latest one
+     * is sent to the tools, so a slow tool never falls behind the cursor.
+     */
+    void SetMotionCoalescing( bool aEnable );
+
 private:
     ///> Number of mouse buttons that is handled in events.
     static const int MouseButtonCount = 3;
@@ -104,6 +130,12 @@ private:
     ///> Handles mouse related events (click, motion, dragging).
     bool handleMouseButton( wxEvent& aEvent, int aIndex, bool aMotion );
 
+    ///> Sends the event to the tools, or holds it if it is a motion or drag event.
+    bool processEvent( const TOOL_EVENT& aEvent );
+
+    ///> Sends the held motion event (if any) to the tools.
+    void flushMotion();
+
     ///> Saves the state of key modifiers (Alt, Ctrl and so on).
     static int decodeModifiers( const wxKeyboardState* aState )
     {
@@ -138,6 +170,17 @@ private:
 
     ///> Instance of an actions list that handles legacy action translation
     ACTIONS* m_actions;
+
+    ///> Latest motion or drag event not sent to the tools yet.
+    OPT<TOOL_EVENT> m_pendingMotion;
+
+    ///> Arrival time of the oldest event superseded by m_pendingMotion.
+    std::chrono::steady_clock::time_point m_pendingSince;
+
+    bool m_coalesceMotion;
+    bool m_flushScheduled;
+
+    MOTION_STATS m_motionStats;
 };
 
 #endif
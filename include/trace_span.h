@@ -0,0 +1,135 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file trace_span.h
+ * @brief Scoped timing spans recorded into per-thread ring buffers.
+ *
+ * Unlike PROF_COUNTER, spans are compiled into release builds.  They cost a single
+ * relaxed atomic load unless recording was enabled (see ADVANCED_CFG::m_traceSpanFile),
+ * and can be written out in the Chrome trace event format, which is understood by
+ * chrome://tracing and https://ui.perfetto.dev.
+ */
+
+#ifndef TRACE_SPAN_H
+#define TRACE_SPAN_H
+
+#include <atomic>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+/**
+ * A RAII timing span.  The time between construction and destruction is recorded in
+ * the ring buffer of the calling thread, if recording is enabled.
+ *
+ * Spans on the same thread nest naturally:
+ *
+ * {
+ *     TRACE_SPAN span( "ZONE_FILLER::Fill", "zones" );
+ *     ...
+ * }
+ *
+ * The name and category are stored as pointers, so they must be string literals or
+ * otherwise outlive the program.
+ */
+class TRACE_SPAN
+{
+public:
+    TRACE_SPAN( const char* aName, const char* aCategory = "kicad" ) :
+            m_name( aName ),
+            m_category( aCategory ),
+            m_active( IsEnabled() ),
+            m_start( m_active ? now() : 0 )
+    {
+    }
+
+    ~TRACE_SPAN()
+    {
+        if( m_active )
+            record( m_name, m_category, m_start, now() );
+    }
+
+    TRACE_SPAN( const TRACE_SPAN& ) = delete;
+    TRACE_SPAN& operator=( const TRACE_SPAN& ) = delete;
+
+    /**
+     * @return true if spans are currently being recorded.
+     */
+    static bool IsEnabled()
+    {
+        return s_enabled.load( std::memory_order_relaxed );
+    }
+
+    /**
+     * Start or stop recording.
+     *
+     * @param aEventsPerThread is the ring buffer capacity of each thread; once full,
+     *                         the oldest spans are overwritten.
+     */
+    static void Enable( bool aEnable, size_t aEventsPerThread = 65536 );
+
+    /**
+     * Enable recording if the advanced config names a trace file.  Each module linking
+     * common (the launcher and each kiface) keeps its own buffers and must call this
+     * at startup.
+     */
+    static void InitFromConfig();
+
+    /**
+     * Append the spans recorded since the last flush to the trace file named in the
+     * advanced config, if any.  Called at module shutdown.
+     */
+    static void FlushToConfigFile();
+
+    /**
+     * Write the spans recorded since the last flush as a complete Chrome trace JSON
+     * object, and mark them as flushed.
+     */
+    static void WriteChromeTrace( std::ostream& aStream );
+
+    /**
+     * Append the spans recorded since the last flush to \a aFileName using the Chrome
+     * JSON array format, whose closing bracket is optional.  This lets several modules
+     * and sessions share one file.
+     *
+     * @return false if the file could not be written.
+     */
+    static bool AppendChromeTrace( const std::string& aFileName );
+
+private:
+    /// Nanoseconds of the steady clock, the same in every module of the process.
+    static uint64_t now();
+
+    static void record( const char* aName, const char* aCategory, uint64_t aStart,
+                        uint64_t aEnd );
+
+    const char* m_name;
+    const char* m_category;
+    bool        m_active;
+    uint64_t    m_start;
+
+    static std::atomic<bool> s_enabled;
+};
+
+#endif // TRACE_SPAN_H
@@ -107,6 +107,17 @@ public:
      */
     virtual int Query( const BOX2I& aRect, std::vector<LAYER_ITEM_PAIR>& aResult ) const;
 
+    /**
+     * Function QueryAll()
+     * Same as Query(), but also finds the items of hidden layers and the items that are not
+     * visible.  Used to find items by position when the caller handles visibility itself,
+     * e.g. to hit-test them.  An item is returned once for each of its layers.
+     * @param aRect area to search for items
+     * @param aResult result of the search, containing VIEW_ITEMs associated with their layers.
+     * @return Number of found items.
+     */
+    int QueryAll( const BOX2I& aRect, std::vector<LAYER_ITEM_PAIR>& aResult ) const;
+
     /**
      * Sets the item visibility.
      *
@@ -685,6 +696,19 @@ public:
      */
     std::unique_ptr<VIEW> DataReference() const;
 
+    /**
+     * Function SaveSnapshot()
+     * renders an area of the view to a PNG image, offscreen.  The items are drawn by the
+     * painter of this view, which is lent to the image GAL meanwhile; overlay layers are
+     * left out.  The view does not need a GAL of its own.
+     *
+     * @param aArea is the area to render, in world units.  It is fitted to the image.
+     * @param aSize is the size of the image, in pixels.
+     * @param aFileName is the name of the PNG file to write.
+     * @return true if the image was written.
+     */
+    bool SaveSnapshot( const BOX2D& aArea, const VECTOR2I& aSize, const wxString& aFileName );
+
     /**
      * @return the printing mode.
      * if return <= 0, the current mode is not a printing mode, just the draw mode
@@ -49,6 +49,8 @@
 #include <algorithm>
 #include <deque>
 #include <cmath>
+#include <limits>
+#include <vector>
 
 #include <clipper.hpp>
 #include <geometry/shape_line_chain.h>
@@ -234,6 +236,11 @@ private:
 
     BOX2I m_bbox;
     std::deque<Vertex> m_vertices;
+
+    /// Horizontal bands of the bounding box, each one listing the edges (by their first
+    /// vertex) of the outline that cross it.  Used to find the hole bridges.
+    std::vector<std::vector<Vertex*>> m_bands;
+    double m_bandHeight = 1.0;
     SHAPE_POLY_SET::TRIANGULATED_POLYGON& m_result;
 
     /**
@@ -342,9 +349,10 @@ private:
     /**
      * Function createList
      * Takes the SHAPE_LINE_CHAIN and links each point into a
-     * circular, doubly-linked list
+     * circular, doubly-linked list.  Holes are linked in the opposite winding
+     * order of outlines, so they can be bridged into their outline.
      */
-    Vertex* createList( const SHAPE_LINE_CHAIN& points )
+    Vertex* createList( const SHAPE_LINE_CHAIN& points, bool aHole = false )
     {
         Vertex* tail = nullptr;
         double sum = 0.0;
@@ -358,7 +366,7 @@ private:
             sum += ( ( p2.x - p1.x ) * ( p2.y + p1.y ) );
         }
 
-        if( sum > 0.0 )
+        if( ( sum > 0.0 ) != aHole )
             for( int i = points.PointCount() - 1; i >= 0; i--)
                 tail = insertVertex( points.CPoint( i ), tail );
         else
@@ -626,6 +634,242 @@ private:
             return area( a, b, a->prev ) < 0 || area( a, a->next, b ) < 0;
     }
 
+    /**
+     * Function getLeftmost
+     * Returns the leftmost vertex of the list containing aStart (the lowest one
+     * when several vertices share the same X coordinate)
+     */
+    Vertex* getLeftmost( Vertex* aStart ) const
+    {
+        Vertex* p = aStart;
+        Vertex* leftmost = aStart;
+
+        do
+        {
+            if( p->x < leftmost->x || ( p->x == leftmost->x && p->y < leftmost->y ) )
+                leftmost = p;
+
+            p = p->next;
+        } while( p != aStart );
+
+        return leftmost;
+    }
+
+    /**
+     * Function sectorContainsSector
+     * Checks whether the sector in vertex m contains the sector in vertex p,
+     * both vertices having the same coordinates
+     */
+    bool sectorContainsSector( const Vertex* m, const Vertex* p ) const
+    {
+        return area( m->prev, m, p->prev ) < 0 && area( p->next, m, m->next ) < 0;
+    }
+
+    /**
+     * Function bandIndex
+     * Returns the index of the horizontal band containing the Y coordinate aY
+     */
+    int bandIndex( double aY ) const
+    {
+        int band = static_cast<int>( ( aY - m_bbox.GetY() ) / m_bandHeight );
+
+        return std::max( 0, std::min( band, static_cast<int>( m_bands.size() ) - 1 ) );
+    }
+
+    /**
+     * Function addEdge
+     * Adds the edge starting at aStart to the bands it crosses
+     */
+    void addEdge( Vertex* aStart )
+    {
+        int first = bandIndex( std::min( aStart->y, aStart->next->y ) );
+        int last = bandIndex( std::max( aStart->y, aStart->next->y ) );
+
+        for( int band = first; band <= last; band++ )
+            m_bands[band].push_back( aStart );
+    }
+
+    /**
+     * Function replaceEdge
+     * Replaces the first vertex of an edge in the bands.  aNew must have the
+     * same coordinates as aOld.
+     */
+    void replaceEdge( Vertex* aOld, Vertex* aNew )
+    {
+        int first = bandIndex( std::min( aNew->y, aNew->next->y ) );
+        int last = bandIndex( std::max( aNew->y, aNew->next->y ) );
+
+        for( int band = first; band <= last; band++ )
+            std::replace( m_bands[band].begin(), m_bands[band].end(), aOld, aNew );
+    }
+
+    /**
+     * Function findHoleBridge
+     * Finds a vertex of the outline that can be connected to the leftmost vertex
+     * aHole of a hole without crossing any edge.  A ray is cast from aHole to the
+     * left, and the bridge is the closest visible vertex to the hit edge.  Only the
+     * edges in the bands crossed by the search area are tested.
+     * Returns nullptr if no such vertex exists (the hole is outside the outline)
+     */
+    Vertex* findHoleBridge( const Vertex* aHole ) const
+    {
+        const double hx = aHole->x;
+        const double hy = aHole->y;
+        double qx = -std::numeric_limits<double>::infinity();
+        Vertex* m = nullptr;
+
+        // Find the segment of the outline just left of the hole vertex, the end
+        // of this segment with the smallest X being a bridge candidate
+        for( Vertex* p : m_bands[ bandIndex( hy ) ] )
+        {
+            if( hy <= p->y && hy >= p->next->y && p->next->y != p->y )
+            {
+                double x = p->x + ( hy - p->y ) * ( p->next->x - p->x ) / ( p->next->y - p->y );
+
+                if( x <= hx && x > qx )
+                {
+                    qx = x;
+
+                    if( x == hx )
+                    {
+                        if( hy == p->y )
+                            return p;
+
+                        if( hy == p->next->y )
+                            return p->next;
+                    }
+
+                    m = p->x < p->next->x ? p : p->next;
+                }
+            }
+        }
+
+        if( !m )
+            return nullptr;
+
+        // The hole touches the outline
+        if( hx == qx )
+            return m;
+
+        // Look for outline vertices inside the triangle formed by the hole vertex,
+        // the intersection point and the candidate: if there are some, the one with
+        // the smallest angle to the ray is the bridge
+        const double mx = m->x;
+        const double my = m->y;
+        double tanMin = std::numeric_limits<double>::infinity();
+        int firstBand = bandIndex( std::min( hy, my ) );
+        int lastBand = bandIndex( std::max( hy, my ) );
+
+        for( int band = firstBand; band <= lastBand; band++ )
+        {
+            for( Vertex* p : m_bands[band] )
+            {
+                if( hx >= p->x && p->x >= mx && hx != p->x
+                        && inTriangle( hy < my ? hx : qx, hy, mx, my, hy < my ? qx : hx, hy,
+                                       p->x, p->y ) )
+                {
+                    double tan = std::abs( hy - p->y ) / ( hx - p->x );
+
+                    if( locallyInside( p, aHole )
+                            && ( tan < tanMin || ( tan == tanMin
+                                    && ( p->x > m->x
+                                            || ( p->x == m->x
+                                                    && sectorContainsSector( m, p ) ) ) ) ) )
+                    {
+                        m = p;
+                        tanMin = tan;
+                    }
+                }
+            }
+        }
+
+        return m;
+    }
+
+    /**
+     * Function inTriangle
+     * Checks whether the point (px, py) is inside the triangle a, b, c
+     */
+    static bool inTriangle( double ax, double ay, double bx, double by, double cx, double cy,
+                            double px, double py )
+    {
+        return     ( cx - px ) * ( ay - py ) - ( ax - px ) * ( cy - py ) >= 0
+                && ( ax - px ) * ( by - py ) - ( bx - px ) * ( ay - py ) >= 0
+                && ( bx - px ) * ( cy - py ) - ( cx - px ) * ( by - py ) >= 0;
+    }
+
+    /**
+     * Function eliminateHoles
+     * Links the holes of aPoly into the outline list aOuter, from left to right, each
+     * hole being connected to the outline by a pair of coincident edges (a bridge).
+     * The result is a single, weakly simple polygon that can be ear-clipped.
+     * Returns false if a hole cannot be bridged to the outline
+     */
+    bool eliminateHoles( const SHAPE_POLY_SET::POLYGON& aPoly, Vertex* aOuter )
+    {
+        std::vector<Vertex*> queue;
+
+        for( size_t ii = 1; ii < aPoly.size(); ii++ )
+        {
+            Vertex* list = createList( aPoly[ii], true );
+
+            // Skip degenerated holes
+            if( !list || list->prev == list->next )
+                continue;
+
+            queue.push_back( getLeftmost( list ) );
+        }
+
+        std::sort( queue.begin(), queue.end(), []( const Vertex* a, const Vertex* b )
+        {
+            return a->x < b->x;
+        } );
+
+        // Index the edges of the outline in horizontal bands
+        size_t vertexCount = m_vertices.size();
+
+        m_bands.clear();
+        m_bands.resize( std::max<size_t>( 1, static_cast<size_t>( std::sqrt( vertexCount ) ) ) );
+        m_bandHeight = std::max( 1.0, double( m_bbox.GetHeight() ) / m_bands.size() );
+
+        Vertex* p = aOuter;
+
+        do
+        {
+            addEdge( p );
+            p = p->next;
+        } while( p != aOuter );
+
+        for( Vertex* hole : queue )
+        {
+            Vertex* bridge = findHoleBridge( hole );
+
+            if( !bridge )
+                return false;
+
+            // The edges of the hole become outline edges
+            p = hole;
+
+            do
+            {
+                addEdge( p );
+                p = p->next;
+            } while( p != hole );
+
+            // The outgoing edge of the bridge vertex now starts at its copy
+            Vertex* holeCopy = bridge->split( hole );
+            Vertex* bridgeCopy = holeCopy->next;
+
+            replaceEdge( bridge, bridgeCopy );
+            addEdge( bridge );
+            addEdge( holeCopy );
+        }
+
+        m_bands.clear();
+
+        return true;
+    }
+
     /**
      * Function insertVertex
      * Creates an entry in the vertices lookup and optionally inserts the newly
@@ -677,6 +921,40 @@ public:
         m_vertices.clear();
         return retval;
     }
+
+    /**
+     * Tesselates a polygon with holes.  The holes are bridged to the outline
+     * before the ear clipping, so the polygon does not need to be fractured.
+     */
+    bool TesselatePolygon( const SHAPE_POLY_SET::POLYGON& aPoly )
+    {
+        if( aPoly.size() == 1 )
+            return TesselatePolygon( aPoly.front() );
+
+        const SHAPE_LINE_CHAIN& outline = aPoly.front();
+
+        m_bbox = outline.BBox();
+        m_result.Clear();
+
+        if( !m_bbox.GetWidth() || !m_bbox.GetHeight() )
+            return false;
+
+        Vertex* firstVertex = createList( outline );
+
+        if( !firstVertex || firstVertex->prev == firstVertex->next )
+            return false;
+
+        bool retval = eliminateHoles( aPoly, firstVertex );
+
+        if( retval )
+        {
+            firstVertex->updateList();
+            retval = earcutList( firstVertex );
+        }
+
+        m_vertices.clear();
+        return retval;
+    }
 };
 
 #endif //__POLYGON_TRIANGULATION_H
@@ -26,10 +26,14 @@
 #ifndef __SHAPE_POLY_SET_H
 #define __SHAPE_POLY_SET_H
 
+#include <atomic>
+#include <cstdint>                      // for uint64_t
 #include <cstdio>
 #include <deque>                        // for deque
+#include <functional>
 #include <iosfwd>                       // for string, stringstream
 #include <memory>
+#include <mutex>
 #include <set>                          // for set
 #include <stdexcept>                    // for out_of_range
 #include <stdlib.h>                     // for abs
@@ -41,7 +45,6 @@
 #include <geometry/shape_line_chain.h>
 #include <math/box2.h>                  // for BOX2I
 #include <math/vector2d.h>              // for VECTOR2I
-#include <md5_hash.h>
 
 
 /**
@@ -240,7 +243,7 @@ class SHAPE_POLY_SET : public SHAPE
 
             const T& Get()
             {
-                return m_poly->Polygon( m_currentPolygon )[m_currentContour].CPoint(
+                return m_poly->CPolygon( m_currentPolygon )[m_currentContour].CPoint(
                         m_currentVertex );
             }
 
@@ -363,7 +366,8 @@ class SHAPE_POLY_SET : public SHAPE
 
             T Get()
             {
-                return m_poly->Polygon( m_currentPolygon )[m_currentContour].Segment( m_currentSegment );
+                return m_poly->CPolygon( m_currentPolygon )[m_currentContour].CSegment(
+                        m_currentSegment );
             }
 
             T operator*()
@@ -585,8 +589,10 @@ class SHAPE_POLY_SET : public SHAPE
         }
 
         ///> Returns the reference to aIndex-th outline in the set
+        ///> (the set is considered as modified, see GetGeneration(): use COutline() to read it)
         SHAPE_LINE_CHAIN& Outline( int aIndex )
         {
+            touch();
             return m_polys[aIndex][0];
         }
 
@@ -607,14 +613,18 @@ class SHAPE_POLY_SET : public SHAPE
         }
 
         ///> Returns the reference to aHole-th hole in the aIndex-th outline
+        ///> (the set is considered as modified, see GetGeneration(): use CHole() to read it)
         SHAPE_LINE_CHAIN& Hole( int aOutline, int aHole )
         {
+            touch();
             return m_polys[aOutline][aHole + 1];
         }
 
         ///> Returns the aIndex-th subpolygon in the set
+        ///> (the set is considered as modified, see GetGeneration(): use CPolygon() to read it)
         POLYGON& Polygon( int aIndex )
         {
+            touch();
             return m_polys[aIndex];
         }
 
@@ -932,6 +942,18 @@ class SHAPE_POLY_SET : public SHAPE
         ///> For aFastMode meaning, see function booleanOp
         void Simplify( POLYGON_MODE aFastMode );
 
+        /**
+         * Function BatchedUnion
+         * merges the overlapping polygons of the set, like Simplify(), but is intended for
+         * large sets of small polygons (knockouts, pads, tracks...).  The polygons are
+         * partitioned in tiles by their position, the tiles are merged in parallel, and then
+         * stitched pairwise, recursively, only the polygons near the border of each pair of
+         * tiles being processed again.
+         * Small sets are just simplified.
+         * For aFastMode meaning, see function booleanOp
+         */
+        void BatchedUnion( POLYGON_MODE aFastMode );
+
         /**
          * Function NormalizeAreaOutlines
          * Convert a self-intersecting polygon to one (or more) non self-intersecting polygon(s)
@@ -1042,6 +1064,21 @@ class SHAPE_POLY_SET : public SHAPE
          */
         void BuildBBoxCaches();
 
+        /**
+         * Function EnableIndex
+         * enables (or disables) the spatial index of the edges of the set.  When enabled,
+         * Contains(), Collide(), SquaredDistance() and SquaredDistanceToPolygon() only look
+         * at the edges near the query point or segment instead of walking all the edges.
+         * The index is built by the first query following a modification of the set, so it
+         * is worth enabling only for sets which are queried many times between modifications.
+         * With the index, Collide() compares the clearance with the exact distance to the edges
+         * instead of testing against an inflated copy of the set.
+         * The setting is kept by assignments to the set.
+         */
+        void EnableIndex( bool aEnable = true );
+
+        bool IsIndexEnabled() const { return m_indexEnabled; }
+
         /**
          * Returns true if a given subpolygon contains the point aP
          *
@@ -1169,7 +1206,7 @@ class SHAPE_POLY_SET : public SHAPE
          * @return int -  The minimum distance between aPoint and all the segments of the aIndex-th
          *                polygon. If the point is contained in the polygon, the distance is zero.
          */
-        SEG::ecoord SquaredDistanceToPolygon( VECTOR2I aPoint, int aIndex );
+        SEG::ecoord SquaredDistanceToPolygon( VECTOR2I aPoint, int aIndex ) const;
 
         /**
          * Function DistanceToPolygon
@@ -1183,7 +1220,7 @@ class SHAPE_POLY_SET : public SHAPE
          *                  aIndex-th polygon. If the point is contained in the polygon, the
          *                  distance is zero.
          */
-        SEG::ecoord SquaredDistanceToPolygon( const SEG& aSegment, int aIndex );
+        SEG::ecoord SquaredDistanceToPolygon( const SEG& aSegment, int aIndex ) const;
 
         /**
          * Function SquaredDistance
@@ -1193,7 +1230,7 @@ class SHAPE_POLY_SET : public SHAPE
          * @return The minimum distance squared between aPoint and all the polygons in the set.
          *         If the point is contained in any of the polygons, the distance is zero.
          */
-        SEG::ecoord SquaredDistance( VECTOR2I aPoint );
+        SEG::ecoord SquaredDistance( VECTOR2I aPoint ) const;
 
         /**
          * Function SquaredDistance
@@ -1204,7 +1241,7 @@ class SHAPE_POLY_SET : public SHAPE
          * @return  The minimum distance squared between aSegment and all the polygons in the set.
          *          If the point is contained in the polygon, the distance is zero.
          */
-        SEG::ecoord SquaredDistance( const SEG& aSegment );
+        SEG::ecoord SquaredDistance( const SEG& aSegment ) const;
 
         /**
          * Function IsVertexInHole.
@@ -1215,6 +1252,13 @@ class SHAPE_POLY_SET : public SHAPE
         bool IsVertexInHole( int aGlobalIdx );
 
     private:
+        /**
+         * Function forEachPolygon
+         * calls aFunc with the index of each polygon of the set.  The polygons are processed
+         * in parallel when the set is large enough: aFunc must only modify the given polygon.
+         */
+        void forEachPolygon( const std::function<void( size_t )>& aFunc );
+
         void fractureSingle( POLYGON& paths );
         void unfractureSingle ( POLYGON& path );
         void importTree( ClipperLib::PolyTree* tree );
@@ -1299,17 +1343,74 @@ class SHAPE_POLY_SET : public SHAPE
         SHAPE_POLY_SET& operator=( const SHAPE_POLY_SET& );
 
         void CacheTriangulation();
+
+        /**
+         * Function IsTriangulationUpToDate
+         * @return true if the cached triangulation was built from the current content of
+         * the set.  This is a O(1) test, based on the modification generation of the set.
+         */
         bool IsTriangulationUpToDate() const;
 
-        MD5_HASH GetHash() const;
+        /**
+         * Function GetGeneration
+         * returns the modification generation of the set.  It changes each time the set is
+         * modified, and each time a non-const reference to its content is given (Outline(),
+         * Hole(), Polygon()).  It can only be compared to a generation of the same set:
+         * use GetHash() to compare the content of different sets.
+         */
+        unsigned long long GetGeneration() const { return m_generation; }
+
+        /**
+         * Function GetHash
+         * @return a 64 bits hash of the content (vertices) of the set.  This is a fast, but
+         * not cryptographic, hash: it is used to detect changes, for instance between two
+         * fills of a zone.
+         */
+        uint64_t GetHash() const;
 
     private:
 
-        MD5_HASH checksum() const;
+        ///> Records a modification of the set
+        void touch() { m_generation++; }
+
+        class EDGE_INDEX;
+
+        /**
+         * Function edgeIndex
+         * @return the spatial index of the edges of the set, built if it is missing or
+         * outdated, or nullptr if the index is not enabled (see EnableIndex()).
+         */
+        const EDGE_INDEX* edgeIndex() const;
+
+        uint64_t checksum() const;
+
+        /**
+         * Function triangulateSingle
+         * triangulates a polygon with holes, appending the result to aResult.  If the
+         * direct triangulation fails, the polygon is fractured (and simplified) and the
+         * resulting outlines are triangulated.
+         */
+        static void triangulateSingle( const POLYGON& aPoly,
+                std::vector<std::unique_ptr<TRIANGULATED_POLYGON>>& aResult );
 
         std::vector<std::unique_ptr<TRIANGULATED_POLYGON>> m_triangulatedPolys;
         bool m_triangulationValid = false;
-        MD5_HASH m_hash;
+
+        ///> The modification generation (see GetGeneration()).  Atomic, as const methods
+        ///> called from several threads read it to validate the caches.
+        std::atomic<unsigned long long> m_generation{ 0 };
+
+        ///> The generation of the set when m_triangulatedPolys was built
+        unsigned long long m_triangulationGeneration = 0;
+
+        ///> The content hash of the set when m_triangulatedPolys was built
+        uint64_t m_hash = 0;
+
+        bool m_indexEnabled = false;
+
+        ///> The spatial index of the edges, built on demand by edgeIndex()
+        mutable std::unique_ptr<EDGE_INDEX> m_edgeIndex;
+        mutable std::mutex m_edgeIndexMutex;
 
 };
 
@@ -0,0 +1,78 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file parallel_for.h
+ * @brief Runs independent work items on a short-lived pool of threads.
+ */
+
+#ifndef PARALLEL_FOR_H
+#define PARALLEL_FOR_H
+
+#include <cstddef>
+#include <functional>
+
+
+/**
+ * Call \a aFunc for every index in [0, \a aCount) and wait for all the calls.
+ *
+ * Up to one thread per core takes the indices in turn, so \a aFunc must only write to the
+ * data of its own index.  The calls run serially on the calling thread when there are too
+ * few items, or when the caller already is a worker of a parallel loop: nested loops would
+ * start one pool per outer item and oversubscribe the cores.
+ *
+ * An exception thrown by \a aFunc is rethrown once all the threads have stopped.
+ *
+ * @param aCount is the number of items.
+ * @param aFunc is called with the index of each item.
+ * @param aMinItemsPerThread is the smallest number of items worth a thread.
+ */
+void ParallelFor( size_t aCount, const std::function<void( size_t )>& aFunc,
+                  size_t aMinItemsPerThread = 1 );
+
+/**
+ * @return true if the calling thread is running items of a parallel loop, i.e. inside
+ *         ParallelFor() or a PARALLEL_WORKER_SCOPE.
+ */
+bool IsParallelWorker();
+
+
+/**
+ * Marks the calling thread as a parallel worker for the lifetime of the object, so that
+ * ParallelFor() runs serially on it.  For the thread pools that cannot use ParallelFor(),
+ * e.g. because they keep the UI refreshed while waiting.
+ */
+class PARALLEL_WORKER_SCOPE
+{
+public:
+    PARALLEL_WORKER_SCOPE();
+    ~PARALLEL_WORKER_SCOPE();
+
+    PARALLEL_WORKER_SCOPE( const PARALLEL_WORKER_SCOPE& ) = delete;
+    PARALLEL_WORKER_SCOPE& operator=( const PARALLEL_WORKER_SCOPE& ) = delete;
+
+private:
+    bool m_wasWorker;
+};
+
+#endif // PARALLEL_FOR_H
@@ -30,9 +30,11 @@
 #include <assert.h>                          // for assert
 #include <cmath>                             // for sqrt, cos, hypot, isinf
 #include <cstdio>
+#include <functional>
 #include <istream>                           // for operator<<, operator>>
 #include <limits>                            // for numeric_limits
 #include <memory>
+#include <numeric>
 #include <set>
 #include <string>                            // for char_traits, operator!=
 #include <type_traits>                       // for swap, move
@@ -49,7 +51,7 @@
 #include <math/box2.h>                       // for BOX2I
 #include <math/util.h>                       // for KiROUND, rescale
 #include <math/vector2d.h>                   // for VECTOR2I, VECTOR2D, VECTOR2
-#include <md5_hash.h>
+#include <parallel_for.h>
 
 
 using namespace ClipperLib;
@@ -68,7 +70,7 @@ SHAPE_POLY_SET::SHAPE_POLY_SET( const SHAPE_LINE_CHAIN& aOutline ) :
 
 
 SHAPE_POLY_SET::SHAPE_POLY_SET( const SHAPE_POLY_SET& aOther, bool aDeepCopy ) :
-    SHAPE( SH_POLY_SET ), m_polys( aOther.m_polys )
+    SHAPE( SH_POLY_SET ), m_polys( aOther.m_polys ), m_indexEnabled( aOther.m_indexEnabled )
 {
     if( aOther.IsTriangulationUpToDate() )
     {
@@ -76,7 +78,8 @@ SHAPE_POLY_SET::SHAPE_POLY_SET( const SHAPE_POLY_SET& aOther, bool aDeepCopy ) :
             m_triangulatedPolys.push_back(
                     std::make_unique<TRIANGULATED_POLYGON>( *aOther.TriangulatedPolygon( i ) ) );
 
-        m_hash = aOther.GetHash();
+        m_hash = aOther.m_hash;
+        m_triangulationGeneration = m_generation;
         m_triangulationValid = true;
     }
 }
@@ -178,6 +181,7 @@ bool SHAPE_POLY_SET::GetGlobalIndex( SHAPE_POLY_SET::VERTEX_INDEX aRelativeIndic
 
 int SHAPE_POLY_SET::NewOutline()
 {
+    touch();
     SHAPE_LINE_CHAIN empty_path;
     POLYGON poly;
 
@@ -190,6 +194,7 @@ int SHAPE_POLY_SET::NewOutline()
 
 int SHAPE_POLY_SET::NewHole( int aOutline )
 {
+    touch();
     SHAPE_LINE_CHAIN empty_path;
 
     empty_path.SetClosed( true );
@@ -207,6 +212,7 @@ int SHAPE_POLY_SET::NewHole( int aOutline )
 
 int SHAPE_POLY_SET::Append( int x, int y, int aOutline, int aHole, bool aAllowDuplication )
 {
+    touch();
     assert( m_polys.size() );
 
     if( aOutline < 0 )
@@ -230,6 +236,7 @@ int SHAPE_POLY_SET::Append( int x, int y, int aOutline, int aHole, bool aAllowDu
 
 void SHAPE_POLY_SET::InsertVertex( int aGlobalIndex, VECTOR2I aNewVertex )
 {
+    touch();
     VERTEX_INDEX index;
 
     if( aGlobalIndex < 0 )
@@ -415,6 +422,7 @@ bool SHAPE_POLY_SET::IsSelfIntersecting() const
 
 int SHAPE_POLY_SET::AddOutline( const SHAPE_LINE_CHAIN& aOutline )
 {
+    touch();
     assert( aOutline.IsClosed() );
 
     POLYGON poly;
@@ -429,6 +437,7 @@ int SHAPE_POLY_SET::AddOutline( const SHAPE_LINE_CHAIN& aOutline )
 
 int SHAPE_POLY_SET::AddHole( const SHAPE_LINE_CHAIN& aHole, int aOutline )
 {
+    touch();
     assert( m_polys.size() );
 
     if( aOutline < 0 )
@@ -449,6 +458,7 @@ int SHAPE_POLY_SET::AddHole( const SHAPE_LINE_CHAIN& aHole, int aOutline )
 void SHAPE_POLY_SET::booleanOp( ClipperLib::ClipType aType, const SHAPE_POLY_SET& aOtherShape,
         POLYGON_MODE aFastMode )
 {
+    touch();
     booleanOp( aType, *this, aOtherShape, aFastMode );
 }
 
@@ -458,6 +468,7 @@ void SHAPE_POLY_SET::booleanOp( ClipperLib::ClipType aType,
         const SHAPE_POLY_SET& aOtherShape,
         POLYGON_MODE aFastMode )
 {
+    touch();
     Clipper c;
 
     c.StrictlySimple( aFastMode == PM_STRICTLY_SIMPLE );
@@ -536,6 +547,7 @@ void SHAPE_POLY_SET::InflateWithLinkedHoles( int aFactor, int aCircleSegmentsCou
 void SHAPE_POLY_SET::Inflate( int aAmount, int aCircleSegmentsCount,
                               CORNER_STRATEGY aCornerStrategy )
 {
+    touch();
     // A static table to avoid repetitive calculations of the coefficient
     // 1.0 - cos( M_PI / aCircleSegmentsCount )
     // aCircleSegmentsCount is most of time <= 64 and usually 8, 12, 16, 32
@@ -618,6 +630,7 @@ void SHAPE_POLY_SET::Inflate( int aAmount, int aCircleSegmentsCount,
 
 void SHAPE_POLY_SET::importTree( PolyTree* tree )
 {
+    touch();
     m_polys.clear();
 
     for( PolyNode* n = tree->GetFirst(); n; n = n->GetNext() )
@@ -668,7 +681,55 @@ struct FractureEdge
 typedef std::vector<FractureEdge*> FractureEdgeSet;
 
 
-static int processEdge( FractureEdgeSet& edges, FractureEdge* edge )
+/**
+ * Horizontal bands of the edges of a polygon being fractured.  Each band lists, in the
+ * order they were created, the edges crossing it, so the edges crossing a given Y
+ * coordinate are found without scanning the whole edge set.
+ */
+class FractureEdgeBands
+{
+public:
+    FractureEdgeBands( int aYMin, int aYMax, size_t aEdgeCount ) :
+        m_yMin( aYMin )
+    {
+        size_t bandCount = std::max<size_t>( 1, std::sqrt( (double) aEdgeCount ) );
+
+        m_bandHeight = std::max<int64_t>( 1, ( (int64_t) aYMax - aYMin ) / bandCount + 1 );
+        m_bands.resize( bandCount );
+    }
+
+    void Add( FractureEdge* aEdge )
+    {
+        int last = bandIndex( std::max( aEdge->m_p1.y, aEdge->m_p2.y ) );
+
+        for( int band = bandIndex( std::min( aEdge->m_p1.y, aEdge->m_p2.y ) ); band <= last;
+             band++ )
+        {
+            m_bands[band].push_back( aEdge );
+        }
+    }
+
+    ///> Returns the edges that can cross the Y coordinate aY (and maybe some other ones)
+    const FractureEdgeSet& Band( int aY ) const
+    {
+        return m_bands[ bandIndex( aY ) ];
+    }
+
+private:
+    int bandIndex( int aY ) const
+    {
+        int64_t band = ( (int64_t) aY - m_yMin ) / m_bandHeight;
+
+        return (int) std::max<int64_t>( 0, std::min<int64_t>( band, m_bands.size() - 1 ) );
+    }
+
+    int                          m_yMin;
+    int64_t                      m_bandHeight;
+    std::vector<FractureEdgeSet> m_bands;
+};
+
+
+static int processEdge( FractureEdgeSet& edges, FractureEdgeBands& bands, FractureEdge* edge )
 {
     int x   = edge->m_p1.x;
     int y   = edge->m_p1.y;
@@ -677,7 +738,10 @@ static int processEdge( FractureEdgeSet& edges, FractureEdge* edge )
 
     FractureEdge* e_nearest = NULL;
 
-    for( FractureEdgeSet::iterator i = edges.begin(); i != edges.end(); ++i )
+    // Edges are tested in their creation order, the first nearest one being kept
+    const FractureEdgeSet& candidates = bands.Band( y );
+
+    for( FractureEdgeSet::const_iterator i = candidates.begin(); i != candidates.end(); ++i )
     {
         if( !(*i)->matches( y ) )
             continue;
@@ -715,6 +779,10 @@ static int processEdge( FractureEdgeSet& edges, FractureEdge* edge )
         edges.push_back( lead1 );
         edges.push_back( lead2 );
 
+        bands.Add( split_2 );
+        bands.Add( lead1 );
+        bands.Add( lead2 );
+
         FractureEdge* link = e_nearest->m_next;
 
         e_nearest->m_p2 = VECTOR2I( x_nearest, y );
@@ -804,26 +872,26 @@ void SHAPE_POLY_SET::fractureSingle( POLYGON& paths )
         first = false;    // first path is always the outline
     }
 
-    // keep connecting holes to the main outline, until there's no holes left...
-    while( num_unconnected > 0 )
-    {
-        int x_min = std::numeric_limits<int>::max();
+    BOX2I bbox = paths[0].BBox();
+    FractureEdgeBands bands( bbox.GetY(), bbox.GetBottom(), edges.size() );
 
-        FractureEdge* smallestX = NULL;
-
-        // find the left-most hole edge and merge with the outline
-        for( FractureEdge* border_edge : border_edges )
-        {
-            int xt = border_edge->m_p1.x;
+    for( FractureEdge* edge : edges )
+        bands.Add( edge );
 
-            if( ( xt < x_min ) && !border_edge->m_connected )
+    // Connect the holes to the main outline, from the left-most one to the right-most one
+    std::stable_sort( border_edges.begin(), border_edges.end(),
+            []( const FractureEdge* a, const FractureEdge* b )
             {
-                x_min = xt;
-                smallestX = border_edge;
-            }
-        }
+                return a->m_p1.x < b->m_p1.x;
+            } );
+
+    for( FractureEdge* border_edge : border_edges )
+    {
+        if( num_unconnected <= 0 )
+            break;
 
-        num_unconnected -= processEdge( edges, smallestX );
+        if( !border_edge->m_connected )
+            num_unconnected -= processEdge( edges, bands, border_edge );
     }
 
     paths.clear();
@@ -845,14 +913,33 @@ void SHAPE_POLY_SET::fractureSingle( POLYGON& paths )
 }
 
 
+// Minimal vertex count of a set to process its polygons in parallel
+static const int PARALLEL_MIN_VERTICES = 4096;
+
+
+void SHAPE_POLY_SET::forEachPolygon( const std::function<void( size_t )>& aFunc )
+{
+    if( TotalVertices() < PARALLEL_MIN_VERTICES )
+    {
+        for( size_t i = 0; i < m_polys.size(); i++ )
+            aFunc( i );
+    }
+    else
+    {
+        ParallelFor( m_polys.size(), aFunc );
+    }
+}
+
+
 void SHAPE_POLY_SET::Fracture( POLYGON_MODE aFastMode )
 {
+    touch();
     Simplify( aFastMode );    // remove overlapping holes/degeneracy
 
-    for( POLYGON& paths : m_polys )
-    {
-        fractureSingle( paths );
-    }
+    forEachPolygon( [this]( size_t aIndex )
+                    {
+                        fractureSingle( m_polys[aIndex] );
+                    } );
 }
 
 
@@ -860,350 +947,1263 @@ void SHAPE_POLY_SET::unfractureSingle( SHAPE_POLY_SET::POLYGON& aPoly )
 {
     assert( aPoly.size() == 1 );
 
-    struct EDGE
+    struct EDGE_LIST_ENTRY
     {
-        int m_index = 0;
-        SHAPE_LINE_CHAIN* m_poly = nullptr;
-        bool m_duplicate = false;
+        int index;
+        EDGE_LIST_ENTRY* next;
+    };
 
-        EDGE( SHAPE_LINE_CHAIN* aPolygon, int aIndex ) :
-            m_index( aIndex ),
-            m_poly( aPolygon )
-        {}
+    auto lc = aPoly[0];
+    lc.Simplify();
 
-        bool compareSegs( const SEG& s1, const SEG& s2 ) const
-        {
-            return (s1.A == s2.B && s1.B == s2.A);
-        }
+    int segCount = lc.SegmentCount();
+    auto edgeList = std::make_unique<EDGE_LIST_ENTRY []>( segCount );
+
+    for( int i = 0; i < segCount; i++ )
+    {
+        edgeList[i].index   = i;
+        edgeList[i].next    = &edgeList[ (i != segCount - 1) ? i + 1 : 0 ];
+    }
+
+    std::unordered_set<EDGE_LIST_ENTRY*> queue;
+
+    // Find the pairs of opposite edges (the fractures): the edges are sorted by their
+    // (lexicographically ordered) end points, so opposite edges are neighbours
+    struct EDGE_KEY
+    {
+        VECTOR2I m_min;
+        VECTOR2I m_max;
+        bool     m_reversed;
+        int      m_index;
+    };
+
+    auto lessPt = []( const VECTOR2I& a, const VECTOR2I& b )
+    {
+        return a.x < b.x || ( a.x == b.x && a.y < b.y );
+    };
+
+    std::vector<EDGE_KEY> keys;
+    keys.reserve( segCount );
+
+    for( int i = 0; i < segCount; i++ )
+    {
+        const VECTOR2I& a = lc.CPoint( i );
+        const VECTOR2I& b = lc.CPoint( i + 1 );
+        bool reversed = lessPt( b, a );
+
+        keys.push_back( { reversed ? b : a, reversed ? a : b, reversed, i } );
+    }
+
+    std::sort( keys.begin(), keys.end(),
+            [&]( const EDGE_KEY& a, const EDGE_KEY& b )
+            {
+                if( a.m_min != b.m_min )
+                    return lessPt( a.m_min, b.m_min );
+
+                if( a.m_max != b.m_max )
+                    return lessPt( a.m_max, b.m_max );
+
+                return a.m_index < b.m_index;
+            } );
+
+    // Pair each edge with the first unpaired opposite edge of its group, and process
+    // the pairs in the order of their last edge, as the edges are walked
+    std::vector<std::pair<int, int>> pairs;
+
+    for( size_t first = 0; first < keys.size(); )
+    {
+        size_t last = first + 1;
 
-        bool operator==( const EDGE& aOther ) const
+        while( last < keys.size() && keys[last].m_min == keys[first].m_min
+                && keys[last].m_max == keys[first].m_max )
         {
-            return compareSegs( m_poly->CSegment( m_index ),
-                    aOther.m_poly->CSegment( aOther.m_index ) );
+            last++;
         }
 
-        bool operator!=( const EDGE& aOther ) const
+        std::vector<bool> paired( last - first, false );
+
+        for( size_t ii = first; ii < last; ii++ )
         {
-            return !compareSegs( m_poly->CSegment( m_index ),
-                    aOther.m_poly->CSegment( aOther.m_index ) );
+            if( paired[ii - first] )
+                continue;
+
+            for( size_t jj = ii + 1; jj < last; jj++ )
+            {
+                if( !paired[jj - first] && keys[jj].m_reversed != keys[ii].m_reversed )
+                {
+                    paired[ii - first] = paired[jj - first] = true;
+                    pairs.emplace_back( keys[ii].m_index, keys[jj].m_index );
+                    break;
+                }
+            }
         }
 
-        struct HASH
-        {
-            std::size_t operator()(  const EDGE& aEdge ) const
+        first = last;
+    }
+
+    std::sort( pairs.begin(), pairs.end(),
+            []( const std::pair<int, int>& a, const std::pair<int, int>& b )
             {
-                const auto& a = aEdge.m_poly->CSegment( aEdge.m_index );
+                return std::max( a.first, a.second ) < std::max( b.first, b.second );
+            } );
 
-                return (std::size_t) ( a.A.x + a.B.x + a.A.y + a.B.y );
-            }
-        };
-    };
+    for( const std::pair<int, int>& pair : pairs )
+    {
+        int e1 = std::min( pair.first, pair.second );
+        int e2 = std::max( pair.first, pair.second );
 
-    struct EDGE_LIST_ENTRY
+        int e1_prev = e1 - 1;
+
+        if( e1_prev < 0 )
+            e1_prev = segCount - 1;
+
+        int e2_prev = e2 - 1;
+
+        if( e2_prev < 0 )
+            e2_prev = segCount - 1;
+
+        int e1_next = e1 + 1;
+
+        if( e1_next == segCount )
+            e1_next = 0;
+
+        int e2_next = e2 + 1;
+
+        if( e2_next == segCount )
+            e2_next = 0;
+
+        edgeList[e1_prev].next  = &edgeList[ e2_next ];
+        edgeList[e2_prev].next  = &edgeList[ e1_next ];
+        edgeList[e1].next = nullptr;
+        edgeList[e2].next = nullptr;
+    }
+
+    for( int i = 0; i < segCount; i++ )
     {
-        int index;
-        EDGE_LIST_ENTRY* next;
-    };
+        if( edgeList[i].next )
+            queue.insert( &edgeList[i] );
+    }
 
-    std::unordered_set<EDGE, EDGE::HASH> uniqueEdges;
+    auto edgeBuf = std::make_unique<EDGE_LIST_ENTRY* []>( segCount );
 
-    auto lc = aPoly[0];
-    lc.Simplify();
+    int n = 0;
+    int outline = -1;
 
-    auto edgeList = std::make_unique<EDGE_LIST_ENTRY []>( lc.SegmentCount() );
+    POLYGON result;
 
-    for( int i = 0; i < lc.SegmentCount(); i++ )
+    while( queue.size() )
     {
-        edgeList[i].index   = i;
-        edgeList[i].next    = &edgeList[ (i != lc.SegmentCount() - 1) ? i + 1 : 0 ];
+        auto    e_first = (*queue.begin() );
+        auto    e = e_first;
+        int     cnt = 0;
+
+        do {
+            edgeBuf[cnt++] = e;
+            e = e->next;
+        } while( e && e != e_first );
+
+        SHAPE_LINE_CHAIN outl;
+
+        for( int i = 0; i < cnt; i++ )
+        {
+            auto p = lc.CPoint( edgeBuf[i]->index );
+            outl.Append( p );
+            queue.erase( edgeBuf[i] );
+        }
+
+        outl.SetClosed( true );
+
+        bool cw = outl.Area() > 0.0;
+
+        if( cw )
+            outline = n;
+
+        result.push_back( outl );
+        n++;
     }
 
-    std::unordered_set<EDGE_LIST_ENTRY*> queue;
+    if( outline > 0 )
+        std::swap( result[0], result[outline] );
+
+    aPoly = result;
+}
+
 
-    for( int i = 0; i < lc.SegmentCount(); i++ )
+bool SHAPE_POLY_SET::HasHoles() const
+{
+    // Iterate through all the polygons on the set
+    for( const POLYGON& paths : m_polys )
     {
-        EDGE e( &lc, i );
-        uniqueEdges.insert( e );
+        // If any of them has more than one contour, it is a hole.
+        if( paths.size() > 1 )
+            return true;
     }
 
-    for( int i = 0; i < lc.SegmentCount(); i++ )
+    // Return false if and only if every polygon has just one outline, without holes.
+    return false;
+}
+
+
+void SHAPE_POLY_SET::Unfracture( POLYGON_MODE aFastMode )
+{
+    touch();
+
+    forEachPolygon( [this]( size_t aIndex )
+                    {
+                        unfractureSingle( m_polys[aIndex] );
+                    } );
+
+    Simplify( aFastMode );    // remove overlapping holes/degeneracy
+}
+
+
+void SHAPE_POLY_SET::Simplify( POLYGON_MODE aFastMode )
+{
+    touch();
+    SHAPE_POLY_SET empty;
+
+    booleanOp( ctUnion, empty, aFastMode );
+}
+
+
+// Maximal polygon count of the tiles merged by BatchedUnion()
+static const size_t BATCHED_UNION_TILE_SIZE = 256;
+
+
+/*
+ * A polygon (outline and holes) kept in the Clipper format, with the bounding box
+ * of its outline, for BatchedUnion()
+ */
+struct CLIPPER_POLYGON
+{
+    Paths    m_Paths;
+    IntRect  m_BBox;
+};
+
+
+static IntRect clipperBBox( const Path& aPath )
+{
+    IntRect bbox = { 0, 0, 0, 0 };
+
+    if( aPath.empty() )
+        return bbox;
+
+    bbox.left = bbox.right = aPath[0].X;
+    bbox.top = bbox.bottom = aPath[0].Y;
+
+    for( const IntPoint& pt : aPath )
     {
-        EDGE    e( &lc, i );
-        auto    it = uniqueEdges.find( e );
+        bbox.left = std::min( bbox.left, pt.X );
+        bbox.right = std::max( bbox.right, pt.X );
+        bbox.top = std::min( bbox.top, pt.Y );
+        bbox.bottom = std::max( bbox.bottom, pt.Y );
+    }
+
+    return bbox;
+}
+
+
+static bool clipperBBoxIntersects( const IntRect& aA, const IntRect& aB )
+{
+    return aA.left <= aB.right && aB.left <= aA.right
+            && aA.top <= aB.bottom && aB.top <= aA.bottom;
+}
+
+
+static IntRect clipperBBoxMerge( const IntRect& aA, const IntRect& aB )
+{
+    return { std::min( aA.left, aB.left ), std::min( aA.top, aB.top ),
+             std::max( aA.right, aB.right ), std::max( aA.bottom, aB.bottom ) };
+}
+
+
+/*
+ * Merges the polygons aPolys[aBegin..aEnd[ and appends the resulting polygons to aResult
+ */
+static void clipperUnion( std::vector<CLIPPER_POLYGON>& aPolys, size_t aBegin, size_t aEnd,
+                          bool aStrictlySimple, std::vector<CLIPPER_POLYGON>& aResult )
+{
+    Clipper c;
+
+    c.StrictlySimple( aStrictlySimple );
+
+    for( size_t ii = aBegin; ii < aEnd; ii++ )
+        c.AddPaths( aPolys[ii].m_Paths, ptSubject, true );
 
-        if( it != uniqueEdges.end() && it->m_index != i )
+    PolyTree solution;
+
+    c.Execute( ctUnion, solution, pftNonZero, pftNonZero );
+
+    for( PolyNode* n = solution.GetFirst(); n; n = n->GetNext() )
+    {
+        if( !n->IsHole() )
         {
-            int e1  = it->m_index;
-            int e2  = i;
+            CLIPPER_POLYGON poly;
+
+            poly.m_Paths.reserve( n->Childs.size() + 1 );
+            poly.m_Paths.push_back( std::move( n->Contour ) );
+
+            for( PolyNode* child : n->Childs )
+                poly.m_Paths.push_back( std::move( child->Contour ) );
+
+            poly.m_BBox = clipperBBox( poly.m_Paths[0] );
+            aResult.push_back( std::move( poly ) );
+        }
+    }
+}
+
 
-            if( e1 > e2 )
-                std::swap( e1, e2 );
+/*
+ * Merges two already merged groups of polygons aA and aB into aResult.  Only the polygons
+ * of a group that can overlap the other group are merged again, the other ones are moved
+ * unchanged.  aA and aB are left empty.
+ */
+static void clipperStitch( std::vector<CLIPPER_POLYGON>& aA, std::vector<CLIPPER_POLYGON>& aB,
+                           bool aStrictlySimple, std::vector<CLIPPER_POLYGON>& aResult )
+{
+    if( aA.empty() || aB.empty() )
+    {
+        aResult = aA.empty() ? std::move( aB ) : std::move( aA );
+        aA.clear();
+        aB.clear();
+        return;
+    }
+
+    auto groupBBox =
+            []( const std::vector<CLIPPER_POLYGON>& aGroup )
+            {
+                IntRect bbox = aGroup[0].m_BBox;
+
+                for( const CLIPPER_POLYGON& poly : aGroup )
+                    bbox = clipperBBoxMerge( bbox, poly.m_BBox );
+
+                return bbox;
+            };
+
+    IntRect bboxA = groupBBox( aA );
+    IntRect bboxB = groupBBox( aB );
+    std::vector<CLIPPER_POLYGON> border;
+
+    aResult.reserve( aA.size() + aB.size() );
+
+    auto split =
+            [&]( std::vector<CLIPPER_POLYGON>& aGroup, const IntRect& aOtherBBox )
+            {
+                for( CLIPPER_POLYGON& poly : aGroup )
+                {
+                    if( clipperBBoxIntersects( poly.m_BBox, aOtherBBox ) )
+                        border.push_back( std::move( poly ) );
+                    else
+                        aResult.push_back( std::move( poly ) );
+                }
 
-            int e1_prev = e1 - 1;
+                aGroup.clear();
+                aGroup.shrink_to_fit();
+            };
+
+    split( aA, bboxB );
+    split( aB, bboxA );
+
+    if( !border.empty() )
+        clipperUnion( border, 0, border.size(), aStrictlySimple, aResult );
+}
+
+
+void SHAPE_POLY_SET::BatchedUnion( POLYGON_MODE aFastMode )
+{
+    if( m_polys.size() <= BATCHED_UNION_TILE_SIZE )
+    {
+        Simplify( aFastMode );
+        return;
+    }
+
+    touch();
+
+    bool strictlySimple = ( aFastMode == PM_STRICTLY_SIMPLE );
+    std::vector<CLIPPER_POLYGON> polys;
+
+    polys.reserve( m_polys.size() );
+
+    for( const POLYGON& poly : m_polys )
+    {
+        if( poly.empty() || poly[0].PointCount() == 0 )
+            continue;
 
-            if( e1_prev < 0 )
-                e1_prev = lc.SegmentCount() - 1;
+        CLIPPER_POLYGON clipperPoly;
 
-            int e2_prev = e2 - 1;
+        for( size_t i = 0; i < poly.size(); i++ )
+            clipperPoly.m_Paths.push_back( poly[i].convertToClipper( i == 0 ) );
+
+        clipperPoly.m_BBox = clipperBBox( clipperPoly.m_Paths[0] );
+        polys.push_back( std::move( clipperPoly ) );
+    }
+
+    m_polys.clear();
+
+    // Build the tiles: the polygons are recursively split in two halves at the median of
+    // their bounding box centers, along the longest axis of the group, until the groups
+    // are small enough.
+    std::vector<std::pair<size_t, size_t>> tiles;
+
+    std::function<void( size_t, size_t )> buildTiles =
+            [&]( size_t aBegin, size_t aEnd )
+            {
+                if( aEnd - aBegin <= BATCHED_UNION_TILE_SIZE )
+                {
+                    tiles.emplace_back( aBegin, aEnd );
+                    return;
+                }
+
+                IntRect bbox = polys[aBegin].m_BBox;
+
+                for( size_t ii = aBegin + 1; ii < aEnd; ii++ )
+                    bbox = clipperBBoxMerge( bbox, polys[ii].m_BBox );
+
+                bool splitX = ( bbox.right - bbox.left ) >= ( bbox.bottom - bbox.top );
+                size_t middle = aBegin + ( aEnd - aBegin ) / 2;
+
+                std::nth_element( polys.begin() + aBegin, polys.begin() + middle,
+                                  polys.begin() + aEnd,
+                        [splitX]( const CLIPPER_POLYGON& a, const CLIPPER_POLYGON& b )
+                        {
+                            if( splitX )
+                                return a.m_BBox.left + a.m_BBox.right
+                                        < b.m_BBox.left + b.m_BBox.right;
+                            else
+                                return a.m_BBox.top + a.m_BBox.bottom
+                                        < b.m_BBox.top + b.m_BBox.bottom;
+                        } );
+
+                buildTiles( aBegin, middle );
+                buildTiles( middle, aEnd );
+            };
+
+    buildTiles( 0, polys.size() );
+
+    // Merge the tiles in parallel
+    std::vector<std::vector<CLIPPER_POLYGON>> results( tiles.size() );
+
+    ParallelFor( tiles.size(),
+                 [&]( size_t aTile )
+                 {
+                     clipperUnion( polys, tiles[aTile].first, tiles[aTile].second,
+                                   strictlySimple, results[aTile] );
+                 } );
+
+    polys.clear();
+    polys.shrink_to_fit();
+
+    // Stitch the tiles pairwise, level by level, in the reverse order of their split: the
+    // tiles were built as the leaves of a binary partition, so neighbour tiles are stitched
+    // first, and each level only merges again the polygons crossing the border of a pair.
+    while( results.size() > 1 )
+    {
+        std::vector<std::vector<CLIPPER_POLYGON>> stitched( ( results.size() + 1 ) / 2 );
+
+        ParallelFor( results.size() / 2,
+                     [&]( size_t aPair )
+                     {
+                         clipperStitch( results[2 * aPair], results[2 * aPair + 1],
+                                        strictlySimple, stitched[aPair] );
+                     } );
+
+        if( results.size() % 2 )
+            stitched.back() = std::move( results.back() );
+
+        results = std::move( stitched );
+    }
+
+    std::vector<CLIPPER_POLYGON>& merged = results[0];
+
+    for( const CLIPPER_POLYGON& clipperPoly : merged )
+    {
+        POLYGON poly;
+
+        poly.reserve( clipperPoly.m_Paths.size() );
+
+        for( const Path& path : clipperPoly.m_Paths )
+            poly.emplace_back( path );
+
+        m_polys.push_back( std::move( poly ) );
+    }
+}
+
+
+int SHAPE_POLY_SET::NormalizeAreaOutlines()
+{
+    touch();
+    // We are expecting only one main outline, but this main outline can have holes
+    // if holes: combine holes and remove them from the main outline.
+    // Note also we are using SHAPE_POLY_SET::PM_STRICTLY_SIMPLE in polygon
+    // calculations, but it is not mandatory. It is used mainly
+    // because there is usually only very few vertices in area outlines
+    SHAPE_POLY_SET::POLYGON& outline = Polygon( 0 );
+    SHAPE_POLY_SET holesBuffer;
+
+    // Move holes stored in outline to holesBuffer:
+    // The first SHAPE_LINE_CHAIN is the main outline, others are holes
+    while( outline.size() > 1 )
+    {
+        holesBuffer.AddOutline( outline.back() );
+        outline.pop_back();
+    }
+
+    Simplify( SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
+
+    // If any hole, substract it to main outline
+    if( holesBuffer.OutlineCount() )
+    {
+        holesBuffer.Simplify( SHAPE_POLY_SET::PM_FAST );
+        BooleanSubtract( holesBuffer, SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
+    }
+
+    RemoveNullSegments();
+
+    return OutlineCount();
+}
+
+
+const std::string SHAPE_POLY_SET::Format() const
+{
+    std::stringstream ss;
+
+    ss << "polyset " << m_polys.size() << "\n";
+
+    for( unsigned i = 0; i < m_polys.size(); i++ )
+    {
+        ss << "poly " << m_polys[i].size() << "\n";
+
+        for( unsigned j = 0; j < m_polys[i].size(); j++ )
+        {
+            ss << m_polys[i][j].PointCount() << "\n";
+
+            for( int v = 0; v < m_polys[i][j].PointCount(); v++ )
+                ss << m_polys[i][j].CPoint( v ).x << " " << m_polys[i][j].CPoint( v ).y << "\n";
+        }
+
+        ss << "\n";
+    }
+
+    return ss.str();
+}
+
+
+bool SHAPE_POLY_SET::Parse( std::stringstream& aStream )
+{
+    touch();
+    std::string tmp;
+
+    aStream >> tmp;
+
+    if( tmp != "polyset" )
+        return false;
+
+    aStream >> tmp;
+
+    int n_polys = atoi( tmp.c_str() );
+
+    if( n_polys < 0 )
+        return false;
+
+    for( int i = 0; i < n_polys; i++ )
+    {
+        POLYGON paths;
+
+        aStream >> tmp;
+
+        if( tmp != "poly" )
+            return false;
+
+        aStream >> tmp;
+        int n_outlines = atoi( tmp.c_str() );
+
+        if( n_outlines < 0 )
+            return false;
+
+        for( int j = 0; j < n_outlines; j++ )
+        {
+            SHAPE_LINE_CHAIN outline;
+
+            outline.SetClosed( true );
+
+            aStream >> tmp;
+            int n_vertices = atoi( tmp.c_str() );
+
+            for( int v = 0; v < n_vertices; v++ )
+            {
+                VECTOR2I p;
+
+                aStream >> tmp; p.x = atoi( tmp.c_str() );
+                aStream >> tmp; p.y = atoi( tmp.c_str() );
+                outline.Append( p );
+            }
+
+            paths.push_back( outline );
+        }
+
+        m_polys.push_back( paths );
+    }
+
+    return true;
+}
+
+
+const BOX2I SHAPE_POLY_SET::BBox( int aClearance ) const
+{
+    BOX2I bb;
+
+    for( unsigned i = 0; i < m_polys.size(); i++ )
+    {
+        if( i == 0 )
+            bb = m_polys[i][0].BBox();
+        else
+            bb.Merge( m_polys[i][0].BBox() );
+    }
+
+    bb.Inflate( aClearance );
+    return bb;
+}
+
+
+bool SHAPE_POLY_SET::PointOnEdge( const VECTOR2I& aP ) const
+{
+    // Iterate through all the polygons in the set
+    for( const POLYGON& polygon : m_polys )
+    {
+        // Iterate through all the line chains in the polygon
+        for( const SHAPE_LINE_CHAIN& lineChain : polygon )
+        {
+            if( lineChain.PointOnEdge( aP ) )
+                return true;
+        }
+    }
+
+    return false;
+}
+
+
+///> Max number of rows and columns of the grid indexing the edges of a polygon
+static const int EDGE_INDEX_MAX_GRID_SIZE = 1024;
+
+
+///> Distance between aBox and the rectangle [aX0, aX1] x [aY0, aY1]
+static double boxDistance( const BOX2I& aBox, double aX0, double aY0, double aX1, double aY1 )
+{
+    double dx = std::max( { aX0 - aBox.GetRight(), aBox.GetLeft() - aX1, 0.0 } );
+    double dy = std::max( { aY0 - aBox.GetBottom(), aBox.GetTop() - aY1, 0.0 } );
+
+    return std::hypot( dx, dy );
+}
+
+
+/**
+ * Spatial index of the edges of the polygons of a SHAPE_POLY_SET.  Each polygon is covered by
+ * a uniform grid of about one cell per edge: each cell lists the edges passing through it, and
+ * each row lists the non-horizontal edges of the closed contours spanning it, which are the
+ * only ones the ray casting of the point in polygon test has to look at.
+ */
+class SHAPE_POLY_SET::EDGE_INDEX
+{
+public:
+    EDGE_INDEX( const POLYSET& aPolys, unsigned long long aGeneration );
+
+    unsigned long long GetGeneration() const { return m_generation; }
+
+    ///> Same as SHAPE_POLY_SET::Contains(), aPoly being the polygon to test or -1 for all
+    bool Contains( const VECTOR2I& aP, int aPoly, int aAccuracy ) const;
+
+    ///> Returns true if aP is closer than aClearance to an edge, or inside a polygon
+    bool Collide( const VECTOR2I& aP, int aClearance ) const;
+
+    ///> Returns true if aSeg is closer than aClearance to an edge, or inside a polygon
+    bool Collide( const SEG& aSeg, int aClearance ) const;
+
+    ///> Same as SHAPE_POLY_SET::SquaredDistanceToPolygon(), or SquaredDistance() if aPoly is -1
+    SEG::ecoord SquaredDistance( const VECTOR2I& aP, int aPoly ) const;
+    SEG::ecoord SquaredDistance( const SEG& aSeg, int aPoly ) const;
+
+private:
+    struct EDGE
+    {
+        SEG m_seg;
+        int m_contour;
+    };
+
+    struct GRID
+    {
+        int64_t           m_x0 = 0;
+        int64_t           m_y0 = 0;
+        int64_t           m_width = 1;
+        int64_t           m_height = 1;
+        int               m_cols = 1;
+        int               m_rows = 1;
+        std::vector<EDGE> m_edges;
+        std::vector<bool> m_validContours;  ///< closed contours, with at least 3 points
+        std::vector<int>  m_cellStart;      ///< start of the edges of each cell in m_cellEdges
+        std::vector<int>  m_cellEdges;
+        std::vector<int>  m_rowStart;       ///< start of the edges of each row in m_rowEdges
+        std::vector<int>  m_rowEdges;       ///< sorted by contour in each row
+
+        int Col( int64_t aX ) const
+        {
+            int64_t col = ( aX - m_x0 ) * m_cols / m_width;
+            return (int) std::max<int64_t>( 0, std::min<int64_t>( col, m_cols - 1 ) );
+        }
+
+        int Row( int64_t aY ) const
+        {
+            int64_t row = ( aY - m_y0 ) * m_rows / m_height;
+            return (int) std::max<int64_t>( 0, std::min<int64_t>( row, m_rows - 1 ) );
+        }
+
+        double ColLeft( int aCol ) const { return m_x0 + (double) aCol * m_width / m_cols; }
+        double RowTop( int aRow ) const { return m_y0 + (double) aRow * m_height / m_rows; }
+
+        ///> Distance between aBox and the area covered by the grid
+        double Distance( const BOX2I& aBox ) const
+        {
+            return boxDistance( aBox, m_x0, m_y0, m_x0 + m_width, m_y0 + m_height );
+        }
+
+        /**
+         * Calls aFunc with the index of each cell which can contain a point closer than aPad
+         * to aSeg (and maybe some other ones).
+         */
+        template <typename FUNC>
+        void ForEachCell( const SEG& aSeg, int aPad, FUNC aFunc ) const
+        {
+            const VECTOR2I& a = aSeg.A;
+            const VECTOR2I& b = aSeg.B;
+            int64_t         yMin = std::min( a.y, b.y );
+            int64_t         yMax = std::max( a.y, b.y );
+            int             lastRow = Row( yMax + aPad );
+
+            for( int row = Row( yMin - aPad ); row <= lastRow; row++ )
+            {
+                int64_t xMin = std::min( a.x, b.x );
+                int64_t xMax = std::max( a.x, b.x );
+
+                if( a.y != b.y )
+                {
+                    // The part of the segment which can come closer than aPad to the row
+                    double yLo = std::max<double>( yMin, RowTop( row ) - aPad );
+                    double yHi = std::min<double>( yMax, RowTop( row + 1 ) + aPad );
+
+                    if( yLo > yHi )
+                        continue;
+
+                    double slope = double( b.x - a.x ) / ( b.y - a.y );
+                    double x1 = a.x + slope * ( yLo - a.y );
+                    double x2 = a.x + slope * ( yHi - a.y );
+
+                    xMin = (int64_t) std::floor( std::min( x1, x2 ) ) - 1;
+                    xMax = (int64_t) std::ceil( std::max( x1, x2 ) ) + 1;
+                }
+
+                int lastCol = Col( xMax + aPad );
+
+                for( int col = Col( xMin - aPad ); col <= lastCol; col++ )
+                    aFunc( row * m_cols + col );
+            }
+        }
+    };
+
+    void buildGrid( GRID& aGrid, const POLYGON& aPoly );
+
+    bool containsSingle( const GRID& aGrid, const VECTOR2I& aP, int aAccuracy ) const;
+
+    ///> Returns true if aPred is true for an edge closer than aPad to aSeg
+    template <typename PRED>
+    bool anyEdge( const SEG& aSeg, int aPad, PRED aPred ) const;
+
+    ///> Returns the min of aBest and of aDist over the edges of aGrid, aDist being a distance to
+    ///> a point or a segment contained in aQuery
+    template <typename DIST_FUNC>
+    SEG::ecoord nearestEdge( const GRID& aGrid, const BOX2I& aQuery, SEG::ecoord aBest,
+                             DIST_FUNC aDist ) const;
+
+    template <typename DIST_FUNC>
+    SEG::ecoord squaredDistance( const VECTOR2I& aInsidePoint, const BOX2I& aQuery, int aPoly,
+                                 DIST_FUNC aDist ) const;
+
+    std::vector<GRID>  m_grids;
+    unsigned long long m_generation;
+};
+
+
+SHAPE_POLY_SET::EDGE_INDEX::EDGE_INDEX( const POLYSET& aPolys, unsigned long long aGeneration ) :
+        m_grids( aPolys.size() ),
+        m_generation( aGeneration )
+{
+    for( size_t ii = 0; ii < aPolys.size(); ii++ )
+        buildGrid( m_grids[ii], aPolys[ii] );
+}
+
+
+void SHAPE_POLY_SET::EDGE_INDEX::buildGrid( GRID& aGrid, const POLYGON& aPoly )
+{
+    BOX2I bbox;
+    bool  first = true;
+
+    for( size_t contour = 0; contour < aPoly.size(); contour++ )
+    {
+        const SHAPE_LINE_CHAIN&      path = aPoly[contour];
+        const std::vector<VECTOR2I>& points = path.CPoints();
+        int                          segCount = path.SegmentCount();
+
+        aGrid.m_validContours.push_back( path.IsClosed() && points.size() >= 3 );
+
+        for( int ii = 0; ii < segCount; ii++ )
+        {
+            const VECTOR2I& p1 = points[ii];
+            const VECTOR2I& p2 = points[ ii + 1 == (int) points.size() ? 0 : ii + 1 ];
+
+            aGrid.m_edges.push_back( { SEG( p1, p2 ), (int) contour } );
+        }
+
+        for( const VECTOR2I& pt : points )
+        {
+            if( first )
+                bbox = BOX2I( pt, VECTOR2I( 0, 0 ) );
+            else
+                bbox.Merge( pt );
+
+            first = false;
+        }
+    }
+
+    if( aGrid.m_edges.empty() )
+    {
+        aGrid.m_cellStart.assign( 2, 0 );
+        aGrid.m_rowStart.assign( 2, 0 );
+        return;
+    }
+
+    aGrid.m_x0 = bbox.GetX();
+    aGrid.m_y0 = bbox.GetY();
+    aGrid.m_width = (int64_t) bbox.GetWidth() + 1;
+    aGrid.m_height = (int64_t) bbox.GetHeight() + 1;
+
+    // About one cell per edge, with square-ish cells
+    double edgeCount = aGrid.m_edges.size();
+    double aspect = (double) aGrid.m_width / aGrid.m_height;
+
+    aGrid.m_cols = (int) std::max( 1.0, std::min<double>( std::sqrt( edgeCount * aspect ),
+                                                          EDGE_INDEX_MAX_GRID_SIZE ) );
+    aGrid.m_rows = (int) std::max( 1.0, std::min<double>( std::sqrt( edgeCount / aspect ),
+                                                          EDGE_INDEX_MAX_GRID_SIZE ) );
+
+    // Count, then fill the edges of the cells and of the rows
+    aGrid.m_cellStart.assign( aGrid.m_cols * aGrid.m_rows + 1, 0 );
+    aGrid.m_rowStart.assign( aGrid.m_rows + 1, 0 );
+
+    auto rowSpan = [&]( const EDGE& aEdge, int& aFirst, int& aLast ) -> bool
+    {
+        const SEG& seg = aEdge.m_seg;
+
+        // Horizontal edges are never crossed by the ray of the point in polygon test
+        if( !aGrid.m_validContours[aEdge.m_contour] || seg.A.y == seg.B.y )
+            return false;
+
+        aFirst = aGrid.Row( std::min( seg.A.y, seg.B.y ) );
+        aLast = aGrid.Row( std::max( seg.A.y, seg.B.y ) );
+        return true;
+    };
+
+    for( const EDGE& edge : aGrid.m_edges )
+    {
+        int first, last;
+
+        aGrid.ForEachCell( edge.m_seg, 0,
+                           [&]( int aCell )
+                           {
+                               aGrid.m_cellStart[aCell + 1]++;
+                           } );
+
+        if( rowSpan( edge, first, last ) )
+        {
+            for( int row = first; row <= last; row++ )
+                aGrid.m_rowStart[row + 1]++;
+        }
+    }
 
-            if( e2_prev < 0 )
-                e2_prev = lc.SegmentCount() - 1;
+    std::partial_sum( aGrid.m_cellStart.begin(), aGrid.m_cellStart.end(),
+                      aGrid.m_cellStart.begin() );
+    std::partial_sum( aGrid.m_rowStart.begin(), aGrid.m_rowStart.end(),
+                      aGrid.m_rowStart.begin() );
 
-            int e1_next = e1 + 1;
+    aGrid.m_cellEdges.resize( aGrid.m_cellStart.back() );
+    aGrid.m_rowEdges.resize( aGrid.m_rowStart.back() );
 
-            if( e1_next == lc.SegmentCount() )
-                e1_next = 0;
+    std::vector<int> cellFill( aGrid.m_cellStart.begin(), aGrid.m_cellStart.end() - 1 );
+    std::vector<int> rowFill( aGrid.m_rowStart.begin(), aGrid.m_rowStart.end() - 1 );
 
-            int e2_next = e2 + 1;
+    for( int ii = 0; ii < (int) aGrid.m_edges.size(); ii++ )
+    {
+        const EDGE& edge = aGrid.m_edges[ii];
+        int         first, last;
 
-            if( e2_next == lc.SegmentCount() )
-                e2_next = 0;
+        aGrid.ForEachCell( edge.m_seg, 0,
+                           [&]( int aCell )
+                           {
+                               aGrid.m_cellEdges[ cellFill[aCell]++ ] = ii;
+                           } );
 
-            edgeList[e1_prev].next  = &edgeList[ e2_next ];
-            edgeList[e2_prev].next  = &edgeList[ e1_next ];
-            edgeList[i].next = nullptr;
-            edgeList[it->m_index].next = nullptr;
+        if( rowSpan( edge, first, last ) )
+        {
+            for( int row = first; row <= last; row++ )
+                aGrid.m_rowEdges[ rowFill[row]++ ] = ii;
         }
     }
+}
 
-    for( int i = 0; i < lc.SegmentCount(); i++ )
-    {
-        if( edgeList[i].next )
-            queue.insert( &edgeList[i] );
-    }
-
-    auto edgeBuf = std::make_unique<EDGE_LIST_ENTRY* []>( lc.SegmentCount() );
 
-    int n = 0;
-    int outline = -1;
+bool SHAPE_POLY_SET::EDGE_INDEX::containsSingle( const GRID& aGrid, const VECTOR2I& aP,
+                                                 int aAccuracy ) const
+{
+    if( aGrid.m_validContours.empty() || !aGrid.m_validContours[0] )
+        return false;
 
-    POLYGON result;
+    bool inOutline = false;
+    bool inHole = false;
 
-    while( queue.size() )
+    if( aP.y >= aGrid.m_y0 && aP.y < aGrid.m_y0 + aGrid.m_height )
     {
-        auto    e_first = (*queue.begin() );
-        auto    e = e_first;
-        int     cnt = 0;
-
-        do {
-            edgeBuf[cnt++] = e;
-            e = e->next;
-        } while( e && e != e_first );
+        int  row = aGrid.Row( aP.y );
+        int  contour = -1;
+        bool inside = false;
 
-        SHAPE_LINE_CHAIN outl;
+        auto closeContour = [&]()
+        {
+            if( inside && contour == 0 )
+                inOutline = true;
+            else if( inside )
+                inHole = true;
+        };
 
-        for( int i = 0; i < cnt; i++ )
+        // Same test as SHAPE_LINE_CHAIN::PointInside(), for all the contours at once
+        for( int ii = aGrid.m_rowStart[row]; ii < aGrid.m_rowStart[row + 1]; ii++ )
         {
-            auto p = lc.CPoint( edgeBuf[i]->index );
-            outl.Append( p );
-            queue.erase( edgeBuf[i] );
-        }
+            const EDGE& edge = aGrid.m_edges[ aGrid.m_rowEdges[ii] ];
 
-        outl.SetClosed( true );
+            if( edge.m_contour != contour )
+            {
+                closeContour();
+                contour = edge.m_contour;
+                inside = false;
+            }
 
-        bool cw = outl.Area() > 0.0;
+            const VECTOR2I& p1 = edge.m_seg.A;
+            const VECTOR2I& p2 = edge.m_seg.B;
+            const VECTOR2I  diff = p2 - p1;
+            const int       d = rescale( diff.x, ( aP.y - p1.y ), diff.y );
 
-        if( cw )
-            outline = n;
+            if( ( ( p1.y > aP.y ) != ( p2.y > aP.y ) ) && ( aP.x - p1.x < d ) )
+                inside = !inside;
+        }
 
-        result.push_back( outl );
-        n++;
+        closeContour();
     }
 
-    if( outline > 0 )
-        std::swap( result[0], result[outline] );
+    // Holes are tested with an accuracy of 1, as in SHAPE_POLY_SET::containsSingle(), so
+    // only the edges of the outline have to be checked, as SHAPE_LINE_CHAIN::PointOnEdge() does.
+    if( aAccuracy != 1 )
+    {
+        int  maxDist = aAccuracy == 0 ? 1 : aAccuracy;
+        bool onEdge = false;
 
-    aPoly = result;
+        aGrid.ForEachCell( SEG( aP, aP ), std::max( maxDist, 0 ) + 2,
+                           [&]( int aCell )
+                           {
+                               for( int ii = aGrid.m_cellStart[aCell];
+                                    !onEdge && ii < aGrid.m_cellStart[aCell + 1]; ii++ )
+                               {
+                                   const EDGE& edge = aGrid.m_edges[ aGrid.m_cellEdges[ii] ];
+
+                                   if( edge.m_contour == 0
+                                           && ( edge.m_seg.A == aP || edge.m_seg.B == aP
+                                                || edge.m_seg.Distance( aP ) <= maxDist ) )
+                                   {
+                                       onEdge = true;
+                                   }
+                               }
+                           } );
+
+        if( aAccuracy == 0 )
+            inOutline = inOutline && !onEdge;
+        else
+            inOutline = inOutline || onEdge;
+    }
+
+    return inOutline && !inHole;
 }
 
 
-bool SHAPE_POLY_SET::HasHoles() const
+bool SHAPE_POLY_SET::EDGE_INDEX::Contains( const VECTOR2I& aP, int aPoly, int aAccuracy ) const
 {
-    // Iterate through all the polygons on the set
-    for( const POLYGON& paths : m_polys )
+    if( aPoly >= 0 )
+        return containsSingle( m_grids[aPoly], aP, aAccuracy );
+
+    BOX2I point( aP, VECTOR2I( 0, 0 ) );
+    int   margin = std::max( aAccuracy, 1 ) + 2;
+
+    for( const GRID& grid : m_grids )
     {
-        // If any of them has more than one contour, it is a hole.
-        if( paths.size() > 1 )
+        if( grid.Distance( point ) <= margin && containsSingle( grid, aP, aAccuracy ) )
             return true;
     }
 
-    // Return false if and only if every polygon has just one outline, without holes.
     return false;
 }
 
 
-void SHAPE_POLY_SET::Unfracture( POLYGON_MODE aFastMode )
+template <typename PRED>
+bool SHAPE_POLY_SET::EDGE_INDEX::anyEdge( const SEG& aSeg, int aPad, PRED aPred ) const
 {
-    for( POLYGON& path : m_polys )
+    BOX2I area = BOX2I( aSeg.A, aSeg.B - aSeg.A ).Normalize();
+
+    for( const GRID& grid : m_grids )
     {
-        unfractureSingle( path );
-    }
+        if( grid.m_edges.empty() || grid.Distance( area ) > aPad )
+            continue;
 
-    Simplify( aFastMode );    // remove overlapping holes/degeneracy
-}
+        bool found = false;
 
+        grid.ForEachCell( aSeg, aPad,
+                          [&]( int aCell )
+                          {
+                              for( int ii = grid.m_cellStart[aCell];
+                                   !found && ii < grid.m_cellStart[aCell + 1]; ii++ )
+                              {
+                                  found = aPred( grid.m_edges[ grid.m_cellEdges[ii] ].m_seg );
+                              }
+                          } );
 
-void SHAPE_POLY_SET::Simplify( POLYGON_MODE aFastMode )
-{
-    SHAPE_POLY_SET empty;
+        if( found )
+            return true;
+    }
 
-    booleanOp( ctUnion, empty, aFastMode );
+    return false;
 }
 
 
-int SHAPE_POLY_SET::NormalizeAreaOutlines()
+bool SHAPE_POLY_SET::EDGE_INDEX::Collide( const VECTOR2I& aP, int aClearance ) const
 {
-    // We are expecting only one main outline, but this main outline can have holes
-    // if holes: combine holes and remove them from the main outline.
-    // Note also we are using SHAPE_POLY_SET::PM_STRICTLY_SIMPLE in polygon
-    // calculations, but it is not mandatory. It is used mainly
-    // because there is usually only very few vertices in area outlines
-    SHAPE_POLY_SET::POLYGON& outline = Polygon( 0 );
-    SHAPE_POLY_SET holesBuffer;
+    if( aClearance <= 0 )
+        return Contains( aP, -1, 0 );
 
-    // Move holes stored in outline to holesBuffer:
-    // The first SHAPE_LINE_CHAIN is the main outline, others are holes
-    while( outline.size() > 1 )
-    {
-        holesBuffer.AddOutline( outline.back() );
-        outline.pop_back();
-    }
+    SEG::ecoord clearance2 = (SEG::ecoord) aClearance * aClearance;
 
-    Simplify( SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
+    return Contains( aP, -1, 1 )
+           || anyEdge( SEG( aP, aP ), aClearance + 2,
+                       [&]( const SEG& aEdge )
+                       {
+                           return aEdge.SquaredDistance( aP ) < clearance2;
+                       } );
+}
 
-    // If any hole, substract it to main outline
-    if( holesBuffer.OutlineCount() )
+
+bool SHAPE_POLY_SET::EDGE_INDEX::Collide( const SEG& aSeg, int aClearance ) const
+{
+    if( aClearance <= 0 )
     {
-        holesBuffer.Simplify( SHAPE_POLY_SET::PM_FAST );
-        BooleanSubtract( holesBuffer, SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
+        return Contains( aSeg.A, -1, 0 )
+               || anyEdge( aSeg, 2,
+                           [&]( const SEG& aEdge )
+                           {
+                               return (bool) aEdge.Intersect( aSeg, true );
+                           } );
     }
 
-    RemoveNullSegments();
+    SEG::ecoord clearance2 = (SEG::ecoord) aClearance * aClearance;
 
-    return OutlineCount();
+    return Contains( aSeg.A, -1, 1 )
+           || anyEdge( aSeg, aClearance + 2,
+                       [&]( const SEG& aEdge )
+                       {
+                           return aEdge.SquaredDistance( aSeg ) < clearance2;
+                       } );
 }
 
 
-const std::string SHAPE_POLY_SET::Format() const
+template <typename DIST_FUNC>
+SEG::ecoord SHAPE_POLY_SET::EDGE_INDEX::nearestEdge( const GRID& aGrid, const BOX2I& aQuery,
+                                                     SEG::ecoord aBest, DIST_FUNC aDist ) const
 {
-    std::stringstream ss;
+    SEG::ecoord best = aBest;
 
-    ss << "polyset " << m_polys.size() << "\n";
+    auto visit = [&]( int aCol, int aRow )
+    {
+        int cell = aRow * aGrid.m_cols + aCol;
 
-    for( unsigned i = 0; i < m_polys.size(); i++ )
+        for( int ii = aGrid.m_cellStart[cell]; best > 0 && ii < aGrid.m_cellStart[cell + 1];
+             ii++ )
+        {
+            best = std::min( best, aDist( aGrid.m_edges[ aGrid.m_cellEdges[ii] ].m_seg ) );
+        }
+    };
+
+    int c0 = aGrid.Col( aQuery.GetLeft() );
+    int c1 = aGrid.Col( aQuery.GetRight() );
+    int r0 = aGrid.Row( aQuery.GetTop() );
+    int r1 = aGrid.Row( aQuery.GetBottom() );
+
+    // Visit the cells by rings of growing size around the query, until the cells left are
+    // farther than the closest edge found so far.
+    for( int ring = 0; best > 0; ring++ )
     {
-        ss << "poly " << m_polys[i].size() << "\n";
+        int left = c0 - ring;
+        int right = c1 + ring;
+        int top = r0 - ring;
+        int bottom = r1 + ring;
 
-        for( unsigned j = 0; j < m_polys[i].size(); j++ )
+        for( int row = std::max( top, 0 ); row <= std::min( bottom, aGrid.m_rows - 1 ); row++ )
         {
-            ss << m_polys[i][j].PointCount() << "\n";
+            if( ring == 0 || row == top || row == bottom )
+            {
+                for( int col = std::max( left, 0 ); col <= std::min( right, aGrid.m_cols - 1 );
+                     col++ )
+                {
+                    visit( col, row );
+                }
+            }
+            else
+            {
+                if( left >= 0 )
+                    visit( left, row );
 
-            for( int v = 0; v < m_polys[i][j].PointCount(); v++ )
-                ss << m_polys[i][j].CPoint( v ).x << " " << m_polys[i][j].CPoint( v ).y << "\n";
+                if( right < aGrid.m_cols )
+                    visit( right, row );
+            }
         }
 
-        ss << "\n";
-    }
-
-    return ss.str();
-}
+        // Distance between the query and the cells not visited yet
+        double gridLeft = aGrid.ColLeft( 0 );
+        double gridRight = aGrid.ColLeft( aGrid.m_cols );
+        double gridTop = aGrid.RowTop( 0 );
+        double gridBottom = aGrid.RowTop( aGrid.m_rows );
+        double doneLeft = aGrid.ColLeft( std::max( left, 0 ) );
+        double doneRight = aGrid.ColLeft( std::min( right + 1, aGrid.m_cols ) );
+        double doneTop = aGrid.RowTop( std::max( top, 0 ) );
+        double doneBottom = aGrid.RowTop( std::min( bottom + 1, aGrid.m_rows ) );
+        double reach = std::numeric_limits<double>::max();
+
+        if( top > 0 )
+            reach = std::min( reach, boxDistance( aQuery, gridLeft, gridTop, gridRight, doneTop ) );
+
+        if( bottom < aGrid.m_rows - 1 )
+        {
+            reach = std::min( reach, boxDistance( aQuery, gridLeft, doneBottom, gridRight,
+                                                  gridBottom ) );
+        }
 
+        if( left > 0 )
+            reach = std::min( reach, boxDistance( aQuery, gridLeft, doneTop, doneLeft, doneBottom ) );
 
-bool SHAPE_POLY_SET::Parse( std::stringstream& aStream )
-{
-    std::string tmp;
+        if( right < aGrid.m_cols - 1 )
+        {
+            reach = std::min( reach, boxDistance( aQuery, doneRight, doneTop, gridRight,
+                                                  doneBottom ) );
+        }
 
-    aStream >> tmp;
+        if( reach == std::numeric_limits<double>::max() )
+            break;
 
-    if( tmp != "polyset" )
-        return false;
+        // SEG::SquaredDistance() rounds the nearest point to integer coordinates, so it can
+        // be a bit smaller than the real distance.
+        reach -= 1.0;
 
-    aStream >> tmp;
+        if( reach > 0 && (double) best <= reach * reach )
+            break;
+    }
 
-    int n_polys = atoi( tmp.c_str() );
+    return best;
+}
 
-    if( n_polys < 0 )
-        return false;
 
-    for( int i = 0; i < n_polys; i++ )
+template <typename DIST_FUNC>
+SEG::ecoord SHAPE_POLY_SET::EDGE_INDEX::squaredDistance( const VECTOR2I& aInsidePoint,
+                                                         const BOX2I& aQuery, int aPoly,
+                                                         DIST_FUNC aDist ) const
+{
+    // Same as SHAPE_POLY_SET::SquaredDistanceToPolygon(): a query starting inside a polygon
+    // is at a zero distance, otherwise the distance is the one to the closest edge.
+    if( aPoly >= 0 )
     {
-        POLYGON paths;
-
-        aStream >> tmp;
+        if( containsSingle( m_grids[aPoly], aInsidePoint, 1 ) )
+            return 0;
 
-        if( tmp != "poly" )
-            return false;
+        return nearestEdge( m_grids[aPoly], aQuery, VECTOR2I::ECOORD_MAX, aDist );
+    }
 
-        aStream >> tmp;
-        int n_outlines = atoi( tmp.c_str() );
+    SEG::ecoord best = VECTOR2I::ECOORD_MAX;
 
-        if( n_outlines < 0 )
-            return false;
+    for( const GRID& grid : m_grids )
+    {
+        double dist = grid.Distance( aQuery ) - 1.0;
 
-        for( int j = 0; j < n_outlines; j++ )
-        {
-            SHAPE_LINE_CHAIN outline;
+        if( grid.m_edges.empty() || ( dist > 0 && dist * dist >= (double) best ) )
+            continue;
 
-            outline.SetClosed( true );
+        if( containsSingle( grid, aInsidePoint, 1 ) )
+            return 0;
 
-            aStream >> tmp;
-            int n_vertices = atoi( tmp.c_str() );
+        best = nearestEdge( grid, aQuery, best, aDist );
+    }
 
-            for( int v = 0; v < n_vertices; v++ )
-            {
-                VECTOR2I p;
+    return best;
+}
 
-                aStream >> tmp; p.x = atoi( tmp.c_str() );
-                aStream >> tmp; p.y = atoi( tmp.c_str() );
-                outline.Append( p );
-            }
 
-            paths.push_back( outline );
-        }
+SEG::ecoord SHAPE_POLY_SET::EDGE_INDEX::SquaredDistance( const VECTOR2I& aP, int aPoly ) const
+{
+    return squaredDistance( aP, BOX2I( aP, VECTOR2I( 0, 0 ) ), aPoly,
+                            [&]( const SEG& aEdge )
+                            {
+                                return aEdge.SquaredDistance( aP );
+                            } );
+}
 
-        m_polys.push_back( paths );
-    }
 
-    return true;
+SEG::ecoord SHAPE_POLY_SET::EDGE_INDEX::SquaredDistance( const SEG& aSeg, int aPoly ) const
+{
+    return squaredDistance( aSeg.A, BOX2I( aSeg.A, aSeg.B - aSeg.A ).Normalize(), aPoly,
+                            [&]( const SEG& aEdge )
+                            {
+                                return std::max<SEG::ecoord>( 0, aEdge.SquaredDistance( aSeg ) );
+                            } );
 }
 
 
-const BOX2I SHAPE_POLY_SET::BBox( int aClearance ) const
+void SHAPE_POLY_SET::EnableIndex( bool aEnable )
 {
-    BOX2I bb;
+    std::lock_guard<std::mutex> lock( m_edgeIndexMutex );
 
-    for( unsigned i = 0; i < m_polys.size(); i++ )
-    {
-        if( i == 0 )
-            bb = m_polys[i][0].BBox();
-        else
-            bb.Merge( m_polys[i][0].BBox() );
-    }
+    m_indexEnabled = aEnable;
 
-    bb.Inflate( aClearance );
-    return bb;
+    if( !aEnable )
+        m_edgeIndex.reset();
 }
 
 
-bool SHAPE_POLY_SET::PointOnEdge( const VECTOR2I& aP ) const
+const SHAPE_POLY_SET::EDGE_INDEX* SHAPE_POLY_SET::edgeIndex() const
 {
-    // Iterate through all the polygons in the set
-    for( const POLYGON& polygon : m_polys )
-    {
-        // Iterate through all the line chains in the polygon
-        for( const SHAPE_LINE_CHAIN& lineChain : polygon )
-        {
-            if( lineChain.PointOnEdge( aP ) )
-                return true;
-        }
-    }
+    if( !m_indexEnabled )
+        return nullptr;
 
-    return false;
+    std::lock_guard<std::mutex> lock( m_edgeIndexMutex );
+
+    if( !m_edgeIndex || m_edgeIndex->GetGeneration() != m_generation )
+        m_edgeIndex = std::make_unique<EDGE_INDEX>( m_polys, m_generation );
+
+    return m_edgeIndex.get();
 }
 
 
 bool SHAPE_POLY_SET::Collide( const SEG& aSeg, int aClearance ) const
 {
+    if( const EDGE_INDEX* index = edgeIndex() )
+        return index->Collide( aSeg, aClearance );
 
     SHAPE_POLY_SET polySet = SHAPE_POLY_SET( *this );
 
@@ -1235,6 +2235,9 @@ bool SHAPE_POLY_SET::Collide( const SEG& aSeg, int aClearance ) const
 
 bool SHAPE_POLY_SET::Collide( const VECTOR2I& aP, int aClearance ) const
 {
+    if( const EDGE_INDEX* index = edgeIndex() )
+        return index->Collide( aP, aClearance );
+
     SHAPE_POLY_SET polySet = SHAPE_POLY_SET( *this );
 
     // Inflate the polygon if necessary.
@@ -1251,12 +2254,14 @@ bool SHAPE_POLY_SET::Collide( const VECTOR2I& aP, int aClearance ) const
 
 void SHAPE_POLY_SET::RemoveAllContours()
 {
+    touch();
     m_polys.clear();
 }
 
 
 void SHAPE_POLY_SET::RemoveContour( int aContourIdx, int aPolygonIdx )
 {
+    touch();
     // Default polygon is the last one
     if( aPolygonIdx < 0 )
         aPolygonIdx += m_polys.size();
@@ -1267,6 +2272,7 @@ void SHAPE_POLY_SET::RemoveContour( int aContourIdx, int aPolygonIdx )
 
 int SHAPE_POLY_SET::RemoveNullSegments()
 {
+    touch();
     int removed = 0;
 
     ITERATOR iterator = IterateWithHoles();
@@ -1320,18 +2326,21 @@ int SHAPE_POLY_SET::RemoveNullSegments()
 
 void SHAPE_POLY_SET::DeletePolygon( int aIdx )
 {
+    touch();
     m_polys.erase( m_polys.begin() + aIdx );
 }
 
 
 void SHAPE_POLY_SET::Append( const SHAPE_POLY_SET& aSet )
 {
+    touch();
     m_polys.insert( m_polys.end(), aSet.m_polys.begin(), aSet.m_polys.end() );
 }
 
 
 void SHAPE_POLY_SET::Append( const VECTOR2I& aP, int aOutline, int aHole )
 {
+    touch();
     Append( aP.x, aP.y, aOutline, aHole );
 }
 
@@ -1406,12 +2415,12 @@ bool SHAPE_POLY_SET::CollideEdge( const VECTOR2I& aPoint,
 
 void SHAPE_POLY_SET::BuildBBoxCaches()
 {
-    for( int polygonIdx = 0; polygonIdx < OutlineCount(); polygonIdx++ )
+    // The bbox caches do not change the content of the set, so don't go through Outline()
+    // and Hole(): they would needlessly invalidate the triangulation and the edge index.
+    for( POLYGON& poly : m_polys )
     {
-        Outline( polygonIdx ).GenerateBBoxCache();
-
-        for( int holeIdx = 0; holeIdx < HoleCount( polygonIdx ); holeIdx++ )
-            Hole( polygonIdx, holeIdx ).GenerateBBoxCache();
+        for( SHAPE_LINE_CHAIN& path : poly )
+            path.GenerateBBoxCache();
     }
 }
 
@@ -1422,6 +2431,9 @@ bool SHAPE_POLY_SET::Contains( const VECTOR2I& aP, int aSubpolyIndex, int aAccur
     if( m_polys.empty() )
         return false;
 
+    if( const EDGE_INDEX* index = edgeIndex() )
+        return index->Contains( aP, aSubpolyIndex, aAccuracy );
+
     // If there is a polygon specified, check the condition against that polygon
     if( aSubpolyIndex >= 0 )
         return containsSingle( aP, aSubpolyIndex, aAccuracy, aUseBBoxCaches );
@@ -1439,6 +2451,7 @@ bool SHAPE_POLY_SET::Contains( const VECTOR2I& aP, int aSubpolyIndex, int aAccur
 
 void SHAPE_POLY_SET::RemoveVertex( int aGlobalIndex )
 {
+    touch();
     VERTEX_INDEX index;
 
     // Assure the to be removed vertex exists, abort otherwise
@@ -1451,12 +2464,14 @@ void SHAPE_POLY_SET::RemoveVertex( int aGlobalIndex )
 
 void SHAPE_POLY_SET::RemoveVertex( VERTEX_INDEX aIndex )
 {
+    touch();
     m_polys[aIndex.m_polygon][aIndex.m_contour].Remove( aIndex.m_vertex );
 }
 
 
 void SHAPE_POLY_SET::SetVertex( int aGlobalIndex, const VECTOR2I& aPos )
 {
+    touch();
     VERTEX_INDEX index;
 
     if( GetRelativeIndices( aGlobalIndex, &index ) )
@@ -1468,6 +2483,7 @@ void SHAPE_POLY_SET::SetVertex( int aGlobalIndex, const VECTOR2I& aPos )
 
 void SHAPE_POLY_SET::SetVertex( const VERTEX_INDEX& aIndex, const VECTOR2I& aPos )
 {
+    touch();
     m_polys[aIndex.m_polygon][aIndex.m_contour].SetPoint( aIndex.m_vertex, aPos );
 }
 
@@ -1475,6 +2491,9 @@ void SHAPE_POLY_SET::SetVertex( const VERTEX_INDEX& aIndex, const VECTOR2I& aPos
 bool SHAPE_POLY_SET::containsSingle( const VECTOR2I& aP, int aSubpolyIndex, int aAccuracy,
                                      bool aUseBBoxCaches ) const
 {
+    if( const EDGE_INDEX* index = edgeIndex() )
+        return index->Contains( aP, aSubpolyIndex, aAccuracy );
+
     // Check that the point is inside the outline
     if( m_polys[aSubpolyIndex][0].PointInside( aP, aAccuracy ) )
     {
@@ -1498,6 +2517,7 @@ bool SHAPE_POLY_SET::containsSingle( const VECTOR2I& aP, int aSubpolyIndex, int
 
 void SHAPE_POLY_SET::Move( const VECTOR2I& aVector )
 {
+    touch();
     for( POLYGON& poly : m_polys )
     {
         for( SHAPE_LINE_CHAIN& path : poly )
@@ -1508,6 +2528,7 @@ void SHAPE_POLY_SET::Move( const VECTOR2I& aVector )
 
 void SHAPE_POLY_SET::Mirror( bool aX, bool aY, const VECTOR2I& aRef )
 {
+    touch();
     for( POLYGON& poly : m_polys )
     {
         for( SHAPE_LINE_CHAIN& path : poly )
@@ -1520,6 +2541,7 @@ void SHAPE_POLY_SET::Mirror( bool aX, bool aY, const VECTOR2I& aRef )
 
 void SHAPE_POLY_SET::Rotate( double aAngle, const VECTOR2I& aCenter )
 {
+    touch();
     for( POLYGON& poly : m_polys )
     {
         for( SHAPE_LINE_CHAIN& path : poly )
@@ -1557,8 +2579,11 @@ SHAPE_POLY_SET::POLYGON SHAPE_POLY_SET::FilletPolygon( unsigned int aRadius, int
 }
 
 
-SEG::ecoord SHAPE_POLY_SET::SquaredDistanceToPolygon( VECTOR2I aPoint, int aPolygonIndex )
+SEG::ecoord SHAPE_POLY_SET::SquaredDistanceToPolygon( VECTOR2I aPoint, int aPolygonIndex ) const
 {
+    if( const EDGE_INDEX* index = edgeIndex() )
+        return index->SquaredDistance( aPoint, aPolygonIndex );
+
     // We calculate the min dist between the segment and each outline segment.  However, if the
     // segment to test is inside the outline, and does not cross any edge, it can be seen outside
     // the polygon.  Therefore test if a segment end is inside (testing only one end is enough).
@@ -1566,7 +2591,7 @@ SEG::ecoord SHAPE_POLY_SET::SquaredDistanceToPolygon( VECTOR2I aPoint, int aPoly
     if( containsSingle( aPoint, aPolygonIndex, 1 ) )
         return 0;
 
-    SEGMENT_ITERATOR iterator = IterateSegmentsWithHoles( aPolygonIndex );
+    CONST_SEGMENT_ITERATOR iterator = CIterateSegmentsWithHoles( aPolygonIndex );
 
     SEG polygonEdge = *iterator;
     SEG::ecoord minDistance = polygonEdge.SquaredDistance( aPoint );
@@ -1585,8 +2610,12 @@ SEG::ecoord SHAPE_POLY_SET::SquaredDistanceToPolygon( VECTOR2I aPoint, int aPoly
 }
 
 
-SEG::ecoord SHAPE_POLY_SET::SquaredDistanceToPolygon( const SEG& aSegment, int aPolygonIndex )
+SEG::ecoord SHAPE_POLY_SET::SquaredDistanceToPolygon( const SEG& aSegment,
+                                                      int aPolygonIndex ) const
 {
+    if( const EDGE_INDEX* index = edgeIndex() )
+        return index->SquaredDistance( aSegment, aPolygonIndex );
+
     // We calculate the min dist between the segment and each outline segment.  However, if the
     // segment to test is inside the outline, and does not cross any edge, it can be seen outside
     // the polygon.  Therefore test if a segment end is inside (testing only one end is enough).
@@ -1594,9 +2623,9 @@ SEG::ecoord SHAPE_POLY_SET::SquaredDistanceToPolygon( const SEG& aSegment, int a
     if( containsSingle( aSegment.A, aPolygonIndex, 1 ) )
         return 0;
 
-    SEGMENT_ITERATOR iterator = IterateSegmentsWithHoles( aPolygonIndex );
-    SEG              polygonEdge = *iterator;
-    SEG::ecoord      minDistance = polygonEdge.SquaredDistance( aSegment );
+    CONST_SEGMENT_ITERATOR iterator = CIterateSegmentsWithHoles( aPolygonIndex );
+    SEG                    polygonEdge = *iterator;
+    SEG::ecoord            minDistance = polygonEdge.SquaredDistance( aSegment );
 
     for( iterator++; iterator && minDistance > 0; iterator++ )
     {
@@ -1613,8 +2642,11 @@ SEG::ecoord SHAPE_POLY_SET::SquaredDistanceToPolygon( const SEG& aSegment, int a
 }
 
 
-SEG::ecoord SHAPE_POLY_SET::SquaredDistance( VECTOR2I aPoint )
+SEG::ecoord SHAPE_POLY_SET::SquaredDistance( VECTOR2I aPoint ) const
 {
+    if( const EDGE_INDEX* index = edgeIndex() )
+        return index->SquaredDistance( aPoint, -1 );
+
     SEG::ecoord currentDistance;
     SEG::ecoord minDistance = SquaredDistanceToPolygon( aPoint, 0 );
 
@@ -1631,8 +2663,11 @@ SEG::ecoord SHAPE_POLY_SET::SquaredDistance( VECTOR2I aPoint )
 }
 
 
-SEG::ecoord SHAPE_POLY_SET::SquaredDistance( const SEG& aSegment )
+SEG::ecoord SHAPE_POLY_SET::SquaredDistance( const SEG& aSegment ) const
 {
+    if( const EDGE_INDEX* index = edgeIndex() )
+        return index->SquaredDistance( aSegment, -1 );
+
     SEG::ecoord currentDistance;
     SEG::ecoord minDistance = SquaredDistanceToPolygon( aSegment, 0 );
 
@@ -1857,116 +2892,150 @@ SHAPE_POLY_SET &SHAPE_POLY_SET::operator=( const SHAPE_POLY_SET& aOther )
 {
     static_cast<SHAPE&>(*this) = aOther;
     m_polys = aOther.m_polys;
+    touch();
 
     // reset poly cache:
-    m_hash = MD5_HASH{};
+    m_hash = 0;
     m_triangulationValid = false;
     m_triangulatedPolys.clear();
     return *this;
 }
 
-MD5_HASH SHAPE_POLY_SET::GetHash() const
+uint64_t SHAPE_POLY_SET::GetHash() const
 {
-    if( !m_hash.IsValid() )
-        return checksum();
+    if( IsTriangulationUpToDate() )
+        return m_hash;
 
-    return m_hash;
+    return checksum();
 }
 
 
 bool SHAPE_POLY_SET::IsTriangulationUpToDate() const
 {
-    if( !m_triangulationValid )
-        return false;
-
-    if( !m_hash.IsValid() )
-        return false;
-
-    auto hash = checksum();
-
-    return hash == m_hash;
+    return m_triangulationValid && m_triangulationGeneration == m_generation;
 }
 
 
 void SHAPE_POLY_SET::CacheTriangulation()
 {
-    bool recalculate = !m_hash.IsValid();
-    MD5_HASH hash;
+    if( IsTriangulationUpToDate() )
+        return;
 
-    if( !m_triangulationValid )
-        recalculate = true;
+    uint64_t hash = checksum();
 
-    if( !recalculate )
+    // The set was possibly modified (or just accessed through a non-const reference),
+    // but its content is the same: the triangulation is still valid.
+    if( m_triangulationValid && hash == m_hash )
     {
-        hash = checksum();
-
-        if( m_hash != hash )
-        {
-            m_hash = hash;
-            recalculate = true;
-        }
-    }
-
-    if( !recalculate )
+        m_triangulationGeneration = m_generation;
         return;
+    }
 
-    SHAPE_POLY_SET tmpSet = *this;
+    // Polygons are independent: they are triangulated in parallel when the set is large
+    std::vector<std::vector<std::unique_ptr<TRIANGULATED_POLYGON>>> results( m_polys.size() );
 
-    if( tmpSet.HasHoles() )
-        tmpSet.Fracture( PM_FAST );
+    forEachPolygon( [&]( size_t aIndex )
+                    {
+                        triangulateSingle( m_polys[aIndex], results[aIndex] );
+                    } );
 
     m_triangulatedPolys.clear();
+
+    for( std::vector<std::unique_ptr<TRIANGULATED_POLYGON>>& result : results )
+    {
+        for( std::unique_ptr<TRIANGULATED_POLYGON>& triPoly : result )
+            m_triangulatedPolys.push_back( std::move( triPoly ) );
+    }
+
     m_triangulationValid = true;
+    m_hash = hash;
+    m_triangulationGeneration = m_generation;
+}
+
+
+void SHAPE_POLY_SET::triangulateSingle( const POLYGON& aPoly,
+        std::vector<std::unique_ptr<TRIANGULATED_POLYGON>>& aResult )
+{
+    auto triPoly = std::make_unique<TRIANGULATED_POLYGON>();
+    PolygonTriangulation tess( *triPoly );
 
-    while( tmpSet.OutlineCount() > 0 )
+    if( tess.TesselatePolygon( aPoly ) )
     {
-        m_triangulatedPolys.push_back( std::make_unique<TRIANGULATED_POLYGON>() );
-        PolygonTriangulation tess( *m_triangulatedPolys.back() );
+        aResult.push_back( std::move( triPoly ) );
+        return;
+    }
 
-        // If the tesselation fails, we re-fracture the polygon, which will
-        // first simplify the system before fracturing and removing the holes
-        // This may result in multiple, disjoint polygons.
-        if( !tess.TesselatePolygon( tmpSet.Polygon( 0 ).front() ) )
-        {
-            tmpSet.Fracture( PM_FAST );
-            m_triangulationValid = false;
-            continue;
-        }
+    // If the tesselation fails, we fracture the polygon, which will first simplify
+    // it before fracturing and removing the holes.
+    // This may result in multiple, disjoint polygons.  Parts that still cannot be
+    // tesselated are skipped.
+    SHAPE_POLY_SET tmpSet;
 
-        tmpSet.DeletePolygon( 0 );
-        m_triangulationValid = true;
+    tmpSet.m_polys.push_back( aPoly );
+    tmpSet.Fracture( PM_FAST );
+
+    for( const POLYGON& poly : tmpSet.m_polys )
+    {
+        triPoly = std::make_unique<TRIANGULATED_POLYGON>();
+        PolygonTriangulation fracturedTess( *triPoly );
+
+        if( fracturedTess.TesselatePolygon( poly.front() ) )
+            aResult.push_back( std::move( triPoly ) );
     }
+}
+
+
+/*
+ * A fast, non cryptographic, 64 bits hash function, working on 64 bits words
+ * (the body and the finalization of MurmurHash3 x64).
+ */
+static inline uint64_t hashMix( uint64_t aHash, uint64_t aWord )
+{
+    aWord *= 0x87c37b91114253d5ULL;
+    aWord = ( aWord << 31 ) | ( aWord >> 33 );
+    aWord *= 0x4cf5ad432745937fULL;
+
+    aHash ^= aWord;
+    aHash = ( aHash << 27 ) | ( aHash >> 37 );
 
-    if( m_triangulationValid )
-        m_hash = checksum();
+    return aHash * 5 + 0x52dce729;
 }
 
 
-MD5_HASH SHAPE_POLY_SET::checksum() const
+static inline uint64_t hashFinalize( uint64_t aHash )
 {
-    MD5_HASH hash;
+    aHash ^= aHash >> 33;
+    aHash *= 0xff51afd7ed558ccdULL;
+    aHash ^= aHash >> 33;
+    aHash *= 0xc4ceb9fe1a85ec53ULL;
+    aHash ^= aHash >> 33;
 
-    hash.Hash( m_polys.size() );
+    return aHash;
+}
+
+
+uint64_t SHAPE_POLY_SET::checksum() const
+{
+    uint64_t hash = hashMix( 0, m_polys.size() );
 
-    for( const auto& outline : m_polys )
+    for( const POLYGON& outline : m_polys )
     {
-        hash.Hash( outline.size() );
+        hash = hashMix( hash, outline.size() );
 
-        for( const auto& lc : outline )
+        for( const SHAPE_LINE_CHAIN& lc : outline )
         {
-            hash.Hash( lc.PointCount() );
+            const std::vector<VECTOR2I>& points = lc.CPoints();
 
-            for( int i = 0; i < lc.PointCount(); i++ )
-            {
-                hash.Hash( lc.CPoint( i ).x );
-                hash.Hash( lc.CPoint( i ).y );
-            }
+            hash = hashMix( hash, points.size() );
+
+            // A point is hashed as one 64 bits word
+            for( const VECTOR2I& pt : points )
+                hash = hashMix( hash, uint64_t( uint32_t( pt.x ) )
+                                      | ( uint64_t( uint32_t( pt.y ) ) << 32 ) );
         }
     }
 
-    hash.Finalize();
-
-    return hash;
+    return hashFinalize( hash );
 }
 
 
@@ -0,0 +1,102 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <parallel_for.h>
+
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <thread>
+#include <vector>
+
+
+static thread_local bool t_isParallelWorker = false;
+
+
+bool IsParallelWorker()
+{
+    return t_isParallelWorker;
+}
+
+
+PARALLEL_WORKER_SCOPE::PARALLEL_WORKER_SCOPE() :
+        m_wasWorker( t_isParallelWorker )
+{
+    t_isParallelWorker = true;
+}
+
+
+PARALLEL_WORKER_SCOPE::~PARALLEL_WORKER_SCOPE()
+{
+    t_isParallelWorker = m_wasWorker;
+}
+
+
+void ParallelFor( size_t aCount, const std::function<void( size_t )>& aFunc,
+                  size_t aMinItemsPerThread )
+{
+    size_t parallelThreadCount = 1;
+
+    if( !t_isParallelWorker )
+    {
+        aMinItemsPerThread = std::max<size_t>( aMinItemsPerThread, 1 );
+        parallelThreadCount = std::min<size_t>( std::thread::hardware_concurrency(),
+                                                ( aCount + aMinItemsPerThread - 1 )
+                                                        / aMinItemsPerThread );
+    }
+
+    if( parallelThreadCount <= 1 )
+    {
+        for( size_t ii = 0; ii < aCount; ++ii )
+            aFunc( ii );
+
+        return;
+    }
+
+    std::atomic<size_t> nextItem( 0 );
+
+    auto item_lambda = [&]() -> size_t
+    {
+        PARALLEL_WORKER_SCOPE workerScope;
+        size_t                num = 0;
+
+        for( size_t ii = nextItem++; ii < aCount; ii = nextItem++ )
+        {
+            aFunc( ii );
+            num++;
+        }
+
+        return num;
+    };
+
+    std::vector<std::future<size_t>> returns( parallelThreadCount );
+
+    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+        returns[ii] = std::async( std::launch::async, item_lambda );
+
+    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+        returns[ii].wait();
+
+    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+        returns[ii].get();
+}
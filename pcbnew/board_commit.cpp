@@ -52,6 +52,13 @@ BOARD_COMMIT::BOARD_COMMIT( EDA_DRAW_FRAME* aFrame )
 }
 
 
+BOARD_COMMIT::BOARD_COMMIT( TOOL_MANAGER* aToolMgr )
+{
+    m_toolMgr = aToolMgr;
+    m_editModules = false;
+}
+
+
 BOARD_COMMIT::~BOARD_COMMIT()
 {
 }
@@ -174,6 +174,105 @@ BOARD::~BOARD()
 }
 
 
+BOARD* BOARD::CreateSnapshot()
+{
+    BOARD* snapshot = new BOARD();
+
+    snapshot->SetFileName( GetFileName() );
+    snapshot->SetDesignSettings( GetDesignSettings() );
+    snapshot->SetPageSettings( GetPageSettings() );
+    snapshot->SetTitleBlock( GetTitleBlock() );
+    snapshot->SetPlotOptions( GetPlotOptions() );
+    snapshot->SetZoneSettings( GetZoneSettings() );
+
+    // Net classes are shared pointers: give the copy its own
+    NETCLASSES& netclasses = snapshot->GetDesignSettings().m_NetClasses;
+    NETCLASSES  source = netclasses;
+
+    netclasses = NETCLASSES();
+    *netclasses.GetDefault() = *source.GetDefault();
+
+    for( const std::pair<const wxString, NETCLASSPTR>& netclass : source )
+        netclasses.Add( std::make_shared<NETCLASS>( *netclass.second ) );
+
+    // The whole layer table, not only the enabled copper layers: user names of technical
+    // layers are kept too
+    for( int layer = 0; layer < PCB_LAYER_ID_COUNT; ++layer )
+        snapshot->m_Layer[layer] = m_Layer[layer];
+
+    snapshot->SetEnabledLayers( GetEnabledLayers() );
+    snapshot->SetVisibleLayers( GetVisibleLayers() );
+    snapshot->SetVisibleElements( GetVisibleElements() );
+
+    // Add the nets in net code order, so they are numbered in the same order in the file
+    std::vector<NETINFO_ITEM*> nets;
+
+    for( NETINFO_ITEM* net : m_NetInfo )
+    {
+        if( net->GetNet() > 0 )
+            nets.push_back( net );
+    }
+
+    std::sort( nets.begin(), nets.end(),
+               []( const NETINFO_ITEM* a, const NETINFO_ITEM* b )
+               {
+                   return a->GetNet() < b->GetNet();
+               } );
+
+    for( NETINFO_ITEM* net : nets )
+        snapshot->Add( new NETINFO_ITEM( snapshot, net->GetNetname() ) );
+
+    auto remapNet = [&]( BOARD_CONNECTED_ITEM* aItem )
+                    {
+                        NETINFO_ITEM* net = snapshot->FindNet( aItem->GetNetname() );
+                        aItem->SetNet( net ? net : NETINFO_LIST::OrphanedItem() );
+                    };
+
+    // Fill the containers directly: BOARD::Add() would also build connectivity data
+    for( MODULE* module : m_modules )
+    {
+        MODULE* clone = static_cast<MODULE*>( module->Clone() );
+
+        clone->SetParent( snapshot );
+        snapshot->Modules().push_back( clone );
+
+        for( D_PAD* pad : clone->Pads() )
+            remapNet( pad );
+
+        for( MODULE_ZONE_CONTAINER* zone : clone->Zones() )
+            remapNet( zone );
+    }
+
+    for( BOARD_ITEM* item : m_drawings )
+    {
+        BOARD_ITEM* clone = static_cast<BOARD_ITEM*>( item->Clone() );
+
+        clone->SetParent( snapshot );
+        snapshot->Drawings().push_back( clone );
+    }
+
+    for( TRACK* track : m_tracks )
+    {
+        TRACK* clone = static_cast<TRACK*>( track->Clone() );
+
+        clone->SetParent( snapshot );
+        snapshot->Tracks().push_back( clone );
+        remapNet( clone );
+    }
+
+    for( ZONE_CONTAINER* zone : m_ZoneDescriptorList )
+    {
+        ZONE_CONTAINER* clone = static_cast<ZONE_CONTAINER*>( zone->Clone() );
+
+        clone->SetParent( snapshot );
+        snapshot->Zones().push_back( clone );
+        remapNet( clone );
+    }
+
+    return snapshot;
+}
+
+
 void BOARD::BuildConnectivity()
 {
     GetConnectivity()->Build( this );
@@ -287,6 +287,18 @@ public:
     BOARD();
     ~BOARD();
 
+    /**
+     * Copy everything PCB_IO::Save() writes into a new board, which can then be written on
+     * another thread while this board is edited.
+     *
+     * Items are cloned (zone fills and custom pad shapes are shared copy-on-write, see
+     * COW_PTR) and their nets are remapped to the nets of the copy.  The copy has no
+     * connectivity data.
+     *
+     * @return the copy, owned by the caller.
+     */
+    BOARD* CreateSnapshot();
+
     const wxPoint GetPosition() const override;
     void SetPosition( const wxPoint& aPos ) override;
 
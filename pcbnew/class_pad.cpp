@@ -186,9 +186,9 @@ int D_PAD::boundingRadius() const
     case PAD_SHAPE_CUSTOM:
         radius = 0;
 
-        for( int cnt = 0; cnt < m_customShapeAsPolygon.OutlineCount(); ++cnt )
+        for( int cnt = 0; cnt < m_customShapeAsPolygon->OutlineCount(); ++cnt )
         {
-            const SHAPE_LINE_CHAIN& poly = m_customShapeAsPolygon.COutline( cnt );
+            const SHAPE_LINE_CHAIN& poly = m_customShapeAsPolygon->COutline( cnt );
             for( int ii = 0; ii < poly.PointCount(); ++ii )
             {
                 int dist = KiROUND( poly.CPoint( ii ).EuclideanNorm() );
@@ -398,7 +398,7 @@ const EDA_RECT D_PAD::GetBoundingBox() const
 
     case PAD_SHAPE_CUSTOM:
         {
-        SHAPE_POLY_SET polySet( m_customShapeAsPolygon );
+        SHAPE_POLY_SET polySet( *m_customShapeAsPolygon );
         // Move shape to actual position
         CustomShapeAsPolygonToBoardPosition( &polySet, GetPosition(), GetOrientation() );
         quadrant1 = m_Pos;
@@ -519,10 +519,8 @@ void D_PAD::Flip( const wxPoint& aCentre, bool aFlipLeftRight )
 void D_PAD::FlipPrimitives()
 {
     // Flip custom shapes
-    for( unsigned ii = 0; ii < m_basicShapes.size(); ++ii )
+    for( PAD_CS_PRIMITIVE& primitive : m_basicShapes.Write() )
     {
-        PAD_CS_PRIMITIVE& primitive = m_basicShapes[ii];
-
         MIRROR( primitive.m_Start.y, 0 );
         MIRROR( primitive.m_End.y, 0 );
         primitive.m_ArcAngle = -primitive.m_ArcAngle;
@@ -540,17 +538,15 @@ void D_PAD::FlipPrimitives()
     }
 
     // Flip local coordinates in merged Polygon
-    m_customShapeAsPolygon.Mirror( false, true );
+    m_customShapeAsPolygon.Write().Mirror( false, true );
 }
 
 
 void D_PAD::MirrorXPrimitives( int aX )
 {
     // Mirror custom shapes
-    for( unsigned ii = 0; ii < m_basicShapes.size(); ++ii )
+    for( PAD_CS_PRIMITIVE& primitive : m_basicShapes.Write() )
     {
-        PAD_CS_PRIMITIVE& primitive = m_basicShapes[ii];
-
         MIRROR( primitive.m_Start.x, aX );
         MIRROR( primitive.m_End.x, aX );
         primitive.m_ArcAngle = -primitive.m_ArcAngle;
@@ -568,14 +564,26 @@ void D_PAD::MirrorXPrimitives( int aX )
     }
 
     // Mirror the local coordinates in merged Polygon
-    for( int cnt = 0; cnt < m_customShapeAsPolygon.OutlineCount(); ++cnt )
+    SHAPE_POLY_SET& mergedPolygon = m_customShapeAsPolygon.Write();
+
+    for( int cnt = 0; cnt < mergedPolygon.OutlineCount(); ++cnt )
     {
-        SHAPE_LINE_CHAIN& poly = m_customShapeAsPolygon.Outline( cnt );
+        SHAPE_LINE_CHAIN& poly = mergedPolygon.Outline( cnt );
         poly.Mirror( true, false );
     }
 }
 
 
+size_t D_PAD::GetCustomShapeMemory( const void** aId ) const
+{
+    if( aId )
+        *aId = m_customShapeAsPolygon.Id();
+
+    return sizeof( SHAPE_POLY_SET ) + m_basicShapes->size() * sizeof( PAD_CS_PRIMITIVE )
+           + m_customShapeAsPolygon->TotalVertices() * sizeof( VECTOR2I );
+}
+
+
 void D_PAD::AppendConfigs( std::vector<PARAM_CFG*>* aResult )
 {
     // Parameters stored in config are only significant parameters
@@ -1159,9 +1167,9 @@ bool D_PAD::HitTest( const wxPoint& aPosition, int aAccuracy ) const
         // Check for hit in polygon
         RotatePoint( &delta, -m_Orient );
 
-        if( m_customShapeAsPolygon.OutlineCount() )
+        if( m_customShapeAsPolygon->OutlineCount() )
         {
-            const SHAPE_LINE_CHAIN& poly = m_customShapeAsPolygon.COutline( 0 );
+            const SHAPE_LINE_CHAIN& poly = m_customShapeAsPolygon->COutline( 0 );
             return TestPointInsidePolygon( (const wxPoint*)&poly.CPoint(0), poly.PointCount(), delta );
         }
         break;
@@ -34,6 +34,7 @@
 #include <board_connected_item.h>
 #include <class_board_item.h>
 #include <convert_to_biu.h>
+#include <core/cow_ptr.h>
 #include <geometry/shape_poly_set.h>
 #include <pad_shapes.h>
 #include <pcbnew.h>
@@ -334,12 +335,18 @@ public:
     /**
      * Accessor to the basic shape list
      */
-    const std::vector<PAD_CS_PRIMITIVE>& GetPrimitives() const { return m_basicShapes; }
+    const std::vector<PAD_CS_PRIMITIVE>& GetPrimitives() const { return *m_basicShapes; }
 
     /**
      * Accessor to the custom shape as one polygon
      */
-    const SHAPE_POLY_SET& GetCustomShapeAsPolygon() const { return m_customShapeAsPolygon; }
+    const SHAPE_POLY_SET& GetCustomShapeAsPolygon() const { return *m_customShapeAsPolygon; }
+
+    /**
+     * @return an approximation of the memory used by the custom shape, and the identifier
+     * of this memory, which is shared between copies of the pad (see COW_PTR::Id()).
+     */
+    size_t GetCustomShapeMemory( const void** aId = nullptr ) const;
 
     void Flip( const wxPoint& aCentre, bool aFlipLeftRight ) override;
 
@@ -822,13 +829,14 @@ private:    // Private variable members:
     /** for free shape pads: a list of basic shapes,
      * in local coordinates, orient 0, coordinates relative to m_Pos
      * They are expected to define only one copper area.
+     * Shared with the copies of the pad until modified, as is m_customShapeAsPolygon.
      */
-    std::vector<PAD_CS_PRIMITIVE> m_basicShapes;
+    COW_PTR<std::vector<PAD_CS_PRIMITIVE>> m_basicShapes;
 
     /** for free shape pads: the set of basic shapes, merged as one polygon,
      * in local coordinates, orient 0, coordinates relative to m_Pos
      */
-    SHAPE_POLY_SET m_customShapeAsPolygon;
+    COW_PTR<SHAPE_POLY_SET> m_customShapeAsPolygon;
 
     /**
      * How to build the custom shape in zone, to create the clearance area:
@@ -71,9 +71,11 @@ ZONE_CONTAINER::ZONE_CONTAINER( BOARD_ITEM_CONTAINER* aParent, bool aInModule )
     m_cornerRadius = 0;
     SetLocalFlags( 0 );                         // flags tempoarry used in zone calculations
     m_Poly = new SHAPE_POLY_SET();              // Outlines
+    m_FilledPolysList.Write().EnableIndex();    // Hit-tested many times between fills
     m_FilledPolysUseThickness = true;           // set the "old" way to build filled polygon areas (before 6.0.x)
     aParent->GetZoneSettings().ExportSetting( *this );
 
+    m_filledPolysHash = 0;
     m_needRefill = false;   // True only after some edition.
 }
 
@@ -105,8 +107,7 @@ ZONE_CONTAINER& ZONE_CONTAINER::operator=( const ZONE_CONTAINER& aOther )
     SetHatchStyle( aOther.GetHatchStyle() );
     SetHatchPitch( aOther.GetHatchPitch() );
     m_HatchLines = aOther.m_HatchLines;     // copy vector <SEG>
-    m_FilledPolysList.RemoveAllContours();
-    m_FilledPolysList.Append( aOther.m_FilledPolysList );
+    m_FilledPolysList = aOther.m_FilledPolysList;
     m_FillSegmList.clear();
     m_FillSegmList = aOther.m_FillSegmList;
 
@@ -156,7 +157,7 @@ void ZONE_CONTAINER::initDataFromSrcInCopyCtor( const ZONE_CONTAINER& aZone )
     m_PadConnection = aZone.m_PadConnection;
     m_ThermalReliefGap = aZone.m_ThermalReliefGap;
     m_ThermalReliefCopperBridge = aZone.m_ThermalReliefCopperBridge;
-    m_FilledPolysList.Append( aZone.m_FilledPolysList );
+    m_FilledPolysList = aZone.m_FilledPolysList;  // shared until one of the zones changes
     m_FillSegmList = aZone.m_FillSegmList;      // vector <> copy
 
     m_doNotAllowCopperPour = aZone.m_doNotAllowCopperPour;
@@ -196,9 +197,9 @@ EDA_ITEM* ZONE_CONTAINER::Clone() const
 
 bool ZONE_CONTAINER::UnFill()
 {
-    bool change = ( !m_FilledPolysList.IsEmpty() || m_FillSegmList.size() > 0 );
+    bool change = ( !m_FilledPolysList->IsEmpty() || m_FillSegmList.size() > 0 );
 
-    m_FilledPolysList.RemoveAllContours();
+    clearFilledPolys();
     m_FillSegmList.clear();
     m_IsFilled = false;
 
@@ -486,7 +487,7 @@ int ZONE_CONTAINER::GetClearance( BOARD_CONNECTED_ITEM* aItem, wxString* aSource
 
 bool ZONE_CONTAINER::HitTestFilledArea( const wxPoint& aRefPos ) const
 {
-    return m_FilledPolysList.Contains( VECTOR2I( aRefPos.x, aRefPos.y ) );
+    return m_FilledPolysList->Contains( VECTOR2I( aRefPos.x, aRefPos.y ) );
 }
 
 
@@ -498,7 +499,7 @@ bool ZONE_CONTAINER::HitTestCutout( const VECTOR2I& aRefPos, int* aOutlineIdx, i
     {
         for( int j = 0; j < m_Poly->HoleCount( i ); j++ )
         {
-            if( m_Poly->Hole( i, j ).PointInside( aRefPos ) )
+            if( m_Poly->CHole( i, j ).PointInside( aRefPos ) )
             {
                 if( aOutlineIdx )
                     *aOutlineIdx = i;
@@ -597,9 +598,9 @@ void ZONE_CONTAINER::GetMsgPanelInfo( EDA_DRAW_FRAME* aFrame, std::vector<MSG_PA
     msg.Printf( wxT( "%d" ), (int) m_HatchLines.size() );
     aList.emplace_back( MSG_PANEL_ITEM( _( "Hatch Lines" ), msg, BLUE ) );
 
-    if( !m_FilledPolysList.IsEmpty() )
+    if( !m_FilledPolysList->IsEmpty() )
     {
-        msg.Printf( wxT( "%d" ), m_FilledPolysList.TotalVertices() );
+        msg.Printf( wxT( "%d" ), m_FilledPolysList->TotalVertices() );
         aList.emplace_back( MSG_PANEL_ITEM( _( "Corner Count" ), msg, BLUE ) );
     }
 }
@@ -614,7 +615,7 @@ void ZONE_CONTAINER::Move( const wxPoint& offset )
 
     Hatch();
 
-    m_FilledPolysList.Move( offset );
+    m_FilledPolysList.Write().Move( offset );
 
     for( SEG& seg : m_FillSegmList )
     {
@@ -649,7 +650,7 @@ void ZONE_CONTAINER::Rotate( const wxPoint& centre, double angle )
     Hatch();
 
     /* rotate filled areas: */
-    m_FilledPolysList.Rotate( angle, VECTOR2I( centre ) );
+    m_FilledPolysList.Write().Rotate( angle, VECTOR2I( centre ) );
 
     for( unsigned ic = 0; ic < m_FillSegmList.size(); ic++ )
     {
@@ -686,7 +687,7 @@ void ZONE_CONTAINER::Mirror( const wxPoint& aMirrorRef, bool aMirrorLeftRight )
 
     Hatch();
 
-    m_FilledPolysList.Mirror( aMirrorLeftRight, !aMirrorLeftRight, VECTOR2I( aMirrorRef ) );
+    m_FilledPolysList.Write().Mirror( aMirrorLeftRight, !aMirrorLeftRight, VECTOR2I( aMirrorRef ) );
 
     for( SEG& seg : m_FillSegmList )
     {
@@ -719,7 +720,7 @@ void ZONE_CONTAINER::RemoveCutout( int aOutlineIdx, int aHoleIdx )
     if( m_Poly->OutlineCount() < aOutlineIdx || m_Poly->HoleCount( aOutlineIdx ) < aHoleIdx )
         return;
 
-    SHAPE_POLY_SET cutPoly( m_Poly->Hole( aOutlineIdx, aHoleIdx ) );
+    SHAPE_POLY_SET cutPoly( m_Poly->CHole( aOutlineIdx, aHoleIdx ) );
 
     // Add the cutout back to the zone
     m_Poly->BooleanAdd( cutPoly, SHAPE_POLY_SET::PM_FAST );
@@ -1019,7 +1020,70 @@ void ZONE_CONTAINER::SwapData( BOARD_ITEM* aImage )
 
 void ZONE_CONTAINER::CacheTriangulation()
 {
-    m_FilledPolysList.CacheTriangulation();
+    // Triangulation is cached in the filled areas, so shared areas are usually up to date
+    if( !m_FilledPolysList->IsTriangulationUpToDate() )
+        m_FilledPolysList.Write().CacheTriangulation();
+}
+
+
+void ZONE_CONTAINER::clearFilledPolys()
+{
+    if( m_FilledPolysList->IsEmpty() )
+        return;
+
+    bool indexed = m_FilledPolysList->IsIndexEnabled();
+
+    m_FilledPolysList.Set( SHAPE_POLY_SET() );
+    m_FilledPolysList.Write().EnableIndex( indexed );
+}
+
+
+/*
+ * Returns true if both sets have exactly the same polygons, in the same order
+ */
+static bool samePolygons( const SHAPE_POLY_SET& aA, const SHAPE_POLY_SET& aB )
+{
+    if( aA.OutlineCount() != aB.OutlineCount() || aA.TotalVertices() != aB.TotalVertices() )
+        return false;
+
+    for( int ii = 0; ii < aA.OutlineCount(); ii++ )
+    {
+        const SHAPE_POLY_SET::POLYGON& polyA = aA.CPolygon( ii );
+        const SHAPE_POLY_SET::POLYGON& polyB = aB.CPolygon( ii );
+
+        if( polyA.size() != polyB.size() )
+            return false;
+
+        for( size_t jj = 0; jj < polyA.size(); jj++ )
+        {
+            if( polyA[jj] != polyB[jj] )
+                return false;
+        }
+    }
+
+    return true;
+}
+
+
+void ZONE_CONTAINER::SetFilledPolysList( SHAPE_POLY_SET& aPolysList )
+{
+    // A refill often gives the same areas: keep sharing them with the undo list
+    if( samePolygons( *m_FilledPolysList, aPolysList ) )
+        return;
+
+    bool indexed = m_FilledPolysList->IsIndexEnabled();
+
+    m_FilledPolysList.Set( aPolysList );
+    m_FilledPolysList.Write().EnableIndex( indexed );
+}
+
+
+size_t ZONE_CONTAINER::GetFilledPolysMemory( const void** aId ) const
+{
+    if( aId )
+        *aId = m_FilledPolysList.Id();
+
+    return sizeof( SHAPE_POLY_SET ) + m_FilledPolysList->TotalVertices() * sizeof( VECTOR2I );
 }
 
 
@@ -1115,13 +1179,13 @@ double ZONE_CONTAINER::CalculateFilledArea()
 
     // Iterate over each outline polygon in the zone and then iterate over
     // each hole it has to compute the total area.
-    for( int i = 0; i < m_FilledPolysList.OutlineCount(); i++ )
+    for( int i = 0; i < m_FilledPolysList->OutlineCount(); i++ )
     {
-        m_area += m_FilledPolysList.Outline( i ).Area();
+        m_area += m_FilledPolysList->COutline( i ).Area();
 
-        for( int j = 0; j < m_FilledPolysList.HoleCount( i ); j++ )
+        for( int j = 0; j < m_FilledPolysList->HoleCount( i ); j++ )
         {
-            m_area -= m_FilledPolysList.Hole( i, j ).Area();
+            m_area -= m_FilledPolysList->CHole( i, j ).Area();
         }
     }
 
@@ -31,6 +31,7 @@
 
 
 #include <vector>
+#include <core/cow_ptr.h>
 #include <gr_basic.h>
 #include <class_board_item.h>
 #include <board_connected_item.h>
@@ -559,7 +560,7 @@ public:
      */
     void ClearFilledPolysList()
     {
-        m_FilledPolysList.RemoveAllContours();
+        clearFilledPolys();
     }
 
    /**
@@ -569,7 +570,7 @@ public:
      */
     const SHAPE_POLY_SET& GetFilledPolysList() const
     {
-        return m_FilledPolysList;
+        return *m_FilledPolysList;
     }
 
     /** (re)create a list of triangles that "fill" the solid areas.
@@ -579,12 +580,10 @@ public:
 
    /**
      * Function SetFilledPolysList
-     * sets the list of filled polygons.
+     * sets the list of filled polygons.  If the new list is identical to the current one,
+     * the current one is kept, so it stays shared with the undo copies of the zone.
      */
-    void SetFilledPolysList( SHAPE_POLY_SET& aPolysList )
-    {
-        m_FilledPolysList = aPolysList;
-    }
+    void SetFilledPolysList( SHAPE_POLY_SET& aPolysList );
 
     /**
       * Function SetFilledPolysList
@@ -718,13 +717,19 @@ public:
     /** @return the hash value previously calculated by BuildHashValue().
      * used in zone filling calculations
      */
-    MD5_HASH GetHashValue() { return m_filledPolysHash; }
+    uint64_t GetHashValue() { return m_filledPolysHash; }
 
     /** Build the hash value of m_FilledPolysList, and store it internally
      *  in m_filledPolysHash.
      *  Used in zone filling calculations, to know if m_FilledPolysList is up to date.
      */
-    void BuildHashValue() { m_filledPolysHash = m_FilledPolysList.GetHash(); }
+    void BuildHashValue() { m_filledPolysHash = m_FilledPolysList->GetHash(); }
+
+    /**
+     * @return an approximation of the memory used by the filled areas, and the identifier
+     * of this memory, which is shared between copies of the zone (see COW_PTR::Id()).
+     */
+    size_t GetFilledPolysMemory( const void** aId = nullptr ) const;
 
 
 
@@ -741,6 +746,9 @@ protected:
      */
     void initDataFromSrcInCopyCtor( const ZONE_CONTAINER& aZone );
 
+    /// Clear the filled areas without touching the copies sharing them
+    void clearFilledPolys();
+
     SHAPE_POLY_SET*       m_Poly;                ///< Outline of the zone.
     int                   m_cornerSmoothingType;
     unsigned int          m_cornerRadius;
@@ -826,11 +834,12 @@ protected:
      * as m_Poly.  In less simple cases (when m_Poly has holes) m_FilledPolysList is
      * a polygon equivalent to m_Poly, without holes but with extra outline segment
      * connecting "holes" with external main outline.  In complex cases an outline
-     * described by m_Poly can have many filled areas
+     * described by m_Poly can have many filled areas.
+     * Shared with the copies of the zone (e.g. in the undo list) until modified.
      */
-    SHAPE_POLY_SET        m_FilledPolysList;
+    COW_PTR<SHAPE_POLY_SET> m_FilledPolysList;
     SHAPE_POLY_SET        m_RawPolysList;
-    MD5_HASH              m_filledPolysHash;    // A hash value used in zone filling calculations
+    uint64_t              m_filledPolysHash;    // A hash value used in zone filling calculations
                                                 // to see if the filled areas are up to date
 
     ZONE_HATCH_STYLE      m_hatchStyle;     // hatch style, see enum above
@@ -35,6 +35,9 @@
 #include <macros.h>
 #include <math/util.h>      // for KiROUND
 
+#include <algorithm>
+#include <unordered_set>
+
 
 /* This module contains out of line member functions for classes given in
  * collectors.h.  Those classes augment the functionality of class PCB_EDIT_FRAME.
@@ -564,6 +567,75 @@ void GENERAL_COLLECTOR::Collect( BOARD_ITEM* aItem, const KICAD_T aScanList[],
 }
 
 
+void GENERAL_COLLECTOR::Collect( BOARD_ITEM* aItem, const KICAD_T aScanList[],
+                                 const wxPoint& aRefPos, const COLLECTORS_GUIDE& aGuide,
+                                 const KIGFX::VIEW* aView )
+{
+    Empty();        // empty the collection, primary criteria list
+    Empty2nd();     // empty the collection, secondary criteria list
+
+    SetGuide( &aGuide );
+    SetScanTypes( aScanList );
+    SetRefPos( aRefPos );
+
+    // Zone corners are the widest hit area tested by Inspect()
+    int   margin = 2 * KiROUND( 5 * aGuide.OnePixelInIU() ) + 1;
+    BOX2I area( VECTOR2I( aRefPos ), VECTOR2I( 0, 0 ) );
+    area.Inflate( margin );
+
+    std::vector<KIGFX::VIEW::LAYER_ITEM_PAIR> found;
+    aView->QueryAll( area, found );
+
+    // An item is found once per layer; the candidates are sorted by scan list order
+    std::unordered_set<BOARD_ITEM*>          unique;
+    std::vector<std::pair<int, BOARD_ITEM*>> candidates;
+
+    for( const KIGFX::VIEW::LAYER_ITEM_PAIR& pair : found )
+    {
+        BOARD_ITEM* item = dynamic_cast<BOARD_ITEM*>( pair.first );
+
+        if( !item || !unique.insert( item ).second )
+            continue;
+
+        int scanIndex = 0;
+
+        while( aScanList[scanIndex] != EOT && aScanList[scanIndex] != item->Type() )
+            scanIndex++;
+
+        if( aScanList[scanIndex] == EOT )
+            continue;
+
+        // Only keep the items of aItem (the view may show temporary items)
+        EDA_ITEM* parent = item;
+
+        while( parent && parent != aItem )
+            parent = parent->GetParent();
+
+        if( parent )
+            candidates.emplace_back( scanIndex, item );
+    }
+
+    std::stable_sort( candidates.begin(), candidates.end(),
+                      []( const std::pair<int, BOARD_ITEM*>& aLhs,
+                          const std::pair<int, BOARD_ITEM*>& aRhs )
+                      {
+                          return aLhs.first < aRhs.first;
+                      } );
+
+    for( const std::pair<int, BOARD_ITEM*>& candidate : candidates )
+        Inspect( candidate.second, nullptr );
+
+    // record the length of the primary list before concatenating on to it.
+    m_PrimaryLength = m_List.size();
+
+    // append 2nd list onto end of the first list
+    for( unsigned i = 0;  i<m_List2nd.size();  ++i )
+        Append( m_List2nd[i] );
+
+    Empty2nd();
+}
+
+
 SEARCH_RESULT PCB_TYPE_COLLECTOR::Inspect( EDA_ITEM* testItem, void* testData )
 {
     // The Visit() function only visits the testItem if its type was in the
@@ -375,6 +375,17 @@ public:
      */
     void Collect( BOARD_ITEM* aItem, const KICAD_T aScanList[],
                  const wxPoint& aRefPos, const COLLECTORS_GUIDE& aGuide );
+
+    /**
+     * Same as the Collect() above, but only tests the items of \a aItem found near \a aRefPos
+     * in the spatial index of \a aView, instead of visiting every item of \a aItem.
+     * \a aView must contain all the items of \a aItem, as the board editor views do.
+     *
+     * Items are collected in the order of their types in \a aScanList, and items of the
+     * same type from top to bottom of the rendering stack.
+     */
+    void Collect( BOARD_ITEM* aItem, const KICAD_T aScanList[], const wxPoint& aRefPos,
+                  const COLLECTORS_GUIDE& aGuide, const KIGFX::VIEW* aView );
 };
 
 
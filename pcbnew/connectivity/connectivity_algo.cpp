@@ -32,6 +32,8 @@
 #include <algorithm>
 #include <future>
 
+#include <trace_span.h>
+
 #ifdef PROFILE
 #include <profile.h>
 #endif
@@ -197,6 +199,8 @@ bool CN_CONNECTIVITY_ALGO::Add( BOARD_ITEM* aItem )
 
 void CN_CONNECTIVITY_ALGO::searchConnections()
 {
+    TRACE_SPAN span( "CN_CONNECTIVITY_ALGO::searchConnections", "connectivity" );
+
 #ifdef CONNECTIVITY_DEBUG
     printf("Search start\n");
 #endif
@@ -306,6 +310,7 @@ const CN_CONNECTIVITY_ALGO::CLUSTERS CN_CONNECTIVITY_ALGO::SearchClusters( CLUST
 const CN_CONNECTIVITY_ALGO::CLUSTERS CN_CONNECTIVITY_ALGO::SearchClusters( CLUSTER_SEARCH_MODE aMode,
         const KICAD_T aTypes[], int aSingleNet )
 {
+    TRACE_SPAN span( "CN_CONNECTIVITY_ALGO::SearchClusters", "connectivity" );
     bool withinAnyNet = ( aMode != CSM_PROPAGATE );
 
     std::deque<CN_ITEM*> Q;
@@ -183,6 +183,18 @@ public:
         return m_itemMap[ aItem ];
     }
 
+    /**
+     * Unlike ItemEntry(), never adds an entry for aItem, so it is safe to call from
+     * several threads as long as the connectivity is not modified.
+     * @return the entry of aItem, or nullptr if aItem is not in the connectivity.
+     */
+    const ITEM_MAP_ENTRY* FindItemEntry( const BOARD_CONNECTED_ITEM* aItem ) const
+    {
+        auto it = m_itemMap.find( aItem );
+
+        return it != m_itemMap.end() ? &it->second : nullptr;
+    }
+
     bool IsNetDirty( int aNet ) const
     {
         if( aNet < 0 )
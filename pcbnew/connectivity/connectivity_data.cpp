@@ -31,6 +31,8 @@
 #include <algorithm>
 #include <future>
 
+#include <trace_span.h>
+
 #include <connectivity/connectivity_data.h>
 #include <connectivity/connectivity_algo.h>
 #include <ratsnest_data.h>
@@ -79,6 +81,8 @@ bool CONNECTIVITY_DATA::Update( BOARD_ITEM* aItem )
 
 void CONNECTIVITY_DATA::Build( BOARD* aBoard )
 {
+    TRACE_SPAN span( "CONNECTIVITY_DATA::Build", "connectivity" );
+
     m_connAlgo.reset( new CN_CONNECTIVITY_ALGO );
     m_connAlgo->Build( aBoard );
     RecalculateRatsnest();
@@ -87,6 +91,8 @@ void CONNECTIVITY_DATA::Build( BOARD* aBoard )
 
 void CONNECTIVITY_DATA::Build( const std::vector<BOARD_ITEM*>& aItems )
 {
+    TRACE_SPAN span( "CONNECTIVITY_DATA::Build", "connectivity" );
+
     m_connAlgo.reset( new CN_CONNECTIVITY_ALGO );
     m_connAlgo->Build( aItems );
 
@@ -99,6 +105,7 @@ void CONNECTIVITY_DATA::updateRatsnest()
     #ifdef PROFILE
     PROF_COUNTER rnUpdate( "update-ratsnest" );
     #endif
+    TRACE_SPAN span( "CONNECTIVITY_DATA::updateRatsnest", "ratsnest" );
     std::vector<RN_NET*> dirty_nets;
 
     // Start with net 1 as net 0 is reserved for not-connected
@@ -149,6 +156,8 @@ void CONNECTIVITY_DATA::addRatsnestCluster( const std::shared_ptr<CN_CLUSTER>& a
 
 void CONNECTIVITY_DATA::RecalculateRatsnest( BOARD_COMMIT* aCommit  )
 {
+    TRACE_SPAN span( "CONNECTIVITY_DATA::RecalculateRatsnest", "ratsnest" );
+
     m_connAlgo->PropagateNets( aCommit );
 
     int lastNet = m_connAlgo->NetCount();
@@ -238,6 +247,7 @@ void CONNECTIVITY_DATA::FindIsolatedCopperIslands( ZONE_CONTAINER* aZone,
 
 void CONNECTIVITY_DATA::FindIsolatedCopperIslands( std::vector<CN_ZONE_ISOLATED_ISLAND_LIST>& aZones )
 {
+    TRACE_SPAN span( "CONNECTIVITY_DATA::FindIsolatedCopperIslands", "connectivity" );
     m_connAlgo->FindIsolatedCopperIslands( aZones );
 }
 
@@ -433,12 +443,16 @@ bool CONNECTIVITY_DATA::CheckConnectivity( std::vector<CN_DISJOINT_NET_ENTRY>& a
 const std::vector<TRACK*> CONNECTIVITY_DATA::GetConnectedTracks( const BOARD_CONNECTED_ITEM* aItem )
 const
 {
-    auto& entry = m_connAlgo->ItemEntry( aItem );
+    // Safe to call from several threads at once: never adds an entry for aItem
+    auto entry = m_connAlgo->FindItemEntry( aItem );
 
     std::set<TRACK*> tracks;
     std::vector<TRACK*> rv;
 
-    for( auto citem : entry.GetItems() )
+    if( !entry )
+        return rv;
+
+    for( auto citem : entry->m_items )
     {
         for( auto connected : citem->ConnectedItems() )
         {
@@ -458,7 +472,13 @@ const
 const void CONNECTIVITY_DATA::GetConnectedPads( const BOARD_CONNECTED_ITEM* aItem,
                                                 std::set<D_PAD*>* pads ) const
 {
-    for( auto citem : m_connAlgo->ItemEntry( aItem ).GetItems() )
+    // Safe to call from several threads at once: never adds an entry for aItem
+    auto entry = m_connAlgo->FindItemEntry( aItem );
+
+    if( !entry )
+        return;
+
+    for( auto citem : entry->m_items )
     {
         for( auto connected : citem->ConnectedItems() )
         {
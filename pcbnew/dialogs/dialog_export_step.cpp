@@ -198,9 +198,12 @@ void PCB_EDIT_FRAME::OnExportSTEP( wxCommandEvent& event )
 {
     wxFileName brdFile = GetBoard()->GetFileName();
 
+    // kicad2step reads the board file, so a save still being written must complete first
+    WaitForBackgroundSave();
+
     if( GetScreen()->IsModify() || brdFile.GetFullPath().empty() )
     {
-        if( !doAutoSave() )
+        if( !doAutoSave() || !WaitForBackgroundSave() )
         {
             DisplayErrorMessage( this,
                                  _( "STEP export failed!  Please save the PCB and try again" ) );
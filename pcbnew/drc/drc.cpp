@@ -53,7 +53,11 @@
 #include <geometry/shape_arc.h>
 #include <drc/drc_item.h>
 #include <drc/drc_courtyard_tester.h>
+#include <parallel_for.h>
 #include <tools/zone_filler_tool.h>
+#include <trace_span.h>
+
+#include <unordered_map>
 
 DRC::DRC() :
         PCB_TOOL_BASE( "pcbnew.DRCTool" ),
@@ -352,6 +356,8 @@ int DRC::TestZoneToZoneOutlines()
 
 void DRC::RunTests( wxTextCtrl* aMessages )
 {
+    TRACE_SPAN span( "DRC::RunTests", "drc" );
+
     // be sure m_pcb is the current board, not a old one
     // ( the board can be reloaded )
     m_pcb = m_pcbEditorFrame->GetBoard();
@@ -654,6 +660,8 @@ bool DRC::doNetClass( const NETCLASSPTR& nc, wxString& msg )
 
 bool DRC::testNetClasses()
 {
+    TRACE_SPAN span( "DRC::testNetClasses", "drc" );
+
     bool        ret = true;
     NETCLASSES& netclasses = m_pcb->GetDesignSettings().m_NetClasses;
     wxString    msg;   // construct this only once here, not in a loop, since somewhat expensive.
@@ -675,6 +683,8 @@ bool DRC::testNetClasses()
 
 void DRC::testPad2Pad()
 {
+    TRACE_SPAN span( "DRC::testPad2Pad", "drc" );
+
     std::vector<D_PAD*> sortedPads;
 
     m_pcb->GetSortedPadListByXthenYCoord( sortedPads );
@@ -709,6 +719,8 @@ void DRC::testPad2Pad()
 
 void DRC::testDrilledHoles()
 {
+    TRACE_SPAN span( "DRC::testDrilledHoles", "drc" );
+
     BOARD_DESIGN_SETTINGS& dsnSettings = m_pcb->GetDesignSettings();
 
     // Test drilled holes to minimize drill bit breakage.
@@ -816,42 +828,114 @@ void DRC::testDrilledHoles()
     if( dsnSettings.m_HoleToHoleMin == 0 || dsnSettings.Ignore( DRCE_DRILLED_HOLES_TOO_CLOSE ) )
         return;
 
+    // Bucket the holes in a grid whose cells are as large as the largest distance between
+    // the centres of two holes too close to each other, so each hole is only compared with
+    // the holes of its own and the 8 neighbouring cells.
+    int maxRadius = 0;
+
+    for( const DRILLED_HOLE& drilledHole : holes )
+        maxRadius = std::max( maxRadius, drilledHole.m_drillRadius );
+
+    // +1 for the rounding of the distance below
+    int64_t cellSize = (int64_t) dsnSettings.m_HoleToHoleMin + 2 * (int64_t) maxRadius + 1;
+
+    auto cellOf = [cellSize]( int aCoord ) -> int64_t
+                  {
+                      int64_t coord = aCoord;
+                      return coord >= 0 ? coord / cellSize : ( coord + 1 ) / cellSize - 1;
+                  };
+
+    auto cellKey = []( int64_t aX, int64_t aY ) -> uint64_t
+                   {
+                       return ( (uint64_t) (uint32_t) aX << 32 ) | (uint32_t) aY;
+                   };
+
+    // Cells hold hole indices in increasing order
+    std::unordered_map<uint64_t, std::vector<size_t>> grid;
+
     for( size_t ii = 0; ii < holes.size(); ++ii )
+    {
+        const wxPoint& pos = holes[ii].m_location;
+        grid[ cellKey( cellOf( pos.x ), cellOf( pos.y ) ) ].push_back( ii );
+    }
+
+    // For each hole, the later holes too close to it and their distance.  Each pair is
+    // found once, from its first hole, as in a test of all the pairs.
+    std::vector<std::vector<std::pair<size_t, int>>> violations( holes.size() );
+
+    auto test_lambda = [&]( size_t ii )
     {
         const DRILLED_HOLE& refHole = holes[ ii ];
+        int64_t             cx = cellOf( refHole.m_location.x );
+        int64_t             cy = cellOf( refHole.m_location.y );
 
-        for( size_t jj = ii + 1; jj < holes.size(); ++jj )
+        for( int64_t x = cx - 1; x <= cx + 1; ++x )
         {
-            const DRILLED_HOLE& checkHole = holes[ jj ];
+            for( int64_t y = cy - 1; y <= cy + 1; ++y )
+            {
+                auto cell = grid.find( cellKey( x, y ) );
 
-            // Holes with identical locations are allowable
-            if( checkHole.m_location == refHole.m_location )
-                continue;
+                if( cell == grid.end() )
+                    continue;
 
-            int actual = KiROUND( GetLineLength( checkHole.m_location, refHole.m_location ) );
-            actual = std::max( 0, actual - checkHole.m_drillRadius - refHole.m_drillRadius );
+                for( size_t jj : cell->second )
+                {
+                    if( jj <= ii )
+                        continue;
 
-            if( actual < dsnSettings.m_HoleToHoleMin )
-            {
-                DRC_ITEM* drcItem = new DRC_ITEM( DRCE_DRILLED_HOLES_TOO_CLOSE );
+                    const DRILLED_HOLE& checkHole = holes[ jj ];
 
-                msg.Printf( drcItem->GetErrorText() + _( " (board minimum %s; actual %s)" ),
-                            MessageTextFromValue( userUnits(), dsnSettings.m_HoleToHoleMin, true ),
-                            MessageTextFromValue( userUnits(), actual, true ) );
+                    // Holes with identical locations are allowable
+                    if( checkHole.m_location == refHole.m_location )
+                        continue;
 
-                drcItem->SetErrorMessage( msg );
-                drcItem->SetItems( refHole.m_owner, checkHole.m_owner );
+                    int actual = KiROUND( GetLineLength( checkHole.m_location,
+                                                         refHole.m_location ) );
+                    actual = std::max( 0, actual - checkHole.m_drillRadius
+                                                 - refHole.m_drillRadius );
 
-                MARKER_PCB* marker = new MARKER_PCB( drcItem, refHole.m_location );
-                addMarkerToPcb( marker );
+                    if( actual < dsnSettings.m_HoleToHoleMin )
+                        violations[ii].emplace_back( jj, actual );
+                }
             }
         }
+
+        // Report in the order of the holes, whatever the order of the cells
+        std::sort( violations[ii].begin(), violations[ii].end() );
+    };
+
+    ParallelFor( holes.size(), test_lambda, 1024 );
+
+    // Markers are created here, in a stable order, as the board is not thread safe
+    for( size_t ii = 0; ii < holes.size(); ++ii )
+    {
+        const DRILLED_HOLE& refHole = holes[ ii ];
+
+        for( const std::pair<size_t, int>& violation : violations[ii] )
+        {
+            const DRILLED_HOLE& checkHole = holes[ violation.first ];
+            int                 actual = violation.second;
+
+            DRC_ITEM* drcItem = new DRC_ITEM( DRCE_DRILLED_HOLES_TOO_CLOSE );
+
+            msg.Printf( drcItem->GetErrorText() + _( " (board minimum %s; actual %s)" ),
+                        MessageTextFromValue( userUnits(), dsnSettings.m_HoleToHoleMin, true ),
+                        MessageTextFromValue( userUnits(), actual, true ) );
+
+            drcItem->SetErrorMessage( msg );
+            drcItem->SetItems( refHole.m_owner, checkHole.m_owner );
+
+            MARKER_PCB* marker = new MARKER_PCB( drcItem, refHole.m_location );
+            addMarkerToPcb( marker );
+        }
     }
 }
 
 
 void DRC::testTracks( wxWindow *aActiveWindow, bool aShowProgressBar )
 {
+    TRACE_SPAN span( "DRC::testTracks", "drc" );
+
     wxProgressDialog * progressDialog = NULL;
     const int delta = 500;  // This is the number of tests between 2 calls to the
                             // progress bar
@@ -902,6 +986,8 @@ void DRC::testTracks( wxWindow *aActiveWindow, bool aShowProgressBar )
 
 void DRC::testUnconnected()
 {
+    TRACE_SPAN span( "DRC::testUnconnected", "drc" );
+
     for( DRC_ITEM* unconnectedItem : m_unconnected )
         delete unconnectedItem;
 
@@ -927,6 +1013,8 @@ void DRC::testUnconnected()
 
 void DRC::testZones()
 {
+    TRACE_SPAN span( "DRC::testZones", "drc" );
+
     // Test copper areas for valid netcodes
     // if a netcode is < 0 the netname was not found when reading a netlist
     // if a netcode is == 0 the netname is void, and the zone is not connected.
@@ -968,6 +1056,8 @@ void DRC::testZones()
 
 void DRC::testKeepoutAreas()
 {
+    TRACE_SPAN span( "DRC::testKeepoutAreas", "drc" );
+
     // Get a list of all zones to inspect, from both board and footprints
     std::list<ZONE_CONTAINER*> areasToInspect = m_pcb->GetZoneList( true );
 
@@ -1032,6 +1122,8 @@ void DRC::testKeepoutAreas()
 
 void DRC::testCopperTextAndGraphics()
 {
+    TRACE_SPAN span( "DRC::testCopperTextAndGraphics", "drc" );
+
     // Test copper items for clearance violations with vias, tracks and pads
 
     for( BOARD_ITEM* brdItem : m_pcb->Drawings() )
@@ -1376,6 +1468,8 @@ void DRC::testCopperTextItem( BOARD_ITEM* aTextItem )
 
 void DRC::testOutline()
 {
+    TRACE_SPAN span( "DRC::testOutline", "drc" );
+
     wxPoint error_loc( m_pcb->GetBoardEdgesBoundingBox().GetPosition() );
 
     m_board_outlines.RemoveAllContours();
@@ -1393,6 +1487,8 @@ void DRC::testOutline()
 
 void DRC::testDisabledLayers()
 {
+    TRACE_SPAN span( "DRC::testDisabledLayers", "drc" );
+
     BOARD*   board = m_pcbEditorFrame->GetBoard();
     wxCHECK( board, /*void*/ );
 
@@ -1461,6 +1557,8 @@ void DRC::testDisabledLayers()
 
 void DRC::testTextVars()
 {
+    TRACE_SPAN span( "DRC::testTextVars", "drc" );
+
     BOARD* board = m_pcbEditorFrame->GetBoard();
 
     for( MODULE* module : board->Modules() )
@@ -1675,6 +1773,8 @@ bool DRC::doPadToPadsDrc( D_PAD* aRefPad, D_PAD** aStart, D_PAD** aEnd, int x_li
 
 void DRC::doCourtyardsDrc()
 {
+    TRACE_SPAN span( "DRC::doCourtyardsDrc", "drc" );
+
     DRC_COURTYARD_TESTER drc_overlap( [&]( MARKER_PCB* aMarker ) { addMarkerToPcb( aMarker ); } );
 
     drc_overlap.RunDRC( *m_pcb );
@@ -1758,10 +1858,10 @@ const int EPSILON = Mils2iu( 5 );
 
 wxPoint DRC::getLocation( TRACK* aTrack, ZONE_CONTAINER* aConflictZone ) const
 {
-    SHAPE_POLY_SET* conflictOutline;
+    const SHAPE_POLY_SET* conflictOutline;
 
     if( aConflictZone->IsFilled() )
-        conflictOutline = const_cast<SHAPE_POLY_SET*>( &aConflictZone->GetFilledPolysList() );
+        conflictOutline = &aConflictZone->GetFilledPolysList();
     else
         conflictOutline = aConflictZone->Outline();
 
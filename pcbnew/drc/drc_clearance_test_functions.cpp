@@ -485,13 +485,13 @@ void DRC::doTrackDrc( TRACK* aRefSeg, TRACKS::iterator aStartIt, TRACKS::iterato
             if( zone->GetNetCode() && zone->GetNetCode() == aRefSeg->GetNetCode() )
                 continue;
 
-            wxString        clearanceSource;
-            int             minClearance = aRefSeg->GetClearance( zone, &clearanceSource );
-            int             widths = refSegWidth / 2;
-            int             center2centerAllowed = minClearance + widths;
-            SHAPE_POLY_SET* outline = const_cast<SHAPE_POLY_SET*>( &zone->GetFilledPolysList() );
+            wxString              clearanceSource;
+            int                   minClearance = aRefSeg->GetClearance( zone, &clearanceSource );
+            int                   widths = refSegWidth / 2;
+            int                   center2centerAllowed = minClearance + widths;
+            const SHAPE_POLY_SET& outline = zone->GetFilledPolysList();
 
-            SEG::ecoord     center2center_squared = outline->SquaredDistance( testSeg );
+            SEG::ecoord           center2center_squared = outline.SquaredDistance( testSeg );
 
             // to avoid false positive, due to rounding issues and approxiamtions
             // in distance and clearance calculations, use a small threshold for distance
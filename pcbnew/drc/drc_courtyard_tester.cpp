@@ -28,9 +28,11 @@
 
 #include <class_module.h>
 #include <drc/drc.h>
+#include <parallel_for.h>
 
 #include <widgets/ui_common.h>
 
+#include <algorithm>
 #include <memory>
 
 /**
@@ -43,6 +45,119 @@
 static const wxChar* DRC_COURTYARD_TRACE = wxT( "KICAD_DRC_COURTYARD" );
 
 
+namespace
+{
+
+/// Two overlapping courtyards and a point of their common area
+struct COURTYARD_OVERLAP
+{
+    size_t  m_first;
+    size_t  m_second;
+    wxPoint m_pos;
+};
+
+
+/**
+ * Find the overlapping courtyards of one board side.
+ *
+ * Courtyard bounding boxes are sorted by their left edge and swept from left to right, so
+ * only the pairs whose boxes overlap get an exact (and costly) polygon intersection.  The
+ * intersections run in parallel.
+ *
+ * @param aCourtyards are the courtyards of the footprints; empty ones are skipped.
+ * @return the overlaps, with m_first < m_second, sorted by m_first then m_second.
+ */
+std::vector<COURTYARD_OVERLAP>
+findOverlaps( const std::vector<const SHAPE_POLY_SET*>& aCourtyards )
+{
+    std::vector<size_t> sorted;
+    std::vector<BOX2I>  bboxes( aCourtyards.size() );
+
+    for( size_t ii = 0; ii < aCourtyards.size(); ++ii )
+    {
+        if( aCourtyards[ii]->OutlineCount() == 0 )
+            continue; // No courtyard defined
+
+        bboxes[ii] = aCourtyards[ii]->BBox();
+        sorted.push_back( ii );
+    }
+
+    std::sort( sorted.begin(), sorted.end(),
+               [&]( size_t a, size_t b )
+               {
+                   return bboxes[a].GetLeft() < bboxes[b].GetLeft();
+               } );
+
+    std::vector<COURTYARD_OVERLAP> candidates;
+    std::vector<size_t>            active;
+
+    for( size_t ii : sorted )
+    {
+        const BOX2I& bbox = bboxes[ii];
+
+        // Boxes ending left of this one cannot overlap it nor any of the next ones
+        active.erase( std::remove_if( active.begin(), active.end(),
+                                      [&]( size_t jj )
+                                      {
+                                          return bboxes[jj].GetRight() < bbox.GetLeft();
+                                      } ),
+                      active.end() );
+
+        for( size_t jj : active )
+        {
+            const BOX2I& other = bboxes[jj];
+
+            if( other.GetTop() <= bbox.GetBottom() && bbox.GetTop() <= other.GetBottom() )
+                candidates.push_back( { std::min( ii, jj ), std::max( ii, jj ), wxPoint() } );
+        }
+
+        active.push_back( ii );
+    }
+
+    std::vector<char> overlapping( candidates.size(), 0 );
+
+    auto intersect_lambda = [&]( size_t ii )
+    {
+        COURTYARD_OVERLAP& candidate = candidates[ii];
+        SHAPE_POLY_SET     courtyard; // temporary storage of the common area
+
+        // Build the common area between footprint and the candidate:
+        courtyard.BooleanIntersection( *aCourtyards[candidate.m_first],
+                                       *aCourtyards[candidate.m_second],
+                                       SHAPE_POLY_SET::PM_FAST );
+
+        // If no overlap, courtyard is empty (no common area).
+        if( courtyard.OutlineCount() )
+        {
+            candidate.m_pos = (wxPoint) courtyard.CVertex( 0, 0, -1 );
+            overlapping[ii] = 1;
+        }
+    };
+
+    ParallelFor( candidates.size(), intersect_lambda, 64 );
+
+    std::vector<COURTYARD_OVERLAP> overlaps;
+
+    for( size_t ii = 0; ii < candidates.size(); ++ii )
+    {
+        if( overlapping[ii] )
+            overlaps.push_back( candidates[ii] );
+    }
+
+    // Report in the order of the footprints, whatever the order of the sweep
+    std::sort( overlaps.begin(), overlaps.end(),
+               []( const COURTYARD_OVERLAP& a, const COURTYARD_OVERLAP& b )
+               {
+                   return a.m_first < b.m_first
+                          || ( a.m_first == b.m_first && a.m_second < b.m_second );
+               } );
+
+    return overlaps;
+}
+
+} // namespace
+
+
 DRC_COURTYARD_TESTER::DRC_COURTYARD_TESTER( MARKER_HANDLER aMarkerHandler ) :
         DRC_TEST_PROVIDER( aMarkerHandler )
 {
@@ -94,75 +209,27 @@ bool DRC_COURTYARD_TESTER::RunDRC( BOARD& aBoard ) const
 
     wxLogTrace( DRC_COURTYARD_TRACE, "Checking for courtyard overlap" );
 
-    // Now test for overlapping on top layer:
-    SHAPE_POLY_SET courtyard; // temporary storage of the courtyard of current footprint
+    std::vector<MODULE*>               footprints( aBoard.Modules().begin(),
+                                                   aBoard.Modules().end() );
+    std::vector<const SHAPE_POLY_SET*> front;
+    std::vector<const SHAPE_POLY_SET*> back;
 
-    for( auto it1 = aBoard.Modules().begin(); it1 != aBoard.Modules().end(); it1++ )
+    for( MODULE* footprint : footprints )
     {
-        MODULE* footprint = *it1;
-
-        if( footprint->GetPolyCourtyardFront().OutlineCount() == 0 )
-            continue; // No courtyard defined
-
-        for( auto it2 = it1 + 1; it2 != aBoard.Modules().end(); it2++ )
-        {
-            MODULE* candidate = *it2;
-
-            if( candidate->GetPolyCourtyardFront().OutlineCount() == 0 )
-                continue; // No courtyard defined
-
-            courtyard.RemoveAllContours();
-            courtyard.Append( footprint->GetPolyCourtyardFront() );
-
-            // Build the common area between footprint and the candidate:
-            courtyard.BooleanIntersection( candidate->GetPolyCourtyardFront(),
-                                           SHAPE_POLY_SET::PM_FAST );
-
-            // If no overlap, courtyard is empty (no common area).
-            // Therefore if a common polygon exists, this is a DRC error
-            if( courtyard.OutlineCount() )
-            {
-                //Overlap between footprint and candidate
-                DRC_ITEM* drcItem = new DRC_ITEM( DRCE_OVERLAPPING_FOOTPRINTS );
-                drcItem->SetItems( footprint, candidate );
-                HandleMarker( new MARKER_PCB( drcItem, (wxPoint) courtyard.CVertex( 0, 0, -1 ) ) );
-                success = false;
-            }
-        }
+        front.push_back( &footprint->GetPolyCourtyardFront() );
+        back.push_back( &footprint->GetPolyCourtyardBack() );
     }
 
-    // Test for overlapping on bottom layer:
-    for( auto it1 = aBoard.Modules().begin(); it1 != aBoard.Modules().end(); it1++ )
+    // Test for overlapping on top layer, then on bottom layer:
+    for( const std::vector<const SHAPE_POLY_SET*>* courtyards : { &front, &back } )
     {
-        MODULE* footprint = *it1;
-
-        if( footprint->GetPolyCourtyardBack().OutlineCount() == 0 )
-            continue; // No courtyard defined
-
-        for( auto it2 = it1 + 1; it2 != aBoard.Modules().end(); it2++ )
+        for( const COURTYARD_OVERLAP& overlap : findOverlaps( *courtyards ) )
         {
-            MODULE* candidate = *it2;
-
-            if( candidate->GetPolyCourtyardBack().OutlineCount() == 0 )
-                continue; // No courtyard defined
-
-            courtyard.RemoveAllContours();
-            courtyard.Append( footprint->GetPolyCourtyardBack() );
-
-            // Build the common area between footprint and the candidate:
-            courtyard.BooleanIntersection( candidate->GetPolyCourtyardBack(),
-                                           SHAPE_POLY_SET::PM_FAST );
-
-            // If no overlap, courtyard is empty (no common area).
-            // Therefore if a common polygon exists, this is a DRC error
-            if( courtyard.OutlineCount() )
-            {
-                //Overlap between footprint and candidate
-                DRC_ITEM* drcItem = new DRC_ITEM( DRCE_OVERLAPPING_FOOTPRINTS );
-                drcItem->SetItems( footprint, candidate );
-                HandleMarker( new MARKER_PCB( drcItem, (wxPoint) courtyard.CVertex( 0, 0, -1 ) ) );
-                success = false;
-            }
+            //Overlap between footprint and candidate
+            DRC_ITEM* drcItem = new DRC_ITEM( DRCE_OVERLAPPING_FOOTPRINTS );
+            drcItem->SetItems( footprints[overlap.m_first], footprints[overlap.m_second] );
+            HandleMarker( new MARKER_PCB( drcItem, overlap.m_pos ) );
+            success = false;
         }
     }
 
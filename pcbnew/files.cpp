@@ -248,6 +248,9 @@ bool PCB_EDIT_FRAME::Files_io_from_id( int id )
     case ID_MENU_READ_BOARD_BACKUP_FILE:
     case ID_MENU_RECOVER_BOARD_AUTOSAVE:
         {
+            // The backup and auto save files are written by the background save
+            WaitForBackgroundSave();
+
             wxFileName currfn = Prj().AbsolutePath( GetBoard()->GetFileName() );
             wxFileName fn = currfn;
 
@@ -288,6 +291,8 @@ bool PCB_EDIT_FRAME::Files_io_from_id( int id )
 
     case ID_NEW_BOARD:
     {
+        WaitForBackgroundSave();
+
         if( IsContentModified() )
         {
             wxFileName fileName = GetBoard()->GetFileName();
@@ -295,7 +300,11 @@ bool PCB_EDIT_FRAME::Files_io_from_id( int id )
                     _( "Current board will be closed, save changes to \"%s\" before continuing?" );
 
             if( !HandleUnsavedChanges( this, wxString::Format( saveMsg, fileName.GetFullName() ),
-                                       [&]()->bool { return Files_io_from_id( ID_SAVE_BOARD ); } ) )
+                                       [&]()->bool
+                                       {
+                                           return Files_io_from_id( ID_SAVE_BOARD )
+                                                  && WaitForBackgroundSave();
+                                       } ) )
                 return false;
         }
         else if( !GetBoard()->IsEmpty() )
@@ -464,10 +473,16 @@ bool PCB_EDIT_FRAME::OpenProjectFiles( const std::vector<wxString>& aFileSet, in
         return false;
     }
 
+    WaitForBackgroundSave();
+
     if( IsContentModified() )
     {
         if( !HandleUnsavedChanges( this, _( "The current PCB has been modified.  Save changes?" ),
-            [&]()->bool { return SavePcbFile( GetBoard()->GetFileName(), CREATE_BACKUP_FILE ); } ) )
+            [&]()->bool
+            {
+                return SavePcbFile( GetBoard()->GetFileName(), CREATE_BACKUP_FILE )
+                       && WaitForBackgroundSave();
+            } ) )
         {
             return false;
         }
@@ -710,6 +725,9 @@ bool PCB_EDIT_FRAME::SavePcbFile( const wxString& aFileName, bool aCreateBackupF
 {
     // please, keep it simple.  prompting goes elsewhere.
 
+    // One save at a time: the backup below must not copy a half written file
+    WaitForBackgroundSave();
+
     wxFileName  pcbFileName = aFileName;
 
     if( pcbFileName.GetExt() == LegacyPcbFileExtension )
@@ -744,23 +762,82 @@ bool PCB_EDIT_FRAME::SavePcbFile( const wxString& aFileName, bool aCreateBackupF
 
     ClearMsgPanel();
 
-    wxString    upperTxt;
-    wxString    lowerTxt;
+    wxASSERT( pcbFileName.IsAbsolute() );
 
-    try
-    {
-        PLUGIN::RELEASER    pi( IO_MGR::PluginFind( IO_MGR::KICAD_SEXP ) );
+    // The board is written from a snapshot on a worker thread; finishBackgroundSave()
+    // reports the result on the GUI thread.
+    BOARD*   snapshot = GetBoard()->CreateSnapshot();
+    PLUGIN*  plugin = IO_MGR::PluginFind( IO_MGR::KICAD_SEXP );
+    wxString fullPath = pcbFileName.GetFullPath();
 
-        wxASSERT( pcbFileName.IsAbsolute() );
+    m_saveFileName = fullPath;
+    m_saveBackupFileName = backupFileName;
+    m_saveIsAutoSave = false;
 
-        pi->Save( pcbFileName.GetFullPath(), GetBoard(), NULL );
-    }
-    catch( const IO_ERROR& ioe )
+    m_saveResult = std::async( std::launch::async,
+            [this, snapshot, plugin, fullPath]() -> wxString
+            {
+                std::unique_ptr<BOARD> board( snapshot );
+                PLUGIN::RELEASER       pi( plugin );
+                wxString               error;
+
+                try
+                {
+                    pi->Save( fullPath, board.get(), NULL );
+                }
+                catch( const IO_ERROR& ioe )
+                {
+                    error = ioe.What();
+                }
+
+                board.reset();
+
+                CallAfter( [this]()
+                           {
+                               finishBackgroundSave();
+                           } );
+
+                return error;
+            } );
+
+    GetBoard()->SetFileName( fullPath );
+    UpdateTitle();
+
+    // Put the saved file in File History, unless aCreateBackupFile is false (which indicates
+    // an autosave -- and we don't want autosave files in the file history).
+    if( aCreateBackupFile )
+        UpdateFileHistory( GetBoard()->GetFileName() );
+
+    // Changes made from now on are not in the saved file
+    GetScreen()->ClrModify();
+    GetScreen()->ClrSave();
+    return true;
+}
+
+
+bool PCB_EDIT_FRAME::WaitForBackgroundSave()
+{
+    return finishBackgroundSave();
+}
+
+
+bool PCB_EDIT_FRAME::finishBackgroundSave()
+{
+    // Already reported, e.g. by WaitForBackgroundSave() before the queued call ran
+    if( !m_saveResult.valid() )
+        return true;
+
+    wxString    error = m_saveResult.get();
+    wxFileName  pcbFileName = m_saveFileName;
+    wxString    upperTxt;
+    wxString    lowerTxt;
+
+    if( !error.IsEmpty() )
     {
         wxString msg = wxString::Format( _(
                 "Error saving board file \"%s\".\n%s" ),
                 GetChars( pcbFileName.GetFullPath() ),
-                GetChars( ioe.What() )
+                GetChars( error )
                 );
         DisplayError( this, msg );
 
@@ -768,16 +845,14 @@ bool PCB_EDIT_FRAME::SavePcbFile( const wxString& aFileName, bool aCreateBackupF
 
         AppendMsgPanel( upperTxt, lowerTxt, CYAN );
 
-        return false;
-    }
+        // The board was not saved
+        GetScreen()->SetModify();
 
-    GetBoard()->SetFileName( pcbFileName.GetFullPath() );
-    UpdateTitle();
+        if( m_saveIsAutoSave )
+            m_autoSaveTimer->Start( m_autoSaveInterval * 1000, wxTIMER_ONE_SHOT );
 
-    // Put the saved file in File History, unless aCreateBackupFile is false (which indicates
-    // an autosave -- and we don't want autosave files in the file history).
-    if( aCreateBackupFile )
-        UpdateFileHistory( GetBoard()->GetFileName() );
+        return false;
+    }
 
     // Delete auto save file on successful save.
     wxFileName autoSaveFileName = pcbFileName;
@@ -787,15 +862,13 @@ bool PCB_EDIT_FRAME::SavePcbFile( const wxString& aFileName, bool aCreateBackupF
     if( autoSaveFileName.FileExists() )
         wxRemoveFile( autoSaveFileName.GetFullPath() );
 
-    if( !!backupFileName )
-        upperTxt.Printf( _( "Backup file: \"%s\"" ), GetChars( backupFileName ) );
+    if( !!m_saveBackupFileName )
+        upperTxt.Printf( _( "Backup file: \"%s\"" ), GetChars( m_saveBackupFileName ) );
 
     lowerTxt.Printf( _( "Wrote board file: \"%s\"" ), GetChars( pcbFileName.GetFullPath() ) );
 
     AppendMsgPanel( upperTxt, lowerTxt, CYAN );
 
-    GetScreen()->ClrModify();
-    GetScreen()->ClrSave();
     return true;
 }
 
@@ -888,6 +961,7 @@ bool PCB_EDIT_FRAME::doAutoSave()
 
     if( SavePcbFile( autoSaveFileName.GetFullPath(), NO_BACKUP_FILE ) )
     {
+        m_saveIsAutoSave = true;
         GetScreen()->SetModify();
         GetBoard()->SetFileName( tmpFileName.GetFullPath() );
         UpdateTitle();
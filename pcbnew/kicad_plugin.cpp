@@ -55,6 +55,15 @@
 
 #include <advanced_config.h> // for pad pin function and pad property feature management
 
+#include <chrono>
+#include <map>
+#include <mutex>
+
+#if defined( __linux__ )
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
 using namespace PCB_KEYS_T;
 
 
@@ -87,21 +96,168 @@ class FP_CACHE_ITEM
 {
     WX_FILENAME             m_filename;
     std::unique_ptr<MODULE> m_module;
+    long long               m_timestamp;    // Of the file when it was last read or written
 
 public:
-    FP_CACHE_ITEM( MODULE* aModule, const WX_FILENAME& aFileName );
+    FP_CACHE_ITEM( MODULE* aModule, const WX_FILENAME& aFileName, long long aTimestamp );
 
     const WX_FILENAME& GetFileName() const { return m_filename; }
     const MODULE*      GetModule()   const { return m_module.get(); }
+
+    long long GetTimestamp() const { return m_timestamp; }
+    void      SetTimestamp( long long aTimestamp ) { m_timestamp = aTimestamp; }
 };
 
 
-FP_CACHE_ITEM::FP_CACHE_ITEM( MODULE* aModule, const WX_FILENAME& aFileName ) :
+FP_CACHE_ITEM::FP_CACHE_ITEM( MODULE* aModule, const WX_FILENAME& aFileName,
+                              long long aTimestamp ) :
     m_filename( aFileName ),
-    m_module( aModule )
+    m_module( aModule ),
+    m_timestamp( aTimestamp )
 { }
 
 
+/**
+ * FP_LIB_WATCHER
+ * counts the changes to footprint files in the watched library directories, so that
+ * FP_CACHE::IsModified() does not have to read the timestamp of every footprint file.
+ *
+ * One inotify instance is shared by all the libraries on Linux.  On other systems nothing
+ * is watched and the caches only poll the library timestamps.  Polling is still needed on
+ * Linux for the changes made by other hosts on network shares, which inotify does not see.
+ */
+class FP_LIB_WATCHER
+{
+public:
+    static FP_LIB_WATCHER& Get()
+    {
+        // Never destroyed: caches can be deleted by static destructors
+        static FP_LIB_WATCHER* s_watcher = new FP_LIB_WATCHER();
+        return *s_watcher;
+    }
+
+    /**
+     * Start watching \a aPath.
+     * @return a watch id, or -1 if the directory cannot be watched.
+     */
+    int Watch( const wxString& aPath )
+    {
+        std::lock_guard<std::mutex> lock( m_lock );
+        int                         watch = -1;
+
+#if defined( __linux__ )
+        if( m_fd >= 0 )
+        {
+            watch = inotify_add_watch( m_fd, aPath.fn_str(),
+                                       IN_CLOSE_WRITE | IN_MODIFY | IN_CREATE | IN_DELETE
+                                       | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF
+                                       | IN_MOVE_SELF );
+        }
+#endif
+
+        // The same directory gives the same watch id
+        if( watch >= 0 )
+            m_watches[watch].m_refs++;
+
+        return watch;
+    }
+
+    void Unwatch( int aWatch )
+    {
+        std::lock_guard<std::mutex> lock( m_lock );
+        auto                        it = m_watches.find( aWatch );
+
+        if( it == m_watches.end() || --it->second.m_refs > 0 )
+            return;
+
+#if defined( __linux__ )
+        inotify_rm_watch( m_fd, aWatch );
+#endif
+        m_watches.erase( it );
+    }
+
+    /**
+     * @return a count of the changes seen in the directory of \a aWatch.  Only its
+     * variations are meaningful.
+     */
+    uint64_t GetChangeCount( int aWatch )
+    {
+        std::lock_guard<std::mutex> lock( m_lock );
+
+        readEvents();
+
+        auto it = m_watches.find( aWatch );
+        return it != m_watches.end() ? it->second.m_changes : 0;
+    }
+
+private:
+    struct WATCH
+    {
+        int      m_refs = 0;
+        uint64_t m_changes = 0;
+    };
+
+    FP_LIB_WATCHER() :
+        m_fd( -1 )
+    {
+#if defined( __linux__ )
+        m_fd = inotify_init1( IN_NONBLOCK | IN_CLOEXEC );
+#endif
+    }
+
+    /// Read the pending notifications without blocking.  Must be called with m_lock held.
+    void readEvents()
+    {
+#if defined( __linux__ )
+        if( m_fd < 0 )
+            return;
+
+        alignas( struct inotify_event ) char buffer[4096];
+        std::string                          extension = "." + KiCadFootprintFileExtension;
+        ssize_t                              len;
+
+        while( ( len = read( m_fd, buffer, sizeof( buffer ) ) ) > 0 )
+        {
+            for( char* ptr = buffer; ptr < buffer + len; )
+            {
+                const struct inotify_event* event = (const struct inotify_event*) ptr;
+
+                ptr += sizeof( struct inotify_event ) + event->len;
+
+                if( event->mask & IN_Q_OVERFLOW )
+                {
+                    // Events were lost: assume every library changed
+                    for( std::pair<const int, WATCH>& watch : m_watches )
+                        watch.second.m_changes++;
+
+                    continue;
+                }
+
+                auto it = m_watches.find( event->wd );
+
+                if( it == m_watches.end() )
+                    continue;
+
+                std::string name = event->len ? event->name : "";
+
+                // Ignore temporary and foreign files, but not changes to the directory itself
+                if( name.empty() || ( name.size() > extension.size()
+                        && name.compare( name.size() - extension.size(), extension.size(),
+                                         extension ) == 0 ) )
+                {
+                    it->second.m_changes++;
+                }
+            }
+        }
+#endif
+    }
+
+    std::mutex           m_lock;
+    int                  m_fd;
+    std::map<int, WATCH> m_watches;
+};
+
+
 typedef boost::ptr_map< wxString, FP_CACHE_ITEM >   MODULE_MAP;
 typedef MODULE_MAP::iterator                        MODULE_ITER;
 typedef MODULE_MAP::const_iterator                  MODULE_CITER;
@@ -119,8 +275,16 @@ class FP_CACHE
     long long       m_cache_timestamp;  // A hash of the timestamps for all the footprint
                                         // files.
 
+    int             m_watch;            // FP_LIB_WATCHER id of the library, or -1
+    uint64_t        m_watch_changes;    // Change count of m_watch when last loaded
+    std::chrono::steady_clock::time_point m_last_check;  // Of m_cache_timestamp
+
+    // The files which could not be parsed, with their timestamp and error message
+    std::map<wxString, std::pair<long long, wxString>> m_load_errors;
+
 public:
     FP_CACHE( PCB_IO* aOwner, const wxString& aLibraryPath );
+    ~FP_CACHE();
 
     wxString    GetPath() const { return m_lib_raw_path; }
     bool        IsWritable() const { return m_lib_path.IsOk() && m_lib_path.IsDirWritable(); }
@@ -139,6 +303,11 @@ public:
      */
     void Save( MODULE* aModule = NULL );
 
+    /**
+     * Function Load
+     * Read the library.  When the cache is already loaded, only the footprint files
+     * which changed since are parsed again.
+     */
     void Load();
 
     void Remove( const wxString& aFootprintName );
@@ -153,7 +322,9 @@ public:
 
     /**
      * Function IsModified
-     * Return true if the cache is not up-to-date.
+     * Return true if the cache is not up-to-date.  This is cheap: the file timestamps are
+     * only read when the library watcher saw a change, or at most once per
+     * ADVANCED_CFG::m_fpLibPollInterval.
      */
     bool IsModified();
 
@@ -180,6 +351,15 @@ FP_CACHE::FP_CACHE( PCB_IO* aOwner, const wxString& aLibraryPath )
     m_lib_path.SetPath( aLibraryPath );
     m_cache_timestamp = 0;
     m_cache_dirty = true;
+    m_watch = -1;
+    m_watch_changes = 0;
+}
+
+
+FP_CACHE::~FP_CACHE()
+{
+    if( m_watch >= 0 )
+        FP_LIB_WATCHER::Get().Unwatch( m_watch );
 }
 
 
@@ -241,7 +421,9 @@ void FP_CACHE::Save( MODULE* aModule )
             THROW_IO_ERROR( msg );
         }
 #endif
-        m_cache_timestamp += fn.GetTimestamp();
+        // Keep the cached footprint when the library is checked for changes again
+        it->second->SetTimestamp( fn.GetTimestamp() );
+        m_cache_timestamp += it->second->GetTimestamp();
     }
 
     m_cache_timestamp += m_lib_path.GetModificationTime().GetValue().GetValue();
@@ -256,6 +438,14 @@ void FP_CACHE::Load()
 {
     m_cache_dirty = false;
     m_cache_timestamp = 0;
+    m_last_check = std::chrono::steady_clock::now();
+
+    // Read the change count first, so changes made while loading are not missed
+    if( m_watch < 0 )
+        m_watch = FP_LIB_WATCHER::Get().Watch( m_lib_raw_path );
+
+    if( m_watch >= 0 )
+        m_watch_changes = FP_LIB_WATCHER::Get().GetChangeCount( m_watch );
 
     wxDir dir( m_lib_raw_path );
 
@@ -274,14 +464,40 @@ void FP_CACHE::Load()
     // the filename thereafter.
     WX_FILENAME fn( m_lib_raw_path, wxT( "dummyName" ) );
 
+    // Footprints and errors of the previous load are kept if their file did not change
+    MODULE_MAP previous;
+    previous.transfer( m_modules );
+
+    std::map<wxString, std::pair<long long, wxString>> previousErrors;
+    previousErrors.swap( m_load_errors );
+
     if( dir.GetFirst( &fullName, fileSpec ) )
     {
-        wxString cacheError;
-
         do
         {
             fn.SetFullName( fullName );
 
+            wxString  fpName = fn.GetName();
+            long long timestamp = fn.GetTimestamp();
+
+            m_cache_timestamp += timestamp;
+
+            MODULE_ITER cached = previous.find( fpName );
+
+            if( cached != previous.end() && cached->second->GetTimestamp() == timestamp )
+            {
+                m_modules.transfer( cached, previous );
+                continue;
+            }
+
+            auto error = previousErrors.find( fullName );
+
+            if( error != previousErrors.end() && error->second.first == timestamp )
+            {
+                m_load_errors.insert( *error );
+                continue;
+            }
+
             // Queue I/O errors so only files that fail to parse don't get loaded.
             try
             {
@@ -290,25 +506,29 @@ void FP_CACHE::Load()
                 m_owner->m_parser->SetLineReader( &reader );
 
                 MODULE*     footprint = (MODULE*) m_owner->m_parser->Parse();
-                wxString    fpName = fn.GetName();
 
                 footprint->SetFPID( LIB_ID( wxEmptyString, fpName ) );
-                m_modules.insert( fpName, new FP_CACHE_ITEM( footprint, fn ) );
-
-                m_cache_timestamp += fn.GetTimestamp();
+                m_modules.insert( fpName, new FP_CACHE_ITEM( footprint, fn, timestamp ) );
             }
             catch( const IO_ERROR& ioe )
             {
-                if( !cacheError.IsEmpty() )
-                    cacheError += "\n\n";
-
-                cacheError += ioe.What();
+                m_load_errors[fullName] = std::make_pair( timestamp, ioe.What() );
             }
         } while( dir.GetNext( &fullName ) );
+    }
+
+    wxString cacheError;
 
+    for( const std::pair<const wxString, std::pair<long long, wxString>>& error : m_load_errors )
+    {
         if( !cacheError.IsEmpty() )
-            THROW_IO_ERROR( cacheError );
+            cacheError += "\n\n";
+
+        cacheError += error.second.second;
     }
+
+    if( !cacheError.IsEmpty() )
+        THROW_IO_ERROR( cacheError );
 }
 
 
@@ -339,7 +559,23 @@ bool FP_CACHE::IsPath( const wxString& aPath ) const
 
 bool FP_CACHE::IsModified()
 {
-    m_cache_dirty = m_cache_dirty || GetTimestamp( m_lib_path.GetFullPath() ) != m_cache_timestamp;
+    if( m_cache_dirty )
+        return true;
+
+    if( m_watch >= 0 && FP_LIB_WATCHER::Get().GetChangeCount( m_watch ) != m_watch_changes )
+    {
+        m_cache_dirty = true;
+        return true;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    int  interval = ADVANCED_CFG::GetCfg().m_fpLibPollInterval;
+
+    if( interval > 0 && now - m_last_check < std::chrono::milliseconds( interval ) )
+        return false;
+
+    m_last_check = now;
+    m_cache_dirty = GetTimestamp( m_lib_path.GetFullPath() ) != m_cache_timestamp;
 
     return m_cache_dirty;
 }
@@ -364,16 +600,54 @@ void PCB_IO::Save( const wxString& aFileName, BOARD* aBoard, const PROPERTIES* a
     // Prepare net mapping that assures that net codes saved in a file are consecutive integers
     m_mapping->SetBoard( aBoard );
 
-    FILE_OUTPUTFORMATTER    formatter( aFileName );
+    // Write next to the target and rename when complete, so that a crash or a full disk
+    // never leaves a truncated board file behind.
+    //
+    // Limitations: the data is not fsync'ed before the rename, so after a power loss the
+    // file may still be empty on some file systems.  The new file gets default permissions
+    // instead of those of the file it replaces, and a symbolic link at aFileName is replaced
+    // by a regular file instead of writing through to its target.  On Windows, wxRenameFile()
+    // may fall back to copying over the old file, which is not atomic.
+    wxString tempFileName = wxString::Format( wxT( "%s.%lu.tmp" ), aFileName,
+                                              (unsigned long) wxGetProcessId() );
+
+    try
+    {
+        FILE_OUTPUTFORMATTER    formatter( tempFileName );
 
-    m_out = &formatter;     // no ownership
+        m_out = &formatter;     // no ownership
 
-    m_out->Print( 0, "(kicad_pcb (version %d) (host pcbnew %s)\n", SEXPR_BOARD_FILE_VERSION,
-                  formatter.Quotew( GetBuildVersion() ).c_str() );
+        m_out->Print( 0, "(kicad_pcb (version %d) (host pcbnew %s)\n", SEXPR_BOARD_FILE_VERSION,
+                      formatter.Quotew( GetBuildVersion() ).c_str() );
 
-    Format( aBoard, 1 );
+        Format( aBoard, 1 );
 
-    m_out->Print( 0, ")\n" );
+        m_out->Print( 0, ")\n" );
+
+        formatter.Finish();
+        m_out = &m_sf;
+    }
+    catch( const IO_ERROR& )
+    {
+        m_out = &m_sf;
+
+        if( wxFileExists( tempFileName ) )
+            wxRemoveFile( tempFileName );
+
+        throw;
+    }
+
+    if( !wxRenameFile( tempFileName, aFileName, true ) )
+    {
+        wxRemoveFile( tempFileName );
+
+        wxString msg = wxString::Format(
+                _( "Cannot rename temporary file \"%s\" to board file \"%s\"" ),
+                GetChars( tempFileName ),
+                GetChars( aFileName )
+                );
+        THROW_IO_ERROR( msg );
+    }
 }
 
 
@@ -900,8 +1174,8 @@ void PCB_IO::format( DRAWSEGMENT* aSegment, int aNestLevel ) const
     case S_POLYGON: // Polygon
         if( aSegment->IsPolyShapeValid() )
         {
-            SHAPE_POLY_SET& poly = aSegment->GetPolyShape();
-            SHAPE_LINE_CHAIN& outline = poly.Outline( 0 );
+            const SHAPE_POLY_SET&   poly = aSegment->GetPolyShape();
+            const SHAPE_LINE_CHAIN& outline = poly.COutline( 0 );
             int pointsCount = outline.PointCount();
 
             m_out->Print( aNestLevel, "(gr_poly (pts" );
@@ -973,8 +1247,8 @@ void PCB_IO::format( EDGE_MODULE* aModuleDrawing, int aNestLevel ) const
     case S_POLYGON: // Polygonal segment
         if( aModuleDrawing->IsPolyShapeValid() )
         {
-            SHAPE_POLY_SET& poly = aModuleDrawing->GetPolyShape();
-            SHAPE_LINE_CHAIN& outline = poly.Outline( 0 );
+            const SHAPE_POLY_SET&   poly = aModuleDrawing->GetPolyShape();
+            const SHAPE_LINE_CHAIN& outline = poly.COutline( 0 );
             int pointsCount = outline.PointCount();
 
             m_out->Print( aNestLevel, "(fp_poly (pts" );
@@ -2105,13 +2379,18 @@ void PCB_IO::init( const PROPERTIES* aProperties )
 
 void PCB_IO::validateCache( const wxString& aLibraryPath, bool checkModified )
 {
-    if( !m_cache || !m_cache->IsPath( aLibraryPath ) || ( checkModified && m_cache->IsModified() ) )
+    if( !m_cache || !m_cache->IsPath( aLibraryPath ) )
     {
         // a spectacular episode in memory management:
         delete m_cache;
         m_cache = new FP_CACHE( this, aLibraryPath );
         m_cache->Load();
     }
+    else if( checkModified && m_cache->IsModified() )
+    {
+        // Only parses the footprint files which changed
+        m_cache->Load();
+    }
 }
 
 
@@ -2304,7 +2583,9 @@ void PCB_IO::FootprintSave( const wxString& aLibraryPath, const MODULE* aFootpri
     }
 
     wxLogTrace( traceKicadPcbPlugin, wxT( "Creating s-expr footprint file '%s'." ), fullPath );
-    mods.insert( footprintName, new FP_CACHE_ITEM( module, WX_FILENAME( fn.GetPath(), fullName ) ) );
+    // Save() sets the file timestamp
+    mods.insert( footprintName,
+                 new FP_CACHE_ITEM( module, WX_FILENAME( fn.GetPath(), fullName ), 0 ) );
     m_cache->Save( module );
 }
 
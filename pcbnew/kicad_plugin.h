@@ -119,6 +119,11 @@ public:
         return wxT( "kicad_pcb" );
     }
 
+    /**
+     * Write the board to a temporary file in the same directory, then rename it over
+     * \a aFileName.  The data is not fsync'ed, and the permissions of an existing file and
+     * symbolic links at \a aFileName are not kept.
+     */
     virtual void Save( const wxString& aFileName, BOARD* aBoard,
                const PROPERTIES* aProperties = NULL ) override;
 
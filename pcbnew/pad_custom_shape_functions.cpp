@@ -152,7 +152,7 @@ void D_PAD::AddPrimitivePoly(
     PAD_CS_PRIMITIVE shape( S_POLYGON );
     shape.m_Poly = aPoly;
     shape.m_Thickness = aThickness;
-    m_basicShapes.push_back( shape );
+    m_basicShapes.Write().push_back( shape );
 
     if( aMergePrimitives )
         MergePrimitivesAsPolygon();
@@ -166,7 +166,7 @@ void D_PAD::AddPrimitiveSegment(
     shape.m_Start = aStart;
     shape.m_End = aEnd;
     shape.m_Thickness = aThickness;
-    m_basicShapes.push_back( shape );
+    m_basicShapes.Write().push_back( shape );
 
     if( aMergePrimitives )
         MergePrimitivesAsPolygon();
@@ -181,7 +181,7 @@ void D_PAD::AddPrimitiveArc(
     shape.m_End = aStart;
     shape.m_ArcAngle = aArcAngle;
     shape.m_Thickness = aThickness;
-    m_basicShapes.push_back( shape );
+    m_basicShapes.Write().push_back( shape );
 
     if( aMergePrimitives )
         MergePrimitivesAsPolygon();
@@ -197,7 +197,7 @@ void D_PAD::AddPrimitiveCurve( wxPoint aStart, wxPoint aEnd, wxPoint aCtrl1, wxP
     shape.m_Ctrl1 = aCtrl1;
     shape.m_Ctrl2 = aCtrl2;
     shape.m_Thickness = aThickness;
-    m_basicShapes.push_back( shape );
+    m_basicShapes.Write().push_back( shape );
 
     if( aMergePrimitives )
         MergePrimitivesAsPolygon();
@@ -211,7 +211,7 @@ void D_PAD::AddPrimitiveCircle(
     shape.m_Start = aCenter;
     shape.m_Radius = aRadius;
     shape.m_Thickness = aThickness;
-    m_basicShapes.push_back( shape );
+    m_basicShapes.Write().push_back( shape );
 
     if( aMergePrimitives )
         MergePrimitivesAsPolygon();
@@ -220,12 +220,8 @@ void D_PAD::AddPrimitiveCircle(
 
 bool D_PAD::SetPrimitives( const std::vector<PAD_CS_PRIMITIVE>& aPrimitivesList )
 {
-    // clear old list
-    m_basicShapes.clear();
-
-    // Import to the basic shape list
-    if( aPrimitivesList.size() )
-        m_basicShapes = aPrimitivesList;
+    // Replace the basic shape list
+    m_basicShapes.Set( aPrimitivesList );
 
     // Only one polygon is expected (pad area = only one copper area)
     return MergePrimitivesAsPolygon();
@@ -233,8 +229,10 @@ bool D_PAD::SetPrimitives( const std::vector<PAD_CS_PRIMITIVE>& aPrimitivesList
 
 bool D_PAD::AddPrimitives( const std::vector<PAD_CS_PRIMITIVE>& aPrimitivesList )
 {
+    std::vector<PAD_CS_PRIMITIVE>& basicShapes = m_basicShapes.Write();
+
     for( const auto& prim : aPrimitivesList )
-        m_basicShapes.push_back( prim );
+        basicShapes.push_back( prim );
 
     return MergePrimitivesAsPolygon();
 }
@@ -243,8 +241,8 @@ bool D_PAD::AddPrimitives( const std::vector<PAD_CS_PRIMITIVE>& aPrimitivesList
 // clear the basic shapes list and associated data
 void D_PAD::DeletePrimitivesList()
 {
-    m_basicShapes.clear();
-    m_customShapeAsPolygon.RemoveAllContours();
+    m_basicShapes.Set( std::vector<PAD_CS_PRIMITIVE>() );
+    m_customShapeAsPolygon.Set( SHAPE_POLY_SET() );
 }
 
 
@@ -253,10 +251,8 @@ bool D_PAD::buildCustomPadPolygon( SHAPE_POLY_SET* aMergedPolygon, int aError )
 {
     SHAPE_POLY_SET aux_polyset;
 
-    for( unsigned cnt = 0; cnt < m_basicShapes.size(); ++cnt )
+    for( const PAD_CS_PRIMITIVE& bshape : *m_basicShapes )
     {
-        const PAD_CS_PRIMITIVE& bshape = m_basicShapes[cnt];
-
         switch( bshape.m_Shape )
         {
         case S_CURVE:
@@ -360,7 +356,11 @@ bool D_PAD::MergePrimitivesAsPolygon( SHAPE_POLY_SET* aMergedPolygon )
     // if aMergedPolygon == NULL, use m_customShapeAsPolygon as target
 
     if( !aMergedPolygon )
-        aMergedPolygon = &m_customShapeAsPolygon;
+    {
+        // Rebuilt from scratch: do not copy the polygon shared with other copies of the pad
+        m_customShapeAsPolygon.Set( SHAPE_POLY_SET() );
+        aMergedPolygon = &m_customShapeAsPolygon.Write();
+    }
 
     aMergedPolygon->RemoveAllContours();
 
@@ -26,6 +26,7 @@
 #define BASE_EDIT_FRAME_H
 
 #include <pcb_base_frame.h>
+#include <undo_memory.h>
 
 class BOARD_ITEM_CONTAINER;
 class PCB_LAYER_WIDGET;
@@ -197,8 +198,18 @@ protected:
     /// Is undo/redo operation currently blocked?
     bool m_undoRedoBlocked;
 
+    /// Estimated memory of the undo list, see trimUndoList()
+    UNDO_MEMORY m_undoMemory;
+
     void unitsChangeRefresh() override;
 
+    /**
+     * Discards the oldest undo levels when the undo list uses more memory than allowed by
+     * ADVANCED_CFG::m_undoMemoryLimit.  The most recent level is always kept.
+     * @param aNewLevel = the level just pushed to the undo list
+     */
+    void trimUndoList( const PICKED_ITEMS_LIST* aNewLevel );
+
     /// Layer manager. It is the responsibility of the child frames to instantiate this
     PCB_LAYER_WIDGET* m_Layers;
 };
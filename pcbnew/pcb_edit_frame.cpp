@@ -177,6 +177,7 @@ PCB_EDIT_FRAME::PCB_EDIT_FRAME( KIWAY* aKiway, wxWindow* aParent ) :
     m_hasAutoSave = true;
     m_microWaveToolBar = NULL;
     m_Layers = nullptr;
+    m_saveIsAutoSave = false;
 
     // We don't know what state board was in when it was lasat saved, so we have to
     // assume dirty
@@ -331,6 +332,10 @@ PCB_EDIT_FRAME::PCB_EDIT_FRAME( KIWAY* aKiway, wxWindow* aParent ) :
 
 PCB_EDIT_FRAME::~PCB_EDIT_FRAME()
 {
+    // The save thread reports back to this frame
+    if( m_saveResult.valid() )
+        m_saveResult.wait();
+
     // Shutdown all running tools
     if( m_toolManager )
         m_toolManager->ShutdownAllTools();
@@ -530,13 +535,20 @@ void PCB_EDIT_FRAME::OnCloseWindow( wxCloseEvent& aEvent )
     if( open_dlg )
         open_dlg->Close( true );
 
+    // A failed save marks the board as modified again, so wait for it before asking
+    WaitForBackgroundSave();
+
     if( IsContentModified() )
     {
         wxFileName fileName = GetBoard()->GetFileName();
         wxString msg = _( "Save changes to \"%s\" before closing?" );
 
         if( !HandleUnsavedChanges( this, wxString::Format( msg, fileName.GetFullName() ),
-                                   [&]()->bool { return Files_io_from_id( ID_SAVE_BOARD ); } ) )
+                                   [&]()->bool
+                                   {
+                                       return Files_io_from_id( ID_SAVE_BOARD )
+                                              && WaitForBackgroundSave();
+                                   } ) )
         {
             aEvent.Veto();
             return;
@@ -23,6 +23,7 @@
 
 #include <unordered_map>
 #include <map>
+#include <future>
 #include "pcb_base_edit_frame.h"
 #include "config_params.h"
 #include "undo_redo_container.h"
@@ -133,6 +134,21 @@ protected:
 
     LAYER_TOOLBAR_ICON_VALUES m_prevIconVal;
 
+    /// The board save running on a worker thread, if any.  Holds the error message of the
+    /// save, empty on success.
+    std::future<wxString>   m_saveResult;
+    wxString                m_saveFileName;         ///< The file written by m_saveResult
+    wxString                m_saveBackupFileName;   ///< The backup made before the save, if any
+    bool                    m_saveIsAutoSave;
+
+    /**
+     * Report the result of the background save once it is complete, and restore the
+     * modified state of the board if it failed.
+     *
+     * @return false if the save failed.
+     */
+    bool finishBackgroundSave();
+
     // The Tool Framework initalization
     void setupTools();
 
@@ -633,15 +649,27 @@ public:
      * writes the board data structures to \a a aFileName
      * Creates backup when requested and update flags (modified and saved flgs)
      *
+     * The board is copied and the copy is written on a worker thread, so editing can go on
+     * during the save.  Errors are reported when the write completes.
+     *
      * @param aFileName The file name to write or wxEmptyString to prompt user for
      *                  file name.
      * @param aCreateBackupFile Creates a back of \a aFileName if true.  Helper
      *                          definitions #CREATE_BACKUP_FILE and #NO_BACKUP_FILE
      *                          are defined for improved code readability.
-     * @return True if file was saved successfully.
+     * @return True if the save was started.
      */
     bool SavePcbFile( const wxString& aFileName, bool aCreateBackupFile = CREATE_BACKUP_FILE );
 
+    /**
+     * Wait for the board save started by SavePcbFile(), if it is still running, and report
+     * its result.  SavePcbFile() only takes a snapshot of the board and writes it on a
+     * worker thread, so call this before the board is closed or replaced.
+     *
+     * @return false if the save failed.
+     */
+    bool WaitForBackgroundSave();
+
     /**
      * Function SavePcbCopy
      * writes the board data structures to \a a aFileName
@@ -494,6 +494,39 @@ bool PLOT_CONTROLLER::PlotLayer()
 }
 
 
+bool PLOT_CONTROLLER::PlotLayers( LSET aLayers, PLOT_FORMAT aFormat, const wxString& aSheetDesc )
+{
+    // Ensure that the previous plot is closed
+    ClosePlot();
+
+    GetPlotOptions().SetFormat( aFormat );
+
+    wxString outputDirName = GetPlotOptions().GetOutputDirectory() ;
+    wxFileName outputDir = wxFileName::DirName( outputDirName );
+    wxString boardFilename = m_board->GetFileName();
+
+    if( !EnsureFileDirectoryExists( &outputDir, boardFilename ) )
+        return false;
+
+    std::vector<PLOT_JOB> jobs;
+
+    for( LSEQ seq = aLayers.UIOrder(); seq; ++seq )
+    {
+        PCB_LAYER_ID layer = *seq;
+        wxFileName   fn = boardFilename;
+        wxString     fileExt = GetDefaultPlotExtension( aFormat );
+
+        if( aFormat == PLOT_FORMAT::GERBER && GetPlotOptions().GetUseGerberProtelExtensions() )
+            fileExt = GetGerberProtelExtension( layer );
+
+        BuildPlotFileName( &fn, outputDir.GetPath(), m_board->GetLayerName( layer ), fileExt );
+        jobs.emplace_back( layer, aFormat, fn.GetFullPath(), aSheetDesc );
+    }
+
+    return PlotBoardLayers( m_board, jobs, GetPlotOptions() ) == (int) jobs.size();
+}
+
+
 void PLOT_CONTROLLER::SetColorMode( bool aColorMode )
 {
     if( !m_plotter )
@@ -38,6 +38,8 @@
 #include <settings/settings_manager.h>
 #include <wx/filename.h>
 
+#include <vector>
+
 class PLOTTER;
 class TEXTE_PCB;
 class D_PAD;
@@ -50,6 +52,7 @@ class TEXTE_MODULE;
 class ZONE_CONTAINER;
 class BOARD;
 class REPORTER;
+class PROGRESS_REPORTER;
 
 
 // Define min and max reasonable values for plot/print scale
@@ -102,7 +105,7 @@ public:
 
     void PlotDimension( DIMENSION* Dimension );
     void PlotPcbTarget( PCB_TARGET* PtMire );
-    void PlotFilledAreas( ZONE_CONTAINER* aZone, SHAPE_POLY_SET& aPolysList );
+    void PlotFilledAreas( ZONE_CONTAINER* aZone, const SHAPE_POLY_SET& aPolysList );
     void PlotTextePcb( TEXTE_PCB* pt_texte );
     void PlotDrawSegment( DRAWSEGMENT* PtSegm );
 
@@ -168,6 +171,45 @@ PLOTTER* StartPlotBoard( BOARD* aBoard,
 void PlotOneBoardLayer( BOARD *aBoard, PLOTTER* aPlotter, PCB_LAYER_ID aLayer,
                         const PCB_PLOT_PARAMS& aPlotOpt );
 
+/**
+ * A job of a batch plot (see PlotBoardLayers()): a board layer plotted in its own file
+ */
+struct PLOT_JOB
+{
+    PLOT_JOB( PCB_LAYER_ID aLayer, PLOT_FORMAT aFormat, const wxString& aFullFileName,
+              const wxString& aSheetDesc = wxEmptyString ) :
+            m_Layer( aLayer ),
+            m_Format( aFormat ),
+            m_FullFileName( aFullFileName ),
+            m_SheetDesc( aSheetDesc ),
+            m_Success( false )
+    {
+    }
+
+    PCB_LAYER_ID m_Layer;
+    PLOT_FORMAT  m_Format;
+    wxString     m_FullFileName;
+    wxString     m_SheetDesc;
+    bool         m_Success;     ///< set by PlotBoardLayers(): true if the file was plotted
+};
+
+/**
+ * Function PlotBoardLayers
+ * plots a batch of layers, each one in its own file, with its own plotter.
+ * Once the zones are filled, layers are independent: the plot files are opened on the
+ * calling thread, then the layers are plotted concurrently.
+ * Solder mask layers having a min thickness temporarily change the board settings, so
+ * they are plotted afterwards, one at a time.
+ * @param aBoard = the board to plot
+ * @param aJobs = the jobs to run. m_Success is updated for each job
+ * @param aPlotOpt = the plot options, the format being the one of each job
+ * @param aProgressReporter = an optional progress reporter, advanced by one for each job
+ * @return the count of plotted files
+ */
+int PlotBoardLayers( BOARD* aBoard, std::vector<PLOT_JOB>& aJobs,
+                     const PCB_PLOT_PARAMS& aPlotOpt,
+                     PROGRESS_REPORTER* aProgressReporter = nullptr );
+
 /**
  * Function PlotStandardLayer
  * plot copper or technical layers.
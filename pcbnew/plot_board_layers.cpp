@@ -54,6 +54,15 @@
 #include <pcbplot.h>
 #include <pcb_painter.h>
 #include <gbr_metadata.h>
+#include <widgets/progress_reporter.h>
+#include <parallel_for.h>
+
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <map>
+#include <thread>
+#include <tuple>
 
 /*
  * Plot a solder mask layer.  Solder mask layers have a minimum thickness value and cannot be
@@ -201,6 +210,111 @@ void PlotOneBoardLayer( BOARD *aBoard, PLOTTER* aPlotter, PCB_LAYER_ID aLayer,
 }
 
 
+/*
+ * Build the groups of zones on aLayerMask to plot together: zones on the same layer, having
+ * the same net and compatible fill settings, whose filled areas overlap or touch.
+ * Zones are bucketed by layer, net and fill settings, then each bucket is split in clusters
+ * of zones connected by their filled area bounding boxes.
+ * Groups are given in board order (the order of their first zone in aBoard->Zones()).
+ */
+static std::vector<std::vector<ZONE_CONTAINER*>> buildZonePlotGroups( BOARD* aBoard,
+                                                                      LSET aLayerMask )
+{
+    // Merging zones can be done only for areas having compatible settings for drawings:
+    // use or not outline thickness, and if using outline thickness, having the same
+    // thickness, because after merging only one outline thickness is used
+    typedef std::tuple<int, int, bool, int> ZONE_KEY;   // layer, net, use thickness, thickness
+
+    std::map<ZONE_KEY, std::vector<size_t>> buckets;
+    const std::vector<ZONE_CONTAINER*>&     zones = aBoard->Zones();
+
+    for( size_t ii = 0; ii < zones.size(); ++ii )
+    {
+        ZONE_CONTAINER* zone = zones[ii];
+
+        if( !aLayerMask[ zone->GetLayer() ] || zone->GetFilledPolysList().IsEmpty() )
+            continue;
+
+        bool useThickness = zone->GetFilledPolysUseThickness();
+        ZONE_KEY key( zone->GetLayer(), zone->GetNetCode(), useThickness,
+                      useThickness ? zone->GetMinThickness() : 0 );
+
+        buckets[ key ].push_back( ii );
+    }
+
+    // Groups, keyed by the index of their first zone
+    std::map<size_t, std::vector<ZONE_CONTAINER*>> groups;
+
+    for( const std::pair<const ZONE_KEY, std::vector<size_t>>& bucket : buckets )
+    {
+        const std::vector<size_t>& members = bucket.second;
+        size_t                     count = members.size();
+        std::vector<BOX2I>         bboxes( count );
+        std::vector<size_t>        root( count );
+        std::vector<size_t>        order( count );
+
+        for( size_t ii = 0; ii < count; ++ii )
+        {
+            ZONE_CONTAINER* zone = zones[ members[ii] ];
+
+            bboxes[ii] = zone->GetFilledPolysList().BBox();
+
+            // Filled areas are plotted with their outline thickness
+            if( zone->GetFilledPolysUseThickness() )
+                bboxes[ii].Inflate( zone->GetMinThickness() / 2 );
+
+            root[ii] = ii;
+            order[ii] = ii;
+        }
+
+        auto findRoot = [&]( size_t aIdx ) -> size_t
+        {
+            while( root[aIdx] != aIdx )
+                aIdx = root[aIdx] = root[ root[aIdx] ];
+
+            return aIdx;
+        };
+
+        // Sweep the bounding boxes along the X axis to find the overlapping or touching ones
+        std::sort( order.begin(), order.end(),
+                   [&]( size_t a, size_t b )
+                   {
+                       return bboxes[a].GetX() < bboxes[b].GetX();
+                   } );
+
+        for( size_t ii = 0; ii < count; ++ii )
+        {
+            const BOX2I& bbox = bboxes[ order[ii] ];
+
+            for( size_t jj = ii + 1; jj < count && bboxes[ order[jj] ].GetX() <= bbox.GetRight();
+                 ++jj )
+            {
+                if( !bbox.Intersects( bboxes[ order[jj] ] ) )
+                    continue;
+
+                size_t a = findRoot( order[ii] );
+                size_t b = findRoot( order[jj] );
+
+                // Keep the first zone (in board order) as root of its cluster
+                if( a != b )
+                    root[ std::max( a, b ) ] = std::min( a, b );
+            }
+        }
+
+        for( size_t ii = 0; ii < count; ++ii )
+            groups[ members[ findRoot( ii ) ] ].push_back( zones[ members[ii] ] );
+    }
+
+    std::vector<std::vector<ZONE_CONTAINER*>> result;
+    result.reserve( groups.size() );
+
+    for( std::pair<const size_t, std::vector<ZONE_CONTAINER*>>& group : groups )
+        result.push_back( std::move( group.second ) );
+
+    return result;
+}
+
+
 /* Plot a copper layer or mask.
  * Silk screen layers are not plotted here.
  */
@@ -265,10 +379,9 @@ void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter,
             extraSize.x += width_adj;
             extraSize.y += width_adj;
 
-            // Store these parameters that can be modified to plot inflated/deflated pads shape
-            wxSize deltaSize = pad->GetDelta(); // has meaning only for trapezoidal pads
-            PAD_SHAPE_T padShape = pad->GetShape();
-            double padCornerRadius = pad->GetRoundRectCornerRadius();
+            // Pads can be plotted by several plot jobs at once (see PlotBoardLayers()), so
+            // they must not be modified: inflated/deflated pads shapes are plotted from a copy
+            D_PAD dummy( *pad );
 
             if( pad->GetShape() == PAD_SHAPE_TRAPEZOID )
             {   // The easy way is to use BuildPadPolygon to calculate
@@ -301,7 +414,7 @@ void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter,
                 else
                     delta.y = coord[1].x - coord[0].x;
 
-                pad->SetDelta( delta );
+                dummy.SetDelta( delta );
             }
             else
                 padPlotsSize = pad->GetSize() + extraSize;
@@ -323,45 +436,42 @@ void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter,
             else if( sketchPads && aLayerMask[B_Fab] )
                 color = aPlotOpt.ColorSettings()->GetColor( B_Fab );
 
-            // Temporary set the pad size to the required plot size:
-            wxSize tmppadsize = pad->GetSize();
-
+            // Set the pad copy size to the required plot size:
             switch( pad->GetShape() )
             {
             case PAD_SHAPE_CIRCLE:
             case PAD_SHAPE_OVAL:
-                pad->SetSize( padPlotsSize );
+                dummy.SetSize( padPlotsSize );
 
                 if( aPlotOpt.GetSkipPlotNPTH_Pads() &&
                     ( aPlotOpt.GetDrillMarksType() == PCB_PLOT_PARAMS::NO_DRILL_SHAPE ) &&
-                    ( pad->GetSize() == pad->GetDrillSize() ) &&
-                    ( pad->GetAttribute() == PAD_ATTRIB_HOLE_NOT_PLATED ) )
+                    ( dummy.GetSize() == dummy.GetDrillSize() ) &&
+                    ( dummy.GetAttribute() == PAD_ATTRIB_HOLE_NOT_PLATED ) )
                     break;
 
-                itemplotter.PlotPad( pad, color, padPlotMode );
+                itemplotter.PlotPad( &dummy, color, padPlotMode );
                 break;
 
             case PAD_SHAPE_RECT:
                 if( margin.x > 0 )
                 {
-                    pad->SetShape( PAD_SHAPE_ROUNDRECT );
-                    pad->SetSize( padPlotsSize );
-                    pad->SetRoundRectCornerRadius( margin.x );
+                    dummy.SetShape( PAD_SHAPE_ROUNDRECT );
+                    dummy.SetSize( padPlotsSize );
+                    dummy.SetRoundRectCornerRadius( margin.x );
                 }
                 KI_FALLTHROUGH;
 
             case PAD_SHAPE_TRAPEZOID:
             case PAD_SHAPE_ROUNDRECT:
             case PAD_SHAPE_CHAMFERED_RECT:
-                pad->SetSize( padPlotsSize );
-                itemplotter.PlotPad( pad, color, padPlotMode );
+                dummy.SetSize( padPlotsSize );
+                itemplotter.PlotPad( &dummy, color, padPlotMode );
                 break;
 
             case PAD_SHAPE_CUSTOM:
             {
                 // inflate/deflate a custom shape is a bit complex.
-                // so build a similar pad shape, and inflate/deflate the polygonal shape
-                D_PAD dummy( *pad );
+                // so use the pad copy, and inflate/deflate the polygonal shape
                 SHAPE_POLY_SET shape;
                 pad->MergePrimitivesAsPolygon( &shape );
                 // Shape polygon can have holes so use InflateWithLinkedHoles(), not Inflate()
@@ -383,12 +493,6 @@ void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter,
             }
                 break;
             }
-
-            // Restore the pad parameters modified by the plot code
-            pad->SetSize( tmppadsize );
-            pad->SetDelta( deltaSize );
-            pad->SetShape( padShape );
-            pad->SetRoundRectCornerRadius( padCornerRadius );
         }
 
         aPlotter->EndBlock( NULL );
@@ -506,54 +610,35 @@ void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter,
 
     // Plot all zones of the same layer & net together so we don't end up with divots where
     // zones touch each other.
-    std::set<ZONE_CONTAINER*> plotted;
+    std::vector<std::vector<ZONE_CONTAINER*>> zoneGroups = buildZonePlotGroups( aBoard,
+                                                                                 aLayerMask );
+    std::vector<SHAPE_POLY_SET> aggregateAreas( zoneGroups.size() );
+    std::vector<size_t>         toFracture;
 
-    for( ZONE_CONTAINER* zone : aBoard->Zones() )
+    for( size_t ii = 0; ii < zoneGroups.size(); ++ii )
     {
-        if( !aLayerMask[ zone->GetLayer() ] || plotted.count( zone ) )
-            continue;
-
-        plotted.insert( zone );
-
-        SHAPE_POLY_SET aggregateArea = zone->GetFilledPolysList();
-        bool needFracture = false;  // If 2 or more filled areas are combined, resulting
-                                    // aggregateArea will be simplified and fractured
-                                    // (Long calculation time)
-
-        for( ZONE_CONTAINER* candidate : aBoard->Zones() )
-        {
-            if( !aLayerMask[ candidate->GetLayer() ] || plotted.count( candidate ) )
-                continue;
-
-            if( candidate->GetNetCode() != zone->GetNetCode() )
-                continue;
+        for( ZONE_CONTAINER* zone : zoneGroups[ii] )
+            aggregateAreas[ii].Append( zone->GetFilledPolysList() );
 
-            // Merging zones of the same net can be done only for areas
-            // having compatible settings for drawings:
-            // use or not outline thickness, and if using outline thickness,
-            // having the same thickness
-            // because after merging only one outline thickness is used
-            if( candidate->GetFilledPolysUseThickness() != zone->GetFilledPolysUseThickness() )
-                // Should not happens, because usually the same option is used for filling
-                continue;
+        // If 2 or more filled areas are combined, resulting aggregateArea will be simplified
+        // and fractured (Long calculation time)
+        if( zoneGroups[ii].size() > 1 )
+            toFracture.push_back( ii );
+    }
 
-            if( zone->GetFilledPolysUseThickness() &&
-                ( candidate->GetMinThickness() != zone->GetMinThickness() ) )
-                continue;
+    // Groups are independent: fracture them in parallel
+    ParallelFor( toFracture.size(),
+                 [&]( size_t aIdx )
+                 {
+                     SHAPE_POLY_SET& aggregateArea = aggregateAreas[ toFracture[aIdx] ];
 
-            plotted.insert( candidate );
-            aggregateArea.Append( candidate->GetFilledPolysList() );
-            needFracture = true;
-        }
+                     aggregateArea.Unfracture( SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
+                     aggregateArea.Fracture( SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
+                 } );
 
-        if( needFracture )
-        {
-            aggregateArea.Unfracture( SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
-            aggregateArea.Fracture( SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
-        }
+    for( size_t ii = 0; ii < zoneGroups.size(); ++ii )
+        itemplotter.PlotFilledAreas( zoneGroups[ii].front(), aggregateAreas[ii] );
 
-        itemplotter.PlotFilledAreas( zone, aggregateArea );
-    }
     aPlotter->EndBlock( NULL );
 
     // Adding drill marks, if required and if the plotter is able to plot them:
@@ -871,7 +956,7 @@ void PlotSolderMaskLayer( BOARD *aBoard, PLOTTER* aPlotter, LSET aLayerMask,
 
     // Merge all polygons: After deflating, not merged (not overlapping) polygons
     // will have the initial shape (with perhaps small changes due to deflating transform)
-    areas.Simplify( SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
+    areas.BatchedUnion( SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
     areas.Deflate( inflate, numSegs );
 
     // Restore initial settings:
@@ -1180,3 +1265,118 @@ PLOTTER* StartPlotBoard( BOARD *aBoard, PCB_PLOT_PARAMS *aPlotOpts, int aLayer,
     delete plotter;
     return NULL;
 }
+
+
+int PlotBoardLayers( BOARD* aBoard, std::vector<PLOT_JOB>& aJobs, const PCB_PLOT_PARAMS& aPlotOpt,
+                     PROGRESS_REPORTER* aProgressReporter )
+{
+    // The locale must be C/POSIX during plots.  Switching it is not thread safe, so it is
+    // switched here once for all jobs, before the worker threads are started.
+    LOCALE_IO toggle;
+
+    std::vector<PCB_PLOT_PARAMS> jobOpts( aJobs.size(), aPlotOpt );
+    std::vector<PLOTTER*>        plotters( aJobs.size(), nullptr );
+    std::vector<size_t>          parallelJobs;
+    std::vector<size_t>          serialJobs;
+    bool                         maskMinThickness =
+            aBoard->GetDesignSettings().m_SolderMaskMinWidth != 0;
+
+    // Opening a plot file also plots the frame reference, which uses the page layout data
+    // shared by all plotters: open all files from this thread.
+    for( size_t ii = 0; ii < aJobs.size(); ++ii )
+    {
+        PLOT_JOB& job = aJobs[ii];
+
+        jobOpts[ii].SetFormat( job.m_Format );
+        plotters[ii] = StartPlotBoard( aBoard, &jobOpts[ii], job.m_Layer, job.m_FullFileName,
+                                       job.m_SheetDesc );
+        job.m_Success = plotters[ii] != nullptr;
+
+        if( !plotters[ii] )
+            continue;
+
+        // PlotSolderMaskLayer() changes the board max error and the arc correction mode
+        if( maskMinThickness && ( job.m_Layer == F_Mask || job.m_Layer == B_Mask ) )
+            serialJobs.push_back( ii );
+        else
+            parallelJobs.push_back( ii );
+    }
+
+    if( aProgressReporter )
+        aProgressReporter->SetMaxProgress( parallelJobs.size() + serialJobs.size() );
+
+    auto plotJob = [&]( size_t aIdx )
+    {
+        PLOTTER* plotter = plotters[aIdx];
+
+        PlotOneBoardLayer( aBoard, plotter, aJobs[aIdx].m_Layer, jobOpts[aIdx] );
+        plotter->EndPlot();
+
+        delete plotter->RenderSettings();
+        delete plotter;
+    };
+
+    std::atomic<size_t> nextJob( 0 );
+    size_t              parallelThreadCount =
+            std::min<size_t>( std::thread::hardware_concurrency(), parallelJobs.size() );
+    std::vector<std::future<size_t>> returns( parallelThreadCount );
+
+    auto plot_lambda = [&]( PROGRESS_REPORTER* aReporter ) -> size_t
+    {
+        size_t num = 0;
+
+        for( size_t i = nextJob++; i < parallelJobs.size(); i = nextJob++ )
+        {
+            plotJob( parallelJobs[i] );
+
+            if( aReporter )
+                aReporter->AdvanceProgress();
+
+            num++;
+        }
+
+        return num;
+    };
+
+    if( parallelThreadCount <= 1 )
+        plot_lambda( aProgressReporter );
+    else
+    {
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+        {
+            returns[ii] = std::async( std::launch::async,
+                                      [&]()
+                                      {
+                                          // Loops inside the plot of a layer stay serial
+                                          PARALLEL_WORKER_SCOPE workerScope;
+                                          return plot_lambda( aProgressReporter );
+                                      } );
+        }
+
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+        {
+            // Here we balance returns with a 100ms timeout to allow UI updating
+            std::future_status status;
+            do
+            {
+                if( aProgressReporter )
+                    aProgressReporter->KeepRefreshing();
+
+                status = returns[ii].wait_for( std::chrono::milliseconds( 100 ) );
+            } while( status != std::future_status::ready );
+        }
+    }
+
+    for( size_t idx : serialJobs )
+    {
+        plotJob( idx );
+
+        if( aProgressReporter )
+        {
+            aProgressReporter->AdvanceProgress();
+            aProgressReporter->KeepRefreshing();
+        }
+    }
+
+    return parallelJobs.size() + serialJobs.size();
+}
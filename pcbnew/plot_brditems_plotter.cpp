@@ -597,7 +597,7 @@ void BRDITEMS_PLOTTER::PlotFootprintGraphicItem( EDGE_MODULE* aEdge )
 
                 for( int jj = 0; jj < tmpPoly.OutlineCount(); ++jj )
                 {
-                    SHAPE_LINE_CHAIN &poly = tmpPoly.Outline( jj );
+                    const SHAPE_LINE_CHAIN& poly = tmpPoly.COutline( jj );
                     m_plotter->PlotPoly( poly, FILLED_SHAPE, thickness, &gbr_metadata );
                 }
             }
@@ -678,7 +678,7 @@ void BRDITEMS_PLOTTER::PlotTextePcb( TEXTE_PCB* pt_texte )
 }
 
 
-void BRDITEMS_PLOTTER::PlotFilledAreas( ZONE_CONTAINER* aZone, SHAPE_POLY_SET& polysList )
+void BRDITEMS_PLOTTER::PlotFilledAreas( ZONE_CONTAINER* aZone, const SHAPE_POLY_SET& polysList )
 {
     if( polysList.IsEmpty() )
         return;
@@ -719,7 +719,7 @@ void BRDITEMS_PLOTTER::PlotFilledAreas( ZONE_CONTAINER* aZone, SHAPE_POLY_SET& p
 
     for( int idx = 0; idx < polysList.OutlineCount(); ++idx )
     {
-        SHAPE_LINE_CHAIN& outline = polysList.Outline( idx );
+        const SHAPE_LINE_CHAIN& outline = polysList.COutline( idx );
 
         cornerList.clear();
         cornerList.reserve( outline.PointCount() );
@@ -834,7 +834,7 @@ void BRDITEMS_PLOTTER::PlotDrawSegment( DRAWSEGMENT* aSeg )
 
                 for( int jj = 0; jj < tmpPoly.OutlineCount(); ++jj )
                 {
-                    SHAPE_LINE_CHAIN& poly = tmpPoly.Outline( jj );
+                    const SHAPE_LINE_CHAIN& poly = tmpPoly.COutline( jj );
                     m_plotter->PlotPoly( poly, FILLED_SHAPE, thickness, &gbr_metadata );
                 }
             }
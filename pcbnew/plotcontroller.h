@@ -83,6 +83,16 @@ public:
      */
     bool PlotLayer();
 
+    /** Plot a set of layers, each one in its own plotfile, named from the board
+     * filename and the layer name. The layers are plotted concurrently.
+     * The current plot, if any, is closed first.
+     * @param aLayers is the set of layers to plot
+     * @param aFormat is the plot file format identifier
+     * @param aSheetDesc
+     * @return true if all the plotfiles were created
+     */
+    bool PlotLayers( LSET aLayers, PLOT_FORMAT aFormat, const wxString& aSheetDesc );
+
     /**
      * @return the current plot full filename, set by OpenPlotfile
      */
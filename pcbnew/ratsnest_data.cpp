@@ -33,6 +33,7 @@
 #endif
 
 #include <ratsnest_data.h>
+#include <trace_span.h>
 #include <functional>
 using namespace std::placeholders;
 
@@ -383,6 +384,8 @@ void RN_NET::compute()
 
 void RN_NET::Update()
 {
+    TRACE_SPAN span( "RN_NET::Update", "ratsnest" );
+
     compute();
 
     m_dirty = false;
@@ -41,6 +41,8 @@
 #include <geometry/shape_circle.h>
 #include <geometry/convex_hull.h>
 
+#include <trace_span.h>
+
 #include "pns_node.h"
 #include "pns_line_placer.h"
 #include "pns_line.h"
@@ -136,6 +138,8 @@ bool ROUTER::StartDragging( const VECTOR2I& aP, ITEM* aItem, int aDragMode )
 
 bool ROUTER::StartDragging( const VECTOR2I& aP, ITEM_SET aStartItems, int aDragMode )
 {
+    TRACE_SPAN span( "PNS::ROUTER::StartDragging", "router" );
+
     if( aStartItems.Empty() )
         return false;
 
@@ -189,7 +193,8 @@ bool ROUTER::isStartingPointRoutable( const VECTOR2I& aWhere, int aLayer )
 }
 
 bool ROUTER::StartRouting( const VECTOR2I& aP, ITEM* aStartItem, int aLayer )
-{   
+{
+    TRACE_SPAN span( "PNS::ROUTER::StartRouting", "router" );
 
     if( ! isStartingPointRoutable( aP, aLayer ) )
     {
@@ -245,6 +250,8 @@ void ROUTER::DisplayItems( const ITEM_SET& aItems )
 
 void ROUTER::Move( const VECTOR2I& aP, ITEM* endItem )
 {
+    TRACE_SPAN span( "PNS::ROUTER::Move", "router" );
+
     m_currentEnd = aP;
 
     switch( m_state )
@@ -390,6 +397,8 @@ void ROUTER::CommitRouting( NODE* aNode )
 
 bool ROUTER::FixRoute( const VECTOR2I& aP, ITEM* aEndItem, bool aForceFinish )
 {
+    TRACE_SPAN span( "PNS::ROUTER::FixRoute", "router" );
+
     bool rv = false;
 
     switch( m_state )
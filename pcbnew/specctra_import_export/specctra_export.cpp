@@ -489,7 +489,7 @@ PADSTACK* SPECCTRA_DB::makePADSTACK( BOARD* aBoard, D_PAD* aPad )
                                          aPad->GetChamferRectRatio(),
                                          doChamfer ? aPad->GetChamferPositions() : 0,
                                          aBoard->GetDesignSettings().m_MaxError );
-            SHAPE_LINE_CHAIN& polygonal_shape = cornerBuffer.Outline( 0 );
+            const SHAPE_LINE_CHAIN& polygonal_shape = cornerBuffer.COutline( 0 );
 
             for( int ndx=0; ndx < reportedLayers; ++ndx )
             {
@@ -841,7 +841,7 @@ void SPECCTRA_DB::fillBOUNDARY( BOARD* aBoard, BOUNDARY* boundary )
         boundary->paths.push_back( path );
         path->layer_id = "pcb";
 
-        SHAPE_LINE_CHAIN& outline = outlines.Outline( cnt );
+        const SHAPE_LINE_CHAIN& outline = outlines.COutline( cnt );
 
         for( int ii = 0; ii < outline.PointCount(); ii++ )
         {
@@ -864,7 +864,7 @@ void SPECCTRA_DB::fillBOUNDARY( BOARD* aBoard, BOUNDARY* boundary )
             poly_ko->SetLayerId( "signal" );
             pcb->structure->keepouts.push_back( keepout );
 
-            SHAPE_LINE_CHAIN& hole = outlines.Hole( cnt, ii );
+            const SHAPE_LINE_CHAIN& hole = outlines.CHole( cnt, ii );
 
             for( int jj = 0; jj < hole.PointCount(); jj++ )
             {
@@ -40,6 +40,12 @@ file near the top; only class BOARD functions go in board.i.
 
 */
 HANDLE_EXCEPTIONS(BOARD::TracksInNetBetweenPoints)
+HANDLE_EXCEPTIONS(ImportTrackArray)
+HANDLE_EXCEPTIONS(ImportViaArray)
+HANDLE_EXCEPTIONS(ImportPadArray)
+HANDLE_EXCEPTIONS(ImportZoneOutlineArray)
+
+%newobject BOARD::CreateSnapshot;
 
 
 %include board_item.i
@@ -121,6 +127,59 @@ HANDLE_EXCEPTIONS(BOARD::TracksInNetBetweenPoints)
     %}
 }
 
+// Bulk geometry arrays are handed to python as a bytearray (no per-item wrapping)
+// and read back from any C contiguous buffer of 32 bit integers, e.g. a memoryview
+// or a numpy int32 array.
+%typemap(out) BULK_ARRAY
+{
+    $result = PyByteArray_FromStringAndSize( reinterpret_cast<const char*>( $1.data() ),
+                                             $1.size() * sizeof( int32_t ) );
+}
+
+%typemap(in) ( const int32_t* aData, size_t aCount ) ( Py_buffer view, bool hasView = false )
+{
+    if( PyObject_GetBuffer( $input, &view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT ) < 0 )
+        SWIG_fail;
+
+    hasView = true;
+
+    if( ( view.itemsize != sizeof( int32_t ) && view.itemsize != 1 )
+            || view.len % sizeof( int32_t ) != 0 )
+    {
+        SWIG_exception_fail( SWIG_TypeError, "expected a buffer of 32 bit integers" );
+    }
+
+    $1 = static_cast<const int32_t*>( view.buf );
+    $2 = view.len / sizeof( int32_t );
+}
+
+%typemap(freearg) ( const int32_t* aData, size_t aCount )
+{
+    if( hasView$argnum )
+        PyBuffer_Release( &view$argnum );
+}
+
+%apply ( const int32_t* aData, size_t aCount ) { ( const int32_t* aPoints, size_t aPointCount ) };
+
+%include pcbnew_bulk_geometry.h
+%{
+#include <pcbnew_bulk_geometry.h>
+%}
+
+%pythoncode
+%{
+def _BulkArrayRows(data, fields):
+    """
+    View a bytearray returned by one of the Export*Array functions as rows of fields
+    """
+    rows = len(data) // (4 * fields)
+
+    try:
+        return memoryview(data).cast('i', [rows, fields]) if rows else memoryview(data).cast('i')
+    except AttributeError:      # Python 2 has no memoryview.cast()
+        return data
+%}
+
 %extend BOARD
 {
     // BOARD_ITEM_CONTAINER's interface functions will be implemented by SWIG
@@ -179,5 +238,40 @@ HANDLE_EXCEPTIONS(BOARD::TracksInNetBetweenPoints)
         netclassmap = {k:v for k,v in self.GetNetClasses().NetClasses().items()}
         netclassmap['Default'] = self.GetNetClasses().GetDefault()
         return netclassmap
+
+    def GetTrackArray(self):
+        """
+        Return the straight track segments as a (count, BULK_TRACK_FIELD_COUNT) int32 memoryview
+        """
+        return _BulkArrayRows(ExportTrackArray(self), BULK_TRACK_FIELD_COUNT)
+
+    def SetTrackArray(self, data):
+        """
+        Write back an array laid out like GetTrackArray(); return the number of changed items
+        """
+        return ImportTrackArray(self, data)
+
+    def GetViaArray(self):
+        return _BulkArrayRows(ExportViaArray(self), BULK_VIA_FIELD_COUNT)
+
+    def SetViaArray(self, data):
+        return ImportViaArray(self, data)
+
+    def GetPadArray(self):
+        return _BulkArrayRows(ExportPadArray(self), BULK_PAD_FIELD_COUNT)
+
+    def SetPadArray(self, data):
+        return ImportPadArray(self, data)
+
+    def GetZoneOutlineArrays(self):
+        """
+        Return ( contours, points ): one row of BULK_ZONE_FIELD_COUNT per zone contour
+        and one ( x, y ) row per contour vertex
+        """
+        return ( _BulkArrayRows(ExportZoneContourArray(self), BULK_ZONE_FIELD_COUNT),
+                 _BulkArrayRows(ExportZonePointArray(self), 2) )
+
+    def SetZoneOutlineArrays(self, contours, points):
+        return ImportZoneOutlineArray(self, contours, points)
     %}
 }
@@ -355,6 +355,7 @@ void PCB_EDIT_FRAME::RunActionPlugin( ACTION_PLUGIN* aActionPlugin )
     {
         OnModify();
         GetScreen()->PushCommandToUndoList( oldBuffer );
+        trimUndoList( oldBuffer );
     }
     else
     {
@@ -0,0 +1,464 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <map>
+#include <memory>
+#include <stdexcept>
+
+#include <board_commit.h>
+#include <class_board.h>
+#include <class_module.h>
+#include <class_pad.h>
+#include <class_track.h>
+#include <class_zone.h>
+#include <pcbnew_scripting_helpers.h>
+
+#include "pcbnew_bulk_geometry.h"
+
+
+namespace
+{
+
+/**
+ * Groups the modifications done by one import.  Items are staged in a BOARD_COMMIT when
+ * the board is the one shown in the editor; otherwise they are modified in place.
+ */
+class BULK_EDIT
+{
+public:
+    BULK_EDIT( BOARD* aBoard ) :
+            m_board( aBoard ),
+            m_count( 0 )
+    {
+        PCB_EDIT_FRAME* frame = ScriptingGetPcbEditFrame();
+
+        // Action plugins are wrapped in their own undo step by the plugin runner
+        if( frame && frame->GetBoard() == aBoard && !IsActionRunning() )
+            m_commit = std::make_unique<BOARD_COMMIT>( frame );
+    }
+
+    /// Must be called before the item is changed.
+    void Modify( BOARD_ITEM* aItem )
+    {
+        if( m_commit )
+            m_commit->Modify( aItem );
+
+        m_count++;
+    }
+
+    int Finish( const wxString& aMessage )
+    {
+        if( m_count == 0 )
+            return 0;
+
+        if( m_commit )
+            m_commit->Push( aMessage );
+        else
+            m_board->BuildConnectivity();
+
+        return m_count;
+    }
+
+private:
+    BOARD*                        m_board;
+    std::unique_ptr<BOARD_COMMIT> m_commit;
+    int                           m_count;
+};
+
+
+void checkArraySize( size_t aCount, size_t aItemCount, int aFieldCount, const char* aWhat )
+{
+    if( aCount != aItemCount * aFieldCount )
+    {
+        throw std::invalid_argument( std::string( aWhat ) + " array has "
+                                     + std::to_string( aCount ) + " values, expected "
+                                     + std::to_string( aItemCount ) + " rows of "
+                                     + std::to_string( aFieldCount ) );
+    }
+}
+
+
+std::vector<TRACK*> collectTracks( BOARD* aBoard, KICAD_T aType )
+{
+    std::vector<TRACK*> tracks;
+
+    for( TRACK* track : aBoard->Tracks() )
+    {
+        if( track->Type() == aType )
+            tracks.push_back( track );
+    }
+
+    return tracks;
+}
+
+
+std::vector<D_PAD*> collectPads( BOARD* aBoard )
+{
+    std::vector<D_PAD*> pads;
+
+    for( MODULE* module : aBoard->Modules() )
+    {
+        for( D_PAD* pad : module->Pads() )
+            pads.push_back( pad );
+    }
+
+    return pads;
+}
+
+
+uint64_t layerMask( const LSET& aLayers )
+{
+    uint64_t mask = 0;
+
+    for( PCB_LAYER_ID layer : aLayers.Seq() )
+        mask |= uint64_t( 1 ) << layer;
+
+    return mask;
+}
+
+
+LSET layerSet( uint32_t aLow, uint32_t aHigh )
+{
+    uint64_t mask = ( uint64_t( aHigh ) << 32 ) | aLow;
+    LSET     layers;
+
+    for( int layer = 0; layer < PCB_LAYER_ID_COUNT; layer++ )
+    {
+        if( ( mask >> layer ) & 1 )
+            layers.set( layer );
+    }
+
+    return layers;
+}
+
+} // namespace
+
+
+BULK_ARRAY ExportTrackArray( BOARD* aBoard )
+{
+    std::vector<TRACK*> tracks = collectTracks( aBoard, PCB_TRACE_T );
+    BULK_ARRAY          data;
+
+    data.reserve( tracks.size() * BULK_TRACK_FIELD_COUNT );
+
+    for( TRACK* track : tracks )
+    {
+        data.push_back( track->GetStart().x );
+        data.push_back( track->GetStart().y );
+        data.push_back( track->GetEnd().x );
+        data.push_back( track->GetEnd().y );
+        data.push_back( track->GetWidth() );
+        data.push_back( track->GetLayer() );
+        data.push_back( track->GetNetCode() );
+    }
+
+    return data;
+}
+
+
+int ImportTrackArray( BOARD* aBoard, const int32_t* aData, size_t aCount )
+{
+    std::vector<TRACK*> tracks = collectTracks( aBoard, PCB_TRACE_T );
+    BULK_EDIT           edit( aBoard );
+
+    checkArraySize( aCount, tracks.size(), BULK_TRACK_FIELD_COUNT, "Track" );
+
+    for( TRACK* track : tracks )
+    {
+        const int32_t* row = aData;
+        wxPoint        start( row[BULK_TRACK_START_X], row[BULK_TRACK_START_Y] );
+        wxPoint        end( row[BULK_TRACK_END_X], row[BULK_TRACK_END_Y] );
+        PCB_LAYER_ID   layer = ToLAYER_ID( row[BULK_TRACK_LAYER] );
+
+        aData += BULK_TRACK_FIELD_COUNT;
+
+        if( track->GetStart() == start && track->GetEnd() == end
+                && track->GetWidth() == row[BULK_TRACK_WIDTH] && track->GetLayer() == layer
+                && track->GetNetCode() == row[BULK_TRACK_NETCODE] )
+        {
+            continue;
+        }
+
+        edit.Modify( track );
+        track->SetStart( start );
+        track->SetEnd( end );
+        track->SetWidth( row[BULK_TRACK_WIDTH] );
+        track->SetLayer( layer );
+        track->SetNetCode( row[BULK_TRACK_NETCODE] );
+    }
+
+    return edit.Finish( _( "Edit Tracks" ) );
+}
+
+
+BULK_ARRAY ExportViaArray( BOARD* aBoard )
+{
+    std::vector<TRACK*> vias = collectTracks( aBoard, PCB_VIA_T );
+    BULK_ARRAY          data;
+
+    data.reserve( vias.size() * BULK_VIA_FIELD_COUNT );
+
+    for( TRACK* track : vias )
+    {
+        VIA*         via = static_cast<VIA*>( track );
+        PCB_LAYER_ID top, bottom;
+
+        via->LayerPair( &top, &bottom );
+
+        data.push_back( via->GetPosition().x );
+        data.push_back( via->GetPosition().y );
+        data.push_back( via->GetWidth() );
+        data.push_back( via->GetDrillValue() );
+        data.push_back( top );
+        data.push_back( bottom );
+        data.push_back( static_cast<int32_t>( via->GetViaType() ) );
+        data.push_back( via->GetNetCode() );
+    }
+
+    return data;
+}
+
+
+int ImportViaArray( BOARD* aBoard, const int32_t* aData, size_t aCount )
+{
+    std::vector<TRACK*> vias = collectTracks( aBoard, PCB_VIA_T );
+    BULK_EDIT           edit( aBoard );
+
+    checkArraySize( aCount, vias.size(), BULK_VIA_FIELD_COUNT, "Via" );
+
+    for( TRACK* track : vias )
+    {
+        VIA*           via = static_cast<VIA*>( track );
+        const int32_t* row = aData;
+        wxPoint        pos( row[BULK_VIA_X], row[BULK_VIA_Y] );
+        PCB_LAYER_ID   top = ToLAYER_ID( row[BULK_VIA_TOP_LAYER] );
+        PCB_LAYER_ID   bottom = ToLAYER_ID( row[BULK_VIA_BOTTOM_LAYER] );
+        VIATYPE        viaType = static_cast<VIATYPE>( row[BULK_VIA_TYPE] );
+        PCB_LAYER_ID   curTop, curBottom;
+
+        aData += BULK_VIA_FIELD_COUNT;
+        via->LayerPair( &curTop, &curBottom );
+
+        if( via->GetPosition() == pos && via->GetWidth() == row[BULK_VIA_WIDTH]
+                && via->GetDrillValue() == row[BULK_VIA_DRILL] && curTop == top
+                && curBottom == bottom && via->GetViaType() == viaType
+                && via->GetNetCode() == row[BULK_VIA_NETCODE] )
+        {
+            continue;
+        }
+
+        edit.Modify( via );
+        via->SetPosition( pos );
+        via->SetWidth( row[BULK_VIA_WIDTH] );
+
+        // Keep the netclass default drill unless the value was actually changed
+        if( via->GetDrillValue() != row[BULK_VIA_DRILL] )
+            via->SetDrill( row[BULK_VIA_DRILL] );
+
+        via->SetViaType( viaType );
+        via->SetLayerPair( top, bottom );
+        via->SetNetCode( row[BULK_VIA_NETCODE] );
+    }
+
+    return edit.Finish( _( "Edit Vias" ) );
+}
+
+
+BULK_ARRAY ExportPadArray( BOARD* aBoard )
+{
+    std::vector<D_PAD*> pads = collectPads( aBoard );
+    BULK_ARRAY          data;
+
+    data.reserve( pads.size() * BULK_PAD_FIELD_COUNT );
+
+    for( D_PAD* pad : pads )
+    {
+        uint64_t layers = layerMask( pad->GetLayerSet() );
+
+        data.push_back( pad->GetPosition().x );
+        data.push_back( pad->GetPosition().y );
+        data.push_back( pad->GetSize().x );
+        data.push_back( pad->GetSize().y );
+        data.push_back( KiROUND( pad->GetOrientation() ) );
+        data.push_back( pad->GetShape() );
+        data.push_back( static_cast<int32_t>( layers & 0xFFFFFFFF ) );
+        data.push_back( static_cast<int32_t>( layers >> 32 ) );
+        data.push_back( pad->GetNetCode() );
+    }
+
+    return data;
+}
+
+
+int ImportPadArray( BOARD* aBoard, const int32_t* aData, size_t aCount )
+{
+    std::vector<D_PAD*> pads = collectPads( aBoard );
+    BULK_EDIT           edit( aBoard );
+
+    checkArraySize( aCount, pads.size(), BULK_PAD_FIELD_COUNT, "Pad" );
+
+    for( D_PAD* pad : pads )
+    {
+        const int32_t* row = aData;
+        wxPoint        pos( row[BULK_PAD_X], row[BULK_PAD_Y] );
+        wxSize         size( row[BULK_PAD_SIZE_X], row[BULK_PAD_SIZE_Y] );
+        PAD_SHAPE_T    shape = static_cast<PAD_SHAPE_T>( row[BULK_PAD_SHAPE] );
+        LSET           layers = layerSet( row[BULK_PAD_LAYERS_LO], row[BULK_PAD_LAYERS_HI] );
+
+        aData += BULK_PAD_FIELD_COUNT;
+
+        if( pad->GetPosition() == pos && pad->GetSize() == size
+                && KiROUND( pad->GetOrientation() ) == row[BULK_PAD_ORIENTATION]
+                && pad->GetShape() == shape && pad->GetLayerSet() == layers
+                && pad->GetNetCode() == row[BULK_PAD_NETCODE] )
+        {
+            continue;
+        }
+
+        // Pads are staged through their parent footprint
+        edit.Modify( pad );
+        pad->SetPosition( pos );
+        pad->SetLocalCoord();
+        pad->SetSize( size );
+        pad->SetOrientation( row[BULK_PAD_ORIENTATION] );
+        pad->SetShape( shape );
+        pad->SetLayerSet( layers );
+        pad->SetNetCode( row[BULK_PAD_NETCODE] );
+    }
+
+    return edit.Finish( _( "Edit Pads" ) );
+}
+
+
+BULK_ARRAY ExportZoneContourArray( BOARD* aBoard )
+{
+    BULK_ARRAY data;
+    int        firstPoint = 0;
+
+    for( int zoneIdx = 0; zoneIdx < aBoard->GetAreaCount(); zoneIdx++ )
+    {
+        const SHAPE_POLY_SET* poly = aBoard->GetArea( zoneIdx )->Outline();
+
+        for( int outline = 0; outline < poly->OutlineCount(); outline++ )
+        {
+            for( int hole = -1; hole < poly->HoleCount( outline ); hole++ )
+            {
+                const SHAPE_LINE_CHAIN& chain = hole < 0 ? poly->COutline( outline )
+                                                         : poly->CHole( outline, hole );
+
+                data.push_back( zoneIdx );
+                data.push_back( outline );
+                data.push_back( hole );
+                data.push_back( firstPoint );
+                data.push_back( chain.PointCount() );
+
+                firstPoint += chain.PointCount();
+            }
+        }
+    }
+
+    return data;
+}
+
+
+BULK_ARRAY ExportZonePointArray( BOARD* aBoard )
+{
+    BULK_ARRAY data;
+
+    for( int zoneIdx = 0; zoneIdx < aBoard->GetAreaCount(); zoneIdx++ )
+    {
+        const SHAPE_POLY_SET* poly = aBoard->GetArea( zoneIdx )->Outline();
+
+        for( auto it = poly->CIterateWithHoles(); it; it++ )
+        {
+            data.push_back( it->x );
+            data.push_back( it->y );
+        }
+    }
+
+    return data;
+}
+
+
+int ImportZoneOutlineArray( BOARD* aBoard, const int32_t* aData, size_t aCount,
+                            const int32_t* aPoints, size_t aPointCount )
+{
+    if( aCount % BULK_ZONE_FIELD_COUNT != 0 || aPointCount % 2 != 0 )
+        throw std::invalid_argument( "Zone arrays must hold whole rows" );
+
+    size_t                        pointRows = aPointCount / 2;
+    std::map<int, SHAPE_POLY_SET> outlines;
+
+    for( size_t ii = 0; ii < aCount; ii += BULK_ZONE_FIELD_COUNT )
+    {
+        const int32_t* row = aData + ii;
+        int            zoneIdx = row[BULK_ZONE_INDEX];
+        int            outline = row[BULK_ZONE_OUTLINE];
+        int            first = row[BULK_ZONE_FIRST_POINT];
+        int            count = row[BULK_ZONE_POINT_COUNT];
+
+        if( zoneIdx < 0 || zoneIdx >= aBoard->GetAreaCount() )
+            throw std::invalid_argument( "Zone index out of range" );
+
+        if( first < 0 || count < 0 || size_t( first ) + count > pointRows )
+            throw std::invalid_argument( "Zone contour points out of range" );
+
+        SHAPE_POLY_SET& poly = outlines[zoneIdx];
+
+        if( row[BULK_ZONE_HOLE] < 0 )
+        {
+            if( outline != poly.OutlineCount() )
+                throw std::invalid_argument( "Zone outlines must be listed in order" );
+
+            poly.NewOutline();
+        }
+        else
+        {
+            if( outline >= poly.OutlineCount() )
+                throw std::invalid_argument( "Zone hole listed before its outline" );
+
+            poly.NewHole( outline );
+        }
+
+        SHAPE_LINE_CHAIN& chain = row[BULK_ZONE_HOLE] < 0
+                                          ? poly.Outline( outline )
+                                          : poly.Hole( outline, poly.HoleCount( outline ) - 1 );
+
+        for( int pt = first; pt < first + count; pt++ )
+            chain.Append( aPoints[2 * pt], aPoints[2 * pt + 1] );
+    }
+
+    BULK_EDIT edit( aBoard );
+
+    for( std::pair<const int, SHAPE_POLY_SET>& entry : outlines )
+    {
+        ZONE_CONTAINER* zone = aBoard->GetArea( entry.first );
+
+        edit.Modify( zone );
+        *zone->Outline() = entry.second;
+        zone->UnFill();
+        zone->Hatch();
+    }
+
+    return edit.Finish( _( "Edit Zone Outlines" ) );
+}
@@ -0,0 +1,131 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file pcbnew_bulk_geometry.h
+ * @brief Bulk export and import of board geometry as flat integer arrays
+ *
+ * Scripts that post-process thousands of items pay a heavy price for one SWIG
+ * round trip per getter.  These helpers copy the geometry of all tracks, vias, pads
+ * or zone outlines into a single row-major int32 array (one row per item, one column
+ * per BULK_*_FIELD) which Python sees through the buffer protocol.  The same layout
+ * can be written back: row N always refers to the Nth item of the matching export.
+ *
+ * All coordinates and sizes are in internal units; angles are in tenths of a degree.
+ */
+
+#ifndef PCBNEW_BULK_GEOMETRY_H
+#define PCBNEW_BULK_GEOMETRY_H
+
+#include <cstdint>
+#include <vector>
+
+class BOARD;
+
+typedef std::vector<int32_t> BULK_ARRAY;
+
+/// Columns of the track array.  Only straight segments (PCB_TRACE_T) are exported.
+enum BULK_TRACK_FIELD
+{
+    BULK_TRACK_START_X = 0,
+    BULK_TRACK_START_Y,
+    BULK_TRACK_END_X,
+    BULK_TRACK_END_Y,
+    BULK_TRACK_WIDTH,
+    BULK_TRACK_LAYER,
+    BULK_TRACK_NETCODE,
+    BULK_TRACK_FIELD_COUNT
+};
+
+/// Columns of the via array.  VIA_TYPE holds the VIATYPE enum value.
+enum BULK_VIA_FIELD
+{
+    BULK_VIA_X = 0,
+    BULK_VIA_Y,
+    BULK_VIA_WIDTH,
+    BULK_VIA_DRILL,
+    BULK_VIA_TOP_LAYER,
+    BULK_VIA_BOTTOM_LAYER,
+    BULK_VIA_TYPE,
+    BULK_VIA_NETCODE,
+    BULK_VIA_FIELD_COUNT
+};
+
+/// Columns of the pad array.  The layer set is split into two 32 bit masks.
+enum BULK_PAD_FIELD
+{
+    BULK_PAD_X = 0,
+    BULK_PAD_Y,
+    BULK_PAD_SIZE_X,
+    BULK_PAD_SIZE_Y,
+    BULK_PAD_ORIENTATION,
+    BULK_PAD_SHAPE,
+    BULK_PAD_LAYERS_LO,
+    BULK_PAD_LAYERS_HI,
+    BULK_PAD_NETCODE,
+    BULK_PAD_FIELD_COUNT
+};
+
+/**
+ * Columns of the zone contour array.  Each row describes one closed contour whose
+ * vertices are POINT_COUNT (x, y) pairs starting at row FIRST_POINT of the point array.
+ * HOLE is -1 for the main outline of a polygon, otherwise the hole index.
+ */
+enum BULK_ZONE_FIELD
+{
+    BULK_ZONE_INDEX = 0,
+    BULK_ZONE_OUTLINE,
+    BULK_ZONE_HOLE,
+    BULK_ZONE_FIRST_POINT,
+    BULK_ZONE_POINT_COUNT,
+    BULK_ZONE_FIELD_COUNT
+};
+
+BULK_ARRAY ExportTrackArray( BOARD* aBoard );
+BULK_ARRAY ExportViaArray( BOARD* aBoard );
+BULK_ARRAY ExportPadArray( BOARD* aBoard );
+BULK_ARRAY ExportZoneContourArray( BOARD* aBoard );
+BULK_ARRAY ExportZonePointArray( BOARD* aBoard );
+
+/**
+ * Write an array laid out like the matching export back to the board.
+ *
+ * Only rows that differ from the current item are applied.  When \a aBoard is the board
+ * open in the editor (and no action plugin is running, which records its own undo
+ * step) all changes are grouped in one BOARD_COMMIT, giving a single undo entry.
+ *
+ * @throw std::invalid_argument if the array size does not match the item count.
+ * @return the number of items that were modified.
+ */
+int ImportTrackArray( BOARD* aBoard, const int32_t* aData, size_t aCount );
+int ImportViaArray( BOARD* aBoard, const int32_t* aData, size_t aCount );
+int ImportPadArray( BOARD* aBoard, const int32_t* aData, size_t aCount );
+
+/**
+ * Replace the outlines of the zones referenced by the contour array.  Zones which do
+ * not appear in the array keep their outline.  Modified zones are left unfilled.
+ */
+int ImportZoneOutlineArray( BOARD* aBoard, const int32_t* aData, size_t aCount,
+                            const int32_t* aPoints, size_t aPointCount );
+
+#endif  // PCBNEW_BULK_GEOMETRY_H
@@ -38,8 +38,11 @@
 #include <kicad_string.h>
 #include <macros.h>
 #include <pcb_draw_panel_gal.h>
+#include <pcb_painter.h>
+#include <pcb_view.h>
 #include <pcbnew.h>
 #include <pcbnew_scripting_helpers.h>
+#include <settings/color_settings.h>
 
 static PCB_EDIT_FRAME* s_PcbEditFrame = NULL;
 
@@ -58,6 +61,12 @@ void ScriptingSetPcbEditFrame( PCB_EDIT_FRAME* aPcbEditFrame )
 }
 
 
+PCB_EDIT_FRAME* ScriptingGetPcbEditFrame()
+{
+    return s_PcbEditFrame;
+}
+
+
 BOARD* LoadBoard( wxString& aFileName )
 {
     if( aFileName.EndsWith( wxT( ".kicad_pcb" ) ) )
@@ -105,6 +114,59 @@ bool SaveBoard( wxString& aFileName, BOARD* aBoard )
 }
 
 
+bool SaveBoardImage( wxString& aFileName, BOARD* aBoard, int aWidth, int aHeight )
+{
+    if( !aBoard || aWidth <= 0 || aHeight <= 0 )
+        return false;
+
+    EDA_RECT bbox = aBoard->ComputeBoundingBox();
+
+    // Leave a small margin around the board
+    bbox.Inflate( std::max( bbox.GetWidth(), bbox.GetHeight() ) / 50 + 1 );
+
+    BOX2D    area( VECTOR2D( bbox.GetOrigin() ), VECTOR2D( bbox.GetSize() ) );
+    VECTOR2I size( aWidth, aHeight );
+
+    // The items of the frame board already belong to the view of its canvas
+    if( s_PcbEditFrame && s_PcbEditFrame->GetBoard() == aBoard )
+        return s_PcbEditFrame->GetCanvas()->GetView()->SaveSnapshot( area, size, aFileName );
+
+    KIGFX::PCB_VIEW    view( false );
+    KIGFX::PCB_PAINTER painter( nullptr );
+    COLOR_SETTINGS     colors;
+
+    // Not the user color theme, so the image only depends on the board
+    colors.ResetToDefaults();
+    painter.GetSettings()->LoadColors( &colors );
+    view.SetPainter( &painter );
+
+    std::vector<BOARD_ITEM*> items;
+
+    for( auto drawing : aBoard->Drawings() )
+        items.push_back( drawing );
+
+    for( auto track : aBoard->Tracks() )
+        items.push_back( track );
+
+    for( auto module : aBoard->Modules() )
+        items.push_back( module );
+
+    for( auto zone : aBoard->Zones() )
+        items.push_back( zone );
+
+    for( auto item : items )
+        view.Add( item );
+
+    bool ok = view.SaveSnapshot( area, size, aFileName );
+
+    // The items outlive the view
+    for( auto item : items )
+        view.Remove( item );
+
+    return ok;
+}
+
+
 bool ExportSpecctraDSN( wxString& aFullFilename )
 {
     if( s_PcbEditFrame )
@@ -35,6 +35,9 @@
 #ifndef SWIG
 void    ScriptingSetPcbEditFrame( PCB_EDIT_FRAME* aPCBEdaFrame );
 
+/// @return the editor frame registered for scripting, or NULL when running standalone.
+PCB_EDIT_FRAME* ScriptingGetPcbEditFrame();
+
 #endif
 
 // For Python scripts: return the current board.
@@ -49,6 +52,14 @@ BOARD*  LoadBoard( wxString& aFileName );
 // so no option to choose the file format.
 bool    SaveBoard( wxString& aFileName, BOARD* aBoard );
 
+/**
+ * Renders a board to a PNG image of the given size, without a window.
+ * The board of the pcbnew frame is drawn as shown in its canvas; any other board is drawn
+ * with the default colors and display options.
+ * @return true if the image was written
+ */
+bool    SaveBoardImage( wxString& aFileName, BOARD* aBoard, int aWidth, int aHeight );
+
 /**
  * will export the current BOARD to a specctra dsn file.
  * See http://www.autotraxeda.com/docs/SPECCTRA/SPECCTRA.pdf for the
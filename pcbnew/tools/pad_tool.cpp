@@ -323,7 +323,7 @@ int PAD_TOOL::EnumeratePads( const TOOL_EVENT& aEvent )
             for( int j = 0; j < segments; ++j )
             {
                 wxPoint testpoint( cursorPos.x - j * line_step.x, cursorPos.y - j * line_step.y );
-                collector.Collect( board(), types, testpoint, guide );
+                collector.Collect( board(), types, testpoint, guide, view() );
 
                 for( int i = 0; i < collector.GetCount(); ++i )
                     selectedPads.push_back( static_cast<D_PAD*>( collector[i] ) );
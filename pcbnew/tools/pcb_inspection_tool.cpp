@@ -147,10 +147,14 @@ int PCB_INSPECTION_TOOL::HighlightItem( const TOOL_EVENT& aEvent )
         GENERAL_COLLECTOR collector;
 
         // Find a connected item for which we are going to highlight a net
-        collector.Collect( board, GENERAL_COLLECTOR::PadsOrTracks, (wxPoint) aPosition, guide );
+        collector.Collect( board, GENERAL_COLLECTOR::PadsOrTracks, (wxPoint) aPosition, guide,
+                           getView() );
 
         if( collector.GetCount() == 0 )
-            collector.Collect( board, GENERAL_COLLECTOR::Zones, (wxPoint) aPosition, guide );
+        {
+            collector.Collect( board, GENERAL_COLLECTOR::Zones, (wxPoint) aPosition, guide,
+                               getView() );
+        }
 
         // Clear the previous highlight
         m_frame->SendMessageToEESCHEMA( nullptr );
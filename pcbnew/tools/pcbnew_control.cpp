@@ -577,10 +577,10 @@ int PCBNEW_CONTROL::DeleteItemCursor( const TOOL_EVENT& aEvent )
             GENERAL_COLLECTOR collector;
             collector.m_Threshold = KiROUND( getView()->ToWorld( HITTEST_THRESHOLD_PIXELS ) );
 
-            if( m_editModules )
-                collector.Collect( board, GENERAL_COLLECTOR::ModuleItems, (wxPoint) aPos, guide );
-            else
-                collector.Collect( board, GENERAL_COLLECTOR::BoardLevelItems, (wxPoint) aPos, guide );
+            const KICAD_T* types = m_editModules ? GENERAL_COLLECTOR::ModuleItems
+                                                 : GENERAL_COLLECTOR::BoardLevelItems;
+
+            collector.Collect( board, types, (wxPoint) aPos, guide, getView() );
 
             // Remove unselectable items
             for( int i = collector.GetCount() - 1; i >= 0; --i )
@@ -38,6 +38,83 @@
 #include <tools/pcb_actions.h>
 #include <tools/global_edit_tool.h>
 #include <tracks_cleaner.h>
+#include <parallel_for.h>
+
+#include <unordered_map>
+
+
+namespace
+{
+
+/**
+ * Run aTest( track ) on each track of aTracks, in parallel.  aTest must only read the
+ * board and its connectivity, and all the tracks must be in the connectivity.
+ *
+ * @return the results of aTest, in the order of aTracks.
+ */
+template <typename RESULT, typename TEST>
+std::vector<RESULT> testTracks( const std::vector<TRACK*>& aTracks, TEST aTest )
+{
+    std::vector<RESULT> results( aTracks.size() );
+
+    ParallelFor( aTracks.size(),
+                 [&]( size_t aIdx )
+                 {
+                     results[aIdx] = aTest( aTracks[aIdx] );
+                 },
+                 256 );
+
+    return results;
+}
+
+
+/// Identifies the segments having the same ends (in any order), width and layer
+struct SEGMENT_KEY
+{
+    SEGMENT_KEY( const TRACK* aTrack ) :
+            m_layer( aTrack->GetLayer() ),
+            m_width( aTrack->GetWidth() ),
+            m_a( aTrack->GetStart() ),
+            m_b( aTrack->GetEnd() )
+    {
+        if( m_b.x < m_a.x || ( m_b.x == m_a.x && m_b.y < m_a.y ) )
+            std::swap( m_a, m_b );
+    }
+
+    bool operator==( const SEGMENT_KEY& aOther ) const
+    {
+        return m_layer == aOther.m_layer && m_width == aOther.m_width && m_a == aOther.m_a
+               && m_b == aOther.m_b;
+    }
+
+    PCB_LAYER_ID m_layer;
+    int          m_width;
+    wxPoint      m_a;
+    wxPoint      m_b;
+};
+
+
+struct POINT_HASH
+{
+    size_t operator()( const wxPoint& aPoint ) const
+    {
+        return std::hash<int>()( aPoint.x ) * 31 + std::hash<int>()( aPoint.y );
+    }
+};
+
+
+struct SEGMENT_KEY_HASH
+{
+    size_t operator()( const SEGMENT_KEY& aKey ) const
+    {
+        POINT_HASH pointHash;
+
+        return ( ( pointHash( aKey.m_a ) * 31 + pointHash( aKey.m_b ) ) * 31 + aKey.m_width ) * 31
+               + aKey.m_layer;
+    }
+};
+
+} // namespace
 
 
 /* Install the cleanup dialog frame to know what should be cleaned
@@ -124,33 +201,38 @@ bool TRACKS_CLEANER::removeBadTrackSegments()
     auto connectivity = m_brd->GetConnectivity();
 
     std::set<BOARD_ITEM *> toRemove;
+    std::vector<TRACK*>    tracks( m_brd->Tracks().begin(), m_brd->Tracks().end() );
 
-    for( auto segment : m_brd->Tracks() )
-    {
-        segment->SetState( FLAG0, false );
-
-        for( auto testedPad : connectivity->GetConnectedPads( segment ) )
-        {
-            if( segment->GetNetCode() != testedPad->GetNetCode() )
+    // Count the items of another net connected to each segment
+    std::vector<int> shorts = testTracks<int>( tracks,
+            [&]( TRACK* aSegment )
             {
-                DRC_ITEM* item = new DRC_ITEM( DRCE_SHORT );
-                item->SetItems( segment );
-                m_itemsList->push_back( item );
+                int count = 0;
 
-                toRemove.insert( segment );
-            }
-        }
+                for( auto testedPad : connectivity->GetConnectedPads( aSegment ) )
+                {
+                    if( aSegment->GetNetCode() != testedPad->GetNetCode() )
+                        count++;
+                }
 
-        for( auto testedTrack : connectivity->GetConnectedTracks( segment ) )
+                for( auto testedTrack : connectivity->GetConnectedTracks( aSegment ) )
+                {
+                    if( aSegment->GetNetCode() != testedTrack->GetNetCode() )
+                        count++;
+                }
+
+                return count;
+            } );
+
+    for( size_t ii = 0; ii < tracks.size(); ii++ )
+    {
+        for( int jj = 0; jj < shorts[ii]; jj++ )
         {
-            if( segment->GetNetCode() != testedTrack->GetNetCode() && !testedTrack->GetState( FLAG0 ) )
-            {
-                DRC_ITEM* item = new DRC_ITEM( DRCE_SHORT );
-                item->SetItems( segment );
-                m_itemsList->push_back( item );
+            DRC_ITEM* item = new DRC_ITEM( DRCE_SHORT );
+            item->SetItems( tracks[ii] );
+            m_itemsList->push_back( item );
 
-                toRemove.insert( segment );
-            }
+            toRemove.insert( tracks[ii] );
         }
     }
 
@@ -161,50 +243,70 @@ bool TRACKS_CLEANER::removeBadTrackSegments()
 bool TRACKS_CLEANER::cleanupVias()
 {
     std::set<BOARD_ITEM*> toRemove;
-    std::vector<VIA*>     vias;
+    std::vector<TRACK*>   vias;
+
+    // Vias at the same location, in board order
+    std::unordered_map<wxPoint, std::vector<VIA*>, POINT_HASH> viasByPosition;
 
     for( auto track : m_brd->Tracks() )
     {
         if( auto via = dyn_cast<VIA*>( track ) )
+        {
+            if( !via->IsLocked() && via->GetStart() != via->GetEnd() )
+                via->SetEnd( via->GetStart() );
+
             vias.push_back( via );
+            viasByPosition[via->GetPosition()].push_back( via );
+        }
     }
 
-    for( auto via1_it = vias.begin(); via1_it != vias.end(); via1_it++ )
+    // To delete through Via on THT pads at same location
+    // Examine the list of connected pads:
+    // if a through pad is found, the via can be removed
+    auto connectivity = m_brd->GetConnectivity();
+
+    std::vector<D_PAD*> throughPads = testTracks<D_PAD*>( vias,
+            [&]( TRACK* aVia ) -> D_PAD*
+            {
+                const LSET all_cu = LSET::AllCuMask();
+
+                if( aVia->IsLocked() )
+                    return nullptr;
+
+                for( D_PAD* pad : connectivity->GetConnectedPads( aVia ) )
+                {
+                    if( ( pad->GetLayerSet() & all_cu ) == all_cu )
+                        return pad;
+                }
+
+                return nullptr;
+            } );
+
+    for( size_t ii = 0; ii < vias.size(); ii++ )
     {
-        auto via1 = *via1_it;
+        VIA* via1 = static_cast<VIA*>( vias[ii] );
 
         if( via1->IsLocked() )
             continue;
 
-        if( via1->GetStart() != via1->GetEnd() )
-            via1->SetEnd( via1->GetStart() );
-
-        // To delete through Via on THT pads at same location
-        // Examine the list of connected pads:
-        // if a through pad is found, the via can be removed
-
-        const auto pads = m_brd->GetConnectivity()->GetConnectedPads( via1 );
-        for( const auto pad : pads )
+        if( throughPads[ii] )
         {
-            const LSET all_cu = LSET::AllCuMask();
-
-            if( ( pad->GetLayerSet() & all_cu ) == all_cu )
-            {
-                DRC_ITEM* item = new DRC_ITEM( DRCE_REDUNDANT_VIA );
-                item->SetItems( via1, pad );
-                m_itemsList->push_back( item );
+            DRC_ITEM* item = new DRC_ITEM( DRCE_REDUNDANT_VIA );
+            item->SetItems( via1, throughPads[ii] );
+            m_itemsList->push_back( item );
 
-                // redundant: delete the via
-                toRemove.insert( via1 );
-                break;
-            }
+            // redundant: delete the via
+            toRemove.insert( via1 );
         }
 
-        for( auto via2_it = via1_it + 1; via2_it != vias.end(); via2_it++ )
+        std::vector<VIA*>& sameLocation = viasByPosition[via1->GetPosition()];
+        auto               via2_it = std::find( sameLocation.begin(), sameLocation.end(), via1 );
+
+        for( via2_it++; via2_it != sameLocation.end(); via2_it++ )
         {
-            auto via2 = *via2_it;
+            VIA* via2 = *via2_it;
 
-            if( via1->GetPosition() != via2->GetPosition() || via2->IsLocked() )
+            if( via2->IsLocked() )
                 continue;
 
             if( via1->GetViaType() == via2->GetViaType() )
@@ -226,17 +328,14 @@ bool TRACKS_CLEANER::cleanupVias()
 
 bool TRACKS_CLEANER::testTrackEndpointDangling( TRACK* aTrack )
 {
+    // Called from several threads at once: the caller checks aTrack is in the connectivity
     auto connectivity = m_brd->GetConnectivity();
-    auto items = connectivity->GetConnectivityAlgo()->ItemEntry( aTrack ).GetItems();
+    auto entry = connectivity->GetConnectivityAlgo()->FindItemEntry( aTrack );
 
-    // Not in the connectivity system.  This is a bug!
-    if( items.empty() )
-    {
-        wxASSERT( !items.empty() );
+    if( !entry || entry->m_items.empty() )
         return false;
-    }
 
-    auto citem = items.front();
+    auto citem = entry->m_items.front();
 
     if( !citem->Valid() )
         return false;
@@ -291,40 +390,64 @@ bool TRACKS_CLEANER::deleteDanglingTracks()
     bool item_erased = false;
     bool modified = false;
 
+    std::vector<TRACK*> candidates( m_brd->Tracks().begin(), m_brd->Tracks().end() );
+
     do // Iterate when at least one track is deleted
     {
         item_erased = false;
         // Ensure the connectivity is up to date, especially after removind a dangling segment
         m_brd->BuildConnectivity();
 
-        for( TRACK* track : m_brd->Tracks() )
+        for( TRACK* track : candidates )
         {
-            bool flag_erase = false; // Start without a good reason to erase it
+            // Not in the connectivity system.  This is a bug!
+            wxASSERT( m_brd->GetConnectivity()->GetConnectivityAlgo()->ItemExists( track ) );
+        }
+
+        // Tst if a track (or a via) endpoint is not connected to another track or to a zone.
+        std::vector<char> dangling = testTracks<char>( candidates,
+                [&]( TRACK* aTrack )
+                {
+                    return testTrackEndpointDangling( aTrack );
+                } );
 
-            // Tst if a track (or a via) endpoint is not connected to another track or to a zone.
-            if( testTrackEndpointDangling( track ) )
-                flag_erase = true;
+        // Only the tracks connected to a deleted track can become dangling
+        std::set<TRACK*> neighbours;
 
-            if( flag_erase )
+        for( size_t ii = 0; ii < candidates.size(); ii++ )
+        {
+            if( !dangling[ii] )
+                continue;
+
+            TRACK*    track = candidates[ii];
+            int       errorCode = track->IsTrack() ? DRCE_DANGLING_TRACK : DRCE_DANGLING_VIA;
+            DRC_ITEM* item = new DRC_ITEM( errorCode );
+            item->SetItems( track );
+            m_itemsList->push_back( item );
+
+            if( !m_dryRun )
             {
-                int errorCode = track->IsTrack() ? DRCE_DANGLING_TRACK : DRCE_DANGLING_VIA;
-                DRC_ITEM* item = new DRC_ITEM( errorCode );
-                item->SetItems( track );
-                m_itemsList->push_back( item );
+                for( TRACK* connected : m_brd->GetConnectivity()->GetConnectedTracks( track ) )
+                    neighbours.insert( connected );
 
-                if( !m_dryRun )
-                {
-                    m_brd->Remove( track );
-                    m_commit.Removed( track );
+                m_brd->Remove( track );
+                m_commit.Removed( track );
 
-                    /* keep iterating, because a track connected to the deleted track
-                     * now perhaps is not connected and should be deleted */
-                    item_erased = true;
-                    modified = true;
-                }
-                // Fix me: In dry run we should disable the track to erase and retry with this disabled track
-                // However the connectivity algo does not handle disabled items.
+                /* keep iterating, because a track connected to the deleted track
+                 * now perhaps is not connected and should be deleted */
+                item_erased = true;
+                modified = true;
             }
+            // Fix me: In dry run we should disable the track to erase and retry with this disabled track
+            // However the connectivity algo does not handle disabled items.
+        }
+
+        candidates.clear();
+
+        for( TRACK* track : m_brd->Tracks() )
+        {
+            if( neighbours.count( track ) )
+                candidates.push_back( track );
         }
     } while( item_erased ); // A segment was erased: test for some new dangling segments
 
@@ -358,21 +481,33 @@ bool TRACKS_CLEANER::deleteTracksInPads()
     std::set<BOARD_ITEM*> toRemove;
 
     // Delete tracks that start and end on the same pad
-    auto connectivity = m_brd->GetConnectivity();
+    auto                connectivity = m_brd->GetConnectivity();
+    std::vector<TRACK*> tracks( m_brd->Tracks().begin(), m_brd->Tracks().end() );
 
-    for( auto track : m_brd->Tracks() )
+    // Count the connected pads containing each track
+    std::vector<int> padCount = testTracks<int>( tracks,
+            [&]( TRACK* aTrack )
+            {
+                int count = 0;
+
+                for( auto pad : connectivity->GetConnectedPads( aTrack ) )
+                {
+                    if( pad->HitTest( aTrack->GetStart() ) && pad->HitTest( aTrack->GetEnd() ) )
+                        count++;
+                }
+
+                return count;
+            } );
+
+    for( size_t ii = 0; ii < tracks.size(); ii++ )
     {
-        // Mark track if connected to pads
-        for( auto pad : connectivity->GetConnectedPads( track ) )
+        for( int jj = 0; jj < padCount[ii]; jj++ )
         {
-            if( pad->HitTest( track->GetStart() ) && pad->HitTest( track->GetEnd() ) )
-            {
-                DRC_ITEM* item = new DRC_ITEM( DRCE_TRACK_IN_PAD );
-                item->SetItems( track );
-                m_itemsList->push_back( item );
+            DRC_ITEM* item = new DRC_ITEM( DRCE_TRACK_IN_PAD );
+            item->SetItems( tracks[ii] );
+            m_itemsList->push_back( item );
 
-                toRemove.insert( track );
-            }
+            toRemove.insert( tracks[ii] );
         }
     }
 
@@ -390,40 +525,41 @@ bool TRACKS_CLEANER::cleanupSegments()
 
     std::set<BOARD_ITEM*> toRemove;
 
-    // Remove duplicate segments (2 superimposed identical segments):
-    for( auto it = m_brd->Tracks().begin(); it != m_brd->Tracks().end(); it++ )
-    {
-        auto track1 = *it;
+    // Remove duplicate segments (2 superimposed identical segments).  The first unlocked
+    // segment of each set of identical segments is kept.
+    std::unordered_map<SEGMENT_KEY, TRACK*, SEGMENT_KEY_HASH> kept;
 
-        if( track1->Type() != PCB_TRACE_T || track1->HasFlag( IS_DELETED ) || track1->IsLocked() )
+    for( TRACK* track : m_brd->Tracks() )
+    {
+        if( track->Type() != PCB_TRACE_T || track->HasFlag( IS_DELETED ) )
             continue;
 
-        for( auto it2 = it + 1; it2 != m_brd->Tracks().end(); it2++ )
-        {
-            auto track2 = *it2;
-
-            if( track2->HasFlag( IS_DELETED ) )
-                continue;
+        SEGMENT_KEY key( track );
+        auto        it = kept.find( key );
 
-            if( track1->IsPointOnEnds( track2->GetStart() )
-                    && track1->IsPointOnEnds( track2->GetEnd() )
-                    && track1->GetWidth() == track2->GetWidth()
-                    && track1->GetLayer() == track2->GetLayer() )
-            {
-                DRC_ITEM* item = new DRC_ITEM( DRCE_DUPLICATE_TRACK );
-                item->SetItems( track2 );
-                m_itemsList->push_back( item );
+        if( it == kept.end() )
+        {
+            if( !track->IsLocked() )
+                kept.emplace( key, track );
+        }
+        else
+        {
+            DRC_ITEM* item = new DRC_ITEM( DRCE_DUPLICATE_TRACK );
+            item->SetItems( track );
+            m_itemsList->push_back( item );
 
-                track2->SetFlags( IS_DELETED );
-                toRemove.insert( track2 );
-            }
+            track->SetFlags( IS_DELETED );
+            toRemove.insert( track );
         }
     }
 
     modified |= removeItems( toRemove );
 
-    // merge collinear segments:
-    for( TRACK* segment : m_brd->Tracks() )
+    // merge collinear segments (merged segments are removed from the board, so iterate
+    // on a copy of the track list):
+    std::vector<TRACK*> segments( m_brd->Tracks().begin(), m_brd->Tracks().end() );
+
+    for( TRACK* segment : segments )
     {
         if( segment->Type() != PCB_TRACE_T )    // one can merge only track collinear segments, not vias.
             continue;
@@ -101,7 +101,7 @@ private:
      * @return true if aTrack has at least one end dangling, i.e. connected
      * to nothing.
      * if aTrack is a via, it is dangling if the via is connected to nothing
-     * or only one item.
+     * or only one item.  Returns false if aTrack is not in the connectivity.
      * @param aTrack is the track (or the via) to test.
      */
     bool testTrackEndpointDangling( TRACK* aTrack );
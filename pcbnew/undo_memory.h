@@ -0,0 +1,87 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef UNDO_MEMORY_H
+#define UNDO_MEMORY_H
+
+#include <cstddef>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class PICKED_ITEMS_LIST;
+
+/**
+ * Running estimate of the memory used by the levels of an undo list.  The memory of each
+ * level is estimated once, when it is added.  Geometry shared between copies of an item
+ * (see COW_PTR) is counted once, whatever the count of levels it is shared by.
+ */
+class UNDO_MEMORY
+{
+public:
+    UNDO_MEMORY() :
+            m_total( 0 )
+    {
+    }
+
+    /**
+     * Adds a level pushed to the undo list.  If a level was already counted at this
+     * address, it was deleted since then and is replaced.
+     */
+    void AddLevel( const PICKED_ITEMS_LIST* aLevel );
+
+    /**
+     * Removes a level from the estimate.  Nothing is done if it is not counted.
+     */
+    void RemoveLevel( const PICKED_ITEMS_LIST* aLevel );
+
+    /**
+     * Removes the levels which are no longer in aLevels (undone, cleared...) and adds the
+     * ones which are not counted yet.
+     */
+    void Sync( const std::vector<PICKED_ITEMS_LIST*>& aLevels );
+
+    /// @return the estimated memory of the counted levels, in bytes
+    size_t GetTotal() const { return m_total; }
+
+private:
+    struct LEVEL
+    {
+        /// Memory of the items which is not shared with other levels
+        size_t m_Size;
+
+        /// Ids and sizes of the shared geometry used by the level
+        std::vector<std::pair<const void*, size_t>> m_Shared;
+    };
+
+    struct SHARED
+    {
+        int    m_RefCount;
+        size_t m_Size;
+    };
+
+    std::unordered_map<const PICKED_ITEMS_LIST*, LEVEL> m_levels;
+    std::unordered_map<const void*, SHARED>             m_shared;
+    size_t                                              m_total;
+};
+
+#endif // UNDO_MEMORY_H
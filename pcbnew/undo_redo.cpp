@@ -26,8 +26,10 @@
  */
 
 #include <functional>
+#include <unordered_set>
 using namespace std::placeholders;
 #include <fctsys.h>
+#include <advanced_config.h>
 #include <class_draw_panel_gal.h>
 #include <macros.h>
 #include <pcbnew.h>
@@ -179,11 +181,184 @@ static void SwapItemData( BOARD_ITEM* aItem, BOARD_ITEM* aImage )
     aItem->SetParent( parent );
 }
 
+/**
+ * Approximate memory used by an item stored in the undo list.  The geometry which can be
+ * shared between copies of an item (see COW_PTR) is not included, but appended to aShared
+ * with its id.
+ */
+static size_t undoItemMemory( EDA_ITEM* aItem,
+                              std::vector<std::pair<const void*, size_t>>& aShared )
+{
+    // Rough size of a simple item (tracks, texts, graphics...)
+    const size_t itemSize = 256;
+    const void*  id = nullptr;
+
+    auto zoneMemory =
+            [&]( const ZONE_CONTAINER* aZone ) -> size_t
+            {
+                size_t fill = aZone->GetFilledPolysMemory( &id );
+
+                aShared.emplace_back( id, fill );
+
+                return sizeof( ZONE_CONTAINER )
+                       + aZone->Outline()->TotalVertices() * sizeof( VECTOR2I );
+            };
+
+    switch( aItem->Type() )
+    {
+    case PCB_ZONE_AREA_T:
+    case PCB_MODULE_ZONE_AREA_T:
+        return zoneMemory( static_cast<ZONE_CONTAINER*>( aItem ) );
+
+    case PCB_MODULE_T:
+    {
+        MODULE* module = static_cast<MODULE*>( aItem );
+        size_t  size = sizeof( MODULE ) + itemSize * module->GraphicalItems().size();
+
+        for( D_PAD* pad : module->Pads() )
+        {
+            size_t shape = pad->GetCustomShapeMemory( &id );
+
+            aShared.emplace_back( id, shape );
+            size += sizeof( D_PAD );
+        }
+
+        for( MODULE_ZONE_CONTAINER* zone : module->Zones() )
+            size += zoneMemory( zone );
+
+        return size;
+    }
+
+    default:
+        return itemSize;
+    }
+}
+
+
+void UNDO_MEMORY::AddLevel( const PICKED_ITEMS_LIST* aLevel )
+{
+    RemoveLevel( aLevel );
+
+    std::vector<std::pair<const void*, size_t>> shared;
+    std::unordered_set<const void*>             seen;
+    LEVEL&                                      level = m_levels[aLevel];
+
+    level.m_Size = 0;
+
+    for( unsigned ii = 0; ii < aLevel->GetCount(); ii++ )
+    {
+        if( EDA_ITEM* copy = aLevel->GetPickedItemLink( ii ) )
+            level.m_Size += undoItemMemory( copy, shared );
+
+        if( aLevel->GetPickedItemStatus( ii ) == UR_DELETED )
+            level.m_Size += undoItemMemory( aLevel->GetPickedItem( ii ), shared );
+    }
+
+    m_total += level.m_Size;
+
+    for( const std::pair<const void*, size_t>& geometry : shared )
+    {
+        if( !seen.insert( geometry.first ).second )
+            continue;
+
+        SHARED& entry = m_shared[geometry.first];
+
+        if( entry.m_RefCount++ == 0 )
+        {
+            entry.m_Size = geometry.second;
+            m_total += geometry.second;
+        }
+
+        level.m_Shared.push_back( geometry );
+    }
+}
+
+
+void UNDO_MEMORY::RemoveLevel( const PICKED_ITEMS_LIST* aLevel )
+{
+    auto it = m_levels.find( aLevel );
+
+    if( it == m_levels.end() )
+        return;
+
+    m_total -= it->second.m_Size;
+
+    for( const std::pair<const void*, size_t>& geometry : it->second.m_Shared )
+    {
+        auto shared = m_shared.find( geometry.first );
+
+        if( --shared->second.m_RefCount == 0 )
+        {
+            m_total -= shared->second.m_Size;
+            m_shared.erase( shared );
+        }
+    }
+
+    m_levels.erase( it );
+}
+
+
+void UNDO_MEMORY::Sync( const std::vector<PICKED_ITEMS_LIST*>& aLevels )
+{
+    std::unordered_set<const PICKED_ITEMS_LIST*> current( aLevels.begin(), aLevels.end() );
+    std::vector<const PICKED_ITEMS_LIST*>        removed;
+
+    for( const auto& level : m_levels )
+    {
+        if( !current.count( level.first ) )
+            removed.push_back( level.first );
+    }
+
+    for( const PICKED_ITEMS_LIST* level : removed )
+        RemoveLevel( level );
+
+    for( const PICKED_ITEMS_LIST* level : aLevels )
+    {
+        if( !m_levels.count( level ) )
+            AddLevel( level );
+    }
+}
+
+
+void PCB_BASE_EDIT_FRAME::trimUndoList( const PICKED_ITEMS_LIST* aNewLevel )
+{
+    const size_t limit = (size_t) ADVANCED_CFG::GetCfg().m_undoMemoryLimit * 1024 * 1024;
+
+    if( limit == 0 )
+        return;
+
+    std::vector<PICKED_ITEMS_LIST*>& commands = GetScreen()->m_UndoList.m_CommandsList;
+
+    // The new level can have the address of a deleted one, still counted: replace it first.
+    // Only the levels added or removed since the last call are processed.
+    if( aNewLevel )
+        m_undoMemory.AddLevel( aNewLevel );
+
+    m_undoMemory.Sync( commands );
+
+    // Always keep the most recent level, however large it is
+    int count = 0;
+
+    while( m_undoMemory.GetTotal() > limit && count < (int) commands.size() - 1 )
+        m_undoMemory.RemoveLevel( commands[count++] );
+
+    if( count > 0 )
+    {
+        wxLogTrace( "KICAD_UNDO", "Undo memory above %d MB, discarding %d levels",
+                    ADVANCED_CFG::GetCfg().m_undoMemoryLimit, count );
+
+        GetScreen()->ClearUndoORRedoList( GetScreen()->m_UndoList, count );
+    }
+}
+
+
 void PCB_BASE_EDIT_FRAME::SaveCopyInUndoList( BOARD_ITEM* aItem, UNDO_REDO_T aCommandType,
                                               const wxPoint& aTransformPoint )
 {
     PICKED_ITEMS_LIST commandToUndo;
     commandToUndo.PushItem( ITEM_PICKER( aItem, aCommandType ) );
+
+    // Pushes the new level and trims the undo list to its memory budget
     SaveCopyInUndoList( commandToUndo, aCommandType, aTransformPoint );
 }
 
@@ -316,6 +491,7 @@ void PCB_BASE_EDIT_FRAME::SaveCopyInUndoList( const PICKED_ITEMS_LIST& aItemsLis
     {
         /* Save the copy in undo list */
         GetScreen()->PushCommandToUndoList( commandToUndo );
+        trimUndoList( commandToUndo );
 
         /* Clear redo list, because after a new command one cannot redo a command */
         GetScreen()->ClearUndoORRedoList( GetScreen()->m_RedoList );
@@ -378,6 +554,7 @@ void PCB_BASE_EDIT_FRAME::RestoreCopyFromRedoList( wxCommandEvent& aEvent )
     // Put the old list in UndoList
     List->ReversePickersListOrder();
     GetScreen()->PushCommandToUndoList( List );
+    trimUndoList( List );
 
     OnModify();
 
@@ -45,6 +45,8 @@
 #include <confirm.h>
 #include <convert_to_biu.h>
 #include <math/util.h>      // for KiROUND
+#include <parallel_for.h>
+#include <trace_span.h>
 
 #include "zone_filler.h"
 
@@ -100,6 +102,7 @@ void ZONE_FILLER::InstallNewProgressReporter( wxWindow* aParent, const wxString&
 
 bool ZONE_FILLER::Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck )
 {
+    TRACE_SPAN span( "ZONE_FILLER::Fill", "zones" );
     std::vector<CN_ZONE_ISOLATED_ISLAND_LIST> toFill;
     auto connectivity = m_board->GetConnectivity();
     bool filledPolyWithOutline = not m_board->GetDesignSettings().m_ZoneUseNoOutlineInFill;
@@ -174,7 +177,15 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck
     else
     {
         for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-            returns[ii] = std::async( std::launch::async, fill_lambda, m_progressReporter );
+        {
+            returns[ii] = std::async( std::launch::async,
+                                      [&]()
+                                      {
+                                          // Loops inside the fill of a zone stay serial
+                                          PARALLEL_WORKER_SCOPE workerScope;
+                                          return fill_lambda( m_progressReporter );
+                                      } );
+        }
 
         for( size_t ii = 0; ii < parallelThreadCount; ++ii )
         {
@@ -231,8 +242,8 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck
         {
             for( int idx = 0; idx < poly.OutlineCount(); )
             {
-                if( poly.Polygon( idx ).empty() ||
-                    !m_boardOutline.Contains( poly.Polygon( idx ).front().CPoint( 0 ) ) )
+                if( poly.CPolygon( idx ).empty() ||
+                    !m_boardOutline.Contains( poly.CPolygon( idx ).front().CPoint( 0 ) ) )
                 {
                     poly.DeletePolygon( idx );
                 }
@@ -283,6 +294,7 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck
 
         for( size_t i = nextItem++; i < toFill.size(); i = nextItem++ )
         {
+            TRACE_SPAN triSpan( "CacheTriangulation", "zones" );
             toFill[i].m_zone->CacheTriangulation();
             num++;
 
@@ -505,7 +517,7 @@ void ZONE_FILLER::knockoutThermalReliefs( const ZONE_CONTAINER* aZone, SHAPE_POL
         }
     }
 
-    holes.Simplify( SHAPE_POLY_SET::PM_FAST );
+    holes.BatchedUnion( SHAPE_POLY_SET::PM_FAST );
     aFill.BooleanSubtract( holes, SHAPE_POLY_SET::PM_FAST );
 }
 
@@ -676,7 +688,7 @@ void ZONE_FILLER::buildCopperItemClearances( const ZONE_CONTAINER* aZone, SHAPE_
         zone->TransformOutlinesShapeWithClearanceToPolygon( aHoles, minClearance, useNetClearance );
     }
 
-    aHoles.Simplify( SHAPE_POLY_SET::PM_FAST );
+    aHoles.BatchedUnion( SHAPE_POLY_SET::PM_FAST );
 }
 
 
@@ -697,6 +709,7 @@ void ZONE_FILLER::computeRawFilledArea( const ZONE_CONTAINER* aZone,
                                         SHAPE_POLY_SET& aRawPolys,
                                         SHAPE_POLY_SET& aFinalPolys )
 {
+    TRACE_SPAN span( "ZONE_FILLER::computeRawFilledArea", "zones" );
     m_high_def = m_board->GetDesignSettings().m_MaxError;
     m_low_def = std::min( ARC_LOW_DEF, int( m_high_def*1.5 ) );   // Reasonable value
 
@@ -757,16 +770,16 @@ void ZONE_FILLER::computeRawFilledArea( const ZONE_CONTAINER* aZone,
         testAreas.Inflate( half_min_width - epsilon, numSegs, intermediatecornerStrategy );
     }
 
-    // Spoke-end-testing is hugely expensive so we generate cached bounding-boxes to speed
-    // things up a bit.
-    testAreas.BuildBBoxCaches();
+    // Spoke-end-testing is hugely expensive so we index the edges of the test areas to speed
+    // things up.
+    testAreas.EnableIndex();
 
     for( const SHAPE_LINE_CHAIN& spoke : thermalSpokes )
     {
         const VECTOR2I& testPt = spoke.CPoint( 3 );
 
         // Hit-test against zone body
-        if( testAreas.Contains( testPt, -1, 1, USE_BBOX_CACHES ) )
+        if( testAreas.Contains( testPt, -1, 1 ) )
         {
             aRawPolys.AddOutline( spoke );
             continue;
@@ -1155,7 +1168,7 @@ void ZONE_FILLER::addHatchFillTypeOnZone( const ZONE_CONTAINER* aZone, SHAPE_POL
     // It happens for holes near the zone outline
     for( int ii = 0; ii < holes.OutlineCount(); )
     {
-        double area = holes.Outline( ii ).Area();
+        double area = holes.COutline( ii ).Area();
 
         if( area < minimal_hole_area ) // The current hole is too small: remove it
             holes.DeletePolygon( ii );
@@ -221,6 +221,25 @@ inline SHAPE_POLY_SET FilletPolySet( SHAPE_POLY_SET& aPolySet, int aRadius, int
     return filletedPolySet;
 }
 
+/**
+ * @brief Returns the area of a polygon set: the area of the outlines minus the area
+ * of their holes
+ */
+inline double PolySetArea( const SHAPE_POLY_SET& aPolySet )
+{
+    double area = 0.0;
+
+    for( int i = 0; i < aPolySet.OutlineCount(); i++ )
+    {
+        area += std::abs( aPolySet.COutline( i ).Area() );
+
+        for( int j = 0; j < aPolySet.HoleCount( i ); j++ )
+            area -= std::abs( aPolySet.CHole( i, j ).Area() );
+    }
+
+    return area;
+}
+
 } // namespace GEOM_TEST
 
 namespace BOOST_TEST_PRINT_NAMESPACE_OPEN
@@ -0,0 +1,117 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <geometry/shape_line_chain.h>
+#include <geometry/shape_poly_set.h>
+
+#include "fixtures_geometry.h"
+
+/**
+ * Fixture for the triangulation cache test suite. It contains an instance of the
+ * common data.
+ */
+struct PolySetCacheFixture
+{
+    struct KI_TEST::CommonTestData common;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( PolySetCache, PolySetCacheFixture )
+
+/**
+ * Checks that the generation counter follows the modifications of the set.
+ */
+BOOST_AUTO_TEST_CASE( Generation )
+{
+    SHAPE_POLY_SET polySet = common.holeyPolySet;
+    unsigned long long generation = polySet.GetGeneration();
+
+    // Const access does not change the generation
+    polySet.COutline( 0 );
+    polySet.CHole( 0, 0 );
+    polySet.CPolygon( 0 );
+    polySet.CVertex( 0 );
+    polySet.SquaredDistance( VECTOR2I( 0, 0 ) );
+    polySet.SquaredDistance( SEG( VECTOR2I( 0, 0 ), VECTOR2I( 10, 10 ) ) );
+    BOOST_CHECK_EQUAL( polySet.GetGeneration(), generation );
+
+    // Write access does
+    polySet.Outline( 0 );
+    BOOST_CHECK( polySet.GetGeneration() != generation );
+    generation = polySet.GetGeneration();
+
+    polySet.Move( VECTOR2I( 10, 10 ) );
+    BOOST_CHECK( polySet.GetGeneration() != generation );
+}
+
+/**
+ * Checks that sets with the same content have the same hash, and different
+ * sets have different hashes.
+ */
+BOOST_AUTO_TEST_CASE( Hash )
+{
+    SHAPE_POLY_SET polySet = common.holeyPolySet;
+
+    BOOST_CHECK_EQUAL( polySet.GetHash(), common.holeyPolySet.GetHash() );
+
+    polySet.Move( VECTOR2I( 10, 10 ) );
+    BOOST_CHECK( polySet.GetHash() != common.holeyPolySet.GetHash() );
+
+    polySet.Move( VECTOR2I( -10, -10 ) );
+    BOOST_CHECK_EQUAL( polySet.GetHash(), common.holeyPolySet.GetHash() );
+}
+
+/**
+ * Checks the validity of the cached triangulation.
+ */
+BOOST_AUTO_TEST_CASE( Triangulation )
+{
+    SHAPE_POLY_SET polySet = common.holeyPolySet;
+
+    BOOST_CHECK( !polySet.IsTriangulationUpToDate() );
+
+    polySet.CacheTriangulation();
+    BOOST_CHECK( polySet.IsTriangulationUpToDate() );
+
+    // A copy shares the up to date triangulation
+    SHAPE_POLY_SET copy( polySet );
+    BOOST_CHECK( copy.IsTriangulationUpToDate() );
+
+    // A non const access is considered as a modification...
+    polySet.Outline( 0 );
+    BOOST_CHECK( !polySet.IsTriangulationUpToDate() );
+
+    // ... but the triangulation is kept if the content did not change
+    polySet.CacheTriangulation();
+    BOOST_CHECK( polySet.IsTriangulationUpToDate() );
+
+    polySet.Move( VECTOR2I( 10, 10 ) );
+    BOOST_CHECK( !polySet.IsTriangulationUpToDate() );
+
+    polySet.CacheTriangulation();
+    BOOST_CHECK( polySet.IsTriangulationUpToDate() );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,117 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <geometry/shape_line_chain.h>
+#include <geometry/shape_poly_set.h>
+
+#include "fixtures_geometry.h"
+#include "geom_test_utils.h"
+
+#include <cmath>
+
+
+/**
+ * Builds a square outline with a grid of aCount x aCount polygonal holes.
+ */
+static SHAPE_POLY_SET buildHoleGrid( int aCount )
+{
+    SHAPE_POLY_SET   polySet;
+    SHAPE_LINE_CHAIN outline;
+    int              size = aCount * 12000 + 8000;
+
+    outline.Append( 0, 0 );
+    outline.Append( size, 0 );
+    outline.Append( size, size );
+    outline.Append( 0, size );
+    outline.SetClosed( true );
+    polySet.AddOutline( outline );
+
+    for( int i = 0; i < aCount; i++ )
+    {
+        for( int j = 0; j < aCount; j++ )
+        {
+            SHAPE_LINE_CHAIN hole;
+            VECTOR2I         center( 10000 + i * 12000 + ( j % 2 ) * 3000, 10000 + j * 12000 );
+
+            for( int k = 0; k < 12; k++ )
+            {
+                double angle = 2.0 * M_PI * k / 12;
+                hole.Append( center.x + KiROUND( 3000 * cos( angle ) ),
+                             center.y + KiROUND( 3000 * sin( angle ) ) );
+            }
+
+            hole.SetClosed( true );
+            polySet.AddHole( hole );
+        }
+    }
+
+    return polySet;
+}
+
+
+BOOST_AUTO_TEST_SUITE( PolySetFracture )
+
+/**
+ * Checks that a fractured polygon keeps its area, and gets back its holes when
+ * unfractured
+ */
+BOOST_AUTO_TEST_CASE( RoundTrip )
+{
+    for( int count : { 1, 5, 30 } )
+    {
+        SHAPE_POLY_SET polySet = buildHoleGrid( count );
+        double         area = GEOM_TEST::PolySetArea( polySet );
+
+        polySet.Fracture( SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
+
+        BOOST_CHECK_EQUAL( polySet.OutlineCount(), 1 );
+        BOOST_CHECK( !polySet.HasHoles() );
+        BOOST_CHECK_CLOSE( GEOM_TEST::PolySetArea( polySet ), area, 1e-6 );
+
+        polySet.Unfracture( SHAPE_POLY_SET::PM_FAST );
+
+        BOOST_CHECK_EQUAL( polySet.OutlineCount(), 1 );
+        BOOST_CHECK_EQUAL( polySet.HoleCount( 0 ), count * count );
+        BOOST_CHECK_CLOSE( GEOM_TEST::PolySetArea( polySet ), area, 1e-6 );
+    }
+}
+
+/**
+ * Checks the fracture of the holey polygon of the common test data
+ */
+BOOST_AUTO_TEST_CASE( CommonData )
+{
+    KI_TEST::CommonTestData common;
+    SHAPE_POLY_SET          polySet = common.holeyPolySet;
+    double                  area = GEOM_TEST::PolySetArea( polySet );
+
+    polySet.Fracture( SHAPE_POLY_SET::PM_FAST );
+
+    BOOST_CHECK_EQUAL( polySet.OutlineCount(), 1 );
+    BOOST_CHECK( !polySet.HasHoles() );
+    BOOST_CHECK_CLOSE( GEOM_TEST::PolySetArea( polySet ), area, 1e-6 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,206 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <geometry/shape_line_chain.h>
+#include <geometry/shape_poly_set.h>
+
+#include <cmath>
+#include <random>
+
+
+/**
+ * Builds a set of aCount x aCount star shaped polygons, each one with a hole.
+ */
+static SHAPE_POLY_SET buildStars( int aCount )
+{
+    SHAPE_POLY_SET polySet;
+
+    for( int i = 0; i < aCount; i++ )
+    {
+        for( int j = 0; j < aCount; j++ )
+        {
+            SHAPE_LINE_CHAIN outline;
+            SHAPE_LINE_CHAIN hole;
+            VECTOR2I         center( i * 25000, j * 25000 );
+
+            for( int k = 0; k < 200; k++ )
+            {
+                double angle = 2.0 * M_PI * k / 200;
+                int    radius = ( k % 2 ) ? 11000 : 6000;
+
+                outline.Append( center.x + KiROUND( radius * cos( angle ) ),
+                                center.y + KiROUND( radius * sin( angle ) ) );
+            }
+
+            for( int k = 0; k < 16; k++ )
+            {
+                double angle = 2.0 * M_PI * k / 16;
+
+                hole.Append( center.x + KiROUND( 3000 * cos( angle ) ),
+                             center.y + KiROUND( 3000 * sin( angle ) ) );
+            }
+
+            outline.SetClosed( true );
+            hole.SetClosed( true );
+            polySet.AddOutline( outline );
+            polySet.AddHole( hole );
+        }
+    }
+
+    return polySet;
+}
+
+
+/**
+ * Returns random points around aPolySet, and its vertices and edge midpoints, which are on
+ * the edges.
+ */
+static std::vector<VECTOR2I> buildTestPoints( const SHAPE_POLY_SET& aPolySet, int aCount )
+{
+    std::vector<VECTOR2I>              points;
+    BOX2I                              bbox = aPolySet.BBox( 5000 );
+    std::mt19937                       rng( 42 );
+    std::uniform_int_distribution<int> x( bbox.GetLeft(), bbox.GetRight() );
+    std::uniform_int_distribution<int> y( bbox.GetTop(), bbox.GetBottom() );
+
+    for( int i = 0; i < aCount; i++ )
+        points.emplace_back( x( rng ), y( rng ) );
+
+    for( int i = 0; i < aPolySet.OutlineCount(); i++ )
+    {
+        for( auto it = aPolySet.CIterateSegmentsWithHoles( i ); it; it++ )
+        {
+            SEG seg = *it;
+
+            points.push_back( seg.A );
+            points.push_back( ( seg.A + seg.B ) / 2 );
+            points.push_back( ( seg.A + seg.B ) / 2 + VECTOR2I( 2, 1 ) );
+        }
+    }
+
+    return points;
+}
+
+
+BOOST_AUTO_TEST_SUITE( PolygonIndex )
+
+
+/**
+ * Checks that the indexed point queries give the same results as the unindexed ones.
+ */
+BOOST_AUTO_TEST_CASE( PointQueries )
+{
+    SHAPE_POLY_SET reference = buildStars( 4 );
+    SHAPE_POLY_SET indexed = reference;
+
+    indexed.EnableIndex();
+    BOOST_CHECK( indexed.IsIndexEnabled() );
+    BOOST_CHECK( !reference.IsIndexEnabled() );
+
+    for( const VECTOR2I& p : buildTestPoints( reference, 2000 ) )
+    {
+        BOOST_TEST_CONTEXT( "Point " << p.x << ", " << p.y )
+        {
+            for( int accuracy : { 0, 1, 5 } )
+                BOOST_CHECK_EQUAL( indexed.Contains( p, -1, accuracy ),
+                                   reference.Contains( p, -1, accuracy ) );
+
+            BOOST_CHECK_EQUAL( indexed.Contains( p, 5 ), reference.Contains( p, 5 ) );
+            BOOST_CHECK_EQUAL( indexed.SquaredDistance( p ), reference.SquaredDistance( p ) );
+            BOOST_CHECK_EQUAL( indexed.SquaredDistanceToPolygon( p, 3 ),
+                               reference.SquaredDistanceToPolygon( p, 3 ) );
+            BOOST_CHECK_EQUAL( indexed.Collide( p ), reference.Collide( p ) );
+
+            // The indexed clearance test is exact: it is the same as testing the distance
+            BOOST_CHECK_EQUAL( indexed.Collide( p, 1000 ),
+                               reference.SquaredDistance( p ) < 1000 * 1000 );
+        }
+    }
+}
+
+
+/**
+ * Checks that the indexed segment queries give the same results as the unindexed ones.
+ */
+BOOST_AUTO_TEST_CASE( SegmentQueries )
+{
+    SHAPE_POLY_SET        reference = buildStars( 3 );
+    SHAPE_POLY_SET        indexed = reference;
+    std::vector<VECTOR2I> points = buildTestPoints( reference, 500 );
+
+    indexed.EnableIndex();
+
+    for( size_t i = 0; i + 1 < points.size(); i += 7 )
+    {
+        SEG seg( points[i], points[( i * 13 ) % points.size()] );
+
+        BOOST_TEST_CONTEXT( "Segment " << seg.A.x << ", " << seg.A.y << " - " << seg.B.x
+                                       << ", " << seg.B.y )
+        {
+            BOOST_CHECK_EQUAL( indexed.SquaredDistance( seg ),
+                               reference.SquaredDistance( seg ) );
+            BOOST_CHECK_EQUAL( indexed.Collide( seg ), reference.Collide( seg ) );
+            BOOST_CHECK_EQUAL( indexed.Collide( seg, 500 ),
+                               reference.SquaredDistance( seg ) < 500 * 500 );
+        }
+    }
+}
+
+
+/**
+ * Checks that the index follows the modifications of the set.
+ */
+BOOST_AUTO_TEST_CASE( Invalidation )
+{
+    SHAPE_POLY_SET polySet = buildStars( 2 );
+    VECTOR2I       center( 25000, 25000 );
+    VECTOR2I       inside( 25000 + 4500, 25000 );
+
+    polySet.EnableIndex();
+
+    BOOST_CHECK( polySet.Contains( inside ) );
+    BOOST_CHECK( !polySet.Contains( center ) );
+
+    polySet.Move( VECTOR2I( 100000, 0 ) );
+    BOOST_CHECK( !polySet.Contains( inside ) );
+
+    polySet.Move( VECTOR2I( -100000, 0 ) );
+    BOOST_CHECK( polySet.Contains( inside ) );
+
+    // Edits through a non-const reference also invalidate the index
+    polySet.Hole( 3, 0 ).Move( VECTOR2I( 3000, 0 ) );
+    BOOST_CHECK( !polySet.Contains( inside ) );
+
+    // The setting survives an assignment
+    polySet = buildStars( 1 );
+    BOOST_CHECK( polySet.IsIndexEnabled() );
+    BOOST_CHECK( polySet.Contains( VECTOR2I( 4500, 0 ) ) );
+
+    polySet.EnableIndex( false );
+    BOOST_CHECK( polySet.Contains( VECTOR2I( 4500, 0 ) ) );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
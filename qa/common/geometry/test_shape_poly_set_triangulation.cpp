@@ -0,0 +1,127 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <geometry/shape_line_chain.h>
+#include <geometry/shape_poly_set.h>
+
+#include "fixtures_geometry.h"
+#include "geom_test_utils.h"
+
+#include <cmath>
+
+
+/**
+ * Returns the area covered by the triangles of the cached triangulation of aPolySet.
+ */
+static double triangulatedArea( const SHAPE_POLY_SET& aPolySet )
+{
+    double area = 0.0;
+
+    for( unsigned int j = 0; j < aPolySet.TriangulatedPolyCount(); ++j )
+    {
+        const SHAPE_POLY_SET::TRIANGULATED_POLYGON* triPoly = aPolySet.TriangulatedPolygon( j );
+
+        for( size_t i = 0; i < triPoly->GetTriangleCount(); i++ )
+        {
+            VECTOR2I a, b, c;
+            triPoly->GetTriangle( i, a, b, c );
+
+            VECTOR2D ab = b - a;
+            VECTOR2D ac = c - a;
+            area += std::abs( ab.x * ac.y - ab.y * ac.x ) / 2.0;
+        }
+    }
+
+    return area;
+}
+
+
+/**
+ * Returns a regular polygon approximating a circle.
+ */
+static SHAPE_LINE_CHAIN buildCircle( const VECTOR2I& aCenter, int aRadius, int aSegments )
+{
+    SHAPE_LINE_CHAIN circle;
+
+    for( int i = 0; i < aSegments; i++ )
+    {
+        double angle = 2.0 * M_PI * i / aSegments;
+        circle.Append( aCenter.x + KiROUND( aRadius * cos( angle ) ),
+                       aCenter.y + KiROUND( aRadius * sin( angle ) ) );
+    }
+
+    circle.SetClosed( true );
+    return circle;
+}
+
+
+BOOST_AUTO_TEST_SUITE( PolySetTriangulation )
+
+/**
+ * Checks that a polygon with holes is triangulated without being fractured, and that
+ * the triangles cover exactly the polygon.
+ */
+BOOST_AUTO_TEST_CASE( Holes )
+{
+    KI_TEST::CommonTestData common;
+    SHAPE_POLY_SET          polySet = common.holeyPolySet;
+
+    polySet.CacheTriangulation();
+
+    BOOST_CHECK( polySet.IsTriangulationUpToDate() );
+    BOOST_CHECK_EQUAL( polySet.TriangulatedPolyCount(), 1 );
+    BOOST_CHECK_CLOSE( triangulatedArea( polySet ), GEOM_TEST::PolySetArea( polySet ), 1e-6 );
+}
+
+/**
+ * Checks a set large enough to be triangulated in parallel: many outlines, each one
+ * with several holes.
+ */
+BOOST_AUTO_TEST_CASE( ManyOutlines )
+{
+    SHAPE_POLY_SET polySet;
+
+    for( int i = 0; i < 16; i++ )
+    {
+        VECTOR2I center( ( i % 4 ) * 3000000, ( i / 4 ) * 3000000 );
+
+        polySet.AddOutline( buildCircle( center, 1000000, 360 ) );
+
+        for( int j = 0; j < 4; j++ )
+        {
+            VECTOR2I holeCenter( center.x + ( ( j % 2 ) ? 400000 : -400000 ),
+                                 center.y + ( ( j / 2 ) ? 400000 : -400000 ) );
+            polySet.AddHole( buildCircle( holeCenter, 200000, 32 ) );
+        }
+    }
+
+    polySet.CacheTriangulation();
+
+    BOOST_CHECK( polySet.IsTriangulationUpToDate() );
+    BOOST_CHECK_EQUAL( polySet.TriangulatedPolyCount(), 16 );
+    BOOST_CHECK_CLOSE( triangulatedArea( polySet ), GEOM_TEST::PolySetArea( polySet ), 1e-6 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,168 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <geometry/shape_line_chain.h>
+#include <geometry/shape_poly_set.h>
+
+#include "geom_test_utils.h"
+
+#include <cmath>
+
+
+/**
+ * Builds a set of overlapping rings (an outline and a hole), laid out on a grid:
+ * each ring overlaps its neighbours, so the merged set has a few large polygons
+ * with many holes, crossing all the tiles.
+ */
+static SHAPE_POLY_SET buildRings( int aCount )
+{
+    SHAPE_POLY_SET polySet;
+
+    for( int i = 0; i < aCount; i++ )
+    {
+        for( int j = 0; j < aCount; j++ )
+        {
+            SHAPE_LINE_CHAIN outline;
+            SHAPE_LINE_CHAIN hole;
+            VECTOR2I         center( i * 1500 + ( j % 3 ) * 100, j * 1500 );
+
+            for( int k = 0; k < 16; k++ )
+            {
+                double angle = 2.0 * M_PI * k / 16;
+
+                outline.Append( center.x + KiROUND( 1000 * cos( angle ) ),
+                                center.y + KiROUND( 1000 * sin( angle ) ) );
+                hole.Append( center.x + KiROUND( 400 * cos( angle ) ),
+                             center.y + KiROUND( 400 * sin( angle ) ) );
+            }
+
+            outline.SetClosed( true );
+            hole.SetClosed( true );
+
+            polySet.AddOutline( outline );
+            polySet.AddHole( hole );
+        }
+    }
+
+    return polySet;
+}
+
+
+BOOST_AUTO_TEST_SUITE( PolySetUnion )
+
+/**
+ * Checks that the batched union of a large set gives the same result as Simplify()
+ */
+BOOST_AUTO_TEST_CASE( SameAsSimplify )
+{
+    SHAPE_POLY_SET simplified = buildRings( 40 );
+    SHAPE_POLY_SET batched = simplified;
+
+    simplified.Simplify( SHAPE_POLY_SET::PM_FAST );
+    batched.BatchedUnion( SHAPE_POLY_SET::PM_FAST );
+
+    BOOST_CHECK_EQUAL( batched.OutlineCount(), simplified.OutlineCount() );
+    BOOST_CHECK_EQUAL( batched.TotalVertices(), simplified.TotalVertices() );
+    BOOST_CHECK_CLOSE( GEOM_TEST::PolySetArea( batched ), GEOM_TEST::PolySetArea( simplified ), 1e-6 );
+
+    // The difference between both results must be empty
+    SHAPE_POLY_SET diff = simplified;
+    diff.BooleanSubtract( batched, SHAPE_POLY_SET::PM_FAST );
+    BOOST_CHECK_EQUAL( diff.OutlineCount(), 0 );
+
+    diff = batched;
+    diff.BooleanSubtract( simplified, SHAPE_POLY_SET::PM_FAST );
+    BOOST_CHECK_EQUAL( diff.OutlineCount(), 0 );
+}
+
+/**
+ * Checks the batched union of heavily overlapping polygons: every polygon overlaps polygons
+ * of many other tiles, so the result is a single outline built across all the stitch levels
+ */
+BOOST_AUTO_TEST_CASE( HeavyOverlap )
+{
+    SHAPE_POLY_SET simplified;
+
+    for( int i = 0; i < 2000; i++ )
+    {
+        SHAPE_LINE_CHAIN square;
+        VECTOR2I         corner( ( i * 37 ) % 1000, ( i * 91 ) % 1000 );
+
+        square.Append( corner );
+        square.Append( corner + VECTOR2I( 5000, 0 ) );
+        square.Append( corner + VECTOR2I( 5000, 5000 ) );
+        square.Append( corner + VECTOR2I( 0, 5000 ) );
+        square.SetClosed( true );
+
+        simplified.AddOutline( square );
+    }
+
+    SHAPE_POLY_SET batched = simplified;
+
+    simplified.Simplify( SHAPE_POLY_SET::PM_FAST );
+    batched.BatchedUnion( SHAPE_POLY_SET::PM_FAST );
+
+    BOOST_CHECK_EQUAL( batched.OutlineCount(), 1 );
+    BOOST_CHECK_EQUAL( batched.OutlineCount(), simplified.OutlineCount() );
+    BOOST_CHECK_EQUAL( batched.TotalVertices(), simplified.TotalVertices() );
+    BOOST_CHECK_CLOSE( GEOM_TEST::PolySetArea( batched ), GEOM_TEST::PolySetArea( simplified ), 1e-6 );
+
+    SHAPE_POLY_SET diff = simplified;
+    diff.BooleanSubtract( batched, SHAPE_POLY_SET::PM_FAST );
+    BOOST_CHECK_EQUAL( diff.OutlineCount(), 0 );
+
+    diff = batched;
+    diff.BooleanSubtract( simplified, SHAPE_POLY_SET::PM_FAST );
+    BOOST_CHECK_EQUAL( diff.OutlineCount(), 0 );
+}
+
+/**
+ * Checks that disjoint polygons are kept unchanged
+ */
+BOOST_AUTO_TEST_CASE( Disjoint )
+{
+    SHAPE_POLY_SET polySet;
+
+    for( int i = 0; i < 1000; i++ )
+    {
+        SHAPE_LINE_CHAIN square;
+        VECTOR2I         corner( ( i % 50 ) * 2000, ( i / 50 ) * 2000 );
+
+        square.Append( corner );
+        square.Append( corner + VECTOR2I( 1000, 0 ) );
+        square.Append( corner + VECTOR2I( 1000, 1000 ) );
+        square.Append( corner + VECTOR2I( 0, 1000 ) );
+        square.SetClosed( true );
+
+        polySet.AddOutline( square );
+    }
+
+    polySet.BatchedUnion( SHAPE_POLY_SET::PM_FAST );
+
+    BOOST_CHECK_EQUAL( polySet.OutlineCount(), 1000 );
+    BOOST_CHECK_CLOSE( GEOM_TEST::PolySetArea( polySet ), 1000 * 1000.0 * 1000.0, 1e-6 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
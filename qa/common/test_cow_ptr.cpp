@@ -0,0 +1,81 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <core/cow_ptr.h>
+
+#include <geometry/shape_poly_set.h>
+
+
+BOOST_AUTO_TEST_SUITE( CowPtr )
+
+
+/**
+ * Copies share the value until one of them is written
+ */
+BOOST_AUTO_TEST_CASE( CopyOnWrite )
+{
+    COW_PTR<std::vector<int>> original( std::vector<int>{ 1, 2, 3 } );
+    COW_PTR<std::vector<int>> copy( original );
+
+    BOOST_CHECK( original.IsShared() );
+    BOOST_CHECK_EQUAL( original.Id(), copy.Id() );
+
+    copy.Write().push_back( 4 );
+
+    BOOST_CHECK( !original.IsShared() );
+    BOOST_CHECK( original.Id() != copy.Id() );
+    BOOST_CHECK_EQUAL( original->size(), 3 );
+    BOOST_CHECK_EQUAL( copy->size(), 4 );
+
+    // Writing an unshared value does not copy it
+    const void* id = copy.Id();
+    copy.Write().push_back( 5 );
+
+    BOOST_CHECK_EQUAL( copy.Id(), id );
+}
+
+
+/**
+ * Set() replaces the value of one copy only
+ */
+BOOST_AUTO_TEST_CASE( Set )
+{
+    SHAPE_POLY_SET square;
+    square.NewOutline();
+    square.Append( 0, 0 );
+    square.Append( 100, 0 );
+    square.Append( 100, 100 );
+    square.Append( 0, 100 );
+
+    COW_PTR<SHAPE_POLY_SET> original( square );
+    COW_PTR<SHAPE_POLY_SET> copy = original;
+
+    copy.Set( SHAPE_POLY_SET() );
+
+    BOOST_CHECK_EQUAL( original->TotalVertices(), 4 );
+    BOOST_CHECK( copy->IsEmpty() );
+    BOOST_CHECK( !original.IsShared() );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,101 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <parallel_for.h>
+
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+
+BOOST_AUTO_TEST_SUITE( ParallelForLoop )
+
+
+/**
+ * Every item is visited exactly once
+ */
+BOOST_AUTO_TEST_CASE( VisitsAllItems )
+{
+    std::vector<int> visits( 1000, 0 );
+
+    ParallelFor( visits.size(),
+                 [&]( size_t aIdx )
+                 {
+                     visits[aIdx]++;
+                 } );
+
+    for( int count : visits )
+        BOOST_CHECK_EQUAL( count, 1 );
+
+    BOOST_CHECK( !IsParallelWorker() );
+}
+
+
+/**
+ * A loop started from a worker of another loop runs on that worker
+ */
+BOOST_AUTO_TEST_CASE( NestedLoopIsSerial )
+{
+    const size_t      outerCount = 4 * std::max( std::thread::hardware_concurrency(), 1u );
+    std::atomic<bool> nestedOnOtherThread( false );
+    std::atomic<int>  nestedItems( 0 );
+
+    ParallelFor( outerCount,
+                 [&]( size_t )
+                 {
+                     std::thread::id outerThread = std::this_thread::get_id();
+
+                     ParallelFor( 100,
+                                  [&]( size_t )
+                                  {
+                                      if( std::this_thread::get_id() != outerThread )
+                                          nestedOnOtherThread = true;
+
+                                      nestedItems++;
+                                  } );
+                 } );
+
+    BOOST_CHECK( !nestedOnOtherThread );
+    BOOST_CHECK_EQUAL( nestedItems, outerCount * 100 );
+}
+
+
+/**
+ * An exception thrown by an item reaches the caller
+ */
+BOOST_AUTO_TEST_CASE( Exception )
+{
+    auto throwOnItem42 = []( size_t aIdx )
+    {
+        if( aIdx == 42 )
+            throw std::runtime_error( "item 42" );
+    };
+
+    BOOST_CHECK_THROW( ParallelFor( 100, throwOnItem42 ), std::runtime_error );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,91 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <richio.h>
+
+#include <cstring>
+
+
+BOOST_AUTO_TEST_SUITE( RichIo )
+
+
+/**
+ * Lines that fit in the buffer are returned whole, with their terminator
+ */
+BOOST_AUTO_TEST_CASE( ChunkShortLines )
+{
+    STRING_LINE_READER reader( "G04 first*\nX0Y0D02*\nM02*", "test" );
+    LINE_CHUNK_READER  chunkReader( reader );
+    char               buffer[32];
+
+    BOOST_CHECK( chunkReader.ReadChunk( buffer, sizeof( buffer ) ) == buffer );
+    BOOST_CHECK_EQUAL( std::string( buffer ), "G04 first*\n" );
+
+    BOOST_CHECK( chunkReader.ReadChunk( buffer, sizeof( buffer ) ) );
+    BOOST_CHECK_EQUAL( std::string( buffer ), "X0Y0D02*\n" );
+
+    BOOST_CHECK( chunkReader.ReadChunk( buffer, sizeof( buffer ) ) );
+    BOOST_CHECK_EQUAL( std::string( buffer ), "M02*" );
+
+    BOOST_CHECK( chunkReader.ReadChunk( buffer, sizeof( buffer ) ) == NULL );
+}
+
+
+/**
+ * A line longer than the buffer is returned in several chunks, as fgets() does, and
+ * the following line is only read once it has been entirely returned
+ */
+BOOST_AUTO_TEST_CASE( ChunkLongLine )
+{
+    const std::string  longLine = "X1000000Y2000000D01*X3000000Y4000000D01*\n";
+    STRING_LINE_READER reader( longLine + "M02*\n", "test" );
+    LINE_CHUNK_READER  chunkReader( reader );
+    char               buffer[16];
+    std::string        text;
+
+    while( chunkReader.ReadChunk( buffer, sizeof( buffer ) ) )
+    {
+        BOOST_CHECK_LE( strlen( buffer ), sizeof( buffer ) - 1 );
+        BOOST_CHECK_EQUAL( reader.LineNumber(), text.size() < longLine.size() ? 1 : 2 );
+        text += buffer;
+    }
+
+    BOOST_CHECK_EQUAL( text, longLine + "M02*\n" );
+}
+
+
+/**
+ * A buffer with no room for text returns nothing instead of looping
+ */
+BOOST_AUTO_TEST_CASE( ChunkTinyBuffer )
+{
+    STRING_LINE_READER reader( "M02*\n", "test" );
+    LINE_CHUNK_READER  chunkReader( reader );
+    char               buffer[1];
+
+    BOOST_CHECK( chunkReader.ReadChunk( buffer, sizeof( buffer ) ) == NULL );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,187 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <trace_span.h>
+
+#include <sstream>
+#include <thread>
+
+
+namespace
+{
+
+/// Count the occurrences of a span name in a trace dump
+int countSpans( const std::string& aTrace, const std::string& aName )
+{
+    std::string key = "\"name\":\"" + aName + "\"";
+    int         count = 0;
+
+    for( size_t pos = aTrace.find( key ); pos != std::string::npos;
+            pos = aTrace.find( key, pos + 1 ) )
+    {
+        count++;
+    }
+
+    return count;
+}
+
+
+/// The thread id of the first span with a given name in a trace dump, or -1
+int spanThreadId( const std::string& aTrace, const std::string& aName )
+{
+    size_t pos = aTrace.find( "\"name\":\"" + aName + "\"" );
+
+    if( pos == std::string::npos )
+        return -1;
+
+    pos = aTrace.find( "\"tid\":", pos );
+
+    if( pos == std::string::npos )
+        return -1;
+
+    return std::stoi( aTrace.substr( pos + 6 ) );
+}
+
+
+std::string flushTrace()
+{
+    std::ostringstream stream;
+    TRACE_SPAN::WriteChromeTrace( stream );
+    return stream.str();
+}
+
+} // namespace
+
+
+struct TraceSpanFixture
+{
+    TraceSpanFixture()
+    {
+        TRACE_SPAN::Enable( true, 16 );
+        flushTrace();
+    }
+
+    ~TraceSpanFixture()
+    {
+        TRACE_SPAN::Enable( false );
+    }
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( TraceSpan, TraceSpanFixture )
+
+
+/**
+ * Nested spans are all recorded, and each flush only returns new spans
+ */
+BOOST_AUTO_TEST_CASE( RecordAndFlush )
+{
+    {
+        TRACE_SPAN outer( "outer" );
+        TRACE_SPAN inner( "inner", "test" );
+    }
+
+    std::string trace = flushTrace();
+
+    BOOST_CHECK_EQUAL( countSpans( trace, "outer" ), 1 );
+    BOOST_CHECK_EQUAL( countSpans( trace, "inner" ), 1 );
+    BOOST_CHECK( trace.find( "\"cat\":\"test\"" ) != std::string::npos );
+    BOOST_CHECK( trace.find( "\"traceEvents\"" ) != std::string::npos );
+
+    BOOST_CHECK_EQUAL( countSpans( flushTrace(), "outer" ), 0 );
+}
+
+
+/**
+ * Nothing is recorded while disabled
+ */
+BOOST_AUTO_TEST_CASE( Disabled )
+{
+    TRACE_SPAN::Enable( false );
+
+    {
+        TRACE_SPAN span( "disabled" );
+    }
+
+    TRACE_SPAN::Enable( true, 16 );
+
+    BOOST_CHECK_EQUAL( countSpans( flushTrace(), "disabled" ), 0 );
+}
+
+
+/**
+ * The ring buffer keeps the most recent spans of each thread
+ */
+BOOST_AUTO_TEST_CASE( RingAndThreads )
+{
+    std::thread worker( []()
+                        {
+                            for( int ii = 0; ii < 40; ii++ )
+                                TRACE_SPAN span( "worker" );
+                        } );
+
+    worker.join();
+
+    {
+        TRACE_SPAN span( "main" );
+    }
+
+    std::string trace = flushTrace();
+
+    BOOST_CHECK_EQUAL( countSpans( trace, "worker" ), 16 );
+    BOOST_CHECK_EQUAL( countSpans( trace, "main" ), 1 );
+}
+
+
+/**
+ * A thread reusing the buffer of an exited thread gets its own thread id, and the
+ * spans of the exited thread keep theirs
+ */
+BOOST_AUTO_TEST_CASE( RecycledBufferThreadId )
+{
+    std::thread first( []()
+                       {
+                           TRACE_SPAN span( "first" );
+                       } );
+
+    first.join();
+
+    std::thread second( []()
+                        {
+                            TRACE_SPAN span( "second" );
+                        } );
+
+    second.join();
+
+    std::string trace = flushTrace();
+    int         firstId = spanThreadId( trace, "first" );
+    int         secondId = spanThreadId( trace, "second" );
+
+    BOOST_CHECK_GT( firstId, 0 );
+    BOOST_CHECK_GT( secondId, 0 );
+    BOOST_CHECK_NE( firstId, secondId );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -454,6 +454,63 @@ BOOST_AUTO_TEST_CASE( Inheritance )
 }
 
 
+/**
+ * Check the flattened symbol cache follows changes to both the derived symbol and its parent.
+ */
+BOOST_AUTO_TEST_CASE( FlattenedCache )
+{
+    std::unique_ptr< LIB_PART > parent( new LIB_PART( "parent" ) );
+    BOOST_CHECK( parent->GetFlattenedPart() == parent.get() );
+
+    std::unique_ptr< LIB_PART > child( new LIB_PART( "child", parent.get() ) );
+    LIB_PART* flattened = child->GetFlattenedPart();
+    BOOST_REQUIRE( flattened );
+    BOOST_CHECK( flattened != child.get() );
+    BOOST_CHECK( flattened->IsRoot() );
+    BOOST_CHECK_EQUAL( flattened->GetName(), "child" );
+
+    // Unchanged symbols reuse the cached copy.
+    BOOST_CHECK( child->GetFlattenedPart() == flattened );
+
+    // Changing the parent invalidates the cache.
+    parent->SetUnitCount( 3 );
+    BOOST_CHECK_EQUAL( child->GetFlattenedPart()->GetUnitCount(), 3 );
+
+    // Changing the derived symbol invalidates the cache.
+    child->SetDescription( "new description" );
+    BOOST_CHECK_EQUAL( child->GetFlattenedPart()->GetDescription(), "new description" );
+
+    // Direct edits of the derived symbol are picked up after clearing its caches.
+    unsigned long long revision = child->GetRevision();
+    child->GetField( DATASHEET )->SetText( "new datasheet" );
+    child->ClearCaches();
+    BOOST_CHECK( child->GetRevision() != revision );
+    BOOST_CHECK_EQUAL( child->GetFlattenedPart()->GetField( DATASHEET )->GetText(),
+                       "new datasheet" );
+
+    // Direct edits of the parent are picked up after clearing the parent caches.
+    LIB_RECTANGLE* rect = new LIB_RECTANGLE( parent.get() );
+    rect->SetEnd( wxPoint( 100, 100 ) );
+    parent->AddDrawItem( rect );
+
+    auto flattenedRect = [&]()
+    {
+        return static_cast<LIB_RECTANGLE*>(
+                child->GetFlattenedPart()->GetNextDrawItem( nullptr, LIB_RECTANGLE_T ) );
+    };
+
+    BOOST_REQUIRE( flattenedRect() );
+    BOOST_CHECK_EQUAL( flattenedRect()->GetEnd(), wxPoint( 100, 100 ) );
+
+    rect->SetEnd( wxPoint( 200, 50 ) );
+    rect->SetSelected();
+    parent->ClearCaches();
+    BOOST_REQUIRE( flattenedRect() );
+    BOOST_CHECK_EQUAL( flattenedRect()->GetEnd(), wxPoint( 200, 50 ) );
+    BOOST_CHECK( !flattenedRect()->IsSelected() );
+}
+
+
 /**
  * Check the copy constructor.
  */
@@ -0,0 +1,638 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file kimath_benchmark.cpp
+ * Micro-benchmarks of the geometry kernel.
+ *
+ * The benchmarks run on generated inputs, which are the same from run to run, and on the
+ * zone fills of the boards found in the QA data directory (or given on the command line,
+ * along with zone filler dumps).  The results are written on stdout as CSV, one line per
+ * benchmark and input:
+ *
+ *   benchmark,input,vertices,reps,min_us,mean_us,result
+ *
+ * "result" is a checksum of what the benchmark computed: it must not change when optimizing
+ * the code under test.
+ */
+
+#include <geometry/seg.h>
+#include <geometry/shape_line_chain.h>
+#include <geometry/shape_poly_set.h>
+#include <math/util.h>
+#include <math/vector2d.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <wx/dir.h>
+#include <wx/filename.h>
+
+
+using CLOCK = std::chrono::steady_clock;
+
+
+/**
+ * A named polygon set to run the benchmarks on, with the points and segments used by the
+ * query benchmarks, spread over its bounding box.
+ */
+struct BENCH_INPUT
+{
+    std::string           name;
+    SHAPE_POLY_SET        polys;
+    std::vector<VECTOR2I> points;
+    std::vector<SEG>      segments;
+};
+
+
+/**
+ * A benchmark: runs once on the given input, and returns a checksum of its results.
+ *
+ * setup, if given, is called before each run, out of the timing, to prepare a copy of the
+ * input which the benchmark can modify.
+ */
+struct BENCHMARK
+{
+    using SETUP_FUNC = std::function<void( const BENCH_INPUT&, SHAPE_POLY_SET& )>;
+    using BENCH_FUNC = std::function<int64_t( const BENCH_INPUT&, SHAPE_POLY_SET& )>;
+
+    std::string name;
+    SETUP_FUNC  setup;
+    BENCH_FUNC  func;
+};
+
+
+///> Number of points and segments used by the query benchmarks
+static const int QUERY_COUNT = 10000;
+
+///> Only one point or segment out of QUERY_STEP is used by the benchmarks of the queries
+///> walking all the edges
+static const size_t QUERY_STEP = 10;
+
+
+static void addQueries( BENCH_INPUT& aInput, unsigned aSeed )
+{
+    std::mt19937 rng( aSeed );
+    BOX2I        bbox = aInput.polys.BBox( aInput.polys.BBox().GetWidth() / 20 );
+    int          maxLength = std::max( 1, bbox.GetWidth() / 20 );
+
+    std::uniform_int_distribution<int> x( bbox.GetLeft(), bbox.GetRight() );
+    std::uniform_int_distribution<int> y( bbox.GetTop(), bbox.GetBottom() );
+    std::uniform_int_distribution<int> d( -maxLength, maxLength );
+
+    for( int i = 0; i < QUERY_COUNT; i++ )
+    {
+        VECTOR2I p( x( rng ), y( rng ) );
+
+        aInput.points.push_back( p );
+        aInput.segments.emplace_back( p, p + VECTOR2I( d( rng ), d( rng ) ) );
+    }
+}
+
+
+/**
+ * A star shaped polygon with aCount vertices and a random radius, like a zone outline
+ * following many pads.
+ */
+static BENCH_INPUT makeStar( int aCount )
+{
+    BENCH_INPUT      input;
+    SHAPE_LINE_CHAIN outline;
+    std::mt19937     rng( aCount );
+
+    std::uniform_int_distribution<int> radius( 9000000, 10000000 );
+
+    for( int i = 0; i < aCount; i++ )
+    {
+        double angle = 2.0 * M_PI * i / aCount;
+        int    r = radius( rng );
+
+        outline.Append( KiROUND( r * cos( angle ) ), KiROUND( r * sin( angle ) ) );
+    }
+
+    outline.SetClosed( true );
+
+    input.name = "star_" + std::to_string( aCount );
+    input.polys.AddOutline( outline );
+    addQueries( input, aCount );
+    return input;
+}
+
+
+/**
+ * A square with a grid of aCount x aCount round holes, like a zone around the pads of a
+ * BGA.
+ */
+static BENCH_INPUT makeHoles( int aCount )
+{
+    BENCH_INPUT      input;
+    SHAPE_LINE_CHAIN outline;
+    int              pitch = 1000000;
+    int              size = ( aCount + 1 ) * pitch;
+
+    outline.Append( 0, 0 );
+    outline.Append( size, 0 );
+    outline.Append( size, size );
+    outline.Append( 0, size );
+    outline.SetClosed( true );
+    input.polys.AddOutline( outline );
+
+    for( int i = 0; i < aCount; i++ )
+    {
+        for( int j = 0; j < aCount; j++ )
+        {
+            SHAPE_LINE_CHAIN hole;
+
+            for( int k = 0; k < 16; k++ )
+            {
+                double angle = 2.0 * M_PI * k / 16;
+
+                hole.Append( ( i + 1 ) * pitch + KiROUND( 300000 * cos( angle ) ),
+                             ( j + 1 ) * pitch + KiROUND( 300000 * sin( angle ) ) );
+            }
+
+            hole.SetClosed( true );
+            input.polys.AddHole( hole );
+        }
+    }
+
+    input.name = "holes_" + std::to_string( aCount * aCount );
+    addQueries( input, aCount );
+    return input;
+}
+
+
+/**
+ * aCount random overlapping small polygons, like the clearance holes of a zone.
+ */
+static BENCH_INPUT makeBlobs( int aCount )
+{
+    BENCH_INPUT  input;
+    std::mt19937 rng( aCount );
+    int          size = KiROUND( std::sqrt( aCount ) * 1000000 );
+
+    std::uniform_int_distribution<int> pos( 0, size );
+    std::uniform_int_distribution<int> radius( 200000, 800000 );
+
+    for( int i = 0; i < aCount; i++ )
+    {
+        SHAPE_LINE_CHAIN blob;
+        VECTOR2I         center( pos( rng ), pos( rng ) );
+        int              r = radius( rng );
+
+        for( int k = 0; k < 12; k++ )
+        {
+            double angle = 2.0 * M_PI * k / 12;
+
+            blob.Append( center.x + KiROUND( r * cos( angle ) ),
+                         center.y + KiROUND( r * sin( angle ) ) );
+        }
+
+        blob.SetClosed( true );
+        input.polys.AddOutline( blob );
+    }
+
+    input.name = "blobs_" + std::to_string( aCount );
+    addQueries( input, aCount );
+    return input;
+}
+
+
+static std::string baseName( const std::string& aPath )
+{
+    return wxFileName( aPath ).GetFullName().ToStdString();
+}
+
+
+static bool readFile( const std::string& aPath, std::string& aContent )
+{
+    std::ifstream file( aPath, std::ios::binary );
+
+    if( !file )
+        return false;
+
+    std::stringstream ss;
+    ss << file.rdbuf();
+    aContent = ss.str();
+    return true;
+}
+
+
+/**
+ * Reads the filled polygons of the zones of a .kicad_pcb file, as a single polygon set.
+ * Only the "(filled_polygon (pts (xy X Y)...))" items are looked at, so the board does not
+ * have to be loaded.
+ */
+static bool loadBoardZoneFills( const std::string& aPath, std::vector<BENCH_INPUT>& aInputs )
+{
+    std::string content;
+
+    if( !readFile( aPath, content ) )
+        return false;
+
+    BENCH_INPUT input;
+    size_t      pos = 0;
+
+    while( ( pos = content.find( "(filled_polygon", pos ) ) != std::string::npos )
+    {
+        SHAPE_LINE_CHAIN outline;
+        size_t           pts = content.find( "(pts", pos );
+        int              depth = 0;
+
+        if( pts == std::string::npos )
+            break;
+
+        // Read the (xy X Y) items up to the end of the pts list
+        for( pos = pts; pos < content.size(); pos++ )
+        {
+            if( content[pos] == ')' && --depth == 0 )
+                break;
+
+            if( content[pos] != '(' )
+                continue;
+
+            depth++;
+
+            if( content.compare( pos, 4, "(xy " ) == 0 )
+            {
+                char*  end;
+                double x = strtod( content.c_str() + pos + 4, &end );
+                double y = strtod( end, &end );
+
+                // Board files are in mm, internal units are nm
+                outline.Append( KiROUND( x * 1e6 ), KiROUND( y * 1e6 ) );
+            }
+        }
+
+        if( outline.PointCount() >= 3 )
+        {
+            outline.SetClosed( true );
+            input.polys.AddOutline( outline );
+        }
+    }
+
+    if( input.polys.OutlineCount() == 0 )
+        return true;
+
+    input.name = baseName( aPath );
+    addQueries( input, input.polys.TotalVertices() );
+    aInputs.push_back( std::move( input ) );
+    return true;
+}
+
+
+/**
+ * Reads the polygon sets of a dump written by the zone filler (SHAPE_FILE_IO format).
+ */
+static bool loadShapeDump( const std::string& aPath, std::vector<BENCH_INPUT>& aInputs )
+{
+    std::string content;
+
+    if( !readFile( aPath, content ) )
+        return false;
+
+    size_t pos = 0;
+    int    index = 0;
+
+    while( ( pos = content.find( "polyset ", pos ) ) != std::string::npos )
+    {
+        BENCH_INPUT       input;
+        std::stringstream ss( content.substr( pos ) );
+
+        pos++;
+
+        if( !input.polys.Parse( ss ) || input.polys.OutlineCount() == 0 )
+            continue;
+
+        input.name = baseName( aPath ) + "#" + std::to_string( index++ );
+        addQueries( input, input.polys.TotalVertices() );
+        aInputs.push_back( std::move( input ) );
+    }
+
+    return true;
+}
+
+
+static bool loadFile( const std::string& aPath, std::vector<BENCH_INPUT>& aInputs )
+{
+    if( wxFileName( aPath ).GetExt() == "kicad_pcb" )
+        return loadBoardZoneFills( aPath, aInputs );
+
+    return loadShapeDump( aPath, aInputs );
+}
+
+
+static void loadDataDir( const std::string& aDir, std::vector<BENCH_INPUT>& aInputs )
+{
+    wxArrayString files;
+
+    if( !wxDir::Exists( aDir ) )
+        return;
+
+    wxDir::GetAllFiles( aDir, &files, "*.kicad_pcb", wxDIR_FILES );
+
+    // Keep the order of the inputs (and of the output) stable
+    files.Sort();
+
+    for( const wxString& file : files )
+        loadBoardZoneFills( file.ToStdString(), aInputs );
+}
+
+
+static int64_t polySetChecksum( const SHAPE_POLY_SET& aPolys )
+{
+    return (int64_t) ( aPolys.GetHash() & 0x7FFFFFFFFFFFFFFFULL );
+}
+
+
+///> A second polygon set for the boolean benchmarks, overlapping the input
+static SHAPE_POLY_SET shiftedCopy( const SHAPE_POLY_SET& aPolys )
+{
+    SHAPE_POLY_SET copy = aPolys;
+    BOX2I          bbox = aPolys.BBox();
+
+    copy.Move( VECTOR2I( bbox.GetWidth() / 7, bbox.GetHeight() / 11 ) );
+    return copy;
+}
+
+
+static void copyInput( const BENCH_INPUT& aInput, SHAPE_POLY_SET& aWork )
+{
+    aWork = aInput.polys;
+}
+
+
+static std::vector<BENCHMARK> benchmarkList =
+{
+    { "seg_distance", nullptr,
+      []( const BENCH_INPUT& aInput, SHAPE_POLY_SET& )
+      {
+          int64_t acc = 0;
+
+          for( size_t i = 1; i < aInput.segments.size(); i++ )
+              acc += aInput.segments[i].SquaredDistance( aInput.segments[i - 1] ) & 0xFFFF;
+
+          return acc;
+      } },
+
+    { "seg_intersect", nullptr,
+      []( const BENCH_INPUT& aInput, SHAPE_POLY_SET& )
+      {
+          int64_t acc = 0;
+
+          for( size_t i = 1; i < aInput.segments.size(); i++ )
+          {
+              for( size_t j = i; j < aInput.segments.size() && j < i + 32; j++ )
+                  acc += (bool) aInput.segments[i].Intersect( aInput.segments[j] );
+          }
+
+          return acc;
+      } },
+
+    { "chain_collide", nullptr,
+      []( const BENCH_INPUT& aInput, SHAPE_POLY_SET& )
+      {
+          const SHAPE_LINE_CHAIN& outline = aInput.polys.COutline( 0 );
+          int                     clearance = aInput.polys.BBox().GetWidth() / 100;
+          int64_t                 acc = 0;
+
+          for( size_t i = 0; i < aInput.segments.size(); i += QUERY_STEP )
+              acc += outline.Collide( aInput.segments[i], clearance );
+
+          return acc;
+      } },
+
+    { "chain_point_inside", nullptr,
+      []( const BENCH_INPUT& aInput, SHAPE_POLY_SET& )
+      {
+          const SHAPE_LINE_CHAIN& outline = aInput.polys.COutline( 0 );
+          int64_t                 acc = 0;
+
+          for( size_t i = 0; i < aInput.points.size(); i += QUERY_STEP )
+              acc += outline.PointInside( aInput.points[i] );
+
+          return acc;
+      } },
+
+    { "polyset_union", copyInput,
+      []( const BENCH_INPUT& aInput, SHAPE_POLY_SET& aWork )
+      {
+          aWork.BooleanAdd( shiftedCopy( aInput.polys ), SHAPE_POLY_SET::PM_FAST );
+          return polySetChecksum( aWork );
+      } },
+
+    { "polyset_subtract", copyInput,
+      []( const BENCH_INPUT& aInput, SHAPE_POLY_SET& aWork )
+      {
+          aWork.BooleanSubtract( shiftedCopy( aInput.polys ), SHAPE_POLY_SET::PM_FAST );
+          return polySetChecksum( aWork );
+      } },
+
+    { "polyset_intersect", copyInput,
+      []( const BENCH_INPUT& aInput, SHAPE_POLY_SET& aWork )
+      {
+          aWork.BooleanIntersection( shiftedCopy( aInput.polys ), SHAPE_POLY_SET::PM_FAST );
+          return polySetChecksum( aWork );
+      } },
+
+    { "polyset_inflate", copyInput,
+      []( const BENCH_INPUT& aInput, SHAPE_POLY_SET& aWork )
+      {
+          aWork.Inflate( aInput.polys.BBox().GetWidth() / 200, 16 );
+          return polySetChecksum( aWork );
+      } },
+
+    { "polyset_fracture",
+      []( const BENCH_INPUT& aInput, SHAPE_POLY_SET& aWork )
+      {
+          // Zone fills are stored fractured: rebuild their holes first
+          aWork = aInput.polys;
+
+          if( !aWork.HasHoles() )
+              aWork.Unfracture( SHAPE_POLY_SET::PM_FAST );
+      },
+      []( const BENCH_INPUT& aInput, SHAPE_POLY_SET& aWork )
+      {
+          aWork.Fracture( SHAPE_POLY_SET::PM_FAST );
+          return polySetChecksum( aWork );
+      } },
+
+    { "polyset_triangulate", copyInput,
+      []( const BENCH_INPUT& aInput, SHAPE_POLY_SET& aWork )
+      {
+          aWork.CacheTriangulation();
+
+          int64_t acc = 0;
+
+          for( unsigned i = 0; i < aWork.TriangulatedPolyCount(); i++ )
+              acc += aWork.TriangulatedPolygon( i )->GetTriangleCount();
+
+          return acc;
+      } },
+
+    { "polyset_squared_distance", copyInput,
+      []( const BENCH_INPUT& aInput, SHAPE_POLY_SET& aWork )
+      {
+          int64_t acc = 0;
+
+          for( size_t i = 0; i < aInput.points.size(); i += QUERY_STEP )
+              acc += aWork.SquaredDistance( aInput.points[i] ) & 0xFFFF;
+
+          return acc;
+      } },
+
+    { "polyset_squared_distance_indexed", copyInput,
+      []( const BENCH_INPUT& aInput, SHAPE_POLY_SET& aWork )
+      {
+          int64_t acc = 0;
+
+          // Includes the building of the index
+          aWork.EnableIndex();
+
+          for( size_t i = 0; i < aInput.points.size(); i += QUERY_STEP )
+              acc += aWork.SquaredDistance( aInput.points[i] ) & 0xFFFF;
+
+          return acc;
+      } },
+};
+
+
+static void printUsage( const char* aName )
+{
+    std::cerr << "Usage: " << aName << " [-r REPS] [-b BENCHMARK] [-d DATA_DIR] [FILE...]\n\n"
+              << "Runs the geometry kernel benchmarks on generated inputs, on the zone fills\n"
+              << "of the boards of DATA_DIR and on the given files (.kicad_pcb files, or\n"
+              << "polygon dumps of the zone filler).  Writes the results on stdout as CSV.\n\n"
+              << "  -r REPS       number of runs of each benchmark (default 5)\n"
+              << "  -b BENCHMARK  run only the benchmarks whose name contains BENCHMARK\n"
+              << "  -d DATA_DIR   directory of the boards (default " << QA_KIMATH_DATA_LOCATION
+              << ", \"\" for none)\n\n"
+              << "Benchmarks:\n";
+
+    for( const BENCHMARK& bench : benchmarkList )
+        std::cerr << "  " << bench.name << "\n";
+}
+
+
+int main( int argc, char** argv )
+{
+    int                      reps = 5;
+    std::string              filter;
+    std::string              dataDir = QA_KIMATH_DATA_LOCATION;
+    std::vector<std::string> files;
+
+    if( const char* env = std::getenv( "KICAD_TEST_KIMATH_DATA_DIR" ) )
+        dataDir = env;
+
+    for( int i = 1; i < argc; i++ )
+    {
+        std::string arg = argv[i];
+
+        if( ( arg == "-r" || arg == "-b" || arg == "-d" ) && i + 1 < argc )
+        {
+            std::string value = argv[++i];
+
+            if( arg == "-r" )
+                reps = std::max( 1, atoi( value.c_str() ) );
+            else if( arg == "-b" )
+                filter = value;
+            else
+                dataDir = value;
+        }
+        else if( arg.size() && arg[0] == '-' )
+        {
+            printUsage( argv[0] );
+            return 1;
+        }
+        else
+        {
+            files.push_back( arg );
+        }
+    }
+
+    std::vector<BENCH_INPUT> inputs;
+
+    inputs.push_back( makeStar( 1000 ) );
+    inputs.push_back( makeStar( 20000 ) );
+    inputs.push_back( makeHoles( 60 ) );
+    inputs.push_back( makeBlobs( 2000 ) );
+
+    if( !dataDir.empty() )
+        loadDataDir( dataDir, inputs );
+
+    for( const std::string& file : files )
+    {
+        if( !loadFile( file, inputs ) )
+        {
+            std::cerr << "Cannot read " << file << "\n";
+            return 2;
+        }
+    }
+
+    std::cout << "benchmark,input,vertices,reps,min_us,mean_us,result" << std::endl;
+
+    for( const BENCHMARK& bench : benchmarkList )
+    {
+        if( !filter.empty() && bench.name.find( filter ) == std::string::npos )
+            continue;
+
+        for( const BENCH_INPUT& input : inputs )
+        {
+            SHAPE_POLY_SET work;
+            int64_t        result = 0;
+            int64_t        minUs = 0;
+            int64_t        totalUs = 0;
+
+            for( int rep = 0; rep < reps; rep++ )
+            {
+                if( bench.setup )
+                    bench.setup( input, work );
+
+                CLOCK::time_point start = CLOCK::now();
+                result = bench.func( input, work );
+                CLOCK::time_point end = CLOCK::now();
+
+                int64_t us = std::chrono::duration_cast<std::chrono::microseconds>( end - start )
+                                     .count();
+
+                minUs = rep == 0 ? us : std::min( minUs, us );
+                totalUs += us;
+            }
+
+            std::cout << bench.name << "," << input.name << "," << input.polys.TotalVertices()
+                      << "," << reps << "," << minUs << "," << totalUs / reps << "," << result
+                      << std::endl;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,382 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <board_commit.h>
+#include <class_board.h>
+#include <class_module.h>
+#include <class_pad.h>
+#include <class_track.h>
+#include <connectivity/connectivity_algo.h>
+#include <connectivity/connectivity_data.h>
+#include <drc/drc.h>
+#include <drc/drc_item.h>
+#include <parallel_for.h>
+#include <tool/tool_manager.h>
+#include <tracks_cleaner.h>
+
+#include <algorithm>
+#include <memory>
+#include <set>
+#include <tuple>
+
+
+/**
+ * What the cleaner reports about an item: error code, main and auxiliary item
+ */
+typedef std::tuple<int, KIID, KIID> CLEANUP_ITEM;
+
+
+struct TRACKS_CLEANER_FIXTURE
+{
+    TRACKS_CLEANER_FIXTURE() : m_commit( &m_toolMgr ), m_module( nullptr )
+    {
+    }
+
+    ~TRACKS_CLEANER_FIXTURE()
+    {
+        for( BOARD_ITEM* item : m_removed )
+            delete item;
+    }
+
+    TRACK* AddTrack( const wxPoint& aStart, const wxPoint& aEnd, int aWidth = 250000 )
+    {
+        TRACK* track = new TRACK( &m_board );
+
+        track->SetStart( aStart );
+        track->SetEnd( aEnd );
+        track->SetWidth( aWidth );
+        track->SetLayer( F_Cu );
+        m_board.Add( track );
+
+        return track;
+    }
+
+    VIA* AddVia( const wxPoint& aPos )
+    {
+        VIA* via = new VIA( &m_board );
+
+        via->SetViaType( VIATYPE::THROUGH );
+        via->SetLayerPair( F_Cu, B_Cu );
+        via->SetPosition( aPos );
+        via->SetWidth( 600000 );
+        via->SetDrill( 300000 );
+        m_board.Add( via );
+
+        return via;
+    }
+
+    D_PAD* AddThroughPad( const wxPoint& aPos )
+    {
+        if( !m_module )
+        {
+            m_module = new MODULE( &m_board );
+            m_board.Add( m_module );
+        }
+
+        D_PAD* pad = new D_PAD( m_module );
+
+        pad->SetShape( PAD_SHAPE_CIRCLE );
+        pad->SetAttribute( PAD_ATTRIB_STANDARD );
+        pad->SetLayerSet( D_PAD::StandardMask() );
+        pad->SetSize( wxSize( 1500000, 1500000 ) );
+        pad->SetDrillSize( wxSize( 800000, 800000 ) );
+        pad->SetPosition( aPos );
+        pad->SetPos0( aPos );
+        m_module->Add( pad );
+
+        return pad;
+    }
+
+    /**
+     * Runs the cleaner with the given tests (see TRACKS_CLEANER::CleanupBoard()), and returns
+     * what it reports, in order.  The items it removes are deleted with the fixture.
+     */
+    std::vector<CLEANUP_ITEM> Cleanup( bool aDryRun, bool aRemoveMisConnected, bool aCleanVias,
+                                       bool aMergeSegments, bool aDeleteUnconnected,
+                                       bool aDeleteTracksInPads )
+    {
+        std::set<TRACK*>       before( m_board.Tracks().begin(), m_board.Tracks().end() );
+        std::vector<DRC_ITEM*> items;
+        TRACKS_CLEANER         cleaner( EDA_UNITS::MILLIMETRES, &m_board, m_commit );
+
+        m_board.BuildConnectivity();
+        cleaner.CleanupBoard( aDryRun, &items, aRemoveMisConnected, aCleanVias, aMergeSegments,
+                              aDeleteUnconnected, aDeleteTracksInPads );
+
+        for( TRACK* track : m_board.Tracks() )
+            before.erase( track );
+
+        m_removed.insert( m_removed.end(), before.begin(), before.end() );
+
+        std::vector<CLEANUP_ITEM> result;
+
+        for( DRC_ITEM* item : items )
+        {
+            result.emplace_back( item->GetErrorCode(), item->GetMainItemID(),
+                                 item->GetAuxItemID() );
+            delete item;
+        }
+
+        return result;
+    }
+
+    bool OnBoard( const TRACK* aTrack ) const
+    {
+        for( TRACK* track : m_board.Tracks() )
+        {
+            if( track == aTrack )
+                return true;
+        }
+
+        return false;
+    }
+
+    TOOL_MANAGER             m_toolMgr;
+    BOARD                    m_board;
+    BOARD_COMMIT             m_commit;
+    MODULE*                  m_module;
+    std::vector<BOARD_ITEM*> m_removed;
+};
+
+
+static bool reports( const std::vector<CLEANUP_ITEM>& aItems, int aCode, const BOARD_ITEM* aMain )
+{
+    for( const CLEANUP_ITEM& item : aItems )
+    {
+        if( std::get<0>( item ) == aCode && std::get<1>( item ) == aMain->m_Uuid )
+            return true;
+    }
+
+    return false;
+}
+
+
+BOOST_FIXTURE_TEST_SUITE( TracksCleaner, TRACKS_CLEANER_FIXTURE )
+
+/**
+ * Identical segments are duplicates whatever the order of their ends, but not segments
+ * of another width
+ */
+BOOST_AUTO_TEST_CASE( DuplicateSegments )
+{
+    TRACK* kept = AddTrack( wxPoint( 0, 0 ), wxPoint( 10000000, 0 ) );
+    TRACK* same = AddTrack( wxPoint( 0, 0 ), wxPoint( 10000000, 0 ) );
+    TRACK* reversed = AddTrack( wxPoint( 10000000, 0 ), wxPoint( 0, 0 ) );
+    TRACK* wider = AddTrack( wxPoint( 0, 0 ), wxPoint( 10000000, 0 ), 500000 );
+
+    std::vector<CLEANUP_ITEM> items = Cleanup( false, false, false, true, false, false );
+
+    BOOST_CHECK( reports( items, DRCE_DUPLICATE_TRACK, same ) );
+    BOOST_CHECK( reports( items, DRCE_DUPLICATE_TRACK, reversed ) );
+    BOOST_CHECK( !reports( items, DRCE_DUPLICATE_TRACK, kept ) );
+    BOOST_CHECK( !reports( items, DRCE_DUPLICATE_TRACK, wider ) );
+
+    BOOST_CHECK( OnBoard( kept ) );
+    BOOST_CHECK( !OnBoard( same ) );
+    BOOST_CHECK( !OnBoard( reversed ) );
+    BOOST_CHECK( OnBoard( wider ) );
+}
+
+/**
+ * Collinear segments which overlap are merged in one segment covering both
+ */
+BOOST_AUTO_TEST_CASE( OverlappingSegments )
+{
+    TRACK* first = AddTrack( wxPoint( 0, 0 ), wxPoint( 10000000, 0 ) );
+    TRACK* second = AddTrack( wxPoint( 5000000, 0 ), wxPoint( 15000000, 0 ) );
+
+    std::vector<CLEANUP_ITEM> items = Cleanup( false, false, false, true, false, false );
+
+    BOOST_CHECK_EQUAL( items.size(), 1u );
+    BOOST_CHECK_EQUAL( m_board.Tracks().size(), 1u );
+
+    TRACK* merged = m_board.Tracks().front();
+
+    BOOST_CHECK( merged == first || merged == second );
+    BOOST_CHECK( std::min( merged->GetStart().x, merged->GetEnd().x ) == 0 );
+    BOOST_CHECK( std::max( merged->GetStart().x, merged->GetEnd().x ) == 15000000 );
+}
+
+/**
+ * Vias at the same location are redundant, and so are vias on through hole pads
+ */
+BOOST_AUTO_TEST_CASE( RedundantVias )
+{
+    VIA* kept = AddVia( wxPoint( 0, 0 ) );
+    VIA* same = AddVia( wxPoint( 0, 0 ) );
+    VIA* other = AddVia( wxPoint( 5000000, 0 ) );
+    VIA* onPad = AddVia( wxPoint( 10000000, 0 ) );
+    VIA* locked = AddVia( wxPoint( 20000000, 0 ) );
+
+    D_PAD* pad = AddThroughPad( wxPoint( 10000000, 0 ) );
+    AddThroughPad( wxPoint( 20000000, 0 ) );
+    locked->SetLocked( true );
+
+    std::vector<CLEANUP_ITEM> items = Cleanup( false, false, true, false, false, false );
+
+    BOOST_CHECK( reports( items, DRCE_REDUNDANT_VIA, kept ) );
+    BOOST_CHECK( reports( items, DRCE_REDUNDANT_VIA, onPad ) );
+    BOOST_CHECK( !reports( items, DRCE_REDUNDANT_VIA, other ) );
+    BOOST_CHECK( !reports( items, DRCE_REDUNDANT_VIA, locked ) );
+
+    for( const CLEANUP_ITEM& item : items )
+    {
+        if( std::get<1>( item ) == onPad->m_Uuid )
+            BOOST_CHECK( std::get<2>( item ) == pad->m_Uuid );
+    }
+
+    BOOST_CHECK( OnBoard( kept ) );
+    BOOST_CHECK( !OnBoard( same ) );
+    BOOST_CHECK( OnBoard( other ) );
+    BOOST_CHECK( !OnBoard( onPad ) );
+    BOOST_CHECK( OnBoard( locked ) );
+}
+
+/**
+ * Dangling tracks are removed until no track is left dangling, and tracks connected at
+ * both ends are kept
+ */
+BOOST_AUTO_TEST_CASE( DanglingTracks )
+{
+    AddThroughPad( wxPoint( 0, 0 ) );
+    AddThroughPad( wxPoint( 10000000, 0 ) );
+
+    TRACK* connected = AddTrack( wxPoint( 0, 0 ), wxPoint( 10000000, 0 ) );
+    TRACK* stub = AddTrack( wxPoint( 0, 0 ), wxPoint( 0, 5000000 ) );
+    TRACK* end = AddTrack( wxPoint( 0, 5000000 ), wxPoint( 3000000, 8000000 ) );
+
+    std::vector<CLEANUP_ITEM> items = Cleanup( false, false, false, false, true, false );
+
+    BOOST_CHECK( reports( items, DRCE_DANGLING_TRACK, end ) );
+    BOOST_CHECK( reports( items, DRCE_DANGLING_TRACK, stub ) );
+    BOOST_CHECK( !reports( items, DRCE_DANGLING_TRACK, connected ) );
+
+    BOOST_CHECK( OnBoard( connected ) );
+    BOOST_CHECK( !OnBoard( stub ) );
+    BOOST_CHECK( !OnBoard( end ) );
+}
+
+/**
+ * Looking up a track missing from the connectivity (e.g. added without BOARD::Add()) does
+ * not add it, as the parallel tests rely on.  The dangling test rebuilds the connectivity
+ * first, so the track is tested like the others
+ */
+BOOST_AUTO_TEST_CASE( DanglingTrackMissingFromConnectivity )
+{
+    AddThroughPad( wxPoint( 0, 0 ) );
+    AddTrack( wxPoint( 0, 0 ), wxPoint( 5000000, 0 ) );
+
+    m_board.BuildConnectivity();
+
+    TRACK* missing = new TRACK( &m_board );
+
+    missing->SetStart( wxPoint( 5000000, 0 ) );
+    missing->SetEnd( wxPoint( 5000000, 5000000 ) );
+    missing->SetWidth( 250000 );
+    missing->SetLayer( F_Cu );
+    m_board.Tracks().push_back( missing );
+
+    std::shared_ptr<CONNECTIVITY_DATA> connectivity = m_board.GetConnectivity();
+
+    BOOST_CHECK( connectivity->GetConnectivityAlgo()->FindItemEntry( missing ) == nullptr );
+    BOOST_CHECK( connectivity->GetConnectedTracks( missing ).empty() );
+    BOOST_CHECK( !connectivity->GetConnectivityAlgo()->ItemExists( missing ) );
+
+    // The dangling test rebuilds the connectivity first
+    std::vector<CLEANUP_ITEM> items = Cleanup( true, false, false, false, true, false );
+
+    BOOST_CHECK( reports( items, DRCE_DANGLING_TRACK, missing ) );
+    BOOST_CHECK( m_board.GetConnectivity()->GetConnectivityAlgo()->ItemExists( missing ) );
+}
+
+/**
+ * The parallel tests (shorts, vias on pads, tracks in pads and dangling tracks) report the
+ * same items, in the same order, as a serial run
+ */
+BOOST_AUTO_TEST_CASE( ParallelSameAsSerial )
+{
+    m_board.Add( new NETINFO_ITEM( &m_board, "A" ) );
+    m_board.Add( new NETINFO_ITEM( &m_board, "B" ) );
+
+    int netA = m_board.FindNet( "A" )->GetNet();
+    int netB = m_board.FindNet( "B" )->GetNet();
+
+    // Enough tracks for several threads (at least 256 items each)
+    for( int i = 0; i < 40; i++ )
+    {
+        int    y = i * 5000000;
+        D_PAD* pad = AddThroughPad( wxPoint( 0, y ) );
+        int    net = ( i % 3 == 0 ) ? netB : netA;
+
+        pad->SetNetCode( netA );
+        AddVia( pad->GetPosition() )->SetNetCode( netA );
+        AddTrack( wxPoint( 0, y ), wxPoint( 200000, y ) )->SetNetCode( netA );
+
+        for( int j = 0; j < 40; j++ )
+        {
+            int x = j * 2000000;
+
+            AddTrack( wxPoint( x, y ), wxPoint( x + 2000000, y ) )->SetNetCode( net );
+
+            if( j % 5 == 0 )
+                AddTrack( wxPoint( x, y ), wxPoint( x, y + 1000000 ) )->SetNetCode( net );
+
+            if( j % 11 == 0 )
+                AddVia( wxPoint( x, y ) )->SetNetCode( net );
+        }
+    }
+
+    BOOST_REQUIRE_GT( m_board.Tracks().size(), 2u * 256 );
+
+    std::vector<CLEANUP_ITEM> serial;
+
+    {
+        // ParallelFor() runs serially on a parallel worker
+        PARALLEL_WORKER_SCOPE serialScope;
+
+        serial = Cleanup( true, true, true, false, true, true );
+    }
+
+    std::vector<CLEANUP_ITEM> parallel = Cleanup( true, true, true, false, true, true );
+
+    auto count =
+            [&]( int aCode )
+            {
+                return std::count_if( serial.begin(), serial.end(),
+                                      [&]( const CLEANUP_ITEM& aItem )
+                                      {
+                                          return std::get<0>( aItem ) == aCode;
+                                      } );
+            };
+
+    // Each test has something to report
+    BOOST_CHECK_GT( count( DRCE_SHORT ), 0 );
+    BOOST_CHECK_GT( count( DRCE_REDUNDANT_VIA ), 0 );
+    BOOST_CHECK_GT( count( DRCE_TRACK_IN_PAD ), 0 );
+    BOOST_CHECK_GT( count( DRCE_DANGLING_TRACK ), 0 );
+
+    BOOST_CHECK( parallel == serial );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
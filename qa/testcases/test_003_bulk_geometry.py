@@ -0,0 +1,62 @@
+import unittest
+import pcbnew
+
+from pcbnew import *
+
+
+class TestBulkGeometry(unittest.TestCase):
+
+    def setUp(self):
+        self.pcb = LoadBoard("data/complex_hierarchy.kicad_pcb")
+
+    def test_track_array_matches_tracks(self):
+        tracks = [t for t in self.pcb.GetTracks() if t.Type() == PCB_TRACE_T]
+        data = self.pcb.GetTrackArray()
+
+        self.assertEqual(data.shape, (len(tracks), BULK_TRACK_FIELD_COUNT))
+        self.assertEqual(data[0, BULK_TRACK_END_X], tracks[0].GetEnd().x)
+        self.assertEqual(data[0, BULK_TRACK_WIDTH], tracks[0].GetWidth())
+
+    def test_track_array_round_trip(self):
+        data = self.pcb.GetTrackArray()
+
+        self.assertEqual(self.pcb.SetTrackArray(data), 0)
+
+        data[0, BULK_TRACK_WIDTH] = data[0, BULK_TRACK_WIDTH] + 1000
+        self.assertEqual(self.pcb.SetTrackArray(data), 1)
+        self.assertEqual(self.pcb.GetTrackArray().tolist(), data.tolist())
+
+    def test_pad_array_round_trip(self):
+        pads = self.pcb.GetPads()
+        data = self.pcb.GetPadArray()
+
+        self.assertEqual(data.shape, (len(pads), BULK_PAD_FIELD_COUNT))
+        self.assertEqual(self.pcb.SetPadArray(data), 0)
+
+        data[0, BULK_PAD_X] = data[0, BULK_PAD_X] + 100000
+        self.assertEqual(self.pcb.SetPadArray(data), 1)
+        self.assertEqual(self.pcb.GetPadArray()[0, BULK_PAD_X], data[0, BULK_PAD_X])
+
+    def test_via_array_size(self):
+        vias = [t for t in self.pcb.GetTracks() if t.Type() == PCB_VIA_T]
+
+        self.assertEqual(len(self.pcb.GetViaArray()), len(vias))
+
+    def test_zone_outline_round_trip(self):
+        contours, points = self.pcb.GetZoneOutlineArrays()
+        total = sum(row[BULK_ZONE_POINT_COUNT] for row in contours.tolist())
+        zones = set(row[BULK_ZONE_INDEX] for row in contours.tolist())
+
+        self.assertEqual(len(points), total)
+        self.assertEqual(self.pcb.SetZoneOutlineArrays(contours, points), len(zones))
+        self.assertEqual(self.pcb.GetZoneOutlineArrays()[1].tolist(), points.tolist())
+
+    def test_wrong_size_is_rejected(self):
+        data = memoryview(ExportTrackArray(self.pcb)).cast('i')
+
+        with self.assertRaises(IOError):
+            self.pcb.SetTrackArray(data[BULK_TRACK_FIELD_COUNT:])
+
+
+if __name__ == '__main__':
+    unittest.main()
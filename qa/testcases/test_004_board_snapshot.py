@@ -0,0 +1,73 @@
+import os
+import tempfile
+import unittest
+import pcbnew
+
+from pcbnew import *
+
+
+class TestBoardSnapshot(unittest.TestCase):
+
+    def setUp(self):
+        self.pcb = LoadBoard("data/complex_hierarchy.kicad_pcb")
+
+        # Not the defaults, so a snapshot missing them is written differently
+        zone_settings = self.pcb.GetZoneSettings()
+        zone_settings.m_ZoneClearance = FromMM(0.789)
+        zone_settings.m_Zone_45_Only = not zone_settings.m_Zone_45_Only
+        self.pcb.SetZoneSettings(zone_settings)
+
+    def save(self, board):
+        handle, filename = tempfile.mkstemp(suffix=".kicad_pcb")
+        os.close(handle)
+
+        try:
+            SaveBoard(filename, board)
+
+            with open(filename) as saved:
+                return saved.read()
+        finally:
+            os.remove(filename)
+
+    def test_snapshot_saves_like_source(self):
+        source = self.save(self.pcb)
+        snapshot = self.pcb.CreateSnapshot()
+
+        self.assertIn("(zone_clearance 0.789)", source)
+        self.assertEqual(self.save(snapshot), source)
+
+    def test_snapshot_ignores_later_edits(self):
+        snapshot = self.pcb.CreateSnapshot()
+        before = self.save(snapshot)
+
+        track = self.pcb.GetTracks()[0]
+        track.SetWidth(track.GetWidth() + FromMM(0.1))
+
+        self.assertEqual(self.save(snapshot), before)
+        self.assertNotEqual(self.save(self.pcb), before)
+
+    def test_snapshot_copies_layers(self):
+        self.pcb.SetLayerName(pcbnew.Dwgs_User, "Notes")
+
+        visible = self.pcb.GetVisibleLayers()
+        visible.RemoveLayer(pcbnew.B_SilkS)
+        self.pcb.SetVisibleLayers(visible)
+
+        snapshot = self.pcb.CreateSnapshot()
+
+        self.assertEqual(snapshot.GetLayerName(pcbnew.Dwgs_User), "Notes")
+
+        for layer in range(pcbnew.PCB_LAYER_ID_COUNT):
+            self.assertEqual(snapshot.GetLayerName(layer), self.pcb.GetLayerName(layer))
+            self.assertEqual(snapshot.GetLayerType(layer), self.pcb.GetLayerType(layer))
+
+        self.assertEqual(snapshot.GetEnabledLayers().FmtHex(),
+                         self.pcb.GetEnabledLayers().FmtHex())
+        self.assertEqual(snapshot.GetVisibleLayers().FmtHex(),
+                         self.pcb.GetVisibleLayers().FmtHex())
+        self.assertFalse(snapshot.IsLayerVisible(pcbnew.B_SilkS))
+        self.assertEqual(snapshot.GetVisibleElements(), self.pcb.GetVisibleElements())
+
+
+if __name__ == '__main__':
+    unittest.main()
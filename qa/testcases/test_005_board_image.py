@@ -0,0 +1,54 @@
+import os
+import tempfile
+import unittest
+import pcbnew
+
+from pcbnew import *
+
+try:
+    import wx
+except ImportError:
+    wx = None
+
+
+class TestBoardImage(unittest.TestCase):
+
+    def setUp(self):
+        self.pcb = LoadBoard("data/complex_hierarchy.kicad_pcb")
+
+        handle, self.filename = tempfile.mkstemp(suffix=".png")
+        os.close(handle)
+
+    def tearDown(self):
+        os.remove(self.filename)
+
+    @unittest.skipIf(wx is None, "the image is read back with wxPython")
+    def test_board_image(self):
+        self.assertTrue(SaveBoardImage(self.filename, self.pcb, 160, 120))
+
+        image = wx.Image(self.filename, wx.BITMAP_TYPE_PNG)
+        self.assertTrue(image.IsOk())
+        self.assertEqual((image.GetWidth(), image.GetHeight()), (160, 120))
+
+        # The margin around the board is cleared to the opaque background color
+        def pixel(x, y):
+            return (image.GetRed(x, y), image.GetGreen(x, y), image.GetBlue(x, y))
+
+        background = pixel(0, 0)
+        self.assertEqual(pixel(159, 119), background)
+
+        if image.HasAlpha():
+            self.assertEqual(image.GetAlpha(0, 0), 255)
+
+        # and the board items are drawn over it
+        data = bytearray(image.GetData())
+        drawn = sum(1 for i in range(0, len(data), 3)
+                    if tuple(data[i:i + 3]) != background)
+        self.assertGreater(drawn, 160 * 120 // 20)
+
+    def test_board_image_bad_size(self):
+        self.assertFalse(SaveBoardImage(self.filename, self.pcb, 0, 120))
+
+
+if __name__ == '__main__':
+    unittest.main()